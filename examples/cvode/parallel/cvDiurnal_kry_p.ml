@@ -68,6 +68,11 @@ let float_cell_size =
 
 let bytes x = header_and_empty_array_size + x * float_cell_size
 
+(* For scaling studies, the process grid and the subgrids can be resized
+   through the environment, and the phases are timed (see
+   examples/utils/scaling_log.ml). *)
+let env_int = Scaling_log.env_int
+
 (* Problem Constants *)
 
 let nvars =    2            (* number of species         *)
@@ -93,11 +98,11 @@ let xmax =     20.0
 let ymin =     30.0         (* grid boundaries in y  *)
 let ymax =     50.0
 
-let npex =     2            (* no. PEs in x direction of PE array *)
-let npey =     2            (* no. PEs in y direction of PE array *)
+let npex = env_int "NPEX" 2 (* no. PEs in x direction of PE array *)
+let npey = env_int "NPEY" 2 (* no. PEs in y direction of PE array *)
                             (* Total no. PEs = NPEX*NPEY *)
-let mxsub =    5            (* no. x points per subgrid *)
-let mysub =    5            (* no. y points per subgrid *)
+let mxsub = env_int "MXSUB" 5 (* no. x points per subgrid *)
+let mysub = env_int "MYSUB" 5 (* no. y points per subgrid *)
 
 let mx =       npex*mxsub   (* MX = number of x mesh points *)
 let my =       npey*mysub   (* MY = number of y mesh points *)
@@ -667,6 +672,8 @@ let main () =
     exit 1
   end;
 
+  Scaling_log.reset ();
+
   (* Set local length *)
   let local_N = nvars*mxsub*mysub in
 
@@ -685,8 +692,12 @@ let main () =
     Cvode.(init BDF
       (SStolerances (reltol, abstol))
       ~lsolver:Spils.(solver (spgmr u)
-                             (prec_left ~setup:(precond data) (psolve data)))
-      (f data) t0 u)
+                        (prec_left
+                          ~setup:(fun jac jok gamma ->
+                                    Scaling_log.precfn
+                                      (fun () -> precond data jac jok gamma))
+                          (psolve data)))
+      (fun t u du -> Scaling_log.rhs (fun () -> f data t u du)) t0 u)
   in
 
   if my_pe = 0 then
@@ -701,7 +712,8 @@ let main () =
   done;
 
   (* Print final statistics *)
-  if my_pe = 0 then print_final_stats cvode_mem
+  if my_pe = 0 then print_final_stats cvode_mem;
+  Scaling_log.log "cvDiurnal_kry_p" comm mx my
 
 (* Check environment variables for extra arguments.  *)
 let reps =
@@ -219,6 +219,22 @@ $(PTHREADS_EXAMPLES:.ml=.opt): %.opt: $(SRC)/$(USELIB).cmxa		\
 	    $(LIB_PATH:%=-ccopt %)	\
 	    $(BIGARRAY_CMXA) unix.cmxa $^
 
+# Phase timing for the scaling studies, shared by the MPI examples that set
+# EXTRA_DEPS = scaling_log.cmo and FILES_TO_CLEAN = $(SCALING_LOG_FILES).
+# Use local copies to avoid problems with make -j.
+SCALING_LOG_FILES=scaling_log.ml scaling_log.cmi scaling_log.cmo	\
+		  scaling_log.cmx scaling_log.o scaling_log.cmt	\
+		  scaling_log.annot
+
+scaling_log.ml: $(UTILS)/scaling_log.ml
+	cp $< $@; chmod ugo-w $@
+
+scaling_log.cmo: scaling_log.ml
+	$(OCAMLC) $(OCAMLFLAGS) -c $(MPI_INCLUDES) -o $@ $<
+
+scaling_log.cmx: scaling_log.ml
+	$(OCAMLOPT) $(OCAMLOPTFLAGS) -c $(MPI_INCLUDES) -o $@ $<
+
 # opam inserts opam's and the system's stublibs directory into
 # CAML_LD_LIBRARY_PATH, which has higher precdence than -dllpath.
 # Make sure we run with the shared libraries in the source tree, not
@@ -0,0 +1,41 @@
+(* Let Cvode.Auto select a band solver for a system whose Jacobian has
+   upper and lower bandwidths 3 and 2, but whose off-diagonal entries
+   all vanish at the initial state y = 0. The detected bandwidths must
+   nevertheless cover the true ones, and the result must agree with that
+   of the dense solver.
+ *)
+
+open Sundials
+
+let n = 60
+
+let f _ y yd =
+  for i = 0 to n - 1 do
+    let up = if i + 3 < n then y.{i + 3} else 0.0
+    and lo = if i >= 2 then y.{i - 2} else 0.0 in
+    yd.{i} <- 1.0 -. 10.0 *. y.{i} +. 0.5 *. up *. y.{i} -. 0.5 *. lo *. lo
+  done
+
+let solve lsolver =
+  let y = Nvector_serial.make n 0.0 in
+  let s = Cvode.(init BDF (SStolerances (1.0e-8, 1.0e-10))
+                   ~lsolver f 0.0 y) in
+  ignore (Cvode.solve_normal s 1.0 y);
+  Nvector.unwrap y
+
+let () =
+  let decision = ref None in
+  let ya = solve (Cvode.Auto.solver ~candidates:[Cvode.Auto.Band]
+                    ~on_decision:(fun d -> decision := Some d) ()) in
+  let yd = solve (Cvode.Dls.solver
+                    (LinearSolver.Direct.dense
+                       (Nvector_serial.make n 0.0) (Matrix.dense n))) in
+  match !decision with
+  | None -> Check.holds "decision" false
+  | Some d ->
+      Check.report "band selected" (d.Cvode.Auto.kind = Cvode.Auto.Band)
+        (Cvode.Auto.string_of_kind d.Cvode.Auto.kind);
+      Check.report "bandwidths"
+        (d.Cvode.Auto.mu >= 3 && d.Cvode.Auto.ml >= 2)
+        (Printf.sprintf "mu = %d, ml = %d" d.Cvode.Auto.mu d.Cvode.Auto.ml);
+      Check.close "band vs dense" 1.0e-6 ya yd
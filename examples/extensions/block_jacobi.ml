@@ -0,0 +1,65 @@
+(* Integrate a chain of weakly coupled cells, each with a stiff linear
+   reaction chain and a quadratic loss, stored in a many-vector with one
+   subvector per cell. The GMRES solver is used without preconditioning
+   and with the block-Jacobi preconditioner (Cvode.Spils.BlockJacobi),
+   whose blocks are computed by difference quotients and by a user
+   function. The preconditioners must reduce the number of linear
+   iterations and give the same solution.
+ *)
+
+open Sundials
+
+let cells = 8
+let species = 5
+let rates = [| 1.0; 10.0; 100.0; 1000.0; 10000.0 |]
+let coupling = 0.1
+
+let cell v b = Nvector_serial.Any.unwrap (ROArray.get v b)
+
+let f _ ((y : Nvector.any ROArray.t), _) ((yd : Nvector.any ROArray.t), _) =
+  for b = 0 to cells - 1 do
+    let u = cell y b and ud = cell yd b in
+    for i = 0 to species - 1 do
+      let left = if b > 0 then (cell y (b - 1)).{i} else 0.0
+      and right = if b < cells - 1 then (cell y (b + 1)).{i} else 0.0 in
+      ud.{i} <- -. rates.(i) *. u.{i}
+                +. (if i > 0 then rates.(i - 1) *. u.{i - 1} else 0.0)
+                +. coupling *. (left +. right -. 2.0 *. u.{i})
+    done;
+    ud.{0} <- ud.{0} -. u.{0} *. u.{0}
+  done
+
+(* The Jacobian of a cell with respect to its own species *)
+let block_jac { Cvode.jac_y = ((y : Nvector.any ROArray.t), _); _ } b jm =
+  let u = cell y b in
+  Matrix.Dense.set_to_zero jm;
+  for i = 0 to species - 1 do
+    Matrix.Dense.set jm i i (-. rates.(i) -. 2.0 *. coupling);
+    if i > 0 then Matrix.Dense.set jm i (i - 1) rates.(i - 1)
+  done;
+  Matrix.Dense.set jm 0 0 (Matrix.Dense.get jm 0 0 -. 2.0 *. u.{0})
+
+let run prec =
+  let y = Nvector_many.wrap (ROArray.init cells (fun b ->
+            Nvector_serial.Any.make species (if b = 0 then 1.0 else 0.0))) in
+  let s = Cvode.(init BDF (SStolerances (1.0e-6, 1.0e-10))
+                   ~lsolver:Spils.(solver (spgmr y) (prec ()))
+                   f 0.0 y) in
+  Cvode.set_max_num_steps s 10000;
+  ignore (Cvode.solve_normal s 10.0 y);
+  let (yv, _) = Nvector.unwrap y in
+  let yc = RealArray.create (cells * species) in
+  for b = 0 to cells - 1 do
+    RealArray.blitn ~src:(cell yv b) ~dst:yc ~dpos:(b * species) species
+  done;
+  yc, Cvode.Spils.get_num_lin_iters s
+
+let () =
+  let y0, li0 = run (fun () -> Cvode.Spils.prec_none) in
+  let y1, li1 = run (fun () -> Cvode.Spils.BlockJacobi.prec_left ()) in
+  let y2, li2 =
+    run (fun () -> Cvode.Spils.BlockJacobi.prec_left ~jac:block_jac ()) in
+  Check.fewer "fewer iterations (dq blocks)" li1 li0;
+  Check.fewer "fewer iterations (user blocks)" li2 li0;
+  Check.close "dq blocks vs none" 1.0e-4 y1 y0;
+  Check.close "user blocks vs none" 1.0e-4 y2 y0
@@ -0,0 +1,54 @@
+(* Integrate the Robertson chemical kinetics problem (as in
+   examples/cvode/serial/cvRoberts_dns.ml) over a long interval, once with
+   the Newton nonlinear solver and once with the Broyden one, and compare
+   the numbers of Jacobian evaluations and of linear solver setups (each
+   of which refactors the iteration matrix) needed for the same accuracy.
+ *)
+
+open Sundials
+
+let f _ (y : RealArray.t) (yd : RealArray.t) =
+  let yd1 = -0.04 *. y.{0} +. 1.0e4 *. y.{1} *. y.{2}
+  and yd3 = 3.0e7 *. y.{1} *. y.{1}
+  in
+  yd.{0} <- yd1;
+  yd.{1} <- (-. yd1 -. yd3);
+  yd.{2} <- yd3
+
+let jac { Cvode.jac_y = (y : RealArray.t); _ } jmat =
+  let set = Matrix.Dense.set jmat in
+  set 0 0 (-0.04);
+  set 0 1 (1.0e4 *. y.{2});
+  set 0 2 (1.0e4 *. y.{1});
+  set 1 0 (0.04);
+  set 1 1 (-1.0e4 *. y.{2} -. 6.0e7 *. y.{1});
+  set 1 2 (-1.0e4 *. y.{1});
+  set 2 1 (6.0e7 *. y.{1})
+
+let tf = 4.0e10
+let rtol = 1.0e-4
+let atol = [| 1.0e-8; 1.0e-14; 1.0e-6 |]
+
+let run mk_nls =
+  let y = Nvector_serial.wrap (RealArray.of_list [1.0; 0.0; 0.0]) in
+  let abstol = Nvector_serial.wrap (RealArray.of_array atol) in
+  let m = Matrix.dense 3 in
+  let s = Cvode.(init BDF (SVtolerances (rtol, abstol))
+                   ~nlsolver:(mk_nls y)
+                   ~lsolver:Dls.(solver ~jac (dense y m))
+                   f 0.0 y) in
+  Cvode.set_max_num_steps s 10000;
+  ignore (Cvode.solve_normal s tf y);
+  Nvector.unwrap y, Cvode.Dls.get_num_jac_evals s,
+  Cvode.get_num_lin_solv_setups s
+
+let () =
+  let yn, nje_n, nsetups_n =
+    run (fun y -> NonlinearSolver.Newton.make y) in
+  let yb, nje_b, nsetups_b =
+    run (fun y -> NonlinearSolver.Broyden.make y) in
+  Check.fewer "fewer jacobian evaluations" nje_b nje_n;
+  Check.fewer "fewer setups" nsetups_b nsetups_n;
+  (* the global errors of both runs are a few tolerances *)
+  Check.below "broyden vs newton (in tolerances)" 100.0
+    (Check.max_scaled_diff rtol (Array.get atol) yn yb)
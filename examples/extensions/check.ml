@@ -0,0 +1,45 @@
+(* Checks shared by the tests of the Sundials/ML extensions, which have no
+   counterpart in the C library and are compared against the .expected
+   files instead. Each check prints one line, "name: ok" when it holds, so
+   that the output of a passing test does not depend on the version of
+   Sundials or on rounding, and "name: FAILED" with the measured value
+   otherwise. *)
+
+open Sundials
+
+let report name ok detail =
+  if ok then Printf.printf "%s: ok\n" name
+  else Printf.printf "%s: FAILED (%s)\n" name detail
+
+(* The largest absolute difference between two arrays. *)
+let max_diff a b =
+  let e = ref 0.0 in
+  for i = 0 to RealArray.length a - 1 do
+    e := max !e (abs_float (a.{i} -. b.{i}))
+  done;
+  !e
+
+(* The largest difference between two arrays relative to the tolerances
+   rtol |a.{i}| + atol i. *)
+let max_scaled_diff rtol atol a b =
+  let e = ref 0.0 in
+  for i = 0 to RealArray.length a - 1 do
+    e := max !e (abs_float (a.{i} -. b.{i})
+                 /. (rtol *. abs_float a.{i} +. atol i))
+  done;
+  !e
+
+let below name tol e =
+  report name (e < tol) (Printf.sprintf "%.3e, tolerance %.1e" e tol)
+
+let close name tol a b = below name tol (max_diff a b)
+
+let fewer name a b =
+  report name (a < b) (Printf.sprintf "%d, not fewer than %d" a b)
+
+let holds name b = report name b "false"
+
+let rejected name f =
+  report name
+    (match f () with exception Invalid_argument _ -> true | _ -> false)
+    "accepted"
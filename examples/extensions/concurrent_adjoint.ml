@@ -0,0 +1,85 @@
+(* Compute the gradients with respect to the initial conditions of
+   several objective functionals G_k = w_k . y(T) of a linear ODE, with
+   one backward problem per functional, once in lockstep and once
+   concurrently in worker processes, and compare the results with the
+   exact values.
+ *)
+
+open Sundials
+module Adj = Cvodes.Adjoint
+
+let printf = Printf.printf
+
+let neq = 2
+let tf = 1.0
+let a = [| [| -1.0; 0.5 |]; [| 0.2; -2.0 |] |]
+
+let f _ y yd =
+  for i = 0 to neq - 1 do
+    yd.{i} <- a.(i).(0) *. y.{0} +. a.(i).(1) *. y.{1}
+  done
+
+(* lambda' = -A^T lambda *)
+let fb { Adj.yb; _ } ybd =
+  for i = 0 to neq - 1 do
+    ybd.{i} <- -. (a.(0).(i) *. yb.{0} +. a.(1).(i) *. yb.{1})
+  done
+
+let weights = Array.init 6 (fun k -> [| float (k + 1); 1.0 /. float (k + 1) |])
+
+let forward () =
+  let y = Nvector_serial.make neq 1.0 in
+  let s = Cvode.(init BDF (SStolerances (1.0e-8, 1.0e-10))
+                   ~lsolver:Dls.(solver (dense y (Matrix.dense neq)))
+                   f 0.0 y) in
+  Adj.init s 100 Adj.IHermite;
+  ignore (Adj.forward_normal s tf y);
+  s
+
+let backward s w =
+  let yb = Nvector_serial.wrap (RealArray.of_array w) in
+  Adj.(init_backward s Cvode.BDF (SStolerances (1.0e-8, 1.0e-10))
+         ~lsolver:Dls.(solver (dense yb (Matrix.dense neq)))
+         (NoSens fb) tf yb)
+
+let gradient bs =
+  let yb = Nvector_serial.make neq 0.0 in
+  ignore (Adj.get bs yb);
+  RealArray.to_array (Nvector.unwrap yb)
+
+let lockstep () =
+  let s = forward () in
+  let bss = Array.map (backward s) weights in
+  Adj.backward_normal s 0.0;
+  Array.map gradient bss
+
+let concurrent () =
+  let s = forward () in
+  Adj.backward_concurrent s (Array.map (fun w s ->
+      let bs = backward s w in
+      Adj.backward_normal s 0.0;
+      gradient bs) weights)
+
+(* dG_k/dy0 = exp(A T)^T w_k, by forward integration of the unit vectors *)
+let exact () =
+  let phi = Array.init neq (fun j ->
+      let y = Nvector_serial.make neq 0.0 in
+      (Nvector.unwrap y).{j} <- 1.0;
+      let s = Cvode.(init BDF (SStolerances (1.0e-10, 1.0e-12))
+                       ~lsolver:Dls.(solver (dense y (Matrix.dense neq)))
+                       f 0.0 y) in
+      ignore (Cvode.solve_normal s tf y);
+      RealArray.to_array (Nvector.unwrap y))
+  in
+  Array.map (fun w ->
+      Array.init neq (fun j -> phi.(j).(0) *. w.(0) +. phi.(j).(1) *. w.(1)))
+    weights
+
+let flatten g = RealArray.of_array (Array.concat (Array.to_list g))
+
+let () =
+  let gl = lockstep () and gc = concurrent () and ge = exact () in
+  Array.iteri (fun k g -> printf "G_%d: dG/dy0 = (%.4f, %.4f)\n" k g.(0) g.(1))
+    ge;
+  Check.close "lockstep vs concurrent" 1.0e-10 (flatten gl) (flatten gc);
+  Check.close "concurrent vs exact" 1.0e-5 (flatten gc) (flatten ge)
@@ -0,0 +1,39 @@
+(* Integrate a one-dimensional reaction-diffusion problem with the
+   difference quotient Jacobian approximation, once with the internal
+   approximation and once with a pool of four domains that evaluate the
+   perturbed right-hand sides in parallel, for both dense and banded
+   matrices, and compare the results.
+ *)
+
+open Sundials
+
+let n = 200
+let dx = 1.0 /. float (n + 1)
+let diff = 0.01 /. (dx *. dx)
+
+let f _ u ud =
+  for i = 0 to n - 1 do
+    let ul = if i = 0 then 1.0 else u.{i - 1}
+    and ur = if i = n - 1 then 0.0 else u.{i + 1} in
+    ud.{i} <- diff *. (ul -. 2.0 *. u.{i} +. ur) +. u.{i} *. (1.0 -. u.{i})
+  done
+
+let solve ?dq_pool mk_ls =
+  let u = RealArray.make n 0.0 in
+  let u_nv = Nvector_serial.wrap u in
+  let s = Cvode.(init BDF (SStolerances (1.0e-6, 1.0e-8))
+                   ~lsolver:Dls.(solver ?dq_pool (mk_ls u_nv))
+                   f 0.0 u_nv) in
+  ignore (Cvode.solve_normal s 1.0 u_nv);
+  u
+
+let compare pool name mk_ls =
+  let dq_pool = Cvode.Dls.{ num_workers = Sundials_domains.num_workers pool;
+                            run = Sundials_domains.run pool } in
+  Check.close (name ^ ": internal vs pool") 1.0e-5
+    (solve mk_ls) (solve ~dq_pool mk_ls)
+
+let () =
+  Sundials_domains.with_pool ~num_workers:4 (fun pool ->
+    compare pool "dense" (fun u -> Cvode.Dls.dense u (Matrix.dense n));
+    compare pool "band" (fun u -> Cvode.Dls.band u (Matrix.band ~mu:1 ~ml:1 n)))
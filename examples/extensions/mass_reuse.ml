@@ -0,0 +1,43 @@
+(* Integrate M(t) y' = -y, whose mass matrix drifts very slowly, with and
+   without reusing the factorizations of the mass matrix
+   (Arkode.ARKStep.Mass.Dls.solver ~reuse_tol), and compare the results
+   and the numbers of factorizations. The heap is compacted between
+   outputs: the generic linear solver is only referenced by the reusing
+   wrapper, which must keep it alive.
+ *)
+
+open Sundials
+
+let n = 20
+
+let f _ y yd =
+  for i = 0 to n - 1 do yd.{i} <- -. y.{i} done
+
+(* (1 + 1e-9 t) times a tridiagonal matrix *)
+let mass t _ m =
+  let s = 1.0 +. 1.0e-9 *. t in
+  Matrix.Dense.set_to_zero m;
+  for i = 0 to n - 1 do
+    Matrix.Dense.set m i i s;
+    if i > 0 then Matrix.Dense.set m i (i - 1) (s *. 0.1);
+    if i < n - 1 then Matrix.Dense.set m i (i + 1) (s *. 0.1)
+  done
+
+let run ?reuse_tol () =
+  let y = Nvector_serial.make n 1.0 in
+  let s = Arkode.ARKStep.(
+            init (explicit f) (SStolerances (1.0e-6, 1.0e-10))
+                 ~mass:Mass.Dls.(solver ?reuse_tol mass true
+                                   (dense y (Matrix.dense n)))
+                 0.0 y) in
+  for i = 1 to 10 do
+    ignore (Arkode.ARKStep.evolve_normal s (float i) y);
+    Gc.compact ()
+  done;
+  Nvector.unwrap y, Arkode.ARKStep.Mass.Dls.get_num_factorizations s
+
+let () =
+  let y1, nf1 = run () in
+  let y2, nf2 = run ~reuse_tol:1.0e-6 () in
+  Check.fewer "fewer factorizations" nf2 nf1;
+  Check.close "reuse vs no reuse" 1.0e-5 y1 y2
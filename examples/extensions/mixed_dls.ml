@@ -0,0 +1,41 @@
+(* Solve the Robertson chemical kinetics problem twice, once with the
+   double-precision dense solver and once with the mixed-precision one,
+   and compare the results.
+ *)
+
+open Sundials
+
+let f _ y yd =
+  yd.{0} <- -0.04 *. y.{0} +. 1.0e4 *. y.{1} *. y.{2};
+  yd.{2} <- 3.0e7 *. y.{1} *. y.{1};
+  yd.{1} <- -. yd.{0} -. yd.{2}
+
+let jac { Cvode.jac_y = y; _ } m =
+  let set = Matrix.Dense.set m in
+  set 0 0 (-0.04);
+  set 0 1 (1.0e4 *. y.{2});
+  set 0 2 (1.0e4 *. y.{1});
+  set 1 0 0.04;
+  set 1 1 (-1.0e4 *. y.{2} -. 6.0e7 *. y.{1});
+  set 1 2 (-1.0e4 *. y.{1});
+  set 2 0 0.0;
+  set 2 1 (6.0e7 *. y.{1});
+  set 2 2 0.0
+
+let solve mk_ls =
+  let y = RealArray.of_array [| 1.0; 0.0; 0.0 |] in
+  let y_nv = Nvector_serial.wrap y in
+  let ls = mk_ls y_nv (Matrix.dense 3) in
+  let s = Cvode.(init BDF (SStolerances (1.0e-8, 1.0e-12))
+                   ~lsolver:Dls.(solver ~jac ls)
+                   f 0.0 y_nv) in
+  ignore (Cvode.solve_normal s 4.0e5 y_nv);
+  y, ls
+
+let () =
+  let yd, _ = solve (fun y m -> Cvode.Dls.dense y m) in
+  let ym, ls = solve (fun y m -> Cvode.Dls.mixed_dense y m) in
+  Check.close "mixed vs dense" 1.0e-6 yd ym;
+  let st = LinearSolver.Direct.Mixed.get_stats ls in
+  Check.holds "mixed-precision solves"
+    (st.LinearSolver.Direct.Mixed.num_solves > 0)
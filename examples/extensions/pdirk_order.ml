@@ -0,0 +1,68 @@
+(* Integrate the Prothero-Robinson problem y' = lambda (y - cos t) - sin t,
+   whose solution is y = cos t, with fixed steps and the PDIRK tables of
+   Arkode.ButcherTable.pdirk. On a nonstiff instance, the errors for two
+   step sizes give the observed order, which is compared to the order of
+   the table. On a very stiff instance, the error must stay small with a
+   large step, since the methods are A-stable and damp the stiff
+   components. ARKStep solves the stages of the tables one after another;
+   the integration is repeated with Arkode.ARKStep.ParallelStages, which
+   solves the stages of each iteration together, and the two results must
+   agree.
+ *)
+
+open Sundials
+
+let printf = Printf.printf
+
+let tf = 1.0
+
+let integrate table lambda h =
+  let f t y yd = yd.{0} <- lambda *. (y.{0} -. cos t) -. sin t in
+  let jac _ m = Matrix.Dense.set m 0 0 lambda in
+  let y = Nvector_serial.make 1 1.0 in
+  let m = Matrix.dense 1 in
+  let s = Arkode.ARKStep.(
+            init (implicit ~lsolver:Dls.(solver ~jac (dense y m)) f)
+                 (SStolerances (1.0e-12, 1.0e-14)) 0.0 y) in
+  Arkode.ARKStep.set_tables s ~implicit_table:table ();
+  Arkode.ARKStep.set_delta_gamma_max s 1.0e3;
+  Arkode.ARKStep.set_fixed_step s (Some h);
+  Arkode.ARKStep.set_stop_time s tf;
+  Arkode.ARKStep.set_max_num_steps s 100000;
+  ignore (Arkode.ARKStep.evolve_normal s tf y);
+  abs_float ((Nvector.unwrap y).{0} -. cos tf)
+
+let integrate_parallel table lambda h =
+  let f t y yd = yd.{0} <- lambda *. (y.{0} -. cos t) -. sin t in
+  let jac _ _ _ j = Matrix.Dense.set j 0 0 lambda in
+  let y = Nvector_serial.make 1 1.0 in
+  let s = Arkode.ARKStep.ParallelStages.(
+            init ~jac table (Arkode.ARKStep.SStolerances (1.0e-12, 1.0e-14))
+                 f 0.0 y) in
+  Arkode.ARKStep.ParallelStages.set_fixed_step s (Some h);
+  Arkode.ARKStep.ParallelStages.set_max_num_steps s 100000;
+  ignore (Arkode.ARKStep.ParallelStages.evolve_normal s tf y);
+  abs_float ((Nvector.unwrap y).{0} -. cos tf)
+
+let check name base =
+  let table = Arkode.ButcherTable.pdirk base in
+  let order = table.Arkode.ButcherTable.method_order in
+  let e1 = integrate table (-1.0) 0.2
+  and e2 = integrate table (-1.0) 0.1 in
+  let observed = log (e1 /. e2) /. log 2.0 in
+  let stiff = integrate table (-1.0e6) 0.2 in
+  printf "%s: %d stages, %d groups, order %d\n"
+    name table.Arkode.ButcherTable.stages
+    (List.length (Arkode.ButcherTable.stage_groups table)) order;
+  Check.report "  observed order" (observed > float order -. 0.5)
+    (Printf.sprintf "%.2f" observed);
+  Check.below "  stiff error" 1.0e-6 stiff;
+  let p1 = integrate_parallel table (-1.0) 0.1
+  and p2 = integrate_parallel table (-1.0e6) 0.2 in
+  Check.below "  parallel stages" (1.0e-3 *. e2 +. 1.0e-12)
+    (abs_float (p1 -. e2));
+  Check.below "  parallel stages (stiff)" 1.0e-6 p2
+
+let () =
+  check "radau IIA 2/3" Arkode.ButcherTable.Radau_IIA_2_3;
+  check "radau IIA 3/5" Arkode.ButcherTable.Radau_IIA_3_5
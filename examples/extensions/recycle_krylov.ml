@@ -0,0 +1,40 @@
+(* Integrate a one-dimensional advection-diffusion-reaction problem
+   with an unpreconditioned Newton-Krylov method, once with SPGMR and
+   once with the recycling GCRO-DR solver, and compare the results.
+ *)
+
+open Sundials
+
+let n = 100
+let dx = 1.0 /. float (n + 1)
+let diff = 1.0 /. (dx *. dx)
+let adv = 20.0 /. (2.0 *. dx)
+let pi = 4.0 *. atan 1.0
+
+let f _ u ud =
+  for i = 0 to n - 1 do
+    let ul = if i = 0 then 0.0 else u.{i - 1}
+    and ur = if i = n - 1 then 0.0 else u.{i + 1} in
+    ud.{i} <- diff *. (ul -. 2.0 *. u.{i} +. ur)
+              -. adv *. (ur -. ul)
+              -. 10.0 *. u.{i} *. u.{i}
+  done
+
+let solve mk_ls =
+  let u = RealArray.init n (fun i -> sin (pi *. float (i + 1) *. dx)) in
+  let u_nv = Nvector_serial.wrap u in
+  let ls = mk_ls u_nv in
+  let s = Cvode.(init BDF (SStolerances (1.0e-6, 1.0e-8))
+                   ~lsolver:Spils.(solver ls prec_none)
+                   f 0.0 u_nv) in
+  ignore (Cvode.solve_normal s 0.5 u_nv);
+  u, ls
+
+let () =
+  let ug, _ = solve (fun u -> LinearSolver.Iterative.spgmr ~maxl:10 u) in
+  let ur, ls =
+    solve (fun u -> LinearSolver.Iterative.gcrodr ~maxl:10 ~recycle:4 u) in
+  Check.close "gcrodr vs spgmr" 1.0e-4 ug ur;
+  let st = LinearSolver.Iterative.Gcrodr.get_stats ls in
+  Check.holds "recycled space in use"
+    (st.LinearSolver.Iterative.Gcrodr.recycle_dim > 0)
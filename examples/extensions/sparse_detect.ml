@@ -0,0 +1,43 @@
+(* Detect the sparsity pattern of a block-diagonal function with
+   Matrix.Sparse.detect, with and without its block sizes, and check that
+   detection with blocks rejects a function that couples two blocks.
+ *)
+
+open Sundials
+
+let printf = Printf.printf
+
+let blocks = [| 3; 5; 2; 4 |]
+let n = Array.fold_left (+) 0 blocks
+
+(* each unknown depends on itself and on the next one in its block *)
+let block_diag ?(coupled=false) y out =
+  let start = ref 0 in
+  Array.iter (fun s ->
+      for i = 0 to s - 1 do
+        let k = !start + i in
+        out.{k} <- y.{k} +. (if i + 1 < s then y.{k + 1} *. y.{k + 1} else 0.0)
+      done;
+      start := !start + s) blocks;
+  (* the last unknown of the third block depends on the first one *)
+  if coupled then out.{9} <- out.{9} +. y.{0}
+
+let pattern a =
+  let _, nc = Matrix.Sparse.size a in
+  let l = ref [] in
+  for c = 0 to nc - 1 do
+    for idx = Matrix.Sparse.get_col a c to Matrix.Sparse.get_col a (c + 1) - 1
+    do
+      l := (fst (Matrix.Sparse.get a idx), c) :: !l
+    done
+  done;
+  List.rev !l
+
+let () =
+  let full = Matrix.Sparse.detect n (block_diag ~coupled:false) in
+  let byblk = Matrix.Sparse.detect ~blocks n (block_diag ~coupled:false) in
+  printf "entries: %d without blocks, %d with blocks\n"
+    (List.length (pattern full)) (List.length (pattern byblk));
+  Check.holds "same pattern" (pattern full = pattern byblk);
+  Check.rejected "coupled blocks rejected"
+    (fun () -> Matrix.Sparse.detect ~blocks n (block_diag ~coupled:true))
@@ -0,0 +1,87 @@
+(* Integrate a two-dimensional reaction-diffusion problem with the band
+   direct solver and with the sparse LU solver of Sundials/ML
+   (LinearSolver.Direct.SparseLu), in the natural ordering and with the
+   minimum degree ordering, and compare the results. The minimum degree
+   ordering must give sparser factors than the natural one, and later
+   setups must reuse the symbolic factorization.
+ *)
+
+open Sundials
+
+let mx = 30
+let my = 30
+let n = mx * my
+let dx = 1.0 /. float (mx + 1)
+let dy = 1.0 /. float (my + 1)
+let cx = 0.01 /. (dx *. dx)
+let cy = 0.01 /. (dy *. dy)
+
+let f _ u ud =
+  let get i j =
+    if i < 0 || j < 0 || i >= mx then 0.0
+    else if j >= my then 1.0
+    else u.{j * mx + i}
+  in
+  for j = 0 to my - 1 do
+    for i = 0 to mx - 1 do
+      let k = j * mx + i in
+      ud.{k} <- cx *. (get (i - 1) j -. 2.0 *. u.{k} +. get (i + 1) j)
+                +. cy *. (get i (j - 1) -. 2.0 *. u.{k} +. get i (j + 1))
+                +. u.{k} *. (1.0 -. u.{k})
+    done
+  done
+
+(* Column k of the Jacobian has (at most) five entries, in increasing
+   row order. *)
+let jac { Cvode.jac_y = (u : RealArray.t); _ } m =
+  let idx = ref 0 in
+  let add r v = Matrix.Sparse.set m !idx r v; incr idx in
+  for j = 0 to my - 1 do
+    for i = 0 to mx - 1 do
+      let k = j * mx + i in
+      Matrix.Sparse.set_col m k !idx;
+      if j > 0 then add (k - mx) cy;
+      if i > 0 then add (k - 1) cx;
+      add k (-2.0 *. cx -. 2.0 *. cy +. 1.0 -. 2.0 *. u.{k});
+      if i < mx - 1 then add (k + 1) cx;
+      if j < my - 1 then add (k + mx) cy
+    done
+  done;
+  Matrix.Sparse.set_col m n !idx
+
+let solve lsolver =
+  let u = RealArray.make n 0.0 in
+  let u_nv = Nvector_serial.wrap u in
+  let s = Cvode.(init BDF (SStolerances (1.0e-6, 1.0e-8))
+                   ~lsolver:(lsolver u_nv) f 0.0 u_nv) in
+  ignore (Cvode.solve_normal s 1.0 u_nv);
+  u
+
+let sparse ordering =
+  let ls = ref None in
+  let mk u_nv =
+    let l = LinearSolver.Direct.SparseLu.make ~ordering u_nv
+              (Matrix.sparse_csc ~nnz:(5 * n) n) in
+    ls := Some l;
+    Cvode.Dls.solver ~jac l
+  in
+  let u = solve mk in
+  match !ls with
+  | Some l -> u, LinearSolver.Direct.SparseLu.get_stats l
+  | None -> assert false
+
+let () =
+  let ub =
+    solve (fun u -> Cvode.Dls.solver
+                      (LinearSolver.Direct.band u
+                         (Matrix.band ~mu:mx ~ml:mx n))) in
+  let un, sn = sparse LinearSolver.Direct.SparseLu.Natural in
+  let um, sm = sparse LinearSolver.Direct.SparseLu.MinDegree in
+  Check.close "natural vs band" 1.0e-5 ub un;
+  Check.close "minimum degree vs band" 1.0e-5 ub um;
+  Check.fewer "less fill"
+    sm.LinearSolver.Direct.SparseLu.factor_nnz
+    sn.LinearSolver.Direct.SparseLu.factor_nnz;
+  Check.holds "symbolic reuse"
+    (sm.LinearSolver.Direct.SparseLu.num_symbolic = 1
+     && sm.LinearSolver.Direct.SparseLu.num_numeric > 1)
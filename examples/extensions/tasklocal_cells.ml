@@ -0,0 +1,51 @@
+(* Integrate independent cells, each holding a Robertson chemical kinetics
+   problem (as in examples/cvode/serial/cvRoberts_dns.ml) with its own
+   rate constants, once with the Newton solver and a dense linear solver
+   on the whole system, and once with the task-local Newton solver
+   (NonlinearSolver.TaskLocal), whose Jacobian is block-diagonal with one
+   block per cell. The results must agree, and a local length that does
+   not match the nvector must be rejected.
+ *)
+
+open Sundials
+
+let cells = 20
+let n = 3 * cells
+let tf = 4.0e5
+let rtol = 1.0e-6
+
+let f _ (y : RealArray.t) (yd : RealArray.t) =
+  for c = 0 to cells - 1 do
+    let k = 3 * c and s = 1.0 +. 0.1 *. float c in
+    let yd1 = -0.04 *. s *. y.{k} +. 1.0e4 *. y.{k + 1} *. y.{k + 2}
+    and yd3 = 3.0e7 *. s *. y.{k + 1} *. y.{k + 1} in
+    yd.{k} <- yd1;
+    yd.{k + 1} <- (-. yd1 -. yd3);
+    yd.{k + 2} <- yd3
+  done
+
+let y0 () =
+  Nvector_serial.wrap (RealArray.init n (fun i -> if i mod 3 = 0 then 1.0
+                                                  else 0.0))
+
+let run ?lsolver nlsolver y =
+  let s = Cvode.(init BDF (SStolerances (rtol, 1.0e-10))
+                   ~nlsolver ?lsolver f 0.0 y) in
+  Cvode.set_max_num_steps s 100000;
+  ignore (Cvode.solve_normal s tf y);
+  Nvector.unwrap y
+
+let () =
+  let y = y0 () in
+  let yn = run ~lsolver:Cvode.Dls.(solver (dense y (Matrix.dense n)))
+               (NonlinearSolver.Newton.make y) y in
+  let y = y0 () in
+  let nls = NonlinearSolver.TaskLocal.make ~block_size:3 y in
+  let yt = run nls y in
+  Check.holds "block setups" (NonlinearSolver.TaskLocal.get_num_setups nls > 0);
+  (* the global errors of both runs are a few tolerances *)
+  Check.below "task-local vs newton (in tolerances)" 100.0
+    (Check.max_scaled_diff rtol (fun _ -> 1.0e-10) yn yt);
+  Check.rejected "wrong local length rejected"
+    (fun () -> NonlinearSolver.TaskLocal.make ~block_size:3
+                 ~local_length:(n - 3) (y0 ()))
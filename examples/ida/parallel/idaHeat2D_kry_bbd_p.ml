@@ -66,13 +66,18 @@ let zero =  0.0
 let one =   1.0
 let two =   2.0
 
+(* For scaling studies, the process grid and the subgrids can be resized
+   through the environment, and the phases are timed (see
+   examples/utils/scaling_log.ml). *)
+let env_int = Scaling_log.env_int
+
 let nout =         11             (* Number of output times *)
 
-let npex =         2              (* No. PEs in x direction of PE array *)
-let npey =         2              (* No. PEs in y direction of PE array *)
+let npex = env_int "NPEX" 2       (* No. PEs in x direction of PE array *)
+let npey = env_int "NPEY" 2       (* No. PEs in y direction of PE array *)
                                     (* Total no. PEs = npex*my *)
-let mxsub =        5              (* No. x points per subgrid *)
-let mysub =        5              (* No. y points per subgrid *)
+let mxsub = env_int "MXSUB" 5     (* No. x points per subgrid *)
+let mysub = env_int "MYSUB" 5     (* No. y points per subgrid *)
 
 let mx =           (npex*mxsub)   (* mx = number of x mesh points *)
 let my =           (npey*mysub)   (* my = number of y mesh points *)
@@ -528,6 +533,8 @@ let main () =
 
   (* Set local length local_N and global length Neq. *)
 
+  Scaling_log.reset ();
+
   let local_N = mxsub*mysub in
   let neq = mx * my in
 
@@ -576,9 +583,13 @@ let main () =
       ~lsolver:Spils.(solver lsolver
                         (Ida_bbd.prec_left ~dqrely:zero
                                            Ida_bbd.({ mudq; mldq; mukeep; mlkeep })
-                                           (reslocal data))
+                                           (fun t uu up res ->
+                                              Scaling_log.precfn (fun () ->
+                                                reslocal data t uu up res)))
       )
-      (heatres data) ~varid:id t0 uu up)
+      (fun t uu up res ->
+         Scaling_log.rhs (fun () -> heatres data t uu up res))
+      ~varid:id t0 uu up)
   in
   (match Config.sundials_version with
    | 2,_,_ -> ()
@@ -638,7 +649,8 @@ let main () =
   done;
 
   (* Print final statistics *)
-  if thispe = 0 then print_final_stats mem
+  if thispe = 0 then print_final_stats mem;
+  Scaling_log.log "idaHeat2D_kry_bbd_p" comm mx my
 
 (* Check environment variables for extra arguments.  *)
 let reps =
@@ -100,6 +100,11 @@ let unwrap = RealArray2.unwrap
 let sqr x = x *. x
 let nvwl2norm = Nvector.DataOps.wl2norm
 
+(* For scaling studies, the process grid and the subgrids can be resized
+   through the environment, and the phases are timed (see
+   examples/utils/scaling_log.ml). *)
+let env_int = Scaling_log.env_int
+
 (* Problem Constants *)
 
 let num_species =   6  (* must equal 2*(number of prey or predators)
@@ -107,10 +112,10 @@ let num_species =   6  (* must equal 2*(number of prey or predators)
 
 let pi          = 3.1415926535898   (* pi *)
 
-let npex        = 2            (* number of processors in the x-direction  *)
-let npey        = 2            (* number of processors in the y-direction  *)
-let mxsub       = 10           (* number of x mesh points per subgrid      *)
-let mysub       = 10           (* number of y mesh points per subgrid      *)
+let npex        = env_int "NPEX" 2    (* processors in the x-direction *)
+let npey        = env_int "NPEY" 2    (* processors in the y-direction *)
+let mxsub       = env_int "MXSUB" 10  (* x mesh points per subgrid     *)
+let mysub       = env_int "MYSUB" 10  (* y mesh points per subgrid     *)
 let mx          = npex*mxsub   (* number of mesh points in the x-direction *)
 let my          = npey*mysub   (* number of mesh points in the y-direction *)
 let nsmxsub     = num_species * mxsub
@@ -598,6 +603,8 @@ let main () =
 
   (* Allocate memory, and set problem data, initial values, tolerances *)
 
+  Scaling_log.reset ();
+
   (* Set local length *)
   let local_N = num_species*mxsub*mysub in
 
@@ -627,8 +634,11 @@ let main () =
               ~lsolver:Spils.(solver
                 (spgmr ~maxl:maxl ~max_restarts:maxlrst cc)
                 (Kinsol_bbd.prec_right Bbd.({ mudq; mldq; mukeep; mlkeep })
-                                       (func_local data)))
-              (func data) cc) in
+                                       (fun u fval ->
+                                         Scaling_log.precfn (fun () ->
+                                           func_local data u fval))))
+              (fun u fval -> Scaling_log.rhs (fun () -> func data u fval))
+              cc) in
   Kinsol.set_constraints kmem (Nvector.make local_N neq comm 0.0);
   Kinsol.set_func_norm_tol kmem fnormtol;
   Kinsol.set_scaled_step_tol kmem scsteptol;
@@ -648,7 +658,8 @@ let main () =
   if my_pe = 0 || my_pe = npelast then print_output my_pe comm cc;
 
   (* Print final statistics and free memory *)
-  if my_pe = 0 then print_final_stats kmem
+  if my_pe = 0 then print_final_stats kmem;
+  Scaling_log.log "kinFoodWeb_kry_bbd_p" comm mx my
 
 (* Check environment variables for extra arguments.  *)
 let reps =
@@ -0,0 +1,86 @@
+(* Run with:
+    ./dense_lu_bench.opt [n1 n2 ...]
+
+   Time the LU factorization of random dense matrices with
+   - Matrix.ArrayDense.getrf,
+   - the dense linear solver with the unblocked Sundials factorization,
+   - the dense linear solver with the cache-blocked factorization, and,
+   - if available, the LAPACK dense linear solver,
+   and check the residual of a solve with each factorization.
+ *)
+
+open Sundials
+
+let printf = Printf.printf
+
+let reps n = max 1 (200_000_000 / (n * n * n))
+
+let time n f =
+  let r = reps n in
+  let t0 = Unix.gettimeofday () in
+  for _ = 1 to r do f () done;
+  (Unix.gettimeofday () -. t0) /. float r
+
+let random_matrix n =
+  Random.init n;
+  let a = Matrix.ArrayDense.create n n in
+  for i = 0 to n - 1 do
+    for j = 0 to n - 1 do
+      Matrix.ArrayDense.set a i j (Random.float 1.0 -. 0.5)
+    done
+  done;
+  a
+
+let residual n a x b =
+  let ax = RealArray.create n in
+  Matrix.ArrayDense.matvec a x ax;
+  let r = ref 0.0 in
+  for i = 0 to n - 1 do
+    r := max !r (abs_float (ax.{i} -. b.{i}))
+  done;
+  if !r < 1.0e-8 *. float n then "ok" else Printf.sprintf "%g" !r
+
+let arraydense n a0 b =
+  let a = RealArray2.copy a0 and p = LintArray.create n in
+  let t = time n (fun () ->
+            Bigarray.Array2.blit (RealArray2.unwrap a0) (RealArray2.unwrap a);
+            Matrix.ArrayDense.getrf a p) in
+  let x = RealArray.copy b in
+  Matrix.ArrayDense.getrs a p x;
+  t, residual n a0 x b
+
+let lsolver n a0 b mk =
+  let m = Matrix.dense n in
+  let ls = mk (Nvector_serial.make n 0.0) m in
+  LinearSolver.init ls;
+  let t = time n (fun () ->
+            Bigarray.Array2.blit (RealArray2.unwrap a0)
+                                 (Matrix.Dense.unwrap (Matrix.unwrap m));
+            LinearSolver.setup ls m) in
+  let x = Nvector_serial.make n 0.0 in
+  LinearSolver.solve ls m x (Nvector_serial.wrap b) 0.0;
+  t, residual n a0 (Nvector.unwrap x) b
+
+let bench n =
+  let a0 = random_matrix n in
+  let b = RealArray.init n (fun i -> float (i mod 7) -. 3.0) in
+  let show name (t, r) =
+    printf "  %-24s %10.3f ms  residual %s\n%!" name (1000.0 *. t) r
+  in
+  printf "n = %d\n" n;
+  show "ArrayDense.getrf" (arraydense n a0 b);
+  show "dense (unblocked)"
+    (lsolver n a0 b (fun v m -> LinearSolver.Direct.dense v m));
+  show "dense (blocked)"
+    (lsolver n a0 b (fun v m -> LinearSolver.Direct.dense ~blocked:true v m));
+  if Config.lapack_enabled then
+    show "lapack_dense"
+      (lsolver n a0 b (fun v m -> LinearSolver.Direct.lapack_dense v m))
+
+let () =
+  let sizes =
+    if Array.length Sys.argv > 1
+    then List.map int_of_string (List.tl (Array.to_list Sys.argv))
+    else [100; 200; 500; 1000; 2000]
+  in
+  List.iter bench sizes
@@ -0,0 +1,458 @@
+/* C baselines for microbench.ml.
+ *
+ * Run with:
+ *    ./microbench.exe [n1 n2 ...] > microbench.c.csv
+ *
+ * Each benchmark calls the same Sundials function as the corresponding
+ * stub of the OCaml binding, or runs the same integration with callbacks
+ * written in C, and prints one line family,name,n,c_ns with the time per
+ * call in nanoseconds.  The timing loop is the same as in microbench.ml:
+ * the number of runs is doubled until a batch takes MIN_TIME seconds, and
+ * the best of NTRIALS batches is kept.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../../src/config.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <cvode/cvode.h>
+#include <nvector/nvector_serial.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+#include <sunlinsol/sunlinsol_band.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
+#include <sunnonlinsol/sunnonlinsol_fixedpoint.h>
+
+#if SUNDIALS_LIB_VERSION < 600
+#define sunrealtype realtype
+#define SUN_PREC_LEFT PREC_LEFT
+#define CTX
+#else
+#define CTX , ctx
+static SUNContext ctx;
+#endif
+
+#define MIN_TIME 0.05
+#define NTRIALS  5
+#define NV	 3		/* vectors in fused and array operations */
+#define MAX_DENSE 1000		/* largest dense matrix */
+#define TF	 1.0		/* end of the integrations */
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+/* Seconds per run of f, which returns the number of calls it stands for.  */
+static double time_per_call(long (*f)(void *), void *data)
+{
+    long reps = 1, i, calls;
+    double t, best;
+    int k;
+
+    for (;;) {
+	t = now();
+	for (i = 0; i < reps; i++) f(data);
+	t = now() - t;
+	if (t >= MIN_TIME) break;
+	reps *= 2;
+    }
+    best = t / reps;
+
+    for (k = 1; k < NTRIALS; k++) {
+	t = now();
+	for (i = 0; i < reps; i++) f(data);
+	t = (now() - t) / reps;
+	if (t < best) best = t;
+    }
+
+    calls = f(data);
+    return best / (calls > 0 ? calls : 1);
+}
+
+static void report(const char *family, const char *name, long n, double t)
+{
+    printf("%s,%s,%ld,%.2f\n", family, name, n, 1.0e9 * t);
+    fflush(stdout);
+}
+
+static void fill(N_Vector v, sunrealtype a, sunrealtype b, int m)
+{
+    sunrealtype *d = N_VGetArrayPointer(v);
+    sunindextype i, n = N_VGetLength(v);
+    for (i = 0; i < n; i++) d[i] = a + b * (i % m);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Serial nvector operations
+ */
+
+struct vecs {
+    N_Vector x, y, z, w, id, c, m;
+    N_Vector xs[NV], ys[NV], zs[NV];
+    N_Vector *yss[NV], *zss[NV];
+    sunrealtype a[NV], r[NV];
+};
+
+#define VEC_BENCH(name, body)			\
+    static long name(void *data)		\
+    {						\
+	struct vecs *v = data;			\
+	body;					\
+	return 1;				\
+    }
+
+VEC_BENCH(b_linearsum,	 N_VLinearSum_Serial(1.0, v->x, 2.0, v->y, v->z))
+VEC_BENCH(b_const,	 N_VConst_Serial(1.0, v->z))
+VEC_BENCH(b_prod,	 N_VProd_Serial(v->x, v->y, v->z))
+VEC_BENCH(b_div,	 N_VDiv_Serial(v->x, v->y, v->z))
+VEC_BENCH(b_scale,	 N_VScale_Serial(2.0, v->x, v->z))
+VEC_BENCH(b_abs,	 N_VAbs_Serial(v->x, v->z))
+VEC_BENCH(b_inv,	 N_VInv_Serial(v->x, v->z))
+VEC_BENCH(b_addconst,	 N_VAddConst_Serial(v->x, 1.0, v->z))
+VEC_BENCH(b_dotprod,	 N_VDotProd_Serial(v->x, v->y))
+VEC_BENCH(b_maxnorm,	 N_VMaxNorm_Serial(v->x))
+VEC_BENCH(b_wrmsnorm,	 N_VWrmsNorm_Serial(v->x, v->w))
+VEC_BENCH(b_wrmsnormmask, N_VWrmsNormMask_Serial(v->x, v->w, v->id))
+VEC_BENCH(b_min,	 N_VMin_Serial(v->x))
+VEC_BENCH(b_wl2norm,	 N_VWL2Norm_Serial(v->x, v->w))
+VEC_BENCH(b_l1norm,	 N_VL1Norm_Serial(v->x))
+VEC_BENCH(b_compare,	 N_VCompare_Serial(1.2, v->x, v->z))
+VEC_BENCH(b_invtest,	 N_VInvTest_Serial(v->x, v->z))
+VEC_BENCH(b_constrmask,	 N_VConstrMask_Serial(v->c, v->x, v->m))
+VEC_BENCH(b_minquotient, N_VMinQuotient_Serial(v->x, v->y))
+VEC_BENCH(b_linearcombination,
+	  N_VLinearCombination_Serial(NV, v->a, v->xs, v->z))
+VEC_BENCH(b_scaleaddmulti,
+	  N_VScaleAddMulti_Serial(NV, v->a, v->x, v->ys, v->zs))
+VEC_BENCH(b_dotprodmulti,
+	  N_VDotProdMulti_Serial(NV, v->x, v->ys, v->r))
+VEC_BENCH(b_linearsumvectorarray,
+	  N_VLinearSumVectorArray_Serial(NV, 1.0, v->xs, 2.0, v->ys, v->zs))
+VEC_BENCH(b_scalevectorarray,
+	  N_VScaleVectorArray_Serial(NV, v->a, v->xs, v->zs))
+VEC_BENCH(b_constvectorarray,
+	  N_VConstVectorArray_Serial(NV, 1.0, v->zs))
+VEC_BENCH(b_wrmsnormvectorarray,
+	  N_VWrmsNormVectorArray_Serial(NV, v->xs, v->ys, v->r))
+VEC_BENCH(b_wrmsnormmaskvectorarray,
+	  N_VWrmsNormMaskVectorArray_Serial(NV, v->xs, v->ys, v->id, v->r))
+VEC_BENCH(b_scaleaddmultivectorarray,
+	  N_VScaleAddMultiVectorArray_Serial(NV, NV, v->a, v->xs,
+					     v->yss, v->zss))
+VEC_BENCH(b_linearcombinationvectorarray,
+	  N_VLinearCombinationVectorArray_Serial(NV, NV, v->a, v->yss,
+						 v->zs))
+
+/* the generic operations, as called for custom nvectors */
+VEC_BENCH(g_linearsum,	 N_VLinearSum(1.0, v->x, 2.0, v->y, v->z))
+VEC_BENCH(g_const,	 N_VConst(1.0, v->z))
+VEC_BENCH(g_scale,	 N_VScale(2.0, v->x, v->z))
+VEC_BENCH(g_dotprod,	 N_VDotProd(v->x, v->y))
+VEC_BENCH(g_maxnorm,	 N_VMaxNorm(v->x))
+VEC_BENCH(g_wrmsnorm,	 N_VWrmsNorm(v->x, v->w))
+
+static struct { const char *name; long (*f)(void *); } serial_benches[] = {
+    { "linearsum", b_linearsum },
+    { "const", b_const },
+    { "prod", b_prod },
+    { "div", b_div },
+    { "scale", b_scale },
+    { "abs", b_abs },
+    { "inv", b_inv },
+    { "addconst", b_addconst },
+    { "dotprod", b_dotprod },
+    { "maxnorm", b_maxnorm },
+    { "wrmsnorm", b_wrmsnorm },
+    { "wrmsnormmask", b_wrmsnormmask },
+    { "min", b_min },
+    { "wl2norm", b_wl2norm },
+    { "l1norm", b_l1norm },
+    { "compare", b_compare },
+    { "invtest", b_invtest },
+    { "constrmask", b_constrmask },
+    { "minquotient", b_minquotient },
+    { "linearcombination", b_linearcombination },
+    { "scaleaddmulti", b_scaleaddmulti },
+    { "dotprodmulti", b_dotprodmulti },
+    { "linearsumvectorarray", b_linearsumvectorarray },
+    { "scalevectorarray", b_scalevectorarray },
+    { "constvectorarray", b_constvectorarray },
+    { "wrmsnormvectorarray", b_wrmsnormvectorarray },
+    { "wrmsnormmaskvectorarray", b_wrmsnormmaskvectorarray },
+    { "scaleaddmultivectorarray", b_scaleaddmultivectorarray },
+    { "linearcombinationvectorarray", b_linearcombinationvectorarray },
+}, custom_benches[] = {
+    { "linearsum", g_linearsum },
+    { "const", g_const },
+    { "scale", g_scale },
+    { "dotprod", g_dotprod },
+    { "maxnorm", g_maxnorm },
+    { "wrmsnorm", g_wrmsnorm },
+};
+
+#define NUM(a) (sizeof(a) / sizeof((a)[0]))
+
+static void nvector_benches(long n)
+{
+    struct vecs v;
+    int j, k;
+
+    v.x = N_VNew_Serial(n CTX);
+    v.y = N_VClone(v.x);
+    v.z = N_VClone(v.x);
+    v.w = N_VClone(v.x);
+    v.id = N_VClone(v.x);
+    v.c = N_VClone(v.x);
+    v.m = N_VClone(v.x);
+    fill(v.x, 1.0, 0.1, 7);
+    fill(v.y, 2.0, -0.1, 5);
+    fill(v.z, 0.0, 0.0, 1);
+    fill(v.w, 1.0e-2, 0.0, 1);
+    fill(v.id, 0.0, 1.0, 2);
+    fill(v.c, 0.0, 1.0, 3);
+    for (j = 0; j < NV; j++) {
+	v.xs[j] = N_VClone(v.x);
+	v.ys[j] = N_VClone(v.x);
+	v.zs[j] = N_VClone(v.x);
+	N_VScale(1.0, v.x, v.xs[j]);
+	N_VScale(1.0, v.y, v.ys[j]);
+	N_VConst(0.0, v.zs[j]);
+	v.yss[j] = v.ys;
+	v.zss[j] = v.zs;
+	v.a[j] = 1.0 / (j + 1);
+    }
+
+    for (k = 0; k < NUM(serial_benches); k++)
+	report("nvector_serial", serial_benches[k].name, n,
+	       time_per_call(serial_benches[k].f, &v));
+    for (k = 0; k < NUM(custom_benches); k++)
+	report("nvector_custom", custom_benches[k].name, n,
+	       time_per_call(custom_benches[k].f, &v));
+
+    for (j = 0; j < NV; j++) {
+	N_VDestroy(v.xs[j]);
+	N_VDestroy(v.ys[j]);
+	N_VDestroy(v.zs[j]);
+    }
+    N_VDestroy(v.x);
+    N_VDestroy(v.y);
+    N_VDestroy(v.z);
+    N_VDestroy(v.w);
+    N_VDestroy(v.id);
+    N_VDestroy(v.c);
+    N_VDestroy(v.m);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Matrix operations
+ */
+
+struct mats {
+    SUNMatrix a;
+    N_Vector x, y;
+};
+
+static long m_matvec(void *data)
+{
+    struct mats *m = data;
+    SUNMatMatvec(m->a, m->x, m->y);
+    return 1;
+}
+
+static long m_scale_addi(void *data)
+{
+    struct mats *m = data;
+    SUNMatScaleAddI(0.5, m->a);
+    return 1;
+}
+
+static void matrix_bench(long n, const char *kind, SUNMatrix a,
+			 N_Vector x, N_Vector y)
+{
+    struct mats m = { a, x, y };
+    char name[64];
+
+    sprintf(name, "%s_matvec", kind);
+    report("matrix", name, n, time_per_call(m_matvec, &m));
+    sprintf(name, "%s_scale_addi", kind);
+    report("matrix", name, n, time_per_call(m_scale_addi, &m));
+}
+
+static void matrix_benches(long n)
+{
+    sunindextype bw = (n > 1) ? 1 : 0, i, j;
+    SUNMatrix a, b, s;
+    N_Vector x, y;
+    sunrealtype *d;
+
+    x = N_VNew_Serial(n CTX);
+    y = N_VClone(x);
+    N_VConst(1.0, x);
+
+    if (n <= MAX_DENSE) {
+	a = SUNDenseMatrix(n, n CTX);
+	d = SUNDenseMatrix_Data(a);
+	for (i = 0; i < n * n; i++) d[i] = 1.0;
+	matrix_bench(n, "dense", a, x, y);
+	SUNMatDestroy(a);
+    }
+
+    b = SUNBandMatrixStorage(n, bw, bw, bw CTX);
+    for (j = 0; j < n; j++)
+	for (i = (j - bw > 0 ? j - bw : 0); i <= j + bw && i < n; i++)
+	    SM_ELEMENT_B(b, i, j) = 1.0;
+    s = SUNSparseFromBandMatrix(b, 0.0, CSC_MAT);
+    matrix_bench(n, "band", b, x, y);
+    matrix_bench(n, "sparse", s, x, y);
+
+    SUNMatDestroy(b);
+    SUNMatDestroy(s);
+    N_VDestroy(x);
+    N_VDestroy(y);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Callbacks from an integrator
+ */
+
+static int decay(sunrealtype t, N_Vector y, N_Vector yd, void *user_data)
+{
+    sunrealtype *y_d = N_VGetArrayPointer(y), *yd_d = N_VGetArrayPointer(yd);
+    sunindextype i, n = N_VGetLength(y);
+    for (i = 0; i < n; i++) yd_d[i] = -y_d[i];
+    return 0;
+}
+
+static int jac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix J,
+	       void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+    sunindextype i, n = N_VGetLength(y);
+    for (i = 0; i < n; i++) SM_ELEMENT_B(J, i, i) = -1.0;
+    return 0;
+}
+
+static int psolve(sunrealtype t, N_Vector y, N_Vector fy, N_Vector r,
+		  N_Vector z, sunrealtype gamma, sunrealtype delta, int lr,
+		  void *user_data)
+{
+    N_VScale(1.0, r, z);
+    return 0;
+}
+
+enum count { RHS_EVALS, JAC_EVALS, PREC_SOLVES };
+
+struct integration {
+    void *mem;
+    N_Vector y;
+    enum count count;
+};
+
+static long integrate(void *data)
+{
+    struct integration *s = data;
+    sunrealtype t;
+    long calls = 0;
+
+    N_VConst(1.0, s->y);
+    CVodeReInit(s->mem, 0.0, s->y);
+    CVode(s->mem, TF, s->y, &t, CV_NORMAL);
+    switch (s->count) {
+    case RHS_EVALS:   CVodeGetNumRhsEvals(s->mem, &calls); break;
+    case JAC_EVALS:   CVodeGetNumJacEvals(s->mem, &calls); break;
+    case PREC_SOLVES: CVodeGetNumPrecSolves(s->mem, &calls); break;
+    }
+    return calls;
+}
+
+static void callback_benches(long n)
+{
+    sunindextype bw = (n > 1) ? 1 : 0;
+    struct integration s;
+    SUNNonlinearSolver nls;
+    SUNLinearSolver ls;
+    SUNMatrix a;
+
+    s.y = N_VNew_Serial(n CTX);
+    N_VConst(1.0, s.y);
+
+    s.mem = CVodeCreate(CV_ADAMS CTX);
+    CVodeInit(s.mem, decay, 0.0, s.y);
+    CVodeSStolerances(s.mem, 1.0e-6, 1.0e-8);
+    nls = SUNNonlinSol_FixedPoint(s.y, 0 CTX);
+    CVodeSetNonlinearSolver(s.mem, nls);
+    s.count = RHS_EVALS;
+    report("callbacks", "rhsfn", n, time_per_call(integrate, &s));
+    CVodeFree(&s.mem);
+    SUNNonlinSolFree(nls);
+
+    s.mem = CVodeCreate(CV_BDF CTX);
+    CVodeInit(s.mem, decay, 0.0, s.y);
+    CVodeSStolerances(s.mem, 1.0e-6, 1.0e-8);
+    a = SUNBandMatrix(n, bw, bw CTX);
+    ls = SUNLinSol_Band(s.y, a CTX);
+    CVodeSetLinearSolver(s.mem, ls, a);
+    CVodeSetJacFn(s.mem, jac);
+    CVodeSetJacEvalFrequency(s.mem, 1);
+#if 540 <= SUNDIALS_LIB_VERSION
+    CVodeSetLSetupFrequency(s.mem, 1);
+#endif
+    s.count = JAC_EVALS;
+    report("callbacks", "jacfn", n, time_per_call(integrate, &s));
+    CVodeFree(&s.mem);
+    SUNLinSolFree(ls);
+    SUNMatDestroy(a);
+
+    s.mem = CVodeCreate(CV_BDF CTX);
+    CVodeInit(s.mem, decay, 0.0, s.y);
+    CVodeSStolerances(s.mem, 1.0e-6, 1.0e-8);
+    ls = SUNLinSol_SPGMR(s.y, SUN_PREC_LEFT, 0 CTX);
+    CVodeSetLinearSolver(s.mem, ls, NULL);
+    CVodeSetPreconditioner(s.mem, NULL, psolve);
+    s.count = PREC_SOLVES;
+    report("callbacks", "precsolvefn", n, time_per_call(integrate, &s));
+    CVodeFree(&s.mem);
+    SUNLinSolFree(ls);
+
+    N_VDestroy(s.y);
+}
+
+int main(int argc, char **argv)
+{
+    static const long default_sizes[] = { 1, 100, 10000 };
+    int i, nsizes = (argc > 1) ? argc - 1 : (int)NUM(default_sizes);
+    long n;
+
+#if 700 <= SUNDIALS_LIB_VERSION
+    SUNContext_Create(SUN_COMM_NULL, &ctx);
+#elif 600 <= SUNDIALS_LIB_VERSION
+    SUNContext_Create(NULL, &ctx);
+#endif
+
+    printf("family,name,n,c_ns\n");
+    for (i = 0; i < nsizes; i++) {
+	n = (argc > 1) ? atol(argv[i + 1]) : default_sizes[i];
+	nvector_benches(n);
+	matrix_benches(n);
+	callback_benches(n);
+    }
+
+#if 600 <= SUNDIALS_LIB_VERSION
+    SUNContext_Free(&ctx);
+#endif
+    return 0;
+}
+
+#else
+int main(int argc, char **argv)
+{
+    /* no baselines: microbench.opt reports the OCaml timings alone */
+    printf("family,name,n,c_ns\n");
+    return 0;
+}
+#endif
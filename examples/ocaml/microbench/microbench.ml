@@ -0,0 +1,298 @@
+(* Run with:
+    ./microbench.exe > microbench.c.csv
+    ./microbench.opt -baseline microbench.c.csv [-json] [n1 n2 ...]
+
+   Microbenchmarks of the binding layer: one benchmark per family of stubs
+   or callbacks, for several problem sizes (the default sizes are 1, 100,
+   and 10000).
+   - nvector_serial: the operations of Nvector_serial.Ops
+                     (the sunml_nvec_ser_* stubs),
+   - nvector_custom: generic operations on OCaml (Nvector_array) vectors,
+                     i.e., calls from C into OCaml (the callml_v* stubs),
+   - matrix:         matvec and scale_addi on dense, band, and sparse
+                     matrices (the sunml_matrix_*_matvec stubs, etc.),
+   - callbacks:      integrations with Cvode that are dominated by calls to
+                     the right-hand side function, to a band Jacobian
+                     function, or to a preconditioner solve function.
+                     The time per call includes the work of the integrator
+                     between calls, which is identical in C and OCaml.
+
+   Each line gives the time per call in nanoseconds, the bytes allocated on
+   the OCaml heap per call, and, given the output of the C baselines in
+   microbench.c, the ratio of the OCaml time to the C time. The output is
+   in CSV format, or in JSON format with -json.
+ *)
+
+open Sundials
+
+let min_time = 0.05  (* seconds per batch of runs *)
+let trials = 5       (* batches, the best of which is kept *)
+let nv = 3           (* vectors in fused and array operations *)
+let max_dense = 1000 (* largest dense matrix *)
+let tf = 1.0         (* end of the integrations *)
+
+(* The number of runs of [f] is doubled until they take [min_time], and
+   the best of [trials] batches is kept. Each run of [f] returns the number
+   of calls that it stands for. Returns the seconds and bytes per call. *)
+let time_per_call f =
+  let rec calibrate reps =
+    let t0 = Unix.gettimeofday () in
+    for _i = 1 to reps do ignore (f ()) done;
+    let t = Unix.gettimeofday () -. t0 in
+    if t >= min_time then reps, t /. float reps else calibrate (2 * reps)
+  in
+  let reps, t = calibrate 1 in
+  let best = ref t and bytes = ref 0.0 in
+  for _i = 2 to trials do
+    let a0 = Gc.allocated_bytes () in
+    let t0 = Unix.gettimeofday () in
+    for _j = 1 to reps do ignore (f ()) done;
+    let t = (Unix.gettimeofday () -. t0) /. float reps in
+    bytes := (Gc.allocated_bytes () -. a0) /. float reps;
+    if t < !best then best := t
+  done;
+  let calls = float (max 1 (f ())) in
+  !best /. calls, !bytes /. calls
+
+type result = {
+  family : string;
+  name : string;
+  n : int;
+  ns : float;
+  bytes : float;
+}
+
+let results = ref []
+
+let run family n benches =
+  List.iter (fun (name, f) ->
+      try
+        let t, bytes = time_per_call f in
+        results := { family; name; n; ns = 1.0e9 *. t; bytes } :: !results;
+        Printf.eprintf "%s %s %d\n%!" family name n
+      with Config.NotImplementedBySundialsVersion -> ())
+    benches
+
+let call f = fun () -> ignore (f ()); 1
+
+(* Serial nvector operations *)
+
+let nvector_serial n =
+  let open Nvector_serial in
+  let mk a b m =
+    let v = make n 0.0 in
+    let d = unwrap v in
+    for i = 0 to n - 1 do d.{i} <- a +. b *. float (i mod m) done;
+    v
+  in
+  let x = mk 1.0 0.1 7 and y = mk 2.0 (-0.1) 5 and z = mk 0.0 0.0 1
+  and w = mk 1.0e-2 0.0 1 and id = mk 0.0 1.0 2 and c = mk 0.0 1.0 3
+  and m = make n 0.0 in
+  let xs = Array.init nv (fun _ -> Ops.clone x)
+  and ys = Array.init nv (fun _ -> Ops.clone y)
+  and zs = Array.init nv (fun _ -> make n 0.0) in
+  let yss = Array.make nv ys and zss = Array.make nv zs in
+  let a = RealArray.init nv (fun j -> 1.0 /. float (j + 1))
+  and r = RealArray.make nv 0.0 in
+  let open Ops in
+  run "nvector_serial" n [
+    "linearsum",    call (fun () -> linearsum 1.0 x 2.0 y z);
+    "const",        call (fun () -> const 1.0 z);
+    "prod",         call (fun () -> prod x y z);
+    "div",          call (fun () -> div x y z);
+    "scale",        call (fun () -> scale 2.0 x z);
+    "abs",          call (fun () -> abs x z);
+    "inv",          call (fun () -> inv x z);
+    "addconst",     call (fun () -> addconst x 1.0 z);
+    "dotprod",      call (fun () -> dotprod x y);
+    "maxnorm",      call (fun () -> maxnorm x);
+    "wrmsnorm",     call (fun () -> wrmsnorm x w);
+    "wrmsnormmask", call (fun () -> wrmsnormmask x w id);
+    "min",          call (fun () -> min x);
+    "wl2norm",      call (fun () -> wl2norm x w);
+    "l1norm",       call (fun () -> l1norm x);
+    "compare",      call (fun () -> compare 1.2 x z);
+    "invtest",      call (fun () -> invtest x z);
+    "constrmask",   call (fun () -> constrmask c x m);
+    "minquotient",  call (fun () -> minquotient x y);
+    "linearcombination", call (fun () -> linearcombination a xs z);
+    "scaleaddmulti",     call (fun () -> scaleaddmulti a x ys zs);
+    "dotprodmulti",      call (fun () -> dotprodmulti x ys r);
+    "linearsumvectorarray",
+      call (fun () -> linearsumvectorarray 1.0 xs 2.0 ys zs);
+    "scalevectorarray",
+      call (fun () -> scalevectorarray a xs zs);
+    "constvectorarray",
+      call (fun () -> constvectorarray 1.0 zs);
+    "wrmsnormvectorarray",
+      call (fun () -> wrmsnormvectorarray xs ys r);
+    "wrmsnormmaskvectorarray",
+      call (fun () -> wrmsnormmaskvectorarray xs ys id r);
+    "scaleaddmultivectorarray",
+      call (fun () -> scaleaddmultivectorarray a xs yss zss);
+    "linearcombinationvectorarray",
+      call (fun () -> linearcombinationvectorarray a yss zs);
+  ]
+
+(* Generic operations on custom nvectors: C calls back into OCaml *)
+
+let nvector_custom n =
+  let x = Nvector_array.make n 1.5 and y = Nvector_array.make n 2.0
+  and z = Nvector_array.make n 0.0 and w = Nvector_array.make n 1.0e-2 in
+  let open Nvector.Ops in
+  run "nvector_custom" n [
+    "linearsum", call (fun () -> linearsum 1.0 x 2.0 y z);
+    "const",     call (fun () -> const 1.0 z);
+    "scale",     call (fun () -> scale 2.0 x z);
+    "dotprod",   call (fun () -> dotprod x y);
+    "maxnorm",   call (fun () -> maxnorm x);
+    "wrmsnorm",  call (fun () -> wrmsnorm x w);
+  ]
+
+(* Matrix operations *)
+
+let matrix n =
+  let bw = if n > 1 then 1 else 0 in
+  let x = RealArray.make n 1.0 and y = RealArray.make n 0.0 in
+  let band = Matrix.Band.make { Matrix.Band.n; mu = bw; smu = bw; ml = bw } 1.0 in
+  let sparse = Matrix.Sparse.from_band Matrix.Sparse.CSC 0.0 band in
+  if n <= max_dense then begin
+    let dense = Matrix.Dense.make n n 1.0 in
+    run "matrix" n [
+      "dense_matvec",     call (fun () -> Matrix.Dense.matvec dense x y);
+      "dense_scale_addi", call (fun () -> Matrix.Dense.scale_addi 0.5 dense);
+    ]
+  end;
+  run "matrix" n [
+    "band_matvec",       call (fun () -> Matrix.Band.matvec band x y);
+    "band_scale_addi",   call (fun () -> Matrix.Band.scale_addi 0.5 band);
+    "sparse_matvec",     call (fun () -> Matrix.Sparse.matvec sparse x y);
+    "sparse_scale_addi", call (fun () -> Matrix.Sparse.scale_addi 0.5 sparse);
+  ]
+
+(* Callbacks from an integrator *)
+
+let decay _ y yd =
+  for i = 0 to RealArray.length y - 1 do yd.{i} <- -. y.{i} done
+
+let integrate s y count () =
+  Nvector_serial.Ops.const 1.0 y;
+  Cvode.reinit s 0.0 y;
+  ignore (Cvode.solve_normal s tf y);
+  count s
+
+let callbacks n =
+  let bw = if n > 1 then 1 else 0 in
+  let y = Nvector_serial.make n 1.0 in
+  let tol = Cvode.SStolerances (1.0e-6, 1.0e-8) in
+  let rhsfn () =
+    let s = Cvode.(init Adams tol
+                     ~nlsolver:(NonlinearSolver.FixedPoint.make y)
+                     decay 0.0 y)
+    in
+    integrate s y Cvode.get_num_rhs_evals
+  in
+  let jacfn () =
+    let jac _ m = for i = 0 to n - 1 do Matrix.Band.set m i i (-1.0) done in
+    let s = Cvode.(init BDF tol
+                     ~lsolver:Dls.(solver ~jac
+                                     (LinearSolver.Direct.band y
+                                        (Matrix.band ~mu:bw ~ml:bw n)))
+                     decay 0.0 y)
+    in
+    Cvode.Spils.set_jac_eval_frequency s 1;
+    (try Cvode.Spils.set_lsetup_frequency s 1
+     with Config.NotImplementedBySundialsVersion -> ());
+    integrate s y Cvode.Dls.get_num_jac_evals
+  in
+  let precsolvefn () =
+    let psolve _ { Cvode.Spils.rhs; _ } z = RealArray.blit ~src:rhs ~dst:z in
+    let s = Cvode.(init BDF tol
+                     ~lsolver:Spils.(solver (LinearSolver.Iterative.spgmr y)
+                                            (prec_left psolve))
+                     decay 0.0 y)
+    in
+    integrate s y Cvode.Spils.get_num_prec_solves
+  in
+  run "callbacks" n [
+    "rhsfn",       rhsfn ();
+    "jacfn",       jacfn ();
+    "precsolvefn", precsolvefn ();
+  ]
+
+(* Output *)
+
+let split s =
+  let rec go i j acc =
+    if j = String.length s then List.rev (String.sub s i (j - i) :: acc)
+    else if s.[j] = ',' then go (j + 1) (j + 1) (String.sub s i (j - i) :: acc)
+    else go i (j + 1) acc
+  in
+  go 0 0 []
+
+(* Reads the lines family,name,n,c_ns printed by microbench.exe. *)
+let read_baseline file =
+  let tbl = Hashtbl.create 128 in
+  let ic = open_in file in
+  (try
+     while true do
+       match split (input_line ic) with
+       | [family; name; n; ns] when family <> "family" ->
+           Hashtbl.replace tbl (family, name, int_of_string n)
+                                (float_of_string ns)
+       | _ -> ()
+     done
+   with End_of_file -> ());
+  close_in ic;
+  tbl
+
+let baseline tbl { family; name; n; _ } =
+  try Some (Hashtbl.find tbl (family, name, n)) with Not_found -> None
+
+let print_csv tbl rs =
+  print_string "family,name,n,ocaml_ns,c_ns,ratio,bytes_per_call\n";
+  List.iter (fun r ->
+      let c, ratio = match baseline tbl r with
+        | Some c -> Printf.sprintf "%.2f" c, Printf.sprintf "%.3f" (r.ns /. c)
+        | None -> "", ""
+      in
+      Printf.printf "%s,%s,%d,%.2f,%s,%s,%.1f\n"
+        r.family r.name r.n r.ns c ratio r.bytes)
+    rs
+
+let print_json tbl rs =
+  print_string "[";
+  List.iteri (fun i r ->
+      let c, ratio = match baseline tbl r with
+        | Some c -> Printf.sprintf "%.2f" c, Printf.sprintf "%.3f" (r.ns /. c)
+        | None -> "null", "null"
+      in
+      Printf.printf
+        "%s\n  {\"family\": \"%s\", \"name\": \"%s\", \"n\": %d, \
+         \"ocaml_ns\": %.2f, \"c_ns\": %s, \"ratio\": %s, \
+         \"bytes_per_call\": %.1f}"
+        (if i = 0 then "" else ",") r.family r.name r.n r.ns c ratio r.bytes)
+    rs;
+  print_string "\n]\n"
+
+let () =
+  let baseline_file = ref None and json = ref false and sizes = ref [] in
+  Arg.parse [
+      "-baseline", Arg.String (fun f -> baseline_file := Some f),
+        "file  C timings printed by microbench.exe";
+      "-json", Arg.Set json, " print JSON rather than CSV";
+    ]
+    (fun n -> sizes := int_of_string n :: !sizes)
+    "microbench.opt [-baseline file] [-json] [n1 n2 ...]";
+  let sizes = if !sizes = [] then [1; 100; 10000] else List.rev !sizes in
+  List.iter (fun n ->
+      nvector_serial n;
+      nvector_custom n;
+      matrix n;
+      callbacks n)
+    sizes;
+  let tbl = match !baseline_file with
+    | None -> Hashtbl.create 1
+    | Some f -> read_baseline f
+  in
+  (if !json then print_json else print_csv) tbl (List.rev !results)
@@ -0,0 +1,222 @@
+(* Compile with:
+    ocamlc -o binary_file.byte -I +sundials -dllpath +sundials \
+              sundials.cma binary_file.ml
+
+   Save arrays and dense, band, and sparse matrices with
+   Sundials.BinaryFile and load them back, check that subarrays of a
+   loaded array remain valid after the array itself is collected, and
+   that corrupted files are rejected. Then import small MatrixMarket
+   files with each supported field and symmetry, and check that
+   malformed ones are rejected.
+ *)
+
+open Sundials
+open Bigarray
+
+let printf = Printf.printf
+
+let file = Filename.temp_file "binary_file" ".bin"
+let mtx = Filename.temp_file "binary_file" ".mtx"
+
+let check name ok = printf "%s: %s\n" name (if ok then "ok" else "NO")
+
+let rejected f =
+  match f () with
+  | exception BinaryFile.InvalidFile _ -> true
+  | _ -> false
+
+let read_file path =
+  let ic = open_in_bin path in
+  let s = really_input_string ic (in_channel_length ic) in
+  close_in ic;
+  Bytes.of_string s
+
+let write_file path b =
+  let oc = open_out_bin path in
+  output_bytes oc b;
+  close_out oc
+
+(* Adds x to the byte at pos *)
+let patch pos x =
+  let b = read_file file in
+  Bytes.set b pos (Char.chr ((Char.code (Bytes.get b pos) + x) land 0xff));
+  write_file file b
+
+(* Row-major contents of a sparse matrix, and whether the row (CSC) or
+   column (CSR) indices are sorted within each column or row *)
+let contents a =
+  let m, n = Matrix.Sparse.size a in
+  let csc = Matrix.Sparse.is_csc a in
+  let vals, ptrs, data = Matrix.Sparse.unwrap a in
+  let r = Array.make_matrix m n 0.0 and sorted = ref true in
+  for j = 0 to (if csc then n else m) - 1 do
+    for p = Index.to_int ptrs.{j} to Index.to_int ptrs.{j + 1} - 1 do
+      let i = Index.to_int vals.{p} in
+      if p > Index.to_int ptrs.{j} && Index.to_int vals.{p - 1} > i
+        then sorted := false;
+      if csc then r.(i).(j) <- r.(i).(j) +. data.{p}
+      else r.(j).(i) <- r.(j).(i) +. data.{p}
+    done
+  done;
+  r, !sorted
+
+let dense_contents a =
+  let m, n = Matrix.Dense.size a in
+  Array.init m (fun i -> Array.init n (fun j -> Matrix.Dense.get a i j))
+
+(* Round trips *)
+
+let realarray () =
+  let a = RealArray.init 1000 (fun i -> float i *. 0.5) in
+  BinaryFile.save_realarray file a;
+  let b = BinaryFile.load_realarray file in
+  check "realarray" (b = a);
+  (* the subarray must keep the mapping alive *)
+  let s = Array1.sub b 500 10 in
+  Gc.full_major ();
+  Gc.full_major ();
+  check "subarray after collection" (s = Array1.sub a 500 10)
+
+let realarray2 () =
+  let a = RealArray2.make 7 5 0.0 in
+  for j = 0 to 4 do
+    for i = 0 to 6 do RealArray2.set a i j (float (10 * i + j)) done
+  done;
+  BinaryFile.save_realarray2 file a;
+  let col = RealArray2.col (BinaryFile.load_realarray2 file) 3 in
+  Gc.full_major ();
+  check "realarray2 column after collection" (col = RealArray2.col a 3)
+
+let arrayband () =
+  let a = Matrix.ArrayBand.make (3, 1, 2) 6 0.0 in
+  for i = 0 to 5 do
+    for j = max 0 (i - 2) to min 5 (i + 1) do
+      Matrix.ArrayBand.set a i j (float (i - j) +. 0.25)
+    done
+  done;
+  BinaryFile.save_arrayband file a;
+  let b = BinaryFile.load_arrayband file in
+  check "arrayband"
+    (Matrix.ArrayBand.dims b = Matrix.ArrayBand.dims a
+     && Matrix.ArrayBand.unwrap b = Matrix.ArrayBand.unwrap a)
+
+let dense () =
+  let a = Matrix.Dense.create 4 6 in
+  for i = 0 to 3 do
+    for j = 0 to 5 do Matrix.Dense.set a i j (float (i * j) -. 2.0) done
+  done;
+  BinaryFile.save_dense file a;
+  check "dense" (dense_contents (BinaryFile.load_dense file) = dense_contents a)
+
+let band () =
+  let a = Matrix.Band.create Matrix.Band.({ n = 6; mu = 1; smu = 3; ml = 2 }) in
+  Matrix.Band.set_to_zero a;
+  for i = 0 to 5 do
+    for j = max 0 (i - 2) to min 5 (i + 1) do
+      Matrix.Band.set a i j (float (i + j) +. 0.5)
+    done
+  done;
+  BinaryFile.save_band file a;
+  let b = BinaryFile.load_band file in
+  let get a = Array.init 6 (fun i -> Array.init 6 (fun j ->
+                if j - i > 1 || i - j > 2 then 0.0 else Matrix.Band.get a i j))
+  in
+  check "band" (Matrix.Band.dims b = Matrix.Band.dims a && get b = get a)
+
+(* A 5x4 matrix with some zero columns and rows *)
+let sparse_source () =
+  let d = Matrix.Dense.make 5 4 0.0 in
+  List.iter (fun (i, j, x) -> Matrix.Dense.set d i j x)
+    [ (0, 0, 1.0); (2, 0, -2.0); (4, 0, 3.0); (1, 2, 4.0);
+      (3, 2, 5.0); (4, 3, -6.0); (0, 3, 7.0) ];
+  d
+
+let sparse () =
+  let d = sparse_source () in
+  let csc = Matrix.Sparse.from_dense Matrix.Sparse.CSC 0.0 d in
+  BinaryFile.save_sparse file csc;
+  check "sparse (CSC)"
+    (fst (contents (BinaryFile.load_sparse Matrix.Sparse.CSC file))
+     = dense_contents d);
+  check "wrong format rejected"
+    (rejected (fun () -> BinaryFile.load_sparse Matrix.Sparse.CSR file));
+  (* the data section starts after the header and two aligned index
+     sections, at 128 + 64 + 64 here *)
+  patch (128 + 128 + 3) 1;
+  check "checksum mismatch rejected"
+    (rejected (fun () -> BinaryFile.load_sparse Matrix.Sparse.CSC file));
+  check "unverified load accepted"
+    (not (rejected (fun () ->
+            BinaryFile.load_sparse ~verify:false Matrix.Sparse.CSC file)));
+  (* a pointer beyond the number of nonzeros (the first byte of ptrs.{1}
+     in either byte order) *)
+  BinaryFile.save_sparse file csc;
+  let isize = Char.code (Bytes.get (read_file file) 20) in
+  patch (128 + isize + (if Sys.big_endian then isize - 1 else 0)) 100;
+  check "bad index pointers rejected"
+    (rejected (fun () ->
+       BinaryFile.load_sparse ~verify:false Matrix.Sparse.CSC file));
+  (* a row index beyond the number of rows (in vals.{0}) *)
+  BinaryFile.save_sparse file csc;
+  patch (128 + 64 + (if Sys.big_endian then isize - 1 else 0)) 5;
+  check "bad index values rejected"
+    (rejected (fun () ->
+       BinaryFile.load_sparse ~verify:false Matrix.Sparse.CSC file));
+  let csr = Matrix.Sparse.from_dense Matrix.Sparse.CSR 0.0 d in
+  BinaryFile.save_sparse file csr;
+  check "sparse (CSR)"
+    (fst (contents (BinaryFile.load_sparse Matrix.Sparse.CSR file))
+     = dense_contents d)
+
+(* MatrixMarket import *)
+
+let import text =
+  write_file mtx (Bytes.of_string text);
+  BinaryFile.import_matrix_market Matrix.Sparse.CSC mtx,
+  BinaryFile.import_matrix_market Matrix.Sparse.CSR mtx
+
+let check_import name text expected =
+  let csc, csr = import text in
+  let c, csorted = contents csc and r, rsorted = contents csr in
+  check name (c = expected && r = expected && csorted && rsorted)
+
+let matrix_market () =
+  check_import "general"
+    "%%MatrixMarket matrix coordinate real general\n\
+     % entries out of order\n\
+     5 4 7\n\
+     4 3 5.0\n1 1 1.0\n5 4 -6\n3 1 -2.0\n\
+     1 4 7e0\n2 3 4.0\n5 1 3.0\n"
+    (dense_contents (sparse_source ()));
+  check_import "symmetric"
+    "%%MatrixMarket matrix coordinate real symmetric\n\
+     3 3 4\n1 1 2.0\n2 1 -1.0\n3 2 -1.0\n3 3 2.0\n"
+    [| [| 2.0; -1.0; 0.0 |]; [| -1.0; 0.0; -1.0 |]; [| 0.0; -1.0; 2.0 |] |];
+  check_import "skew-symmetric"
+    "%%MatrixMarket matrix coordinate integer skew-symmetric\n\
+     3 3 2\n2 1 3\n3 1 -4\n"
+    [| [| 0.0; -3.0; 4.0 |]; [| 3.0; 0.0; 0.0 |]; [| -4.0; 0.0; 0.0 |] |];
+  check_import "pattern"
+    "%%MatrixMarket matrix coordinate pattern general\n\
+     2 3 3\n1 3\n2 1\n2 2\n"
+    [| [| 0.0; 0.0; 1.0 |]; [| 1.0; 1.0; 0.0 |] |];
+  let bad text = rejected (fun () -> ignore (import text)) in
+  check "array format rejected"
+    (bad "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n");
+  check "complex field rejected"
+    (bad "%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1 0\n");
+  check "out-of-range entry rejected"
+    (bad "%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1.0\n");
+  check "missing entry rejected"
+    (bad "%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1.0\n")
+
+let () =
+  realarray ();
+  realarray2 ();
+  arrayband ();
+  dense ();
+  band ();
+  sparse ();
+  matrix_market ();
+  Sys.remove file;
+  Sys.remove mtx
@@ -0,0 +1,95 @@
+(* Compile with:
+    ocamlc -o bratu_continuation.byte -I +sundials -dllpath +sundials \
+              sundials.cma bratu_continuation.ml
+
+   Run with:
+    ./bratu_continuation.byte [points]
+
+   Solve the discretized one-dimensional Bratu problem
+     u'' + lambda exp(u) = 0,  u(0) = u(1) = 0,
+   first for a sweep of values of lambda below the turning point,
+   independently and with Kinsol.Continuation.sweep, comparing the
+   numbers of Newton iterations, and then follow the branch of solutions
+   around the turning point (lambda near 3.51) with
+   Kinsol.Continuation.arclength.
+ *)
+
+open Sundials
+
+let printf = Printf.printf
+
+let n = 50
+let dx = 1.0 /. float (n + 1)
+
+let bratu lambda u f =
+  for i = 0 to n - 1 do
+    let ul = if i = 0 then 0.0 else u.{i - 1}
+    and ur = if i = n - 1 then 0.0 else u.{i + 1} in
+    f.{i} <- (ul -. 2.0 *. u.{i} +. ur) /. (dx *. dx)
+             +. lambda *. exp u.{i}
+  done
+
+let make u =
+  let m = Matrix.dense n in
+  Kinsol.(init ~lsolver:Dls.(solver (dense u m)) (bratu 0.0) u)
+
+let max_u u = Array.fold_left max 0.0 (RealArray.to_array (Nvector.unwrap u))
+
+let () =
+  let points = if Array.length Sys.argv > 1
+               then int_of_string Sys.argv.(1) else 1000 in
+  let params = Array.init points (fun i -> 3.4 *. float i /. float points) in
+  let u = Nvector_serial.make n 0.0 in
+  let ones = Nvector_serial.make n 1.0 in
+
+  (* every point from the zero guess, with a new Jacobian *)
+  let s = make u in
+  let iters = ref 0 in
+  Array.iter (fun lambda ->
+      Nvector.Ops.const 0.0 u;
+      Kinsol.set_sys_func s (bratu lambda);
+      ignore (Kinsol.(solve s u LineSearch ones ones));
+      iters := !iters + Kinsol.get_num_nonlin_solv_iters s) params;
+  printf "independent solves: %6.2f iterations per point\n"
+    (float !iters /. float points);
+
+  (* a continuation sweep *)
+  let s = make u in
+  Nvector.Ops.const 0.0 u;
+  let st = Kinsol.Continuation.(sweep ~strategy:Kinsol.LineSearch
+                                  s bratu ones ones u params (fun _ _ -> ()))
+  in
+  printf "continuation sweep: %6.2f iterations per point \
+          (%d solves, %d rejected)\n"
+    (float st.Kinsol.Continuation.num_nonlin_iters /. float points)
+    st.Kinsol.Continuation.num_solves st.Kinsol.Continuation.num_rejected;
+
+  (* a repeated value, then a jump close to the turning point, which is
+     reached through intermediate points *)
+  let s = make u in
+  Nvector.Ops.const 0.0 u;
+  let st = Kinsol.Continuation.(sweep ~strategy:Kinsol.LineSearch
+                                  s bratu ones ones u [| 0.0; 0.0; 3.3 |]
+                                  (fun _ _ -> ()))
+  in
+  printf "jump to lambda = 3.3: %d solves, %d rejected, max u = %.4f\n"
+    st.Kinsol.Continuation.num_solves st.Kinsol.Continuation.num_rejected
+    (max_u u);
+
+  (* around the turning point and back down to lambda = 1 *)
+  let s = make u in
+  Nvector.Ops.const 0.0 u;
+  let lambda_max = ref 0.0 and lambda_last = ref 0.0 in
+  let st = Kinsol.Continuation.arclength s bratu ones ones u 0.0 0.1
+             (fun lambda _ ->
+                lambda_max := max !lambda_max lambda;
+                lambda_last := lambda;
+                lambda > 1.0 || lambda >= !lambda_max)
+  in
+  printf "arclength: %d points, %.2f iterations per point\n"
+    st.Kinsol.Continuation.num_points
+    (float st.Kinsol.Continuation.num_nonlin_iters
+     /. float st.Kinsol.Continuation.num_points);
+  printf "  turning point near lambda = %.4f\n" !lambda_max;
+  printf "  upper branch at lambda = %.4f: max u = %.4f\n"
+    !lambda_last (max_u u)
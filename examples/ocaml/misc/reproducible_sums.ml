@@ -0,0 +1,63 @@
+(* Compile with:
+    ocamlfind ocamlopt -package sundialsml.openmp,sundialsml.pthreads,unix \
+                       -linkpkg -o reproducible_sums.opt reproducible_sums.ml
+
+   Compare the Sundials reductions of OpenMP and Pthreads nvectors with the
+   reproducible ones (Nvector_openmp.set_reproducible and
+   Nvector_pthreads.set_reproducible) for several numbers of threads: time
+   per call, and whether the results depend on the number of threads.
+ *)
+
+open Sundials
+
+let printf = Printf.printf
+
+let threads = [1; 2; 4; 8]
+let reps = 200
+
+let time f =
+  let t0 = Unix.gettimeofday () in
+  for _i = 1 to reps do ignore (f ()) done;
+  (Unix.gettimeofday () -. t0) /. float reps
+
+module type NVECTOR = sig
+  type t
+  val wrap : ?context:Context.t -> ?with_fused_ops:bool -> int
+             -> RealArray.t -> t
+  val set_reproducible : t -> bool -> unit
+  module Ops : Nvector.NVECTOR_OPS with type t = t
+end
+
+module Bench (V : NVECTOR) = struct
+  let run name x w =
+    List.iter (fun repro ->
+      let label = Printf.sprintf "%s %s" name
+                    (if repro then "reproducible" else "sundials") in
+      let results = List.map (fun nt ->
+          let xv = V.wrap nt x and wv = V.wrap nt w in
+          V.set_reproducible xv repro;
+          let open V.Ops in
+          let r = (dotprod xv wv, wrmsnorm xv wv, l1norm xv) in
+          let t = time (fun () -> dotprod xv wv)
+                  +. time (fun () -> wrmsnorm xv wv)
+                  +. time (fun () -> l1norm xv) in
+          printf "  %-22s %d threads %10.2f us\n%!" label nt (1.0e6 *. t);
+          r) threads
+      in
+      let same = List.for_all (fun r -> r = List.hd results) results in
+      printf "  %-22s results %s across thread counts\n"
+        label (if same then "identical" else "differ")) [false; true]
+end
+
+module OpenMP = Bench (Nvector_openmp)
+module Pthreads = Bench (Nvector_pthreads)
+
+let bench n =
+  let x = RealArray.init n (fun i -> sin (0.37 *. float i) /. float (1 + i mod 17))
+  and w = RealArray.init n (fun i -> 1.0 /. (1.0 +. float (i mod 5))) in
+  printf "n = %d\n" n;
+  OpenMP.run "openmp" x w;
+  Pthreads.run "pthreads" x w
+
+let () =
+  List.iter bench [10_000; 100_000; 1_000_000; 10_000_000]
@@ -0,0 +1,60 @@
+(* Compile with:
+    ocamlc -o revolve_adjoint.byte -I +sundials -dllpath +sundials \
+              sundials.cma revolve_adjoint.ml
+
+   Compute the gradient with respect to the initial conditions of
+   G = w . y(T) for a linear ODE over a long horizon split into many
+   segments, with a binomial checkpointing schedule for several numbers
+   of snapshots, and show the recomputation ratio of each.
+ *)
+
+open Sundials
+module Adj = Cvodes.Adjoint
+
+let printf = Printf.printf
+
+let neq = 2
+let tf = 20.0
+let nsegments = 200
+let a = [| [| -0.1; 0.5 |]; [| -0.5; -0.1 |] |]
+let w = [| 1.0; 2.0 |]
+
+let f _ y yd =
+  for i = 0 to neq - 1 do
+    yd.{i} <- a.(i).(0) *. y.{0} +. a.(i).(1) *. y.{1}
+  done
+
+(* lambda' = -A^T lambda *)
+let fb { Adj.yb; _ } ybd =
+  for i = 0 to neq - 1 do
+    ybd.{i} <- -. (a.(0).(i) *. yb.{0} +. a.(1).(i) *. yb.{1})
+  done
+
+let times = Array.init (nsegments + 1)
+              (fun i -> tf *. float i /. float nsegments)
+
+let gradient budget =
+  let y0 = Nvector_serial.make neq 1.0 in
+  let s = Cvode.(init BDF (SStolerances (1.0e-8, 1.0e-10))
+                   ~lsolver:Dls.(solver (dense y0 (Matrix.dense neq)))
+                   f 0.0 (Nvector.clone y0)) in
+  Adj.init s 20 Adj.IHermite;
+  let yb = Nvector_serial.wrap (RealArray.of_array w) in
+  let init t =
+    let bs = Adj.(init_backward s Cvode.BDF (SStolerances (1.0e-8, 1.0e-10))
+                    ~lsolver:Dls.(solver (dense yb (Matrix.dense neq)))
+                    (NoSens fb) t yb) in
+    [ { Adj.rev_bsession = bs; Adj.rev_yb = yb; Adj.rev_yqb = None } ]
+  in
+  let stats = Adj.backward_revolve s budget times y0 init in
+  RealArray.to_array (Nvector.unwrap yb), stats
+
+let () =
+  List.iter (fun n ->
+      let g, st = gradient (Adj.Snapshots n) in
+      printf "%3d snapshots: dG/dy0 = (%.6f, %.6f)  %4d advances, \
+              %6d/%5d steps, recomputation ratio %.2f\n"
+        st.Adj.num_snapshots g.(0) g.(1) st.Adj.num_advances
+        st.Adj.num_forward_steps st.Adj.num_taped_steps
+        st.Adj.recomputation_ratio)
+    [1; 2; 4; 8; 16; nsegments]
@@ -0,0 +1,82 @@
+(* Compile with:
+    ocamlc -o session_pool.byte -I +sundials -dllpath +sundials \
+              unix.cma sundials.cma session_pool.ml
+
+   Run with:
+    ./session_pool.byte [requests]
+
+   Answer a sequence of small requests, each the integration of a linear
+   oscillator with a different damping, once with a new session per
+   request and once with sessions from a Cvode.Pool, and show the median
+   and 99th percentile latencies.
+ *)
+
+open Sundials
+
+let printf = Printf.printf
+
+let n = 10
+let tf = 5.0
+
+(* n independent oscillators x'' = -x - c x' with c = damping *)
+let rhs damping _ y yd =
+  for i = 0 to n / 2 - 1 do
+    let x = y.{2 * i} and v = y.{2 * i + 1} in
+    yd.{2 * i} <- v;
+    yd.{2 * i + 1} <- -. x -. damping *. float (i + 1) *. v
+  done
+
+(* The key describes the structure of the problem; here only its size *)
+let make damping key t0 y0 =
+  let m = Matrix.dense key in
+  let s = Cvode.(init BDF (SStolerances (1.0e-6, 1.0e-8))
+                   ~lsolver:Dls.(solver (dense y0 m))
+                   (rhs damping) t0 y0) in
+  Cvode.set_max_num_steps s 5000;
+  s
+
+let y0 = Nvector_serial.make n 1.0
+let y = Nvector_serial.make n 0.0
+
+let fresh damping =
+  let s = make damping n 0.0 y0 in
+  ignore (Cvode.solve_normal s tf y)
+
+let pool = Cvode.Pool.create (make 0.0)
+
+let pooled damping =
+  Cvode.Pool.with_session pool n ~rhsfn:(rhs damping) 0.0 y0
+    (fun s -> ignore (Cvode.solve_normal s tf y))
+
+let latencies requests f =
+  let ts = Array.make requests 0.0 in
+  for r = 0 to requests - 1 do
+    let damping = 0.1 +. float (r mod 10) *. 0.05 in
+    let t0 = Unix.gettimeofday () in
+    f damping;
+    ts.(r) <- Unix.gettimeofday () -. t0
+  done;
+  Array.sort compare ts;
+  let pct p = 1.0e6 *. ts.(min (requests - 1) (requests * p / 100)) in
+  pct 50, pct 99
+
+let () =
+  let requests =
+    if Array.length Sys.argv > 1 then int_of_string Sys.argv.(1) else 5000
+  in
+  let show name (p50, p99) =
+    printf "  %-8s p50 %8.1f us  p99 %8.1f us\n%!" name p50 p99
+  in
+  printf "%d requests\n" requests;
+  show "fresh" (latencies requests fresh);
+  show "pooled" (latencies requests pooled);
+  let st = Cvode.Pool.get_stats pool in
+  printf "pool: %d created, %d reused\n"
+    st.Cvode.Pool.num_created st.Cvode.Pool.num_reused;
+  (* a session cannot be released twice *)
+  let s = Cvode.Pool.acquire pool n 0.0 y0 in
+  Cvode.Pool.release pool n s;
+  printf "double release: %s\n"
+    (match Cvode.Pool.release pool n s with
+     | () -> "NOT DETECTED"
+     | exception Invalid_argument _ -> "rejected")
@@ -0,0 +1,87 @@
+(* Run with:
+    mpirun -np 32 ./hierarchical_reductions.opt
+
+   Time the reductions of parallel nvectors with flat MPI_Allreduce calls
+   and with node-aware reductions (Nvector_parallel.init_hierarchical),
+   for several local lengths, and check that both give the same results.
+   On a single host, all ranks share one node, so the node-aware
+   reductions never send a message. Finally, check that an mpiplusx
+   nvector, which keeps a duplicate of the communicator, also reduces
+   through the node reducer.
+ *)
+
+open Sundials
+
+let printf = Printf.printf
+
+let comm = Mpi.comm_world
+let npes = Mpi.comm_size comm
+let my_pe = Mpi.comm_rank comm
+
+let reps = 2000
+let nmulti = 8
+
+let time f =
+  Mpi.barrier comm;
+  let t0 = Mpi.wtime () in
+  for _i = 1 to reps do ignore (f ()) done;
+  let dt = Mpi.wtime () -. t0 in
+  (* the slowest rank determines the cost *)
+  Mpi.allreduce_float dt Mpi.Max comm *. 1e6 /. float reps
+
+let run nlocal =
+  let nglobal = npes * nlocal in
+  let x = Nvector_parallel.make ~with_fused_ops:true nlocal nglobal comm 0.0
+  and w = Nvector_parallel.make nlocal nglobal comm 1.0e-2 in
+  let xd = Nvector_parallel.local_array x in
+  for i = 0 to nlocal - 1 do
+    xd.{i} <- sin (float (my_pe * nlocal + i))
+  done;
+  let ys = Array.init nmulti (fun _ -> Nvector_parallel.clone x) in
+  let dp = RealArray.make nmulti 0.0 in
+  let open Nvector_parallel.Ops in
+  let ops = [
+      "dotprod",      (fun () -> dotprod x x);
+      "wrmsnorm",     (fun () -> wrmsnorm x w);
+      "maxnorm",      (fun () -> maxnorm x);
+      "min",          (fun () -> min x);
+      "dotprodmulti", (fun () -> dotprodmulti x ys dp; dp.{nmulti - 1});
+    ]
+  in
+  List.iter (fun (name, f) ->
+      Nvector_parallel.set_hierarchical x false;
+      let flat = time f and rflat = f () in
+      Nvector_parallel.set_hierarchical x true;
+      let node = time f and rnode = f () in
+      let same = abs_float (rflat -. rnode) <= 1e-12 *. abs_float rflat in
+      if my_pe = 0 then
+        printf "%9d  %-13s %9.2f %9.2f %7.2fx  %s\n"
+          nlocal name flat node (flat /. node)
+          (if same then "same" else "DIFFERENT"))
+    ops
+
+let check_mpiplusx () =
+  let nlocal = 100 in
+  let x = Nvector_mpiplusx.wrap comm (Nvector_serial.Any.make nlocal 1.0) in
+  Nvector_mpiplusx.set_hierarchical x true;
+  let before = Nvector_parallel.num_hierarchical_reductions comm in
+  let d = Nvector_mpiplusx.Ops.dotprod x x in
+  let after = Nvector_parallel.num_hierarchical_reductions comm in
+  if my_pe = 0 then begin
+    printf "\nmpiplusx dotprod: %s\n"
+      (if d = float (npes * nlocal) then "ok" else "WRONG");
+    printf "mpiplusx through the node reducer: %s\n"
+      (if after > before then "ok" else "NO")
+  end
+
+let () =
+  let node_size, num_nodes = Nvector_parallel.init_hierarchical comm in
+  if my_pe = 0 then begin
+    printf "%d ranks, %d node(s), %d rank(s) on node 0\n\n"
+      npes num_nodes node_size;
+    printf "%9s  %-13s %9s %9s %8s\n"
+      "local n" "operation" "flat(us)" "node(us)" "speedup"
+  end;
+  List.iter run [10; 1000; 100000];
+  check_mpiplusx ();
+  Nvector_parallel.free_hierarchical comm
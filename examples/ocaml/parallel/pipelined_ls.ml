@@ -0,0 +1,89 @@
+(* Run with:
+    mpirun -np 4 ./pipelined_ls.byte
+
+   Solve a distributed one-dimensional diffusion-reaction system with
+   KINSOL, once with the standard and once with the pipelined Krylov
+   solvers, and compare the number of linear iterations and global
+   reductions.
+ *)
+
+open Sundials
+
+let printf = Printf.printf
+
+let comm = Mpi.comm_world
+let npes = Mpi.comm_size comm
+let my_pe = Mpi.comm_rank comm
+
+let nlocal = 2000
+let nglobal = npes * nlocal
+
+(* z = A v with A = tridiag(-1, d_i, -c) distributed by blocks *)
+let atimes c (v, _, _) (z, _, _) =
+  if my_pe > 0 then Mpi.send_float v.{0} (my_pe - 1) 0 comm;
+  if my_pe < npes - 1 then Mpi.send_float v.{nlocal - 1} (my_pe + 1) 0 comm;
+  let vl = if my_pe > 0 then Mpi.receive_float (my_pe - 1) 0 comm else 0.0 in
+  let vr =
+    if my_pe < npes - 1 then Mpi.receive_float (my_pe + 1) 0 comm else 0.0
+  in
+  for i = 0 to nlocal - 1 do
+    let gi = my_pe * nlocal + i in
+    let left = if i = 0 then vl else v.{i - 1}
+    and right = if i = nlocal - 1 then vr else v.{i + 1} in
+    let d = 2.05 +. 0.5 *. sin (float gi) in
+    z.{i} <- d *. v.{i} -. left -. c *. right
+  done
+
+(* F(u) = A u - 1, so that KINSOL's inexact Newton iteration only exercises
+   the linear solver. *)
+let func c u ((f, _, _) as fv) =
+  atimes c u fv;
+  for i = 0 to nlocal - 1 do
+    f.{i} <- f.{i} -. 1.0
+  done
+
+let jac_times_vec c v jv _ _ = atimes c v jv; false
+
+let make_nv x = Nvector_parallel.make nlocal nglobal comm x
+
+let run name ls c =
+  let u = make_nv 0.0 and scale = make_nv 1.0 in
+  let kmem = Kinsol.(init ~lsolver:Spils.(solver ~jac_times_vec:(jac_times_vec c)
+                                                 ls prec_none)
+                       (func c) u) in
+  Kinsol.set_func_norm_tol kmem 1.0e-9;
+  ignore (Kinsol.solve kmem u Kinsol.Newton scale scale);
+  let r = make_nv 0.0 in
+  func c (Nvector.unwrap u) (Nvector.unwrap r);
+  let (r, _, _) = Nvector.unwrap r in
+  let local = ref 0.0 in
+  for i = 0 to nlocal - 1 do
+    local := !local +. r.{i} *. r.{i}
+  done;
+  let res = sqrt (Mpi.allreduce_float !local Mpi.Sum comm) in
+  if my_pe = 0 then
+    printf "%-16s linear iters = %4d  residual %s\n" name
+      (Kinsol.Spils.get_num_lin_iters kmem)
+      (if res < 1.0e-6 then "ok" else Printf.sprintf "TOO LARGE (%g)" res);
+  ls
+
+let () =
+  let tmpl = make_nv 0.0 in
+
+  ignore (run "pcg" (LinearSolver.Iterative.pcg ~maxl:500 tmpl) 1.0);
+  let ls = run "pipelined pcg"
+             (LinearSolver.Iterative.pipelined_pcg ~maxl:500 tmpl) 1.0 in
+  let st = LinearSolver.Iterative.Pipelined.get_stats ls in
+  if my_pe = 0 then
+    printf "  reductions = %d, overlapped = %b\n"
+      st.LinearSolver.Iterative.Pipelined.num_reductions
+      st.LinearSolver.Iterative.Pipelined.overlapped;
+
+  ignore (run "spgmr"
+            (LinearSolver.Iterative.spgmr ~maxl:30 ~max_restarts:20 tmpl) 1.3);
+  let ls = run "pipelined gmres"
+             (LinearSolver.Iterative.pipelined_gmres
+                ~maxl:30 ~max_restarts:20 tmpl) 1.3 in
+  if my_pe = 0 then
+    printf "  reductions = %d\n"
+      (LinearSolver.Iterative.Pipelined.get_num_reductions ls)
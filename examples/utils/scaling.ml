@@ -0,0 +1,294 @@
+let synopsis =
+  {|scaling [options] <example> ...
+
+     Run parallel examples under mpirun for several numbers of processes
+     and print strong and weak scaling tables.  Each <example> should be
+     an executable that reads its process grid and subgrid sizes from the
+     NPEX, NPEY, MXSUB, and MYSUB environment variables and appends its
+     phase times to the file named by SCALING_LOG, like
+     cvode/parallel/cvDiurnal_kry_p, cvode/parallel/cvDiurnal_kry_bbd_p,
+     ida/parallel/idaHeat2D_kry_bbd_p, and
+     kinsol/parallel/kinFoodWeb_kry_bbd_p.
+
+     For np processes, the process grid is NPEX x NPEY = np with NPEY the
+     largest divisor of np not above its square root.  Strong scaling keeps
+     the global mesh (about <grid> x <grid> points) fixed, weak scaling
+     keeps the subgrid of each process (<sub> x <sub> points) fixed.
+
+     The phases are the user function (rhs, the right-hand side, residual,
+     or system function), the user functions of the preconditioner
+     (precfn, the setup function or the local function of the BBD
+     preconditioner), and the rest (krylov, mostly Krylov iterations,
+     preconditioner factorizations, and preconditioner solves); see
+     utils/scaling_log.ml.
+     With -pmpi, the examples are run through misc/pmpi_counters_wrapper
+     (which loads the library given by PMPI_COUNTERS_LIB) and the tables
+     also give the number of MPI_Allreduce calls and the time spent in
+     them, the number and volume of point-to-point messages, and the time
+     spent waiting for them.
+
+     Efficiencies are relative to the smallest number of processes p0:
+     T(p0) p0 / (T(p) p) for strong scaling and T(p0) / T(p) for weak
+     scaling.
+
+Options:|}
+
+let mpirun = ref (try Sys.getenv "MPIRUN" with Not_found -> "mpirun")
+let nps = ref [1; 2; 4]
+let grid = ref 40
+let sub = ref 10
+let strong = ref false
+let weak = ref false
+let pmpi = ref None
+let runs = ref 1
+let csv = ref false
+let examples = ref []
+
+(* Helpers *)
+
+let split c s =
+  let rec go i j acc =
+    if j = String.length s then List.rev (String.sub s i (j - i) :: acc)
+    else if s.[j] = c then go (j + 1) (j + 1) (String.sub s i (j - i) :: acc)
+    else go i (j + 1) acc
+  in
+  go 0 0 []
+
+let read_lines file =
+  let ic = open_in file in
+  let rec go acc =
+    match input_line ic with
+    | l -> go (l :: acc)
+    | exception End_of_file -> close_in ic; List.rev acc
+  in
+  go []
+
+let with_temp_file f =
+  let tmpfile = Filename.temp_file "sundials-scaling." ".csv" in
+  match f tmpfile with
+  | r -> Sys.remove tmpfile; r
+  | exception e -> Sys.remove tmpfile; raise e
+
+let example_name ex =
+  let b = Filename.basename ex in
+  try Filename.chop_extension b with Invalid_argument _ -> b
+
+(* The process grid: npex x npey = np with npey <= npex as close as
+   possible. *)
+let process_grid np =
+  let rec go d = if np mod d = 0 then d else go (d - 1) in
+  let npey = go (max 1 (int_of_float (sqrt (float np)))) in
+  np / npey, npey
+
+(* Running an example *)
+
+type comm = {
+  allreduce_calls : float;
+  allreduce_time  : float;
+  p2p_msgs        : float;
+  p2p_bytes       : float;
+  wait_time       : float;
+}
+
+type row = {
+  np    : int;
+  npex  : int;
+  npey  : int;
+  mx    : int;
+  my    : int;
+  total : float;
+  rhs   : float;
+  precfn : float;
+  krylov: float;
+  comm  : comm option;
+}
+
+(* Sum the per-function lines label,np,function,calls,bytes,seconds
+   written by pmpi_counters.c. *)
+let read_comm file =
+  let c = ref { allreduce_calls = 0.0; allreduce_time = 0.0;
+                p2p_msgs = 0.0; p2p_bytes = 0.0; wait_time = 0.0 } in
+  List.iter (fun l ->
+      match split ',' l with
+      | [_; _; fn; calls; bytes; secs] ->
+          let calls = float_of_string calls
+          and bytes = float_of_string bytes
+          and secs = float_of_string secs
+          and r = !c in
+          (match fn with
+           | "MPI_Allreduce" | "MPI_Iallreduce" ->
+               c := { r with allreduce_calls = r.allreduce_calls +. calls;
+                             allreduce_time = r.allreduce_time +. secs }
+           | "MPI_Send" | "MPI_Isend" ->
+               c := { r with p2p_msgs = r.p2p_msgs +. calls;
+                             p2p_bytes = r.p2p_bytes +. bytes }
+           | "MPI_Sendrecv" ->
+               c := { r with p2p_msgs = r.p2p_msgs +. calls;
+                             p2p_bytes = r.p2p_bytes +. bytes;
+                             wait_time = r.wait_time +. secs }
+           | "MPI_Recv" | "MPI_Wait" | "MPI_Waitall" | "MPI_Waitany"
+           | "MPI_Testall" ->
+               c := { r with wait_time = r.wait_time +. secs }
+           | _ -> ())
+      | _ -> failwith ("Bad line in PMPI counters: " ^ l))
+    (read_lines file);
+  !c
+
+let run_once ex np (mxsub, mysub) =
+  let npex, npey = process_grid np in
+  with_temp_file (fun log ->
+  with_temp_file (fun counters ->
+    let vars = ["NPEX", string_of_int npex;
+                "NPEY", string_of_int npey;
+                "MXSUB", string_of_int mxsub;
+                "MYSUB", string_of_int mysub;
+                "NUM_REPS", "1";
+                "SCALING_LOG", log;
+                "PMPI_COUNTERS", counters;
+                "PMPI_LABEL", example_name ex] in
+    let env =
+      let ours s = List.exists (fun (v, _) ->
+                       let n = String.length v in
+                       String.length s > n && String.sub s 0 (n + 1) = v ^ "=")
+                     vars
+      in
+      Array.append
+        (Array.of_list (List.map (fun (v, x) -> v ^ "=" ^ x) vars))
+        (Array.of_list (List.filter (fun s -> not (ours s))
+                          (Array.to_list (Unix.environment ()))))
+    in
+    let cmd = String.concat " " (
+        [!mpirun; "-np"; string_of_int np]
+        @ (match !pmpi with None -> [] | Some w -> [Filename.quote w])
+        @ [Filename.quote ex])
+    in
+    let dev_null = Unix.openfile "/dev/null" [Unix.O_RDWR] 0 in
+    let pid = Unix.create_process_env "/bin/sh" [| "/bin/sh"; "-c"; cmd |]
+                env dev_null dev_null Unix.stderr in
+    Unix.close dev_null;
+    (match Unix.waitpid [] pid with
+     | _, Unix.WEXITED 0 -> ()
+     | _ -> failwith ("Command failed: " ^ cmd));
+    match List.rev (read_lines log) with
+    | l :: _ ->
+        (match split ',' l with
+         | [_; _; mx; my; total; rhs; precfn; krylov] ->
+             { np; npex; npey;
+               mx = int_of_string mx; my = int_of_string my;
+               total = float_of_string total;
+               rhs = float_of_string rhs;
+               precfn = float_of_string precfn;
+               krylov = float_of_string krylov;
+               comm = (match !pmpi with
+                       | None -> None
+                       | Some _ -> Some (read_comm counters)) }
+         | _ -> failwith ("Bad line in scaling log: " ^ l))
+    | [] -> failwith ("No scaling log from: " ^ cmd)))
+
+(* The fastest of several runs. *)
+let run ex np sizes =
+  let rec go best i =
+    if i = 0 then best
+    else
+      let r = run_once ex np sizes in
+      go (if r.total < best.total then r else best) (i - 1)
+  in
+  go (run_once ex np sizes) (!runs - 1)
+
+(* Output *)
+
+let efficiency mode r0 r =
+  if mode = "strong"
+  then r0.total *. float r0.np /. (r.total *. float r.np)
+  else r0.total /. r.total
+
+let print_csv_header () =
+  print_string "example,mode,np,npex,npey,mx,my,total,rhs,precfn,krylov,\
+                allreduce_calls,allreduce_s,p2p_msgs,p2p_bytes,wait_s,\
+                efficiency\n"
+
+let print_csv name mode rows =
+  let r0 = List.hd rows in
+  List.iter (fun r ->
+      Printf.printf "%s,%s,%d,%d,%d,%d,%d,%.6f,%.6f,%.6f,%.6f,"
+        name mode r.np r.npex r.npey r.mx r.my r.total r.rhs r.precfn r.krylov;
+      (match r.comm with
+       | None -> print_string ",,,,,"
+       | Some c -> Printf.printf "%.0f,%.6f,%.0f,%.0f,%.6f,"
+                     c.allreduce_calls c.allreduce_time
+                     c.p2p_msgs c.p2p_bytes c.wait_time);
+      Printf.printf "%.3f\n%!" (efficiency mode r0 r))
+    rows
+
+let print_table name mode rows =
+  let r0 = List.hd rows in
+  Printf.printf "\n%s: %s scaling\n\n" name mode;
+  Printf.printf "%4s %9s %11s %9s %9s %9s %9s"
+    "np" "procs" "mesh" "total[s]" "rhs[s]" "precfn[s]" "krylov[s]";
+  if !pmpi <> None then
+    Printf.printf " %9s %9s %9s %9s %9s"
+      "allreduce" "allred[s]" "msgs" "MB" "wait[s]";
+  print_string "   eff\n";
+  List.iter (fun r ->
+      Printf.printf "%4d %9s %11s %9.3f %9.3f %9.3f %9.3f"
+        r.np (Printf.sprintf "%dx%d" r.npex r.npey)
+        (Printf.sprintf "%dx%d" r.mx r.my)
+        r.total r.rhs r.precfn r.krylov;
+      (match r.comm with
+       | None -> ()
+       | Some c -> Printf.printf " %9.0f %9.3f %9.0f %9.2f %9.3f"
+                     c.allreduce_calls c.allreduce_time
+                     c.p2p_msgs (c.p2p_bytes /. 1.0e6) c.wait_time);
+      Printf.printf " %5.2f\n%!" (efficiency mode r0 r))
+    rows
+
+(* Parse args. *)
+
+let read_nps s =
+  try
+    let l = List.map int_of_string (split ',' s) in
+    if List.exists (fun n -> n <= 0) l then failwith "";
+    List.sort compare l
+  with Failure _ ->
+    raise (Arg.Bad ("expected positive integers separated by commas but got "
+                    ^ s))
+
+let args = [
+      "-np", Arg.String (fun s -> nps := read_nps s),
+        "<n1,n2,...> numbers of processes (default 1,2,4)";
+      "-strong", Arg.Set strong, " strong scaling (default: both)";
+      "-weak", Arg.Set weak, " weak scaling (default: both)";
+      "-grid", Arg.Set_int grid,
+        "<n> global mesh points in x and y for strong scaling (default 40)";
+      "-sub", Arg.Set_int sub,
+        "<n> mesh points per process in x and y for weak scaling \
+         (default 10)";
+      "-mpirun", Arg.Set_string mpirun,
+        "<cmd> command to launch MPI programs (default $MPIRUN or mpirun)";
+      "-pmpi", Arg.String (fun w -> pmpi := Some w),
+        "<wrapper> count MPI calls through misc/pmpi_counters_wrapper";
+      "-runs", Arg.Set_int runs, "<n> keep the fastest of n runs (default 1)";
+      "-csv", Arg.Set csv, " print CSV rather than tables";
+    ]
+
+let _ =
+  Arg.parse args (fun ex -> examples := ex :: !examples) synopsis;
+  if !examples = [] then (Arg.usage args synopsis; exit 0);
+  let modes =
+    (if !strong || not !weak then ["strong"] else [])
+    @ (if !weak || not !strong then ["weak"] else [])
+  in
+  if !csv then print_csv_header ();
+  List.iter (fun ex ->
+      List.iter (fun mode ->
+          let sizes np =
+            if mode = "weak" then !sub, !sub
+            else
+              let npex, npey = process_grid np in
+              max 1 (!grid / npex), max 1 (!grid / npey)
+          in
+          let rows = List.map (fun np -> run ex np (sizes np)) !nps in
+          (if !csv then print_csv else print_table)
+            (example_name ex) mode rows)
+        modes)
+    (List.rev !examples)
@@ -0,0 +1,64 @@
+(* Phase timing for the scaling studies of utils/scaling.ml, shared by the
+   parallel examples that take part in them (copied into their directories
+   and linked through EXTRA_DEPS).
+
+   The process grid and the subgrids of an example can be resized through
+   the environment variables NPEX, NPEY, MXSUB, and MYSUB (see env_int),
+   and, if SCALING_LOG names a file, the time spent in each phase is
+   appended to it (see log).  The phases are the user function (rhs: the
+   right-hand side, residual, or system function), the user functions of
+   the preconditioner (precfn: the setup function, or the local function
+   of a BBD preconditioner, but not the factorization done by the BBD
+   module itself), and the rest (krylov). *)
+
+let env_int v default =
+  try int_of_string (Unix.getenv v) with Not_found | Failure _ -> default
+
+let file = try Some (Unix.getenv "SCALING_LOG") with Not_found -> None
+
+let rhs_time = ref 0.0
+let precfn_time = ref 0.0
+let start = ref 0.0
+
+let reset () =
+  start := Unix.gettimeofday ();
+  rhs_time := 0.0;
+  precfn_time := 0.0
+
+(* Adds the time taken by f () to t, but only when logging, so as not to
+   perturb the timings of the regression tests. *)
+let timed t f =
+  match file with
+  | None -> f ()
+  | Some _ ->
+      let t0 = Unix.gettimeofday () in
+      let stop () = t := !t +. (Unix.gettimeofday () -. t0) in
+      match f () with
+      | r -> stop (); r
+      | exception e -> stop (); raise e
+
+let rhs f = timed rhs_time f
+let precfn f = timed precfn_time f
+
+(* Append name,np,mx,my,total,rhs,precfn,krylov to the SCALING_LOG file,
+   where total is the time since reset.  Each time is the maximum over the
+   processes, and krylov is the time spent outside the user functions
+   (Krylov iterations, preconditioner factorizations and solves, and
+   solver overhead). *)
+let log name comm mx my =
+  match file with
+  | None -> ()
+  | Some file ->
+      let total = Unix.gettimeofday () -. !start in
+      let t = [| total; !rhs_time; !precfn_time;
+                 total -. !rhs_time -. !precfn_time |]
+      and tmax = Array.make 4 0.0 in
+      Mpi.reduce_float_array t tmax Mpi.Max 0 comm;
+      if Mpi.comm_rank comm = 0 then begin
+        let oc =
+          open_out_gen [Open_wronly; Open_append; Open_creat] 0o644 file
+        in
+        Printf.fprintf oc "%s,%d,%d,%d,%.6f,%.6f,%.6f,%.6f\n"
+          name (Mpi.comm_size comm) mx my tmax.(0) tmax.(1) tmax.(2) tmax.(3);
+        close_out oc
+      end
@@ -0,0 +1,239 @@
+/*
+ * Counts the calls, bytes, and time spent in MPI functions through the
+ * PMPI profiling interface. Build it as a shared library,
+ *
+ *   mpicc -shared -fPIC -o libpmpi_counters.so pmpi_counters.c
+ *
+ * and preload it into each process, e.g., with pmpi_counters_wrapper:
+ *
+ *   mpirun -np 4 misc/pmpi_counters_wrapper ./cvDiurnal_kry_bbd_p.opt
+ *
+ * At MPI_Finalize, the counters of all processes are combined on rank 0:
+ * calls and bytes are summed and times are maximized. If the environment
+ * variable PMPI_COUNTERS names a file, one line
+ *
+ *   label,np,function,calls,bytes,seconds
+ *
+ * is appended to it for each function that was called, where label is
+ * the value of PMPI_LABEL (or the empty string). Otherwise a table is
+ * printed on stderr.
+ *
+ * Bytes are counted on the sending side for point-to-point functions and
+ * as the size of the contribution of each process for collectives. The
+ * time of a nonblocking function (MPI_Isend, MPI_Irecv, MPI_Iallreduce)
+ * only covers posting it; waiting for its completion is counted in
+ * MPI_Wait, MPI_Waitall, MPI_Waitany, or MPI_Testall.
+ */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if MPI_VERSION >= 3
+#define MPI_CONST const
+#else
+#define MPI_CONST
+#endif
+
+enum counter {
+    C_SEND = 0,
+    C_ISEND,
+    C_RECV,
+    C_IRECV,
+    C_SENDRECV,
+    C_WAIT,
+    C_WAITALL,
+    C_WAITANY,
+    C_TESTALL,
+    C_ALLREDUCE,
+    C_IALLREDUCE,
+    C_REDUCE,
+    C_BCAST,
+    C_BARRIER,
+    NUM_COUNTERS
+};
+
+static const char *counter_names[NUM_COUNTERS] = {
+    "MPI_Send",
+    "MPI_Isend",
+    "MPI_Recv",
+    "MPI_Irecv",
+    "MPI_Sendrecv",
+    "MPI_Wait",
+    "MPI_Waitall",
+    "MPI_Waitany",
+    "MPI_Testall",
+    "MPI_Allreduce",
+    "MPI_Iallreduce",
+    "MPI_Reduce",
+    "MPI_Bcast",
+    "MPI_Barrier",
+};
+
+static double calls[NUM_COUNTERS];
+static double bytes[NUM_COUNTERS];
+static double seconds[NUM_COUNTERS];
+
+static double message_bytes(int count, MPI_Datatype datatype)
+{
+    int size;
+
+    if (datatype == MPI_DATATYPE_NULL
+	    || PMPI_Type_size(datatype, &size) != MPI_SUCCESS)
+	return 0.0;
+    return (double)count * (double)size;
+}
+
+#define COUNT(c, nbytes, call)					\
+    do {							\
+	double t0 = PMPI_Wtime();				\
+	int r = (call);						\
+	seconds[c] += PMPI_Wtime() - t0;			\
+	calls[c] += 1.0;					\
+	bytes[c] += (nbytes);					\
+	return r;						\
+    } while (0)
+
+int MPI_Send(MPI_CONST void *buf, int count, MPI_Datatype datatype,
+	     int dest, int tag, MPI_Comm comm)
+{
+    COUNT(C_SEND, message_bytes(count, datatype),
+	  PMPI_Send(buf, count, datatype, dest, tag, comm));
+}
+
+int MPI_Isend(MPI_CONST void *buf, int count, MPI_Datatype datatype,
+	      int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    COUNT(C_ISEND, message_bytes(count, datatype),
+	  PMPI_Isend(buf, count, datatype, dest, tag, comm, request));
+}
+
+int MPI_Recv(void *buf, int count, MPI_Datatype datatype,
+	     int source, int tag, MPI_Comm comm, MPI_Status *status)
+{
+    COUNT(C_RECV, 0.0,
+	  PMPI_Recv(buf, count, datatype, source, tag, comm, status));
+}
+
+int MPI_Irecv(void *buf, int count, MPI_Datatype datatype,
+	      int source, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    COUNT(C_IRECV, 0.0,
+	  PMPI_Irecv(buf, count, datatype, source, tag, comm, request));
+}
+
+int MPI_Sendrecv(MPI_CONST void *sendbuf, int sendcount,
+		 MPI_Datatype sendtype, int dest, int sendtag,
+		 void *recvbuf, int recvcount, MPI_Datatype recvtype,
+		 int source, int recvtag, MPI_Comm comm, MPI_Status *status)
+{
+    COUNT(C_SENDRECV, message_bytes(sendcount, sendtype),
+	  PMPI_Sendrecv(sendbuf, sendcount, sendtype, dest, sendtag,
+			recvbuf, recvcount, recvtype, source, recvtag,
+			comm, status));
+}
+
+int MPI_Wait(MPI_Request *request, MPI_Status *status)
+{
+    COUNT(C_WAIT, 0.0, PMPI_Wait(request, status));
+}
+
+int MPI_Waitall(int count, MPI_Request requests[], MPI_Status statuses[])
+{
+    COUNT(C_WAITALL, 0.0, PMPI_Waitall(count, requests, statuses));
+}
+
+int MPI_Waitany(int count, MPI_Request requests[], int *index,
+		MPI_Status *status)
+{
+    COUNT(C_WAITANY, 0.0, PMPI_Waitany(count, requests, index, status));
+}
+
+int MPI_Testall(int count, MPI_Request requests[], int *flag,
+		MPI_Status statuses[])
+{
+    COUNT(C_TESTALL, 0.0, PMPI_Testall(count, requests, flag, statuses));
+}
+
+int MPI_Allreduce(MPI_CONST void *sendbuf, void *recvbuf, int count,
+		  MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
+{
+    COUNT(C_ALLREDUCE, message_bytes(count, datatype),
+	  PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm));
+}
+
+#if MPI_VERSION >= 3
+int MPI_Iallreduce(const void *sendbuf, void *recvbuf, int count,
+		   MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+		   MPI_Request *request)
+{
+    COUNT(C_IALLREDUCE, message_bytes(count, datatype),
+	  PMPI_Iallreduce(sendbuf, recvbuf, count, datatype, op, comm,
+			  request));
+}
+#endif
+
+int MPI_Reduce(MPI_CONST void *sendbuf, void *recvbuf, int count,
+	       MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
+{
+    COUNT(C_REDUCE, message_bytes(count, datatype),
+	  PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm));
+}
+
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype,
+	      int root, MPI_Comm comm)
+{
+    COUNT(C_BCAST, message_bytes(count, datatype),
+	  PMPI_Bcast(buffer, count, datatype, root, comm));
+}
+
+int MPI_Barrier(MPI_Comm comm)
+{
+    COUNT(C_BARRIER, 0.0, PMPI_Barrier(comm));
+}
+
+int MPI_Finalize(void)
+{
+    double sum_calls[NUM_COUNTERS], sum_bytes[NUM_COUNTERS],
+	   max_seconds[NUM_COUNTERS];
+    int rank, np, i;
+
+    PMPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    PMPI_Comm_size(MPI_COMM_WORLD, &np);
+    PMPI_Reduce(calls, sum_calls, NUM_COUNTERS, MPI_DOUBLE, MPI_SUM,
+		0, MPI_COMM_WORLD);
+    PMPI_Reduce(bytes, sum_bytes, NUM_COUNTERS, MPI_DOUBLE, MPI_SUM,
+		0, MPI_COMM_WORLD);
+    PMPI_Reduce(seconds, max_seconds, NUM_COUNTERS, MPI_DOUBLE, MPI_MAX,
+		0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+	const char *file = getenv("PMPI_COUNTERS");
+	const char *label = getenv("PMPI_LABEL");
+	FILE *out = NULL;
+
+	if (label == NULL) label = "";
+	if (file != NULL) {
+	    out = fopen(file, "a");
+	    if (out == NULL) perror(file);
+	}
+
+	if (out == NULL)
+	    fprintf(stderr, "%-14s %12s %16s %12s\n",
+		    "function", "calls", "bytes", "seconds");
+	for (i = 0; i < NUM_COUNTERS; ++i) {
+	    if (sum_calls[i] == 0.0) continue;
+	    if (out != NULL)
+		fprintf(out, "%s,%d,%s,%.0f,%.0f,%.6f\n", label, np,
+			counter_names[i], sum_calls[i], sum_bytes[i],
+			max_seconds[i]);
+	    else
+		fprintf(stderr, "%-14s %12.0f %16.0f %12.6f\n",
+			counter_names[i], sum_calls[i], sum_bytes[i],
+			max_seconds[i]);
+	}
+	if (out != NULL) fclose(out);
+    }
+
+    return PMPI_Finalize();
+}
@@ -459,6 +459,95 @@ module ButcherTable = struct (* {{{ *)
     if Sundials_configuration.safe then (check b1; check b2);
     c_check_ark_order outfile b1 b2
 
+  (* Parallel-stage methods {{{ *)
+
+  type pdirk_base =
+    | Radau_IIA_2_3
+    | Radau_IIA_3_5
+
+  (* Radau IIA coefficients (c, A, b = last row of A, order), and the
+     diagonals D for which I - D^{-1} A is nilpotent, so that the stiff
+     error components vanish after [stages] iterations. *)
+  let pdirk_coefficients = function
+    | Radau_IIA_2_3 ->
+        [| 1.0 /. 3.0; 1.0 |],
+        [| [| 5.0 /. 12.0; -1.0 /. 12.0 |];
+           [| 3.0 /. 4.0;   1.0 /. 4.0  |] |],
+        [| 0.25841837620280367; 0.6449489742783178 |],
+        3
+    | Radau_IIA_3_5 ->
+        let r6 = sqrt 6.0 in
+        [| (4.0 -. r6) /. 10.0; (4.0 +. r6) /. 10.0; 1.0 |],
+        [| [| (88.0 -. 7.0 *. r6) /. 360.0;
+              (296.0 -. 169.0 *. r6) /. 1800.0;
+              (-2.0 +. 3.0 *. r6) /. 225.0 |];
+           [| (296.0 +. 169.0 *. r6) /. 1800.0;
+              (88.0 +. 7.0 *. r6) /. 360.0;
+              (-2.0 -. 3.0 *. r6) /. 225.0 |];
+           [| (16.0 -. r6) /. 36.0;
+              (16.0 +. r6) /. 36.0;
+              1.0 /. 9.0 |] |],
+        [| 0.10404994025001671; 0.3328127454285066; 0.4812901402100925 |],
+        5
+
+  (* The iterations Y^j - h D f(Y^j) = y_n + h (A - D) f(Y^(j-1)), from
+     Y^0 = y_n, unrolled into a table whose first stage is explicit and
+     whose stages j*s + 1, ..., j*s + s are the s stages of iteration j. *)
+  let pdirk ?iterations base =
+    let c, a, d, order = pdirk_coefficients base in
+    let s = Array.length c in
+    let m = match iterations with Some m -> m | None -> order - 1 in
+    if m < 1 then invalid_arg "pdirk: iterations must be positive";
+    let stages = 1 + s * m in
+    let stage_values = RealArray2.make stages stages 0.0 in
+    let av = RealArray2.unwrap stage_values in
+    let stage = 1 + (m - 1) * s in
+    for j = 1 to m do
+      for i = 0 to s - 1 do
+        let r = 1 + (j - 1) * s + i in
+        av.{r, r} <- d.(i);
+        if j = 1 then av.{r, 0} <- c.(i) -. d.(i)
+        else
+          for k = 0 to s - 1 do
+            av.{r, 1 + (j - 2) * s + k} <-
+              a.(i).(k) -. (if i = k then d.(i) else 0.0)
+          done
+      done
+    done;
+    let coefficients = RealArray.make stages 0.0 in
+    let bembed = RealArray.make stages 0.0 in
+    for k = 0 to s - 1 do
+      coefficients.{stage + k} <- a.(s - 1).(k);
+      if m > 1 then bembed.{stage - s + k} <- a.(s - 1).(k)
+    done;
+    if m = 1 then bembed.{0} <- 1.0;
+    {
+      method_order = min order (m + 1);
+      stages;
+      stage_values;
+      stage_times = RealArray.init stages
+                      (fun r -> if r = 0 then 0.0 else c.((r - 1) mod s));
+      coefficients;
+      embedding = Some (min order m, bembed);
+    }
+
+  let stage_groups bt =
+    if Sundials_configuration.safe then check bt;
+    let av = RealArray2.unwrap bt.stage_values in
+    let level = Array.make bt.stages 0 in
+    for i = 1 to bt.stages - 1 do
+      for j = 0 to i - 1 do
+        if av.{i, j} <> 0.0 then level.(i) <- max level.(i) (level.(j) + 1)
+      done
+    done;
+    let groups = Array.make (Array.fold_left max 0 level + 1) [] in
+    for i = bt.stages - 1 downto 0 do
+      groups.(level.(i)) <- i :: groups.(level.(i))
+    done;
+    Array.to_list groups
+
+  (* }}} *)
+
 end (* }}} *)
 
 module ARKStep = struct (* {{{ *)
@@ -659,10 +748,22 @@ module ARKStep = struct (* {{{ *)
           session.ls_callbacks <- DlsDenseCallback (cb, ls)
       | LSI.LapackDense ->
           session.ls_callbacks <- DlsDenseCallback (cb, ls)
+      | LSI.MixedDense ->
+          session.ls_callbacks <- DlsDenseCallback (cb, ls)
       | LSI.Band ->
           session.ls_callbacks <- DlsBandCallback (cb, ls)
       | LSI.LapackBand ->
           session.ls_callbacks <- DlsBandCallback (cb, ls)
+      | LSI.MixedBand ->
+          session.ls_callbacks <- DlsBandCallback (cb, ls)
+      | LSI.SpikeBand ->
+          session.ls_callbacks <- DlsBandCallback (cb, ls)
+      | LSI.SparseLu ->
+          if jac = None then invalid_arg "SparseLu requires Jacobian function";
+          session.ls_callbacks <- DirectCustomCallback (cb, ls)
+      | LSI.ReorderedBand ->
+          if jac = None then invalid_arg "Reordered requires Jacobian function";
+          session.ls_callbacks <- DirectCustomCallback (cb, ls)
       | LSI.Klu _ ->
           if jac = None then invalid_arg "Klu requires Jacobian function";
           session.ls_callbacks <- SlsKluCallback (cb, ls)
@@ -1175,12 +1276,27 @@ let matrix_embedded_solver (LSI.LS ({ LSI.rawptr; _ } as hls) as ls) session _ =
         | LSI.LapackDense ->
             session.mass_callbacks <-
               DlsDenseMassCallback (cb, Matrix.unwrap mat)
+        | LSI.MixedDense ->
+            session.mass_callbacks <-
+              DlsDenseMassCallback (cb, Matrix.unwrap mat)
         | LSI.Band ->
             session.mass_callbacks <-
               DlsBandMassCallback (cb, Matrix.unwrap mat)
         | LSI.LapackBand ->
             session.mass_callbacks <-
               DlsBandMassCallback (cb, Matrix.unwrap mat)
+        | LSI.MixedBand ->
+            session.mass_callbacks <-
+              DlsBandMassCallback (cb, Matrix.unwrap mat)
+        | LSI.SpikeBand ->
+            session.mass_callbacks <-
+              DlsBandMassCallback (cb, Matrix.unwrap mat)
+        | LSI.SparseLu ->
+            session.mass_callbacks <-
+              DirectCustomMassCallback (cb, Matrix.unwrap mat)
+        | LSI.ReorderedBand ->
+            session.mass_callbacks <-
+              DirectCustomMassCallback (cb, Matrix.unwrap mat)
         | LSI.Klu _ ->
             session.mass_callbacks <-
               SlsKluMassCallback (cb, Matrix.unwrap mat)
@@ -1211,10 +1327,34 @@ let matrix_embedded_solver (LSI.LS ({ LSI.rawptr; _ } as hls) as ls) session _ =
         | Some m -> m
         | None -> failwith "a direct linear solver is required"
 
-      let solver massfn time_dep
-                 (LSI.LS ({ LSI.rawptr; LSI.solver; LSI.matrix } as hls) as ls)
+      (* 5.0.0 <= Sundials *)
+      external c_cached_wrap
+        : ('m, 'nd, 'nk) LSI.cptr -> float -> bool -> Context.t
+          -> ('m, 'nd, 'nk) LSI.cptr
+        = "sunml_lsolver_cached_wrap"
+
+      (* 5.0.0 <= Sundials *)
+      external c_cached_num_factorizations : ('m, 'nd, 'nk) LSI.cptr -> int
+        = "sunml_lsolver_cached_num_factorizations"
+
+      let cached hls reuse_tol lumped =
+        if reuse_tol = None && not lumped then hls.LSI.rawptr, LSI.HLS hls
+        else begin
+          if Sundials_impl.Version.lt500
+            then raise Config.NotImplementedBySundialsVersion;
+          let tol = match reuse_tol with Some tol -> tol | None -> 0.0 in
+          (* the wrapper holds a global root on the wrapped solver, and
+             has its own tag so that it is not mistaken for it *)
+          let rawptr = c_cached_wrap hls.LSI.rawptr tol lumped
+                                     hls.LSI.context in
+          rawptr, LSI.HLS { hls with LSI.rawptr; LSI.solver = LSI.Cached }
+        end
+
+      let solver ?reuse_tol ?(lumped=false) massfn time_dep
+                 (LSI.LS ({ LSI.solver; LSI.matrix } as hls) as ls)
                  session _ =
         let matrix = assert_matrix matrix in
+        let rawptr, held = cached hls reuse_tol lumped in
         set_mass_callbacks massfn solver matrix session;
         if Sundials_impl.Version.in_compat_mode2 then make_compat solver matrix session
         else if Sundials_impl.Version.in_compat_mode2_3
@@ -1222,7 +1362,7 @@ let matrix_embedded_solver (LSI.LS ({ LSI.rawptr; _ } as hls) as ls) session _ =
         else (c_set_mass_linear_solver session rawptr (Some matrix) time_dep;
               c_set_mass_fn session);
         LSI.attach ls;
-        session.mass_solver <- LSI.HLS hls
+        session.mass_solver <- held
 
       external get_work_space : 'k serial_session -> int * int
           = "sunml_arkode_dls_get_mass_work_space"
@@ -1238,6 +1378,13 @@ let matrix_embedded_solver (LSI.LS ({ LSI.rawptr; _ } as hls) as ls) session _ =
         mass_check_direct s;
         c_get_num_mass_setups s
 
+      let get_num_factorizations s =
+        mass_check_direct s;
+        match s.mass_solver with
+        | LSI.HLS { LSI.rawptr; LSI.solver = LSI.Cached } ->
+            c_cached_num_factorizations rawptr
+        | _ -> c_get_num_mass_setups s
+
       external get_num_mult_setups : 'k serial_session -> int
         = "sunml_arkode_ark_get_num_mass_mult_setups"
 
@@ -2169,6 +2316,445 @@ let matrix_embedded_solver (LSI.LS ({ LSI.rawptr; _ } as hls) as ls) session _ =
 
   let write_session ?logfile session = c_print_mem session logfile
 
+  (* Concurrent stage solves {{{ *)
+
+  module ParallelStages = struct
+
+    type stage_pool = {
+        num_workers : int;
+        run : (int -> unit) -> unit;
+      }
+
+    let sequential_stage_pool = { num_workers = 1; run = fun job -> job 0 }
+
+    type jac_fn = float -> RealArray.t -> RealArray.t -> Matrix.Dense.t -> unit
+
+    (* The Newton iteration of a worker: the iteration matrix
+       I - gamma J of the stages that it last solved, its own linear
+       solver, and scratch vectors. *)
+    type worker = {
+        wrhs      : RealArray.t;
+        wres      : RealArray.t;
+        wdelta    : RealArray.t;
+        wytmp     : RealArray.t;
+        wftmp     : RealArray.t;
+        wres_nv   : Nvector_serial.t;
+        wdelta_nv : Nvector_serial.t;
+        wmat      : Nvector_serial.kind Matrix.dense;
+        wls       : (Matrix.Dense.t, Nvector_serial.kind, [`Dls])
+                      LinearSolver.serial_t;
+        mutable wgamma         : float;   (* nan when not factored *)
+        mutable wfailed        : bool;
+        mutable wnum_rhs_evals : int;
+        mutable wnum_setups    : int;
+        mutable wnum_iters     : int;
+      }
+
+    type session = {
+        table   : ButcherTable.t;
+        groups  : int array array;
+        n       : int;
+        pool    : stage_pool;
+        rhsfn   : RealArray.t rhsfn;
+        jacfn   : jac_fn option;
+        ewtfn   : RealArray.t -> RealArray.t -> unit;
+        y       : RealArray.t;
+        fy      : RealArray.t;
+        ewt     : RealArray.t;
+        ynew    : RealArray.t;
+        yerr    : RealArray.t;
+        stage_y : RealArray.t array;
+        stage_f : RealArray.t array;
+        jac     : Matrix.Dense.t;
+        workers : worker array;
+
+        mutable t       : float;
+        mutable current : bool;   (* fy, ewt, and jac are those at (t, y) *)
+        mutable h       : float;  (* the next step size, 0.0 if not chosen *)
+        mutable fixed   : bool;
+        mutable hmin    : float;
+        mutable hmax    : float;
+        mutable hlast   : float;
+        mutable max_num_steps    : int;
+        mutable max_nonlin_iters : int;
+        mutable nonlin_conv_coef : float;
+
+        mutable num_steps      : int;
+        mutable num_rhs_evals  : int;
+        mutable num_jac_evals  : int;
+        mutable num_conv_fails : int;
+        mutable num_err_fails  : int;
+      }
+
+    (* Step size control, as in the ARKODE defaults *)
+    let safety = 0.96
+    let growth = 20.0
+    let max_conv_fails = 10
+    let max_err_fails = 7
+
+    let wrms v ewt =
+      let n = RealArray.length v in
+      let s = ref 0.0 in
+      for i = 0 to n - 1 do
+        let x = v.{i} *. ewt.{i} in
+        s := !s +. x *. x
+      done;
+      sqrt (!s /. float n)
+
+    let ewt_fun = function
+      | SStolerances (rtol, atol) ->
+          if rtol < 0.0 || atol < 0.0
+            then invalid_arg "ParallelStages: negative tolerance";
+          (fun y ewt ->
+            for i = 0 to RealArray.length y - 1 do
+              let w = rtol *. abs_float y.{i} +. atol in
+              if w <= 0.0 then raise NonPositiveEwt;
+              ewt.{i} <- 1.0 /. w
+            done)
+      | SVtolerances (rtol, atol) ->
+          let atol = Nvector.unwrap atol in
+          if rtol < 0.0 then invalid_arg "ParallelStages: negative tolerance";
+          (fun y ewt ->
+            for i = 0 to RealArray.length y - 1 do
+              let w = rtol *. abs_float y.{i} +. atol.{i} in
+              if w <= 0.0 then raise NonPositiveEwt;
+              ewt.{i} <- 1.0 /. w
+            done)
+      | WFtolerances efun -> efun
+
+    let init ?context ?(pool=sequential_stage_pool) ?jac table tol f t0 y0 =
+      ButcherTable.check table;
+      let stages = table.ButcherTable.stages in
+      let av = RealArray2.unwrap table.ButcherTable.stage_values in
+      for i = 0 to stages - 1 do
+        for j = i + 1 to stages - 1 do
+          if av.{i, j} <> 0.0
+            then invalid_arg "ParallelStages.init: table is not diagonally \
+                              implicit"
+        done
+      done;
+      if pool.num_workers < 1
+        then invalid_arg "ParallelStages.init: num_workers must be positive";
+      let y0 = Nvector.unwrap y0 in
+      let n = RealArray.length y0 in
+      let make_worker _ =
+        let res = RealArray.create n and delta = RealArray.create n in
+        let res_nv = Nvector_serial.wrap ?context res
+        and delta_nv = Nvector_serial.wrap ?context delta in
+        let m = Matrix.dense ?context n in
+        let ls = LinearSolver.Direct.dense ?context delta_nv m in
+        LinearSolver.init ls;
+        {
+          wrhs = RealArray.create n;
+          wres = res;
+          wdelta = delta;
+          wytmp = RealArray.create n;
+          wftmp = RealArray.create n;
+          wres_nv = res_nv;
+          wdelta_nv = delta_nv;
+          wmat = m;
+          wls = ls;
+          wgamma = nan;
+          wfailed = false;
+          wnum_rhs_evals = 0;
+          wnum_setups = 0;
+          wnum_iters = 0;
+        }
+      in
+      {
+        table;
+        groups = Array.of_list (List.map Array.of_list
+                                  (ButcherTable.stage_groups table));
+        n;
+        pool;
+        rhsfn = f;
+        jacfn = jac;
+        ewtfn = ewt_fun tol;
+        y = RealArray.copy y0;
+        fy = RealArray.create n;
+        ewt = RealArray.create n;
+        ynew = RealArray.create n;
+        yerr = RealArray.create n;
+        stage_y = Array.init stages (fun _ -> RealArray.create n);
+        stage_f = Array.init stages (fun _ -> RealArray.create n);
+        jac = Matrix.Dense.create n n;
+        workers = Array.init pool.num_workers make_worker;
+
+        t = t0;
+        current = false;
+        h = 0.0;
+        fixed = false;
+        hmin = 0.0;
+        hmax = infinity;
+        hlast = 0.0;
+        max_num_steps = 500;
+        max_nonlin_iters = 3;
+        nonlin_conv_coef = 0.1;
+
+        num_steps = 0;
+        num_rhs_evals = 0;
+        num_jac_evals = 0;
+        num_conv_fails = 0;
+        num_err_fails = 0;
+      }
+
+    (* Difference quotients as in arkLsDenseDQJac; worker w computes the
+       columns j = w, w + num_workers, ... *)
+    let update_jacobian s h =
+      s.num_jac_evals <- s.num_jac_evals + 1;
+      match s.jacfn with
+      | Some jac -> jac s.t s.y s.fy s.jac
+      | None ->
+          let n = s.n and nw = Array.length s.workers in
+          let srur = sqrt Config.unit_roundoff in
+          let fnorm = wrms s.fy s.ewt in
+          let min_inc =
+            if fnorm <> 0.0
+            then 1000.0 *. abs_float h *. Config.unit_roundoff
+                   *. float n *. fnorm
+            else 1.0
+          in
+          s.pool.run (fun w ->
+            let wk = s.workers.(w) in
+            let ytmp = wk.wytmp and ftmp = wk.wftmp in
+            RealArray.blit ~src:s.y ~dst:ytmp;
+            let j = ref w in
+            while !j < n do
+              let yj = s.y.{!j} in
+              ytmp.{!j} <- yj +. max (srur *. abs_float yj)
+                                     (min_inc /. s.ewt.{!j});
+              let inc = ytmp.{!j} -. yj in
+              s.rhsfn s.t ytmp ftmp;
+              wk.wnum_rhs_evals <- wk.wnum_rhs_evals + 1;
+              ytmp.{!j} <- yj;
+              for i = 0 to n - 1 do
+                Matrix.Dense.set s.jac i !j ((ftmp.{i} -. s.fy.{i}) /. inc)
+              done;
+              j := !j + nw
+            done)
+
+    (* Solves for stage r of a step of size h from (t, y) on worker wk,
+       and returns false if the Newton iteration does not converge. *)
+    let solve_stage s wk h r =
+      let table = s.table in
+      let av = RealArray2.unwrap table.ButcherTable.stage_values in
+      let rhs = wk.wrhs and yr = s.stage_y.(r) and fr = s.stage_f.(r) in
+      let n = s.n in
+      RealArray.blit ~src:s.y ~dst:rhs;
+      let plain = ref true in
+      for j = 0 to r - 1 do
+        let a = av.{r, j} in
+        if a <> 0.0 then begin
+          let fj = s.stage_f.(j) and ha = h *. a in
+          plain := false;
+          for i = 0 to n - 1 do rhs.{i} <- rhs.{i} +. ha *. fj.{i} done
+        end
+      done;
+      let tr = s.t +. table.ButcherTable.stage_times.{r} *. h in
+      let gamma = h *. av.{r, r} in
+      let eval y f =
+        s.rhsfn tr y f;
+        wk.wnum_rhs_evals <- wk.wnum_rhs_evals + 1
+      in
+      RealArray.blit ~src:rhs ~dst:yr;
+      if gamma = 0.0 then begin
+        if !plain && tr = s.t then RealArray.blit ~src:s.fy ~dst:fr
+        else eval yr fr;
+        true
+      end else begin
+        if wk.wgamma <> gamma then begin
+          wk.wgamma <- nan;
+          let m = Matrix.unwrap wk.wmat in
+          Matrix.Dense.blit ~src:s.jac ~dst:m;
+          Matrix.Dense.scale_addi (-. gamma) m;
+          LinearSolver.setup wk.wls wk.wmat;
+          wk.wgamma <- gamma;
+          wk.wnum_setups <- wk.wnum_setups + 1
+        end;
+        (* simplified Newton iteration on yr - gamma f(tr, yr) = rhs, with
+           the convergence test of arkNls *)
+        let rec iterate k dnorm_prev crate =
+          if k >= s.max_nonlin_iters then false
+          else begin
+            eval yr fr;
+            for i = 0 to n - 1 do
+              wk.wres.{i} <- rhs.{i} +. gamma *. fr.{i} -. yr.{i}
+            done;
+            LinearSolver.solve wk.wls wk.wmat wk.wdelta_nv wk.wres_nv 0.0;
+            for i = 0 to n - 1 do yr.{i} <- yr.{i} +. wk.wdelta.{i} done;
+            wk.wnum_iters <- wk.wnum_iters + 1;
+            let dnorm = wrms wk.wdelta s.ewt in
+            let crate =
+              if k = 0 then crate else max (0.3 *. crate) (dnorm /. dnorm_prev)
+            in
+            if dnorm *. min 1.0 crate <= s.nonlin_conv_coef then true
+            else if k > 0 && dnorm > 2.3 *. dnorm_prev then false
+            else iterate (k + 1) dnorm crate
+          end
+        in
+        let ok = iterate 0 0.0 1.0 in
+        (* the stage derivative from the converged stage equation *)
+        if ok then
+          for i = 0 to n - 1 do fr.{i} <- (yr.{i} -. rhs.{i}) /. gamma done;
+        ok
+      end
+
+    (* Computes the stages, group by group, and the solution of a step of
+       size h into ynew. Returns the weighted norm of the error estimate,
+       or infinity if a stage could not be solved. *)
+    let attempt s h =
+      if not s.current then begin
+        s.rhsfn s.t s.y s.fy;
+        s.num_rhs_evals <- s.num_rhs_evals + 1;
+        s.ewtfn s.y s.ewt;
+        update_jacobian s h;
+        Array.iter (fun wk -> wk.wgamma <- nan) s.workers;
+        s.current <- true
+      end;
+      let nw = Array.length s.workers in
+      let solve_group group =
+        let len = Array.length group in
+        s.pool.run (fun w ->
+          let wk = s.workers.(w) in
+          wk.wfailed <- false;
+          let k = ref w in
+          while !k < len && not wk.wfailed do
+            (match solve_stage s wk h group.(!k) with
+             | ok -> wk.wfailed <- not ok
+             | exception RecoverableFailure ->
+                 wk.wgamma <- nan;
+                 wk.wfailed <- true);
+            k := !k + nw
+          done);
+        not (Array.exists (fun wk -> wk.wfailed) s.workers)
+      in
+      let rec solve_groups g =
+        g >= Array.length s.groups
+        || (solve_group s.groups.(g) && solve_groups (g + 1))
+      in
+      if not (solve_groups 0) then infinity
+      else begin
+        let table = s.table in
+        let b = table.ButcherTable.coefficients in
+        RealArray.blit ~src:s.y ~dst:s.ynew;
+        RealArray.fill s.yerr 0.0;
+        for r = 0 to table.ButcherTable.stages - 1 do
+          let fr = s.stage_f.(r) and hb = h *. b.{r} in
+          let he = match table.ButcherTable.embedding with
+                   | Some (_, d) -> h *. (b.{r} -. d.{r})
+                   | None -> 0.0
+          in
+          for i = 0 to s.n - 1 do
+            s.ynew.{i} <- s.ynew.{i} +. hb *. fr.{i};
+            s.yerr.{i} <- s.yerr.{i} +. he *. fr.{i}
+          done
+        done;
+        if s.fixed then 0.0 else wrms s.yerr s.ewt
+      end
+
+    (* Takes one step, without passing tout. *)
+    let step s tout =
+      let p = match s.table.ButcherTable.embedding with
+              | Some (p, _) -> p
+              | None -> 0
+      in
+      let ratio err =
+        if err = 0.0 then growth
+        else safety *. err ** (-1.0 /. float (p + 1))
+      in
+      let rec retry h nconv nerr =
+        let last = s.t +. h >= tout
+                   -. 100.0 *. Config.unit_roundoff
+                      *. (abs_float s.t +. abs_float h) in
+        let h' = if last then tout -. s.t else h in
+        let err = attempt s h' in
+        if err = infinity then begin
+          s.num_conv_fails <- s.num_conv_fails + 1;
+          if s.fixed || nconv + 1 >= max_conv_fails || h' <= s.hmin
+            then raise ConvergenceFailure;
+          retry (max s.hmin (0.25 *. h')) (nconv + 1) nerr
+        end else if err > 1.0 then begin
+          s.num_err_fails <- s.num_err_fails + 1;
+          if nerr + 1 >= max_err_fails || h' <= s.hmin
+            then raise ErrFailure;
+          retry (max s.hmin (h' *. max 0.1 (ratio err))) nconv (nerr + 1)
+        end else begin
+          s.t <- (if last then tout else s.t +. h');
+          RealArray.blit ~src:s.ynew ~dst:s.y;
+          s.current <- false;
+          s.num_steps <- s.num_steps + 1;
+          s.hlast <- h';
+          if not s.fixed then begin
+            let next = min s.hmax (h' *. min growth (ratio err)) in
+            s.h <- if last then max next h else next
+          end
+        end
+      in
+      retry s.h 0 0
+
+    let evolve_normal s tout yout =
+      if tout < s.t then raise IllInput;
+      if s.h = 0.0 && tout > s.t then
+        s.h <- min s.hmax (max s.hmin (0.01 *. (tout -. s.t)));
+      let nsteps = ref 0 in
+      while s.t < tout do
+        if !nsteps >= s.max_num_steps then raise TooMuchWork;
+        step s tout;
+        incr nsteps
+      done;
+      RealArray.blit ~src:s.y ~dst:(Nvector.unwrap yout);
+      s.t, Success
+
+    let set_fixed_step s hfixed =
+      match hfixed with
+      | Some h ->
+          if h <= 0.0 then invalid_arg "ParallelStages.set_fixed_step";
+          s.fixed <- true;
+          s.h <- h
+      | None ->
+          s.fixed <- false
+
+    let set_init_step s h =
+      if h < 0.0 then invalid_arg "ParallelStages.set_init_step";
+      s.h <- h
+
+    let set_min_step s hmin =
+      if hmin < 0.0 then invalid_arg "ParallelStages.set_min_step";
+      s.hmin <- hmin
+
+    let set_max_step s hmax =
+      s.hmax <- (if hmax <= 0.0 then infinity else hmax)
+
+    let set_max_num_steps s mxsteps =
+      s.max_num_steps <- (if mxsteps <= 0 then 500 else mxsteps)
+
+    let set_max_nonlin_iters s maxcor =
+      s.max_nonlin_iters <- (if maxcor <= 0 then 3 else maxcor)
+
+    let set_nonlin_conv_coef s nlscoef =
+      s.nonlin_conv_coef <- (if nlscoef <= 0.0 then 0.1 else nlscoef)
+
+    let get_current_time s = s.t
+    let get_last_step s = s.hlast
+    let get_current_step s = s.h
+    let get_num_steps s = s.num_steps
+    let get_num_jac_evals s = s.num_jac_evals
+    let get_num_nonlin_solv_conv_fails s = s.num_conv_fails
+    let get_num_err_test_fails s = s.num_err_fails
+
+    let sum_workers field s =
+      Array.fold_left (fun n wk -> n + field wk) 0 s.workers
+
+    let get_num_rhs_evals s =
+      s.num_rhs_evals + sum_workers (fun wk -> wk.wnum_rhs_evals) s
+
+    let get_num_lin_solv_setups = sum_workers (fun wk -> wk.wnum_setups)
+    let get_num_nonlin_solv_iters = sum_workers (fun wk -> wk.wnum_iters)
+
+  end
+
+  (* }}} *)
+
 end (* }}} *)
 
 module ERKStep = struct (* {{{ *)
@@ -2661,10 +3247,22 @@ module MRIStep = struct (* {{{ *)
           session.ls_callbacks <- DlsDenseCallback (cb, ls)
       | LSI.LapackDense ->
           session.ls_callbacks <- DlsDenseCallback (cb, ls)
+      | LSI.MixedDense ->
+          session.ls_callbacks <- DlsDenseCallback (cb, ls)
       | LSI.Band ->
           session.ls_callbacks <- DlsBandCallback (cb, ls)
       | LSI.LapackBand ->
           session.ls_callbacks <- DlsBandCallback (cb, ls)
+      | LSI.MixedBand ->
+          session.ls_callbacks <- DlsBandCallback (cb, ls)
+      | LSI.SpikeBand ->
+          session.ls_callbacks <- DlsBandCallback (cb, ls)
+      | LSI.SparseLu ->
+          if jac = None then invalid_arg "SparseLu requires Jacobian function";
+          session.ls_callbacks <- DirectCustomCallback (cb, ls)
+      | LSI.ReorderedBand ->
+          if jac = None then invalid_arg "Reordered requires Jacobian function";
+          session.ls_callbacks <- DirectCustomCallback (cb, ls)
       | LSI.Klu _ ->
           if jac = None then invalid_arg "Klu requires Jacobian function";
           session.ls_callbacks <- SlsKluCallback (cb, ls)
@@ -692,6 +692,55 @@ module ButcherTable : sig (* {{{ *)
       @since 4.0.0 *)
   val check_ark_order : ?outfile:Logfile.t -> t -> t -> int * int option * bool
 
+  (** {3:pdirk Parallel-stage methods} *)
+
+  (** Fully implicit methods underlying the parallel diagonally-implicit
+      iterated Runge-Kutta (PDIRK) methods. The names give the number of
+      stages and the order. *)
+  type pdirk_base =
+    | Radau_IIA_2_3         (** Two-stage Radau IIA method of order 3. *)
+    | Radau_IIA_3_5         (** Three-stage Radau IIA method of order 5. *)
+
+  (** Returns a parallel diagonally-implicit iterated Runge-Kutta (PDIRK)
+      method as a diagonally-implicit Butcher table. The call
+      [pdirk ~iterations base] gives the method that approximates the
+      stages {% $Y$ %} of the [base] method, which has $s$ stages and
+      coefficients {% $A$ %}, by [iterations] iterations of
+      {% $Y^{(j)} - h D f(Y^{(j)}) = y_n + h (A - D) f(Y^{(j-1)})$ %}
+      from {% $Y^{(0)} = y_n$ %}. Since the matrix {% $D$ %} is diagonal,
+      the $s$ stage systems of an iteration are independent of one another:
+      they can be solved concurrently, each with its own Newton iteration
+      and linear solver. The diagonal of {% $D$ %} is chosen so that
+      {% $I - D^{-1}A$ %} is nilpotent, which damps the stiff error
+      components completely after $s$ iterations.
+
+      The table has {% $1 + s\cdot\mathtt{iterations}$ %} stages: an
+      explicit stage at {% $y_n$ %} followed by the $s$ stages of each
+      iteration. Its order is the smaller of the order of [base] and
+      [iterations + 1], and its embedding, taken from the previous
+      iteration, has one order less. By default, [iterations] is the least
+      number that gives the order of [base] (2 or 4), in which case the
+      methods are A-stable.
+
+      The stages of an iteration are solved concurrently by
+      {!ARKStep.ParallelStages}. The table can also be passed to
+      {!ARKStep.set_tables} (as the [implicit_table]), but ARKStep solves
+      the stages in sequence; since the diagonal coefficient changes from
+      one stage to the next, it is then advisable to increase
+      {!ARKStep.set_delta_gamma_max} to avoid recomputing the iteration
+      matrix at each stage.
+
+      @raise Invalid_argument If [iterations] is not positive. *)
+  val pdirk : ?iterations:int -> pdirk_base -> t
+
+  (** Groups the stages of a table by their dependencies. The call
+      [stage_groups bt] returns a list of lists of stage indices such that
+      the stages of a list only depend on those of previous lists. In
+      particular, the implicit systems of the stages in a list are
+      independent and can be solved concurrently, as by
+      {!ARKStep.ParallelStages}. *)
+  val stage_groups : t -> int list list
+
 end (* }}} *)
 
 (** {2:timestepping Time-stepping Modules} *)
@@ -994,11 +1043,17 @@ module ARKStep : sig (* {{{ *)
         @arkode_ark <Usage/ARKStep_c_interface/User_callable.html#mass-matrix-solver-specification-functions> Mass matrix solver specification functions *)
     type ('data, 'kind) solver
 
-    (** Alias for mass matrix solvers that are restricted to serial nvectors. *)
+    (** Alias for mass matrix solvers that are restricted to nvectors whose
+        payloads are {!Sundials.RealArray.t}s, namely serial, OpenMP, and
+        Pthreads nvectors. *)
     type 'kind serial_solver = (Nvector_serial.data, 'kind) solver
                                constraint 'kind = [>Nvector_serial.kind]
 
-    (** {3:arkdlsmass Direct mass matrix solvers} *)
+    (** {3:arkdlsmass Direct mass matrix solvers}
+
+        The matrices of the direct solvers are not distributed; problems
+        with {!Nvector_parallel} payloads must use an
+        {{!Spils}iterative mass matrix solver}. *)
     module Dls : sig (* {{{ *)
       include module type of Sundials_LinearSolver.Direct
 
@@ -1027,13 +1082,33 @@ module ARKStep : sig (* {{{ *)
           independent variable [t], if not it is only computed and factored
           once.
 
+          When a time-dependent mass matrix varies slowly, the
+          [reuse_tol] argument avoids refactoring it at every setup. The
+          factors of an earlier matrix {% $M_0$%} are kept until the
+          current one satisfies
+          {% $\max_{ij}|M_{ij}(t) - M_{0,ij}| > \mathtt{reuse\_tol}
+              \cdot \max_{ij}|M_{0,ij}|$%}, or until the sparsity pattern
+          changes. Solves against the older factors are only approximate,
+          so [reuse_tol] should be small relative to the integration
+          tolerances. Passing [~reuse_tol:0.0] only skips refactoring when
+          the mass matrix is unchanged.
+
+          Setting [lumped] to [true] replaces the mass matrix by the
+          diagonal matrix of its row sums. The generic linear solver is
+          then never used, each solve is a componentwise division, and
+          [reuse_tol] (default: [0.0]) applies to the lumped diagonal.
+
           NB: The boolean argument is ignored in
           {{!Sundials_Config.sundials_version}Config.sundials_version} < 3.0.0.
 
+          @raise Config.NotImplementedBySundialsVersion [reuse_tol] or
+                 [lumped] with Sundials < 5.0.0
           @arkode_ark ARKStepSetMassLinearSolver
           @arkode_user ARKStepSetMassFn *)
       val solver :
-        'm mass_fn
+        ?reuse_tol:float
+        -> ?lumped:bool
+        -> 'm mass_fn
         -> bool
         -> ('m, RealArray.t, 'kind, [>`Dls]) LinearSolver.t
         -> 'kind serial_solver
@@ -1054,6 +1129,12 @@ module ARKStep : sig (* {{{ *)
           @since 3.0.0 *)
       val get_num_setups : 'k serial_session -> int
 
+      (** Returns the number of times that the mass matrix was actually
+          factored (or lumped). This is less than the number of setups
+          when factorizations are reused (see [reuse_tol] in {!solver})
+          and otherwise equal to it. *)
+      val get_num_factorizations : 'k serial_session -> int
+
       (** Returns the number of calls made to the mass matrix matvec
           setup routine.
 
@@ -1411,7 +1492,9 @@ module ARKStep : sig (* {{{ *)
 
       This function does everything necessary to initialize a session, i.e.,
       it makes the calls referenced below. The {!evolve_normal} and
-      {!evolve_one_step} functions may be called directly.
+      {!evolve_one_step} functions may be called directly. The stages of a
+      session are solved one after another; {!ParallelStages.init} creates
+      a session that solves independent stages concurrently.
 
       By default, the session is created using the context returned by
       {!Sundials.Context.default}, but this can be overridden by passing
@@ -2268,6 +2351,152 @@ module ARKStep : sig (* {{{ *)
       @since 4.1.0 *)
   val write_butcher : ?logfile:Logfile.t -> ('d, 'k) session -> unit
 
+  (** {2:parallelstages Concurrent stage solves} *)
+
+  (** Integration with diagonally-implicit methods whose stages are solved
+      concurrently.
+
+      An ARKStep session solves the stages of a table one after another.
+      A {!ParallelStages.session} instead solves the stages of each group
+      of {!ButcherTable.stage_groups} at the same time, distributing them
+      over the workers of a {!ParallelStages.stage_pool}. Each worker has
+      its own simplified Newton iteration, iteration matrix
+      {% $I - h a_{ii} J$ %}, and dense direct linear solver, which it
+      only refactors when the diagonal coefficient of its stage changes.
+      With a {!ButcherTable.pdirk} method of $s$ base stages and a pool of
+      $s$ workers, each worker thus factors its matrix once per step and
+      reuses it for all the iterations. The Jacobian {% $J$ %} is
+      evaluated once per step, at {% $(t_n, y_n)$ %}, by [jac] or by
+      difference quotients distributed over the workers.
+
+      Only problems {% $\dot{y} = f(t, y)$ %} on serial nvectors are
+      supported. Unless {!ParallelStages.set_fixed_step} is used, the step
+      size is adapted by an elementary controller from the error estimate
+      of the embedding of the table. {!ParallelStages.evolve_normal} stops
+      exactly at [tout]: there is no interpolation, root finding, or mass
+      matrix.
+
+      With OCaml 5, a {!Sundials_domains} pool [p] runs the workers in
+      parallel:
+      [{ num_workers = Sundials_domains.num_workers p;
+         run = Sundials_domains.run p }].
+      The right-hand side and Jacobian functions must then be safe to call
+      concurrently. *)
+  module ParallelStages : sig (* {{{ *)
+
+    (** Executors for the stage solves. In the call [run job], [job w] must
+        be called exactly once for each worker [w] from [0] to
+        [num_workers - 1], possibly concurrently, and [run] must only return
+        once all calls have completed. *)
+    type stage_pool = {
+        num_workers : int;               (** Number of workers. *)
+        run : (int -> unit) -> unit;     (** Runs a job for every worker. *)
+      }
+
+    (** Solves the stages one after another on the calling thread. *)
+    val sequential_stage_pool : stage_pool
+
+    (** Jacobian functions. The call [jac t y fy j] stores
+        {% $J = \frac{\partial f}{\partial y}(t, y)$ %} in [j], where
+        [fy] is {% $f(t, y)$ %}. *)
+    type jac_fn = float -> RealArray.t -> RealArray.t -> Matrix.Dense.t -> unit
+
+    (** A session integrating with concurrent stage solves. *)
+    type session
+
+    (** [init ~pool ~jac bt tol f t0 y0] creates a session that integrates
+        {% $\dot{y} = f(t, y)$ %} from {% $y(t_0) = y_0$ %} with the
+        diagonally-implicit table [bt]. The [pool] defaults to
+        {!sequential_stage_pool}, and the Jacobian is approximated by
+        difference quotients when [jac] is not given.
+
+        @raise Invalid_argument The table is not diagonally implicit or
+                                the pool has no workers. *)
+    val init :
+         ?context:Context.t
+      -> ?pool:stage_pool
+      -> ?jac:jac_fn
+      -> ButcherTable.t
+      -> (RealArray.t, 'k) tolerance
+      -> RealArray.t rhsfn
+      -> float
+      -> 'k Nvector.serial
+      -> session
+
+    (** [tret, r = evolve_normal s tout yout] integrates up to [tout],
+        which is not interpolated but reached by the last step, and stores
+        the solution in [yout]. The result [r] is always [Success].
+
+        @raise IllInput [tout] lies before the current time.
+        @raise TooMuchWork More than {!set_max_num_steps} steps were taken.
+        @raise ErrFailure Too many error test failures, or the minimum step
+                          size was reached.
+        @raise ConvergenceFailure Too many Newton convergence failures, or
+                                  a failure with a fixed step size. *)
+    val evolve_normal :
+      session -> float -> 'k Nvector.serial -> float * solver_result
+
+    (** Fixes the step size, or restores adaptivity with [None]. *)
+    val set_fixed_step : session -> float option -> unit
+
+    (** Sets the size of the first step. The default is a hundredth of the
+        first integration interval. *)
+    val set_init_step : session -> float -> unit
+
+    (** Sets a lower bound on the step size (default [0.0]). *)
+    val set_min_step : session -> float -> unit
+
+    (** Sets an upper bound on the step size (a nonpositive value restores
+        the default, no bound). *)
+    val set_max_step : session -> float -> unit
+
+    (** Sets the maximum number of steps per call to {!evolve_normal} (a
+        nonpositive value restores the default, 500). *)
+    val set_max_num_steps : session -> int -> unit
+
+    (** Sets the maximum number of Newton iterations per stage (a
+        nonpositive value restores the default, 3). *)
+    val set_max_nonlin_iters : session -> int -> unit
+
+    (** Sets the safety factor of the Newton convergence test (a
+        nonpositive value restores the default, 0.1). *)
+    val set_nonlin_conv_coef : session -> float -> unit
+
+    (** Returns the time reached. *)
+    val get_current_time : session -> float
+
+    (** Returns the size of the last step taken. *)
+    val get_last_step : session -> float
+
+    (** Returns the size of the next step to attempt. *)
+    val get_current_step : session -> float
+
+    (** Returns the number of steps taken. *)
+    val get_num_steps : session -> int
+
+    (** Returns the number of right-hand side evaluations, including those
+        of the difference quotients. *)
+    val get_num_rhs_evals : session -> int
+
+    (** Returns the number of Jacobian evaluations. *)
+    val get_num_jac_evals : session -> int
+
+    (** Returns the number of iteration matrix factorizations, summed over
+        the workers. *)
+    val get_num_lin_solv_setups : session -> int
+
+    (** Returns the number of Newton iterations, summed over the stages. *)
+    val get_num_nonlin_solv_iters : session -> int
+
+    (** Returns the number of steps rejected because a stage did not
+        converge. *)
+    val get_num_nonlin_solv_conv_fails : session -> int
+
+    (** Returns the number of steps rejected by the error test. *)
+    val get_num_err_test_fails : session -> int
+
+  end (* }}} *)
+
 end (* }}} *)
 
 (** ERKStep Time-Stepping Module for nonstiff initial value problems.
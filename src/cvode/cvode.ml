@@ -249,6 +249,146 @@ module Dls = struct (* {{{ *)
     | Band -> ()
     | _ -> if jac = None then invalid_arg "A Jacobian function is required"
 
+  type dq_pool = {
+      num_workers : int;
+      run : (int -> unit) -> unit;
+    }
+
+  let sequential_dq_pool = { num_workers = 1; run = fun job -> job 0 }
+
+  external c_dq_get_err_weights : 'k serial_session -> Nvector_serial.t -> unit
+    = "sunml_cvode_get_err_weights"
+
+  external c_dq_get_step : 'k serial_session -> float
+    = "sunml_cvode_get_dq_step"
+
+  (* Scratch space of a difference quotient Jacobian, allocated on the
+     first evaluation, with a perturbed state and a right-hand side for
+     each worker. *)
+  type dq_work = {
+      mutable dq_ewt : Nvector_serial.t option;
+      mutable dq_inc : RealArray.t;
+      mutable dq_ytmp : RealArray.t array;
+      mutable dq_ftmp : RealArray.t array;
+    }
+
+  let new_dq_work () = { dq_ewt = None; dq_inc = RealArray.create 0;
+                         dq_ytmp = [||]; dq_ftmp = [||] }
+
+  let dq_scratch work pool n =
+    if Array.length work.dq_ytmp <> pool.num_workers
+       || RealArray.length work.dq_ytmp.(0) <> n
+    then begin
+      work.dq_ytmp <- Array.init pool.num_workers (fun _ -> RealArray.create n);
+      work.dq_ftmp <- Array.init pool.num_workers (fun _ -> RealArray.create n)
+    end
+
+  (* Increments as in cvLsDenseDQJac and cvLsBandDQJac, with the step size
+     h of the step being attempted. *)
+  let dq_increments work session y fy =
+    let n = RealArray.length y in
+    let ewt_nv =
+      match work.dq_ewt with
+      | Some v when RealArray.length (Nvector.unwrap v) = n -> v
+      | _ ->
+          let v = Nvector_serial.make ~context:session.context n 0.0 in
+          work.dq_ewt <- Some v;
+          work.dq_inc <- RealArray.create n;
+          v
+    in
+    c_dq_get_err_weights session ewt_nv;
+    let ewt = Nvector.unwrap ewt_nv in
+    let fnorm =
+      let s = ref 0.0 in
+      for i = 0 to n - 1 do
+        let v = fy.{i} *. ewt.{i} in
+        s := !s +. v *. v
+      done;
+      sqrt (!s /. float n)
+    in
+    let srur = sqrt Config.unit_roundoff in
+    let min_inc =
+      if fnorm <> 0.0
+      then 1000.0 *. abs_float (c_dq_get_step session)
+             *. Config.unit_roundoff *. float n *. fnorm
+      else 1.0
+    in
+    let inc = work.dq_inc in
+    for j = 0 to n - 1 do
+      inc.{j} <- max (srur *. abs_float y.{j}) (min_inc /. ewt.{j})
+    done;
+    inc
+
+  (* Worker w computes the columns j = w, w + num_workers, ... *)
+  let dense_dqjac pool work session
+                  { jac_t = t; jac_y = y; jac_fy = fy; _ } jm =
+    let n = RealArray.length y in
+    let inc = dq_increments work session y fy in
+    dq_scratch work pool n;
+    let f = session.rhsfn in
+    pool.run (fun w ->
+      let ytmp = work.dq_ytmp.(w) and ftmp = work.dq_ftmp.(w) in
+      RealArray.blit ~src:y ~dst:ytmp;
+      let j = ref w in
+      while !j < n do
+        let yj = y.{!j} in
+        ytmp.{!j} <- yj +. inc.{!j};
+        f t ytmp ftmp;
+        ytmp.{!j} <- yj;
+        let inc_inv = 1.0 /. inc.{!j} in
+        for i = 0 to n - 1 do
+          Matrix.Dense.set jm i !j ((ftmp.{i} -. fy.{i}) *. inc_inv)
+        done;
+        j := !j + pool.num_workers
+      done)
+
+  (* Worker w computes the column groups g = w, w + num_workers, ... *)
+  let band_dqjac pool work session
+                 { jac_t = t; jac_y = y; jac_fy = fy; _ } jm =
+    let { Matrix.Band.n; Matrix.Band.mu; Matrix.Band.ml; _ } =
+      Matrix.Band.dims jm in
+    let inc = dq_increments work session y fy in
+    let f = session.rhsfn in
+    let width = ml + mu + 1 in
+    let ngroups = min width n in
+    dq_scratch work pool n;
+    pool.run (fun w ->
+      let ytmp = work.dq_ytmp.(w) and ftmp = work.dq_ftmp.(w) in
+      RealArray.blit ~src:y ~dst:ytmp;
+      let g = ref w in
+      while !g < ngroups do
+        let j = ref !g in
+        while !j < n do
+          ytmp.{!j} <- y.{!j} +. inc.{!j};
+          j := !j + width
+        done;
+        f t ytmp ftmp;
+        let j = ref !g in
+        while !j < n do
+          ytmp.{!j} <- y.{!j};
+          let inc_inv = 1.0 /. inc.{!j} in
+          for i = max 0 (!j - mu) to min (n - 1) (!j + ml) do
+            Matrix.Band.set jm i !j ((ftmp.{i} -. fy.{i}) *. inc_inv)
+          done;
+          j := !j + width
+        done;
+        g := !g + pool.num_workers
+      done)
+
+  let dq_jac (type m) (type tag) pool session
+        (solver_data : (m, 'nd, 'nk, tag) LSI.solver_data) : m jac_fn option =
+    if pool.num_workers < 1 then invalid_arg "num_workers must be positive";
+    let work = new_dq_work () in
+    match solver_data with
+    | LSI.Dense -> Some (dense_dqjac pool work session)
+    | LSI.LapackDense -> Some (dense_dqjac pool work session)
+    | LSI.MixedDense -> Some (dense_dqjac pool work session)
+    | LSI.Band -> Some (band_dqjac pool work session)
+    | LSI.LapackBand -> Some (band_dqjac pool work session)
+    | LSI.MixedBand -> Some (band_dqjac pool work session)
+    | LSI.SpikeBand -> Some (band_dqjac pool work session)
+    | _ -> invalid_arg "dq_pool requires a dense or band solver"
+
   let set_ls_callbacks (type m) (type tag)
         ?jac ?(linsys : m linsys_fn option)
         (solver_data : (m, 'nd, 'nk, tag) LSI.solver_data)
@@ -262,10 +402,22 @@ module Dls = struct (* {{{ *)
         session.ls_callbacks <- DlsDenseCallback (cb, ls)
     | LSI.LapackDense ->
         session.ls_callbacks <- DlsDenseCallback (cb, ls)
+    | LSI.MixedDense ->
+        session.ls_callbacks <- DlsDenseCallback (cb, ls)
     | LSI.Band ->
         session.ls_callbacks <- DlsBandCallback (cb, ls)
     | LSI.LapackBand ->
         session.ls_callbacks <- DlsBandCallback (cb, ls)
+    | LSI.MixedBand ->
+        session.ls_callbacks <- DlsBandCallback (cb, ls)
+    | LSI.SpikeBand ->
+        session.ls_callbacks <- DlsBandCallback (cb, ls)
+    | LSI.SparseLu ->
+        if jac = None then invalid_arg "SparseLu requires Jacobian function";
+        session.ls_callbacks <- DirectCustomCallback (cb, ls)
+    | LSI.ReorderedBand ->
+        if jac = None then invalid_arg "Reordered requires Jacobian function";
+        session.ls_callbacks <- DirectCustomCallback (cb, ls)
     | LSI.Klu _ ->
         if jac = None then invalid_arg "Klu requires Jacobian function";
         session.ls_callbacks <- SlsKluCallback (cb, ls)
@@ -292,11 +444,15 @@ module Dls = struct (* {{{ *)
     | Some m -> m
     | None -> failwith "a direct linear solver is required"
 
-  let solver ?jac ?linsys ls session _ =
+  let solver ?jac ?linsys ?dq_pool ls session _ =
     let LSI.LS ({ LSI.rawptr; LSI.solver; LSI.matrix } as hls) = ls in
     let matrix = assert_matrix matrix in
     if Sundials_impl.Version.lt500 && linsys <> None
       then raise Config.NotImplementedBySundialsVersion;
+    let jac = match jac, dq_pool with
+              | None, Some pool -> dq_jac pool session solver
+              | _ -> jac
+    in
     set_ls_callbacks ?jac ?linsys solver matrix session;
     if Sundials_impl.Version.in_compat_mode2
        then make_compat (jac <> None) solver matrix session
@@ -677,6 +833,51 @@ module Spils = struct (* {{{ *)
       ls_check_spils_band s;
       get_num_rhs_evals s
   end (* }}} *)
+
+  module BlockJacobi = struct (* {{{ *)
+    include BlockJacobiTypes
+
+    (* 5.0.0 <= Sundials *)
+    external c_init : ('a, 'k) Nvector.t -> cptr * int array
+      = "sunml_cvode_blockjac_init"
+
+    (* 5.0.0 <= Sundials *)
+    external c_set_preconditioner : ('a, 'k) session -> unit
+      = "sunml_cvode_set_blockjac_preconditioner"
+
+    let init_preconditioner jac session nv =
+      if Sundials_impl.Version.lt500
+        then raise Config.NotImplementedBySundialsVersion;
+      let cptr, sizes = c_init nv in
+      session.ls_precfns <- BlockJacobiPrecFns {
+          block_cptr     = cptr;
+          block_jac_fn   = jac;
+          block_matrices = Array.map (fun n -> Matrix.Dense.create n n) sizes;
+        };
+      c_set_preconditioner session
+
+    let prec_left ?jac () =
+      LSI.Iterative.(PrecLeft,  init_preconditioner jac)
+    let prec_right ?jac () =
+      LSI.Iterative.(PrecRight, init_preconditioner jac)
+    let prec_both ?jac () =
+      LSI.Iterative.(PrecBoth,  init_preconditioner jac)
+
+    external c_get_num_rhs_evals : cptr -> int
+      = "sunml_cvode_blockjac_get_num_rhs_evals"
+
+    let get_num_blocks s =
+      ls_check_spils_block_jacobi s;
+      match s.ls_precfns with
+      | BlockJacobiPrecFns { block_matrices } -> Array.length block_matrices
+      | _ -> raise LinearSolver.InvalidLinearSolver
+
+    let get_num_rhs_evals s =
+      ls_check_spils_block_jacobi s;
+      match s.ls_precfns with
+      | BlockJacobiPrecFns { block_cptr } -> c_get_num_rhs_evals block_cptr
+      | _ -> raise LinearSolver.InvalidLinearSolver
+  end (* }}} *)
 end (* }}} *)
 
 let matrix_embedded_solver ((LSI.LS ({ LSI.rawptr; _ } as hls)) as ls) session _ =
@@ -686,6 +887,362 @@ let matrix_embedded_solver ((LSI.LS ({ LSI.rawptr; _ } as hls)) as ls) session _
   LSI.attach ls;
   session.ls_solver <- LSI.HLS hls
 
+module Auto = struct (* {{{ *)
+  type kind =
+    | Dense
+    | Band
+    | SparseLu
+    | Klu
+    | Spgmr
+
+  type decision = {
+      kind       : kind;
+      mu         : int;
+      ml         : int;
+      costs      : (kind * float) list;
+      from_cache : bool;
+    }
+
+  let string_of_kind = function
+    | Dense    -> "dense"
+    | Band     -> "band"
+    | SparseLu -> "sparselu"
+    | Klu      -> "klu"
+    | Spgmr    -> "spgmr"
+
+  let kind_of_string = function
+    | "dense"    -> Some Dense
+    | "band"     -> Some Band
+    | "sparselu" -> Some SparseLu
+    | "klu"      -> Some Klu
+    | "spgmr"    -> Some Spgmr
+    | _          -> None
+
+  external c_get_current_time : ('a, 'k) session -> float
+    = "sunml_cvode_get_current_time"
+
+  (* Cache files hold one decision per line, as
+       "fingerprint" kind mu ml # costs
+     where later lines override earlier ones.  *)
+  let cache_lookup file key =
+    match open_in file with
+    | exception Sys_error _ -> None
+    | ic ->
+        let entry found line =
+          try
+            Scanf.sscanf line " %S %s %d %d" (fun k s mu ml ->
+              match kind_of_string s with
+              | Some kind when k = key -> Some (kind, mu, ml)
+              | _ -> found)
+          with Scanf.Scan_failure _ | Failure _ | End_of_file -> found
+        in
+        let rec loop found =
+          match input_line ic with
+          | exception End_of_file -> close_in ic; found
+          | line -> loop (entry found line)
+        in
+        loop None
+
+  let cache_store file key { kind; mu; ml; costs; _ } =
+    let flags = [Open_wronly; Open_append; Open_creat; Open_text] in
+    match open_out_gen flags 0o644 file with
+    | exception Sys_error _ -> ()
+    | oc ->
+        Printf.fprintf oc "%S %s %d %d #" key (string_of_kind kind) mu ml;
+        List.iter (fun (k, c) ->
+                     Printf.fprintf oc " %s=%.3e" (string_of_kind k) c) costs;
+        output_char oc '\n';
+        close_out oc
+
+  (* Shortest of [reps] wall-clock timings of [f], excluding [prepare]. *)
+  let best_time ?(prepare=fun () -> ()) reps f =
+    let best = ref infinity in
+    for _i = 1 to max 1 reps do
+      prepare ();
+      let t0 = Sundials_impl.wall_clock () in
+      f ();
+      best := min !best (Sundials_impl.wall_clock () -. t0)
+    done;
+    !best
+
+  (* Difference-quotient Jacobian, column by column, with increments
+     sqrt(eps) max(|y_c|, 1).  CVODE also bounds the increments below using
+     the error weights and the step size, which matters for accuracy but
+     not for finding the structure.  *)
+  let dq_jacobian f t y fy =
+    let n = RealArray.length y in
+    let j = Matrix.Dense.create n n in
+    let yp = RealArray.copy y and fp = RealArray.create n in
+    let srur = sqrt Config.unit_roundoff in
+    for c = 0 to n - 1 do
+      let yc = y.{c} in
+      let inc = srur *. max (abs_float yc) 1.0 in
+      yp.{c} <- yc +. inc;
+      f t yp fp;
+      yp.{c} <- yc;
+      for r = 0 to n - 1 do
+        Matrix.Dense.set j r c ((fp.{r} -. fy.{r}) /. inc)
+      done
+    done;
+    j
+
+  (* The Jacobian at y, with the entries that vanish there taken from the
+     Jacobian at a perturbed state.  Probing y alone misses entries that
+     happen to be zero at the initial state, like products with components
+     that start at zero, and would underestimate the bandwidths.  The
+     perturbation is skipped if f rejects the perturbed state.  *)
+  let dense_probe f t y fy =
+    let n = RealArray.length y in
+    let j = dq_jacobian f t y fy in
+    let st = Random.State.make [| n |] in
+    let yp = RealArray.init n (fun i ->
+               let w = 0.5 +. Random.State.float st 1.0 in
+               let w = if Random.State.bool st then w else -. w in
+               y.{i} +. 1.0e-2 *. w *. (abs_float y.{i} +. 1.0)) in
+    let fp = RealArray.create n in
+    (match f t yp fp; dq_jacobian f t yp fp with
+     | exception RecoverableFailure -> ()
+     | jp ->
+         for c = 0 to n - 1 do
+           for r = 0 to n - 1 do
+             if Matrix.Dense.get j r c = 0.0
+             then Matrix.Dense.set j r c (Matrix.Dense.get jp r c)
+           done
+         done);
+    j
+
+  let iter_dense j f =
+    let n, _ = Matrix.Dense.size j in
+    for c = 0 to n - 1 do
+      for r = 0 to n - 1 do
+        let v = Matrix.Dense.get j r c in
+        if v <> 0.0 then f r c v
+      done
+    done
+
+  let iter_sparse j f =
+    let _, n = Matrix.Sparse.size j in
+    for c = 0 to n - 1 do
+      for idx = Matrix.Sparse.get_col j c to Matrix.Sparse.get_col j (c + 1) - 1
+      do
+        let r, v = Matrix.Sparse.get j idx in
+        f r c v
+      done
+    done
+
+  (* Number of nonzeros, bandwidths, largest magnitude, and a hash of the
+     pattern.  *)
+  let structure n iter =
+    let nnz = ref 0 and mu = ref 0 and ml = ref 0
+    and amax = ref 0.0 and h = ref n in
+    iter (fun r c v ->
+      incr nnz;
+      mu := max !mu (c - r);
+      ml := max !ml (r - c);
+      amax := max !amax (abs_float v);
+      h := (!h * 31 + r * n + c) land 0x3fffffff);
+    !nnz, !mu, !ml, !amax, !h
+
+  let time_direct reps k ls m reset x b =
+    LinearSolver.init ls;
+    let t_setup = best_time ~prepare:reset reps
+                    (fun () -> LinearSolver.setup ls m) in
+    let t_solve = best_time reps (fun () -> LinearSolver.solve ls m x b 0.0) in
+    t_setup +. float k *. t_solve
+
+  (* Unpreconditioned GMRES on I - gamma J, with J v approximated by a
+     difference quotient of the right-hand side function.  *)
+  let time_spgmr context reps k f t y fy gamma x b =
+    let n = RealArray.length y in
+    let ls = LinearSolver.Iterative.spgmr ~context
+               (Nvector_serial.wrap ~context (RealArray.copy y)) in
+    let yp = RealArray.create n and fp = RealArray.create n in
+    LinearSolver.set_atimes ls (fun v z ->
+      let nv = ref 0.0 in
+      for i = 0 to n - 1 do nv := !nv +. v.{i} *. v.{i} done;
+      if !nv = 0.0 then RealArray.fill z 0.0
+      else begin
+        let sigma = 1.0 /. sqrt !nv in
+        for i = 0 to n - 1 do yp.{i} <- y.{i} +. sigma *. v.{i} done;
+        f t yp fp;
+        for i = 0 to n - 1 do
+          z.{i} <- v.{i} -. gamma *. (fp.{i} -. fy.{i}) /. sigma
+        done
+      end);
+    let m = Matrix.dense ~context 1 in
+    LinearSolver.init ls;
+    LinearSolver.setup ls m;
+    let tol = 1.0e-4 *. sqrt (float n) in
+    let xa = Nvector.unwrap x in
+    float k *. best_time ~prepare:(fun () -> RealArray.fill xa 0.0) reps
+                 (fun () -> LinearSolver.solve ls m x b tol)
+
+  let install context sparse_jac kind mu ml session nv =
+    let n = RealArray.length (Nvector.unwrap nv) in
+    match kind, sparse_jac with
+    | Dense, _ ->
+        Dls.solver (Dls.dense ~context nv (Matrix.dense ~context n)) session nv
+    | Band, _ ->
+        Dls.solver (Dls.band ~context nv (Matrix.band ~context ~mu ~ml n))
+                   session nv
+    | SparseLu, Some (jac, nnz) ->
+        let m = Matrix.sparse_csc ~context ~nnz n in
+        Dls.solver ~jac (Dls.SparseLu.make ~context nv m) session nv
+    | Klu, Some (jac, nnz) ->
+        let m = Matrix.sparse_csc ~context ~nnz n in
+        Dls.solver ~jac (Dls.Klu.make ~context nv m) session nv
+    | (SparseLu | Klu), None ->
+        invalid_arg "Auto: sparse solvers require sparse_jac"
+    | Spgmr, _ ->
+        Spils.(solver (spgmr ~context nv) prec_none) session nv
+
+  let select ?cache ?model ~candidates ?sparse_jac ~max_probe ~k ~reps
+             session y =
+    let context = session.context in
+    let n = RealArray.length y in
+    let cached key =
+      match cache with
+      | None -> None
+      | Some file ->
+          (match cache_lookup file key with
+           | Some (kind, mu, ml)
+               when List.mem kind candidates
+                    && (sparse_jac <> None || (kind <> SparseLu && kind <> Klu))
+             -> Some { kind; mu; ml; costs = []; from_cache = true }
+           | _ -> None)
+    in
+    let calibrate () =
+      let f = session.rhsfn in
+      let t = c_get_current_time session in
+      let fy = RealArray.create n in
+      let t_rhs = best_time reps (fun () -> f t y fy) in
+      let jac =
+        match sparse_jac with
+        | Some (jac, nnz) ->
+            let j = Matrix.Sparse.make Matrix.Sparse.CSC n n nnz in
+            let tmp = RealArray.(create n, create n, create n) in
+            let arg = { jac_t = t; jac_y = y; jac_fy = fy; jac_tmp = tmp } in
+            let t_jac =
+              best_time ~prepare:(fun () -> Matrix.Sparse.set_to_zero j) reps
+                        (fun () -> jac arg j)
+            in
+            `Sparse (j, t_jac)
+        | None when n <= max_probe -> `Dense (dense_probe f t y fy)
+        | None -> `Unknown
+      in
+      let iter = match jac with
+                 | `Sparse (j, _) -> iter_sparse j
+                 | `Dense j -> iter_dense j
+                 | `Unknown -> fun _ -> ()
+      in
+      let nnz, mu, ml, amax, hash = structure n iter in
+      let mu, ml = match jac with `Unknown -> n - 1, n - 1 | _ -> mu, ml in
+      let key =
+        match model with
+        | Some m -> Printf.sprintf "%s:%d" m n
+        | None -> Printf.sprintf "n%d:nnz%d:mu%d:ml%d:%08x" n nnz mu ml hash
+      in
+      match (if model = None then cached key else None) with
+      | Some d -> key, d
+      | None ->
+          (* Calibrate on M = I - gamma J with gamma ~ 1/|J| *)
+          let gamma = 1.0 /. (1.0 +. amax) in
+          let b = Nvector_serial.wrap ~context (RealArray.make n 1.0) in
+          let x = Nvector_serial.wrap ~context (RealArray.make n 0.0) in
+          let cost kind =
+            try
+              match kind, jac with
+              | Dense, (`Dense _ | `Sparse _) when n <= max_probe ->
+                  let m = Matrix.dense ~context n in
+                  let a = Matrix.Dense.create n n in
+                  Matrix.Dense.set_to_zero a;
+                  iter (fun r c v -> Matrix.Dense.set a r c (-. gamma *. v));
+                  Matrix.Dense.scale_addi 1.0 a;
+                  let reset () =
+                    Matrix.Dense.blit ~src:a ~dst:(Matrix.unwrap m) in
+                  let ls = LinearSolver.Direct.dense ~context x m in
+                  Some (float n *. t_rhs +. time_direct reps k ls m reset x b)
+              | Band, (`Dense _ | `Sparse _) when mu + ml + 1 < n ->
+                  let m = Matrix.band ~context ~mu ~ml n in
+                  let a =
+                    Matrix.Band.create (Matrix.Band.dims (Matrix.unwrap m)) in
+                  Matrix.Band.set_to_zero a;
+                  iter (fun r c v -> Matrix.Band.set a r c (-. gamma *. v));
+                  Matrix.Band.scale_addi 1.0 a;
+                  let reset () =
+                    Matrix.Band.blit ~src:a ~dst:(Matrix.unwrap m) in
+                  let ls = LinearSolver.Direct.band ~context x m in
+                  Some (float (mu + ml + 1) *. t_rhs
+                        +. time_direct reps k ls m reset x b)
+              | (SparseLu | Klu), `Sparse (j, t_jac)
+                  when kind = SparseLu || Config.klu_enabled ->
+                  let m = Matrix.sparse_csc ~context ~nnz:(nnz + n) n in
+                  let a = Matrix.Sparse.make Matrix.Sparse.CSC n n (nnz + n) in
+                  Matrix.Sparse.blit ~src:j ~dst:a;
+                  Matrix.Sparse.scale_addi (-. gamma) a;
+                  let reset () =
+                    Matrix.Sparse.blit ~src:a ~dst:(Matrix.unwrap m) in
+                  let open LinearSolver.Direct in
+                  let td =
+                    if kind = Klu
+                    then time_direct reps k (Klu.make ~context x m) m reset x b
+                    else time_direct reps k (SparseLu.make ~context x m)
+                                     m reset x b
+                  in
+                  Some (t_jac +. td)
+              | Spgmr, _ ->
+                  Some (time_spgmr context reps k f t y fy gamma x b)
+              | _ -> None
+            with
+            | Config.NotImplementedBySundialsVersion -> None
+            | LinearSolver.LUfactFailure
+            | LinearSolver.PackageFailure _
+            | LinearSolver.ZeroInDiagonal _
+            | LinearSolver.ConvFailure
+            | LinearSolver.ResReduced
+            | LinearSolver.ATimesFailure _
+            | LinearSolver.QRfactFailure
+            | LinearSolver.QRSolFailure
+            | LinearSolver.GSFailure
+            | LinearSolver.InternalFailure _
+            | Matrix.ZeroDiagonalElement _
+            | RecoverableFailure -> Some infinity
+          in
+          let costs =
+            List.fold_right (fun kind acc ->
+                               match cost kind with
+                               | Some c -> (kind, c) :: acc
+                               | None -> acc) candidates []
+          in
+          let kind =
+            match costs with
+            | [] -> Spgmr
+            | c0 :: rest ->
+                fst (List.fold_left (fun (bk, bc) (k, c) ->
+                                       if c < bc then (k, c) else (bk, bc))
+                                    c0 rest)
+          in
+          key, { kind; mu; ml; costs; from_cache = false }
+    in
+    match model with
+    | Some m ->
+        let key = Printf.sprintf "%s:%d" m n in
+        (match cached key with Some d -> key, d | None -> calibrate ())
+    | None -> calibrate ()
+
+  let solver ?cache ?model ?(candidates=[Dense; Band; SparseLu; Klu; Spgmr])
+             ?sparse_jac ?(max_probe=500) ?(solves_per_setup=20) ?(reps=3)
+             ?(on_decision=fun _ -> ()) () session nv =
+    let key, d = select ?cache ?model ~candidates ?sparse_jac ~max_probe
+                        ~k:solves_per_setup ~reps session (Nvector.unwrap nv)
+    in
+    (match cache with
+     | Some file when not d.from_cache -> cache_store file key d
+     | _ -> ());
+    on_decision d;
+    install session.context sparse_jac d.kind d.mu d.ml session nv
+end (* }}} *)
+
 external sv_tolerances  : ('a, 'k) session -> float -> ('a, 'k) nvector -> unit
     = "sunml_cvode_sv_tolerances"
 external ss_tolerances  : ('a, 'k) session -> float -> float -> unit
@@ -866,6 +1423,117 @@ let reinit session ?nlsolver ?nlsrhsfn ?lsolver ?roots ?rhsfn t0 y0 =
    | Some roots -> root_init session roots);
   (match rhsfn with None -> () | Some f -> session.rhsfn <- f)
 
+module Pool = struct (* {{{ *)
+
+  type ('key, 'd, 'k) t = {
+      make : 'key -> float -> ('d, 'k) Nvector.t -> ('d, 'k) session;
+      max_idle : int;
+      idle : ('key, ('d, 'k) session list) Hashtbl.t;
+      mutable idle_count : int;
+      (* weak, so that sessions that are never released can be collected *)
+      mutable acquired : ('key * ('d, 'k) session Weak.t) list;
+      mutable num_acquired : int;
+      mutable prune_at : int;
+      mutable created : int;
+      mutable reused : int;
+    }
+
+  type stats = {
+      num_created : int;
+      num_reused : int;
+      num_idle : int;
+    }
+
+  let create ?(max_idle=64) make =
+    if max_idle < 0 then invalid_arg "Pool.create: max_idle < 0";
+    {
+      make;
+      max_idle;
+      idle = Hashtbl.create 16;
+      idle_count = 0;
+      acquired = [];
+      num_acquired = 0;
+      prune_at = 64;
+      created = 0;
+      reused = 0;
+    }
+
+  let alive (_, w) = Weak.check w 0
+
+  (* Drops the collected sessions when the list has doubled since the
+     last time. *)
+  let add_acquired p key s =
+    let w = Weak.create 1 in
+    Weak.set w 0 (Some s);
+    p.acquired <- (key, w) :: p.acquired;
+    p.num_acquired <- p.num_acquired + 1;
+    if p.num_acquired >= p.prune_at then begin
+      p.acquired <- List.filter alive p.acquired;
+      p.num_acquired <- List.length p.acquired;
+      p.prune_at <- max 64 (2 * p.num_acquired)
+    end
+
+  let acquire p key ?roots ?rhsfn t0 y0 =
+    match (try Hashtbl.find p.idle key with Not_found -> []) with
+    | s :: rest ->
+        Hashtbl.replace p.idle key rest;
+        p.idle_count <- p.idle_count - 1;
+        p.reused <- p.reused + 1;
+        reinit s ?roots ?rhsfn t0 y0;
+        add_acquired p key s;
+        s
+    | [] ->
+        let s = p.make key t0 y0 in
+        p.created <- p.created + 1;
+        (match roots with None -> () | Some roots -> root_init s roots);
+        (match rhsfn with None -> () | Some f -> s.rhsfn <- f);
+        add_acquired p key s;
+        s
+
+  (* Removes s, and any collected sessions, from the acquired sessions,
+     checking its key. *)
+  let rec remove_acquired key s = function
+    | [] -> raise Not_found
+    | (k, w) :: rest ->
+        (match Weak.get w 0 with
+         | Some s' when s' == s ->
+             if k <> key then invalid_arg "Pool.release: wrong key";
+             rest
+         | Some _ -> (k, w) :: remove_acquired key s rest
+         | None -> remove_acquired key s rest)
+
+  let release p key s =
+    (match remove_acquired key s p.acquired with
+     | acquired ->
+         p.acquired <- acquired;
+         p.num_acquired <- List.length acquired
+     | exception Not_found ->
+         if List.memq s (try Hashtbl.find p.idle key with Not_found -> [])
+         then invalid_arg "Pool.release: session already released"
+         else invalid_arg "Pool.release: session not acquired from this pool");
+    if p.idle_count < p.max_idle then begin
+      let idle = try Hashtbl.find p.idle key with Not_found -> [] in
+      Hashtbl.replace p.idle key (s :: idle);
+      p.idle_count <- p.idle_count + 1
+    end
+
+  let with_session p key ?roots ?rhsfn t0 y0 f =
+    let s = acquire p key ?roots ?rhsfn t0 y0 in
+    match f s with
+    | r -> release p key s; r
+    | exception e -> release p key s; raise e
+
+  let clear p =
+    Hashtbl.reset p.idle;
+    p.idle_count <- 0
+
+  let get_stats p =
+    { num_created = p.created;
+      num_reused = p.reused;
+      num_idle = p.idle_count }
+
+end (* }}} *)
+
 external get_root_info  : ('a, 'k) session -> Roots.t -> unit
     = "sunml_cvode_get_root_info"
 
@@ -178,6 +178,28 @@ module Dls : sig (* {{{ *)
   type 'm linsys_fn =
     (RealArray.t triple, RealArray.t) jacobian_arg -> 'm -> bool -> float -> bool
 
+  (** Executors for the difference quotient Jacobian approximation.
+      In the call [run job], [job w] must be called exactly once for each
+      worker [w] from [0] to [num_workers - 1], possibly concurrently, and
+      [run] must only return once all calls have completed. Each worker
+      evaluates the right-hand side function on its own copies of [y] and
+      of the scratch vectors, which are kept between evaluations, and
+      writes a disjoint set of columns of the Jacobian matrix.
+
+      With OCaml 5, a {!Sundials_domains} pool [p] runs the workers in
+      parallel:
+      [{ num_workers = Sundials_domains.num_workers p;
+         run = Sundials_domains.run p }].
+      The right-hand side function must then be safe to call concurrently. *)
+  type dq_pool = {
+      num_workers : int;               (** Number of workers. *)
+      run : (int -> unit) -> unit;     (** Runs a job for every worker. *)
+    }
+
+  (** Evaluates the perturbed right-hand sides one after another on the
+      calling thread. *)
+  val sequential_dq_pool : dq_pool
+
   (** Create a Cvode-specific linear solver from a Jacobian approximation
       function and generic direct linear solver.
 
@@ -186,6 +208,18 @@ module Dls : sig (* {{{ *)
       used), but must be provided for other solvers (or [Invalid_argument]
       is raised).
 
+      When [jac] is not given, passing [dq_pool] replaces the internal
+      difference quotient approximation with an equivalent one whose
+      right-hand side evaluations are distributed over the workers of the
+      pool: one column at a time for dense matrices, and one group of
+      [mu + ml + 1] columns at a time for banded ones. These evaluations
+      are not counted by {!get_num_lin_rhs_evals}, and are counted by
+      {!get_num_jac_evals} as a single Jacobian evaluation. Passing
+      [dq_pool] with another kind of solver raises [Invalid_argument].
+      This feature is only provided by CVODE: the direct linear solvers of
+      IDA, ARKODE, and KINSOL always use their internal
+      approximations.
+
       The [linsys] argument allows to override the standard linear system
       function that calls [jac] to compute {% $M$ %}. This feature is only
       available in Sundials >= 5.0.0.
@@ -196,6 +230,7 @@ module Dls : sig (* {{{ *)
   val solver :
     ?jac:'m jac_fn ->
     ?linsys:'m linsys_fn ->
+    ?dq_pool:dq_pool ->
     ('m, RealArray.t, 'kind, [>`Dls]) LinearSolver.t ->
     'kind serial_linear_solver
 
@@ -288,8 +323,8 @@ module Spils : sig (* {{{ *)
 
   (** Specifies a preconditioner, including the type of preconditioning
       (none, left, right, or both) and callback functions.
-      The following functions and those in {!Banded} and {!Cvode_bbd}
-      construct preconditioners.
+      The following functions and those in {!Banded}, {!BlockJacobi}, and
+      {!Cvode_bbd} construct preconditioners.
 
       The {!prec_solve_fn} is mandatory. The {!prec_setup_fn} can be
       omitted if not needed.
@@ -367,6 +402,68 @@ module Spils : sig (* {{{ *)
     val get_num_rhs_evals : 'kind serial_session -> int
   end (* }}} *)
 
+  (** Block-Jacobi preconditioners for {!Nvector_many} nvectors.
+
+      Each subvector of a many-vector is taken as one block of unknowns
+      and the preconditioner is the block diagonal part of the Newton
+      matrix, {% $P = \mathrm{diag}(I - \gamma J_{bb})$%}, where
+      {% $J_{bb}$%} is the Jacobian of the [b]th subvector of $f$ with
+      respect to the [b]th subvector of $y$. The blocks are factored
+      densely at each setup and the block solves run in C, without calling
+      OCaml, in parallel when the library is compiled with OpenMP.
+
+      The subvectors must have {!RealArray.t} payloads, that is, be serial,
+      OpenMP, or Pthreads nvectors. *)
+  module BlockJacobi : sig (* {{{ *)
+
+    (** Functions that compute the diagonal blocks of the Jacobian. In the
+        call [block_jac_fn jac b jm], [jac] is a {!jacobian_arg} with no
+        work vectors, [b] is the index of a subvector, and [jm] is the
+        square dense matrix to fill with {% $J_{bb}$%}. The function is
+        called for every block when a new Jacobian is needed.
+
+        Raising {!Sundials.RecoverableFailure} indicates a recoverable
+        error. Any other exception is treated as an unrecoverable error.
+
+        {warning Neither the elements of [jac] nor the matrix [jm] should
+                 be accessed after the function has returned.} *)
+    type 'd block_jac_fn = (unit, 'd) jacobian_arg -> int -> Matrix.Dense.t
+                           -> unit
+
+    (** A block-Jacobi {!preconditioner} for many-vectors. The call
+        [prec_left ~jac ()] instantiates a left preconditioner whose
+        diagonal blocks are given by [jac]. By default, they are computed
+        by difference quotients, which costs one evaluation of the
+        right-hand side function per unknown.
+
+        @raise Invalid_argument The nvector is not a many-vector or one of
+                                its subvectors does not have an array
+                                payload.
+        @raise Config.NotImplementedBySundialsVersion Block-Jacobi
+               preconditioners require Sundials >= 5.0.0
+        @cvode CVodeSetPreconditioner *)
+    val prec_left : ?jac:'d block_jac_fn -> unit -> ('d, 'k) preconditioner
+
+    (** Like {!prec_left} but preconditions from the right.
+
+        @cvode CVodeSetPreconditioner *)
+    val prec_right : ?jac:'d block_jac_fn -> unit -> ('d, 'k) preconditioner
+
+    (** Like {!prec_left} but preconditions from both sides.
+
+        @cvode CVodeSetPreconditioner *)
+    val prec_both : ?jac:'d block_jac_fn -> unit -> ('d, 'k) preconditioner
+
+    (** {4:stats Block-Jacobi statistics} *)
+
+    (** Returns the number of blocks (subvectors) of the preconditioner. *)
+    val get_num_blocks : ('d, 'k) session -> int
+
+    (** Returns the number of calls to the right-hand side callback for the
+        difference quotient approximation of the blocks. *)
+    val get_num_rhs_evals : ('d, 'k) session -> int
+  end (* }}} *)
+
   (** {3:lsolvers Solvers} *)
 
   (** Callback functions that preprocess or evaluate Jacobian-related data
@@ -577,6 +674,89 @@ val matrix_embedded_solver :
        (unit, 'data, 'kind, [>`MatE]) LinearSolver.t
     -> ('data, 'kind) linear_solver
 
+(** Automatic selection of a linear solver for serial problems.
+
+    The solver returned by {!Auto.solver} examines the Jacobian of the
+    right-hand side function at the initial condition, times the candidate
+    linear solvers that suit its structure on a representative system
+    {% $M = I - \gamma J$ %}, and installs the cheapest. Decisions may be
+    cached in a file so that later runs of the same model skip the
+    calibration. *)
+module Auto : sig (* {{{ *)
+
+  (** The linear solvers that may be selected. *)
+  type kind =
+    | Dense     (** {!LinearSolver.Direct.dense} with a difference-quotient
+                    Jacobian. *)
+    | Band      (** {!LinearSolver.Direct.band} with the detected bandwidths
+                    and a difference-quotient Jacobian. *)
+    | SparseLu  (** {!LinearSolver.Direct.SparseLu} with the given sparse
+                    Jacobian function. *)
+    | Klu       (** {!LinearSolver.Direct.Klu} with the given sparse
+                    Jacobian function. *)
+    | Spgmr     (** {!LinearSolver.Iterative.spgmr} without a
+                    preconditioner. *)
+
+  (** The outcome of a selection. The [costs] give the estimated time in
+      seconds of one Jacobian update followed by [solves_per_setup]
+      solves for each candidate that was timed; a candidate whose setup or
+      solves fail has an infinite cost, and one that the installed Sundials
+      does not provide is omitted. It is empty when the decision was read from a cache.
+      The bandwidths [mu] and [ml] are those used for [Band]. *)
+  type decision = {
+      kind       : kind;
+      mu         : int;
+      ml         : int;
+      costs      : (kind * float) list;
+      from_cache : bool;
+    }
+
+  (** Returns the name used for a kind in cache files. *)
+  val string_of_kind : kind -> string
+
+  (** Creates a linear solver that selects one of the [candidates] (by
+      default, all of them) when the session is created. Candidates that do
+      not fit the problem are skipped:
+      - [Dense] needs at most [max_probe] equations (default 500),
+      - [Band] needs a bandwidth {% $\mathtt{mu} + \mathtt{ml} + 1 < n$ %},
+      - [SparseLu] and [Klu] need a [sparse_jac] function, given with the
+        number of nonzeros it produces, and [Klu] also needs
+        {{!Sundials_Config.klu_enabled}Config.klu_enabled}.
+
+      The structure of the Jacobian is taken from [sparse_jac] when it is
+      given, or otherwise from a difference-quotient approximation when
+      there are at most [max_probe] equations. Larger systems without a
+      sparse Jacobian function use [Spgmr], which is also the fallback
+      when no candidate applies. The approximation is made at the initial
+      state and at a nearby perturbed state, so that entries that vanish
+      initially still count towards the bandwidths.
+
+      Each candidate is timed [reps] times (default 3) on wall-clock time
+      and the best time is kept. Its cost counts the Jacobian evaluation,
+      one setup, and [solves_per_setup] solves (default 20).
+
+      If [cache] names a file, decisions are appended to it and looked up
+      before calibrating. The key is the [model] name and system size if
+      [model] is given, which avoids probing entirely on a hit, and
+      otherwise the size, bandwidths, and sparsity pattern of the probed
+      Jacobian. The [on_decision] function is called with every decision.
+
+      Only the initial state (and its neighbourhood) is examined: the
+      choice is not revised when the Jacobian changes during integration. *)
+  val solver :
+       ?cache:string
+    -> ?model:string
+    -> ?candidates:kind list
+    -> ?sparse_jac:(Matrix.Sparse.csc Matrix.Sparse.t Dls.jac_fn * int)
+    -> ?max_probe:int
+    -> ?solves_per_setup:int
+    -> ?reps:int
+    -> ?on_decision:(decision -> unit)
+    -> unit
+    -> 'kind serial_linear_solver
+
+end (* }}} *)
+
 (** {2:tols Tolerances} *)
 
 (** Functions that set the multiplicative error weights for use in the weighted
@@ -806,6 +986,92 @@ val reinit :
   -> ('d, 'k) Nvector.t
   -> unit
 
+(** Pools of sessions for workloads that solve many small problems.
+
+    Creating a session allocates the solver memory, the linear solver, its
+    matrix, and their OCaml wrappers. When many short problems with the
+    same structure are solved in turn, this can dominate the run time. A
+    pool keeps released sessions, grouped by a user-defined key that
+    describes the structure of a problem (for example, its size, the
+    kinds of its linear solver and matrix, and its tolerances), and
+    returns them, reinitialized with {!reinit}, for subsequent problems
+    with the same key. Their memory, linear solvers, and matrices are thus
+    reused.
+
+    Reinitialization resets the integration counters and the state, but
+    not the optional inputs (the [set_*] functions). The creation function
+    should set any that are required, and problems should not change those
+    that are not common to all problems with the same key.
+
+    Pools are not thread-safe.
+
+    @cvode CVodeReInit *)
+module Pool : sig (* {{{ *)
+
+  (** A pool of sessions with keys of type ['key]. *)
+  type ('key, 'd, 'k) t
+
+  (** Creates a pool. The function [make key t0 y0] must create a session
+      for a problem with the structure described by [key], initialized at
+      [t0] with [y0]. At most [max_idle] released sessions are kept in
+      the pool (the default is 64); others are left to the garbage
+      collector. *)
+  val create :
+       ?max_idle:int
+    -> ('key -> float -> ('d, 'k) Nvector.t -> ('d, 'k) session)
+    -> ('key, 'd, 'k) t
+
+  (** [acquire p key t0 y0] returns a session for a problem with the given
+      key, initialized at [t0] with [y0]. A released session with the same
+      key is reinitialized if possible, otherwise a new one is created.
+      The [roots] and [rhsfn] arguments are as for {!reinit} and replace
+      those of the session. The pool does not keep acquired sessions
+      alive: one that is never released is left to the garbage
+      collector.  *)
+  val acquire :
+       ('key, 'd, 'k) t
+    -> 'key
+    -> ?roots:(int * 'd rootsfn)
+    -> ?rhsfn:'d rhsfn
+    -> float
+    -> ('d, 'k) Nvector.t
+    -> ('d, 'k) session
+
+  (** Returns a session obtained from {!acquire} with the given key to the
+      pool. The session must not be used afterward.
+
+      @raise Invalid_argument The session was not acquired from the pool,
+                              was acquired with another key, or has
+                              already been released. *)
+  val release : ('key, 'd, 'k) t -> 'key -> ('d, 'k) session -> unit
+
+  (** [with_session p key t0 y0 f] acquires a session, applies [f] to it,
+      and releases it, even if [f] raises an exception. *)
+  val with_session :
+       ('key, 'd, 'k) t
+    -> 'key
+    -> ?roots:(int * 'd rootsfn)
+    -> ?rhsfn:'d rhsfn
+    -> float
+    -> ('d, 'k) Nvector.t
+    -> (('d, 'k) session -> 'a)
+    -> 'a
+
+  (** Drops all the released sessions. *)
+  val clear : ('key, 'd, 'k) t -> unit
+
+  (** Usage statistics of a pool. *)
+  type stats = {
+      num_created : int;  (** Number of sessions created. *)
+      num_reused : int;   (** Number of sessions reinitialized. *)
+      num_idle : int;     (** Number of sessions held in the pool. *)
+    }
+
+  (** Returns the usage statistics of a pool. *)
+  val get_stats : ('key, 'd, 'k) t -> stats
+
+end (* }}} *)
+
 (** {2:set Modifying the solver (optional input functions)} *)
 
 (** Sets the integration tolerances.
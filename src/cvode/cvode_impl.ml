@@ -149,6 +149,24 @@ module CvodeBbdTypes = struct
     }
 end
 
+module BlockJacobiTypes = struct
+  type 'a block_jac_fn =
+    (unit, 'a) jacobian_arg
+    -> int
+    -> Matrix.Dense.t
+    -> unit
+
+  type cptr
+
+  (* These fields are accessed from cvode_ml.c *)
+  type 'a precfns =
+    {
+      block_cptr     : cptr;
+      block_jac_fn   : 'a block_jac_fn option;
+      block_matrices : Matrix.Dense.t array;
+    }
+end
+
 (* Sensitivity *)
 
 module QuadratureTypes = struct
@@ -522,6 +540,8 @@ and 'a linsolv_precfns =
   | BBDPrecFns of 'a CvodeBbdParamTypes.precfns
   | BBBDPrecFns of 'a CvodesBbdParamTypes.precfns
 
+  | BlockJacobiPrecFns of 'a BlockJacobiTypes.precfns
+
 and ('a, 'kind) sensext =
     NoSensExt
   | FwdSensExt of ('a, 'kind) fsensext
@@ -614,6 +634,12 @@ let ls_check_spils_band session =
     | BandedPrecFns -> ()
     | _ -> raise LinearSolver.InvalidLinearSolver
 
+let ls_check_spils_block_jacobi session =
+  if Sundials_configuration.safe then
+    match session.ls_precfns with
+    | BlockJacobiPrecFns _ -> ()
+    | _ -> raise LinearSolver.InvalidLinearSolver
+
 let ls_check_spils_bbd session =
   if Sundials_configuration.safe then
     match session.ls_precfns with
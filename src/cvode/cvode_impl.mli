@@ -63,6 +63,17 @@ module CvodeBbdTypes :
   sig
     type bandwidths = { mudq : int; mldq : int; mukeep : int; mlkeep : int; }
   end
+module BlockJacobiTypes :
+  sig
+    type 'a block_jac_fn =
+        (unit, 'a) jacobian_arg -> int -> Matrix.Dense.t -> unit
+    type cptr
+    type 'a precfns = {
+      block_cptr : cptr;
+      block_jac_fn : 'a block_jac_fn option;
+      block_matrices : Matrix.Dense.t array;
+    }
+  end
 module QuadratureTypes :
   sig type 'a quadrhsfn = float -> 'a -> 'a -> unit end
 module SensitivityTypes :
@@ -289,6 +300,7 @@ and 'a linsolv_precfns =
   | BandedPrecFns
   | BBDPrecFns of 'a CvodeBbdParamTypes.precfns
   | BBBDPrecFns of 'a CvodesBbdParamTypes.precfns
+  | BlockJacobiPrecFns of 'a BlockJacobiTypes.precfns
 and ('a, 'kind) sensext =
     NoSensExt
   | FwdSensExt of ('a, 'kind) fsensext
@@ -327,6 +339,7 @@ val ls_check_direct : ('a, 'b) session -> unit
 val ls_check_spils : ('a, 'b) session -> unit
 val ls_check_spils_band : ('a, 'b) session -> unit
 val ls_check_spils_bbd : ('a, 'b) session -> unit
+val ls_check_spils_block_jacobi : ('a, 'b) session -> unit
 type 'a serial_session = (Nvector_serial.data, 'a) session
   constraint 'a = [> Nvector_serial.kind ]
 type ('data, 'kind) linear_solver =
@@ -862,6 +862,378 @@ CAMLprim value sunml_cvode_set_banded_preconditioner (value vsession,
     CAMLreturn (Val_unit);
 }
 
+/* The step size of the step being attempted (cv_h), for the increments of
+   difference quotient Jacobians.  CVodeGetCurrentStep gives the step size
+   to try next, which differs from cv_h after a failed step.  CVODE sets
+   gamma = h * rl1 before solving the nonlinear system, so h is recovered
+   from them; older versions fall back to CVodeGetCurrentStep.  */
+static int cvode_dq_step(void *cvode_mem, sunrealtype *h)
+{
+#if 540 <= SUNDIALS_LIB_VERSION
+    sunrealtype tn, gamma, rl1;
+    N_Vector ypred, yn, fn, zn1;
+    void *user_data;
+    int flag;
+
+    flag = CVodeGetNonlinearSystemData(cvode_mem, &tn, &ypred, &yn, &fn,
+				       &gamma, &rl1, &zn1, &user_data);
+    if (flag != CV_SUCCESS) return flag;
+    if (rl1 != 0.0) {
+	*h = gamma / rl1;
+	return CV_SUCCESS;
+    }
+#endif
+    return CVodeGetCurrentStep(cvode_mem, h);
+}
+
+/* Block-Jacobi preconditioner for many-vectors
+ *
+ * Each subvector of a many-vector is treated as one block of unknowns and
+ * the preconditioner is the block diagonal part of the Newton matrix,
+ * P = diag(I - gamma J_bb).  The Jacobian blocks are held in OCaml
+ * (BlockJacobiTypes.precfns.block_matrices) and computed either by a user
+ * callback or by difference quotients over the columns of each block.
+ * The factors of the blocks are held in C, and the solves only read them:
+ * no OCaml code is run when the preconditioner is applied.  With OpenMP,
+ * the blocks are factored and solved in parallel.  */
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <string.h>
+#include <nvector/nvector_manyvector.h>
+#include <sundials/sundials_dense.h>
+#include <sundials/sundials_math.h>
+
+#if SUNDIALS_LIB_VERSION < 600
+#define SUNDlsMat_denseGETRS denseGETRS
+#define SUN_UNIT_ROUNDOFF UNIT_ROUNDOFF
+#endif
+
+struct blockjac {
+    sunindextype nblocks;
+    sunindextype *sizes;
+    sunrealtype **jac;		/* payloads of the block_matrices */
+    sunrealtype **lu;		/* factors of I - gamma J_bb */
+    sunrealtype ***cols;	/* column pointers into lu */
+    sunindextype **pivots;
+    sunrealtype **rdata;	/* subvector data for a solve */
+    sunrealtype **zdata;
+    N_Vector ytemp;		/* for difference quotients, on demand */
+    N_Vector ftemp;
+    N_Vector ewt;
+    long int num_rhs_evals;
+};
+
+#define BLOCKJAC(v) (*(struct blockjac **)Data_custom_val(v))
+
+static void free_blockjac(struct blockjac *bj)
+{
+    sunindextype b;
+
+    if (bj == NULL) return;
+
+    for (b = 0; b < bj->nblocks; b++) {
+	if (bj->lu != NULL) free(bj->lu[b]);
+	if (bj->cols != NULL) free(bj->cols[b]);
+	if (bj->pivots != NULL) free(bj->pivots[b]);
+    }
+    free(bj->sizes);
+    free(bj->jac);
+    free(bj->lu);
+    free(bj->cols);
+    free(bj->pivots);
+    free(bj->rdata);
+    free(bj->zdata);
+    if (bj->ytemp != NULL) N_VDestroy(bj->ytemp);
+    if (bj->ftemp != NULL) N_VDestroy(bj->ftemp);
+    if (bj->ewt != NULL) N_VDestroy(bj->ewt);
+    free(bj);
+}
+
+static void finalize_blockjac(value vbj)
+{
+    free_blockjac(BLOCKJAC(vbj));
+}
+
+static int blockjac_subvector_ok(N_Vector v)
+{
+    return (v != NULL && v->ops->nvgetarraypointer != NULL
+	    && N_VGetArrayPointer(v) != NULL);
+}
+
+/* The caller must not trigger a GC between this call and the use of the
+   pointers.  */
+static void blockjac_subvector_data(struct blockjac *bj, N_Vector v,
+				    sunrealtype **data)
+{
+    sunindextype b;
+
+    for (b = 0; b < bj->nblocks; b++)
+	data[b] = N_VGetArrayPointer(N_VGetSubvector_ManyVector(v, b));
+}
+
+static int blockjac_dq(struct blockjac *bj, void *cvode_mem,
+		       sunrealtype t, N_Vector y, N_Vector fy, void *user_data)
+{
+    sunrealtype srur, fnorm, min_inc, inc, inc_inv, yj, h;
+    sunrealtype *yb, *ytb, *fyb, *ftb, *ewb, *jb;
+    sunindextype b, i, j, nb;
+    int r;
+
+    if (bj->ytemp == NULL) {
+	bj->ytemp = N_VClone(y);
+	bj->ftemp = N_VClone(y);
+	bj->ewt = N_VClone(y);
+	if (bj->ytemp == NULL || bj->ftemp == NULL || bj->ewt == NULL)
+	    return -1;
+    }
+
+    if (CVodeGetErrWeights(cvode_mem, bj->ewt) != CV_SUCCESS
+	    || cvode_dq_step(cvode_mem, &h) != CV_SUCCESS)
+	return -1;
+
+    /* Increments as in cvBandPrecDQJac */
+    N_VScale(1.0, y, bj->ytemp);
+    fnorm = N_VWrmsNorm(fy, bj->ewt);
+    srur = SUNRsqrt(SUN_UNIT_ROUNDOFF);
+    min_inc = (fnorm != 0.0)
+	? (1000.0 * SUNRabs(h) * SUN_UNIT_ROUNDOFF * N_VGetLength(y) * fnorm)
+	: 1.0;
+
+    for (b = 0; b < bj->nblocks; b++) {
+	nb = bj->sizes[b];
+	for (j = 0; j < nb; j++) {
+	    /* the rhs callback may trigger a GC: reload the data pointers */
+	    ytb = N_VGetArrayPointer(N_VGetSubvector_ManyVector(bj->ytemp, b));
+	    yb  = N_VGetArrayPointer(N_VGetSubvector_ManyVector(y, b));
+	    ewb = N_VGetArrayPointer(N_VGetSubvector_ManyVector(bj->ewt, b));
+
+	    yj = yb[j];
+	    inc = SUNMAX(srur * SUNRabs(yj), min_inc / ewb[j]);
+	    ytb[j] = yj + inc;
+
+	    r = rhsfn(t, bj->ytemp, bj->ftemp, user_data);
+	    bj->num_rhs_evals++;
+	    if (r != 0) return r;
+
+	    ytb = N_VGetArrayPointer(N_VGetSubvector_ManyVector(bj->ytemp, b));
+	    ftb = N_VGetArrayPointer(N_VGetSubvector_ManyVector(bj->ftemp, b));
+	    fyb = N_VGetArrayPointer(N_VGetSubvector_ManyVector(fy, b));
+	    ytb[j] = yj;
+
+	    jb = bj->jac[b] + j * nb;
+	    inc_inv = 1.0 / inc;
+	    for (i = 0; i < nb; i++) jb[i] = (ftb[i] - fyb[i]) * inc_inv;
+	}
+    }
+
+    return 0;
+}
+
+static int blockjac_user(value session, value vprec, struct blockjac *bj,
+			 sunrealtype t, N_Vector y, N_Vector fy)
+{
+    CAMLparam2(session, vprec);
+    CAMLlocal3(vjac, varg, vfn);
+    sunindextype b;
+    int r;
+
+    varg = sunml_cvode_make_jac_arg(t, y, fy, Val_unit);
+    vfn = Some_val(Field(vprec, RECORD_CVODE_BLOCKJAC_PRECFNS_JAC_FN));
+
+    for (b = 0; b < bj->nblocks; b++) {
+	vjac = Field(Field(vprec, RECORD_CVODE_BLOCKJAC_PRECFNS_MATRICES), b);
+
+	/* NB: Don't trigger GC while processing this return value!  */
+	value rv = caml_callback3_exn(vfn, varg, Val_long(b), vjac);
+	r = CHECK_EXCEPTION(session, rv, RECOVERABLE);
+	if (r != 0) CAMLreturnT(int, r);
+    }
+
+    CAMLreturnT(int, 0);
+}
+
+/* Returns 0 or 1 (recoverable) if a block is singular.  */
+static int blockjac_factor(struct blockjac *bj, sunrealtype gamma)
+{
+    sunindextype b, k, nb;
+    int fail = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(k, nb) reduction(|:fail) schedule(dynamic)
+#endif
+    for (b = 0; b < bj->nblocks; b++) {
+	nb = bj->sizes[b];
+	for (k = 0; k < nb * nb; k++) bj->lu[b][k] = -gamma * bj->jac[b][k];
+	for (k = 0; k < nb; k++) bj->lu[b][k * nb + k] += 1.0;
+	if (sunml_dense_getrf(bj->cols[b], nb, nb, bj->pivots[b]) != 0)
+	    fail |= 1;
+    }
+
+    return fail;
+}
+
+static int blockjac_setupfn(sunrealtype t,
+			    N_Vector y,
+			    N_Vector fy,
+			    sunbooleantype jok,
+			    sunbooleantype *jcurPtr,
+			    sunrealtype gamma,
+			    void *user_data)
+{
+    CAMLparam0();
+    CAMLlocal3(session, vprec, vmats);
+    struct blockjac *bj;
+    sunindextype b;
+    int r;
+
+    WEAK_DEREF (session, *(value*)user_data);
+    vprec = Field(CVODE_LS_PRECFNS_FROM_ML(session), 0);
+    bj = BLOCKJAC(Field(vprec, RECORD_CVODE_BLOCKJAC_PRECFNS_CPTR));
+
+    vmats = Field(vprec, RECORD_CVODE_BLOCKJAC_PRECFNS_MATRICES);
+    for (b = 0; b < bj->nblocks; b++)
+	bj->jac[b] = REAL_ARRAY(Field(Field(vmats, b),
+				      RECORD_MAT_MATRIXCONTENT_PAYLOAD));
+
+    if (jok) {
+	*jcurPtr = SUNFALSE;
+    } else {
+	r = Is_block(Field(vprec, RECORD_CVODE_BLOCKJAC_PRECFNS_JAC_FN))
+	    ? blockjac_user(session, vprec, bj, t, y, fy)
+	    : blockjac_dq(bj, CVODE_MEM_FROM_ML(session), t, y, fy, user_data);
+	if (r != 0) CAMLreturnT(int, r);
+	*jcurPtr = SUNTRUE;
+    }
+
+    CAMLreturnT(int, blockjac_factor(bj, gamma));
+}
+
+static int blockjac_solvefn(sunrealtype t,
+			    N_Vector y,
+			    N_Vector fy,
+			    N_Vector rvec,
+			    N_Vector z,
+			    sunrealtype gamma,
+			    sunrealtype delta,
+			    int lr,
+			    void *user_data)
+{
+    CAMLparam0();
+    CAMLlocal1(session);
+    struct blockjac *bj;
+    sunindextype b;
+
+    WEAK_DEREF (session, *(value*)user_data);
+    bj = BLOCKJAC(Field(Field(CVODE_LS_PRECFNS_FROM_ML(session), 0),
+			RECORD_CVODE_BLOCKJAC_PRECFNS_CPTR));
+
+    blockjac_subvector_data(bj, rvec, bj->rdata);
+    blockjac_subvector_data(bj, z, bj->zdata);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (b = 0; b < bj->nblocks; b++) {
+	if (bj->zdata[b] != bj->rdata[b])
+	    memcpy(bj->zdata[b], bj->rdata[b],
+		   bj->sizes[b] * sizeof(sunrealtype));
+	SUNDlsMat_denseGETRS(bj->cols[b], bj->sizes[b], bj->pivots[b],
+			     bj->zdata[b]);
+    }
+
+    CAMLreturnT(int, 0);
+}
+#endif
+
+CAMLprim value sunml_cvode_blockjac_init(value vnv)
+{
+    CAMLparam1(vnv);
+    CAMLlocal2(vr, vsizes);
+#if 500 <= SUNDIALS_LIB_VERSION
+    N_Vector nv = NVEC_VAL(vnv);
+    struct blockjac *bj;
+    sunindextype b, k, nb, nblocks;
+    N_Vector sv;
+
+    if (N_VGetVectorID(nv) != SUNDIALS_NVEC_MANYVECTOR)
+	caml_invalid_argument("Block-Jacobi preconditioner: "
+			      "a many-vector is required");
+
+    nblocks = N_VGetNumSubvectors_ManyVector(nv);
+    for (b = 0; b < nblocks; b++) {
+	sv = N_VGetSubvector_ManyVector(nv, b);
+	if (!blockjac_subvector_ok(sv))
+	    caml_invalid_argument("Block-Jacobi preconditioner: "
+				  "subvectors must have array payloads");
+    }
+
+    bj = calloc(1, sizeof(struct blockjac));
+    if (bj == NULL) caml_raise_out_of_memory();
+    bj->nblocks = nblocks;
+    bj->sizes  = calloc(nblocks, sizeof(sunindextype));
+    bj->jac    = calloc(nblocks, sizeof(sunrealtype *));
+    bj->lu     = calloc(nblocks, sizeof(sunrealtype *));
+    bj->cols   = calloc(nblocks, sizeof(sunrealtype **));
+    bj->pivots = calloc(nblocks, sizeof(sunindextype *));
+    bj->rdata  = calloc(nblocks, sizeof(sunrealtype *));
+    bj->zdata  = calloc(nblocks, sizeof(sunrealtype *));
+    if (bj->sizes == NULL || bj->jac == NULL || bj->lu == NULL
+	    || bj->cols == NULL || bj->pivots == NULL
+	    || bj->rdata == NULL || bj->zdata == NULL) {
+	free_blockjac(bj);
+	caml_raise_out_of_memory();
+    }
+
+    for (b = 0; b < nblocks; b++) {
+	nb = N_VGetLength(N_VGetSubvector_ManyVector(nv, b));
+	bj->sizes[b] = nb;
+	bj->lu[b] = malloc(nb * nb * sizeof(sunrealtype));
+	bj->cols[b] = malloc(nb * sizeof(sunrealtype *));
+	bj->pivots[b] = malloc(nb * sizeof(sunindextype));
+	if (bj->lu[b] == NULL || bj->cols[b] == NULL || bj->pivots[b] == NULL) {
+	    free_blockjac(bj);
+	    caml_raise_out_of_memory();
+	}
+	for (k = 0; k < nb; k++) bj->cols[b][k] = bj->lu[b] + k * nb;
+    }
+
+    vsizes = caml_alloc_tuple(nblocks);
+    for (b = 0; b < nblocks; b++)
+	Store_field(vsizes, b, Val_long(bj->sizes[b]));
+
+    vr = caml_alloc_tuple(2);
+    Store_field(vr, 0, caml_alloc_final(1, &finalize_blockjac, 1, 20));
+    BLOCKJAC(Field(vr, 0)) = bj;
+    Store_field(vr, 1, vsizes);
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn(vr);
+}
+
+CAMLprim value sunml_cvode_set_blockjac_preconditioner(value vsession)
+{
+    CAMLparam1(vsession);
+#if 500 <= SUNDIALS_LIB_VERSION
+    int flag = CVodeSetPreconditioner(CVODE_MEM_FROM_ML(vsession),
+				      blockjac_setupfn, blockjac_solvefn);
+    CHECK_LS_FLAG ("CVodeSetPreconditioner", flag);
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn (Val_unit);
+}
+
+CAMLprim value sunml_cvode_blockjac_get_num_rhs_evals(value vbj)
+{
+    CAMLparam1(vbj);
+    long int r = 0;
+#if 500 <= SUNDIALS_LIB_VERSION
+    r = BLOCKJAC(vbj)->num_rhs_evals;
+#endif
+    CAMLreturn(Val_long(r));
+}
+
 CAMLprim value sunml_cvode_set_jac_times(value vdata, value vhas_setup,
 					 value vhas_times)
 {
@@ -1804,6 +2176,19 @@ CAMLprim value sunml_cvode_get_current_step(value vcvode_mem)
     CAMLreturn(caml_copy_double(v));
 }
 
+CAMLprim value sunml_cvode_get_dq_step(value vcvode_mem)
+{
+    CAMLparam1(vcvode_mem);
+
+    int flag;
+    sunrealtype v;
+
+    flag = cvode_dq_step(CVODE_MEM_FROM_ML(vcvode_mem), &v);
+    CHECK_FLAG("CVodeGetNonlinearSystemData", flag);
+
+    CAMLreturn(caml_copy_double(v));
+}
+
 CAMLprim value sunml_cvode_get_current_time(value vcvode_mem)
 {
     CAMLparam1(vcvode_mem);
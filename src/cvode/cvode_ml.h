@@ -233,6 +233,13 @@ enum cvode_bbd_precfns_index {
   RECORD_CVODE_BBD_PRECFNS_SIZE
 };
 
+enum cvode_blockjac_precfns_index {
+  RECORD_CVODE_BLOCKJAC_PRECFNS_CPTR = 0,
+  RECORD_CVODE_BLOCKJAC_PRECFNS_JAC_FN,
+  RECORD_CVODE_BLOCKJAC_PRECFNS_MATRICES,
+  RECORD_CVODE_BLOCKJAC_PRECFNS_SIZE
+};
+
 enum cvode_lmm_tag {
   VARIANT_CVODE_LMM_ADAMS = 0,
   VARIANT_CVODE_LMM_BDF,
@@ -2027,6 +2027,39 @@ module Adjoint : sig (* {{{ *)
       @cvodes_adj CVodeB (CV_ONE_STEP) *)
   val backward_one_step : ('d, 'k) Cvode.session -> float -> unit
 
+  (** Runs independent backward problems concurrently. Each job is called
+      with the forward session in a separate worker process, forked after
+      the forward integration, where it typically creates its own backward
+      problems with {!init_backward}, integrates them with
+      {!backward_normal}, and returns a gradient. Jobs thus read the
+      checkpoints of the forward problem concurrently, each in its own
+      copy, and do not see one another's backward problems. Their results
+      are returned in order.
+
+      Sundials integrates all the backward problems of a session in lockstep
+      and reintegrates the forward problem between checkpoints, so this is
+      the way to spread multiple objective functionals over several cores.
+      At most [num_workers] processes run at once (the default is the
+      number of online processors). Backward problems created before the
+      call are integrated by every job that calls {!backward_normal}.
+
+      A job runs with a copy of the program state: its side effects are
+      not visible to the caller, and its result must be a value that can
+      be marshalled (e.g., arrays of floats, but not nvectors or
+      closures).
+      If a job raises an exception, this function raises [Failure] with
+      its description after all the jobs have finished.
+
+      Worker processes are created with [fork], which most MPI
+      implementations do not support: this function must not be used
+      in a program that has called [MPI_Init]. It is not available on
+      Windows. *)
+  val backward_concurrent :
+       ?num_workers:int
+    -> ('d, 'k) Cvode.session
+    -> (('d, 'k) Cvode.session -> 'r) array
+    -> 'r array
+
   (** Fills the given vector with the solution of the backward ODE problem at
       the returned time, interpolating if necessary.
 
@@ -2269,6 +2302,76 @@ module Adjoint : sig (* {{{ *)
       @return ([nniters], [nncfails]) *)
   val get_nonlin_solv_stats : ('d, 'k) bsession -> int *int
 
+  (** {2:revolve Checkpointing under a memory budget} *)
+
+  (** Limits the number of forward states stored by {!backward_revolve},
+      either directly or as a number of bytes. *)
+  type revolve_budget = Sundials_impl.Revolve.budget =
+    | Snapshots of int  (** At most this many snapshots. *)
+    | Bytes of int      (** Snapshots occupying at most this many bytes. *)
+
+  (** Statistics of a call to {!backward_revolve}. *)
+  type revolve_stats = Sundials_impl.Revolve.stats = {
+      num_segments : int;       (** Number of segments. *)
+      num_snapshots : int;      (** Number of snapshots used. *)
+      num_advances : int;       (** Number of segments integrated without
+                                    recording checkpoints. *)
+      num_forward_steps : int;  (** Total number of forward steps. *)
+      num_taped_steps : int;    (** Number of forward steps taken while
+                                    recording checkpoints, i.e., those of a
+                                    single forward integration. *)
+      recomputation_ratio : float;
+        (** [num_forward_steps / num_taped_steps]. *)
+    }
+
+  (** A backward problem integrated by {!backward_revolve}: its session,
+      a vector holding its state, and, optionally, a vector holding its
+      quadrature variables. Both vectors are updated at the end of each
+      segment. *)
+  type ('d, 'k) revolve_backward = {
+      rev_bsession : ('d, 'k) bsession;
+      rev_yb : ('d, 'k) Nvector.t;
+      rev_yqb : ('d, 'k) Nvector.t option;
+    }
+
+  (** Solves the forward and backward problems with a bounded number of
+      stored forward states.
+      [backward_revolve s budget times y0 init] splits the forward
+      integration from [times.(0)] to [times.(L)] into the [L] segments
+      between consecutive elements of the strictly increasing array
+      [times]. The forward problem is integrated from the initial
+      value at [times.(0)] while storing the states at some segment
+      boundaries (snapshots), and the segments are then reversed in turn,
+      from last to first: each is reintegrated from the nearest preceding
+      snapshot, recording the checkpoints of the adjoint module, and the
+      backward problems are integrated over it.
+      The first time that a segment is reversed, [init times.(L)] must
+      create the backward problems with {!init_backward} and return
+      them. They are reinitialized with the values of their vectors at the
+      start of each subsequent segment.
+
+      Snapshots are taken according to the binomial schedule of
+      Griewank and Walther's Revolve algorithm, which minimizes the number
+      of segments that must be reintegrated for the given number of
+      snapshots. The number of forward steps thus grows only
+      logarithmically with the number of segments for a fixed budget,
+      which allows long horizons to be reversed in bounded memory. The
+      checkpoints within a segment are managed by Sundials, as set by the
+      argument [nd] of {!init}, which must have been called. Forward
+      sensitivities are not supported.
+
+      @cvodes_adj CVodeAdjReInit
+      @cvodes_adj CVodeReInitB
+      @raise Invalid_argument [times] has less than two elements or the
+                              budget does not allow a single snapshot. *)
+  val backward_revolve :
+       ('d, 'k) Cvode.session
+    -> revolve_budget
+    -> float array
+    -> ('d, 'k) Nvector.t
+    -> (float -> ('d, 'k) revolve_backward list)
+    -> revolve_stats
+
   (** {2:exceptions Exceptions} *)
 
   (** Adjoint sensitivity analysis was not initialized.
@@ -2855,6 +2855,16 @@ CAMLprim value sunml_cvodes_adj_init(value vdata, value vnd, value vinterptype)
     CAMLreturn (Val_unit);
 }
 
+CAMLprim value sunml_cvodes_adj_adj_reinit(value vdata)
+{
+    CAMLparam1(vdata);
+
+    int flag = CVodeAdjReInit(CVODE_MEM_FROM_ML(vdata));
+    SCHECK_FLAG("CVodeAdjReInit", flag);
+
+    CAMLreturn (Val_unit);
+}
+
 CAMLprim value sunml_cvodes_adj_ss_tolerances(value vparent, value vwhich,
 					  value vreltol, value vabstol)
 {
@@ -233,10 +233,22 @@ module Dls = struct (* {{{ *)
         session.ls_callbacks <- DlsDenseCallback cb
     | LSI.LapackDense ->
         session.ls_callbacks <- DlsDenseCallback cb
+    | LSI.MixedDense ->
+        session.ls_callbacks <- DlsDenseCallback cb
     | LSI.Band ->
         session.ls_callbacks <- DlsBandCallback cb
     | LSI.LapackBand ->
         session.ls_callbacks <- DlsBandCallback cb
+    | LSI.MixedBand ->
+        session.ls_callbacks <- DlsBandCallback cb
+    | LSI.SpikeBand ->
+        session.ls_callbacks <- DlsBandCallback cb
+    | LSI.SparseLu ->
+        if jac = None then invalid_arg "SparseLu requires Jacobian function";
+        session.ls_callbacks <- DirectCustomCallback cb
+    | LSI.ReorderedBand ->
+        if jac = None then invalid_arg "Reordered requires Jacobian function";
+        session.ls_callbacks <- DirectCustomCallback cb
     | LSI.Klu _ ->
         if jac = None then invalid_arg "Klu requires Jacobian function";
         session.ls_callbacks <- SlsKluCallback cb
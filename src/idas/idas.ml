@@ -794,6 +794,9 @@ module Adjoint = struct (* {{{ *)
   external backward_one_step : ('a, 'k) session -> float -> unit
       = "sunml_idas_adj_backward_one_step"
 
+  let backward_concurrent ?num_workers s jobs =
+    Sundials_impl.Workers.run ?num_workers (Array.map (fun f () -> f s) jobs)
+
   external c_get : ('a, 'k) session -> int
                    -> ('a, 'k) Nvector.t -> ('a, 'k) Nvector.t -> float
       = "sunml_idas_adj_get"
@@ -1020,6 +1023,14 @@ module Adjoint = struct (* {{{ *)
                 BDlsDenseCallback { jacfn = f; jmat = none }
             | Some (WithSens f) ->
                 BDlsDenseCallbackSens { jacfn_sens = f; jmat = none })
+      | LSI.MixedDense ->
+          session.ls_callbacks <- (match jac with
+            | None ->
+                BDlsDenseCallback { jacfn = no_callback; jmat = none }
+            | Some (NoSens f) ->
+                BDlsDenseCallback { jacfn = f; jmat = none }
+            | Some (WithSens f) ->
+                BDlsDenseCallbackSens { jacfn_sens = f; jmat = none })
       | LSI.Band ->
           session.ls_callbacks <- (match jac with
             | None ->
@@ -1036,6 +1047,36 @@ module Adjoint = struct (* {{{ *)
                 BDlsBandCallback { jacfn = f; jmat = none }
             | Some (WithSens f) ->
                 BDlsBandCallbackSens { jacfn_sens = f; jmat = none })
+      | LSI.MixedBand ->
+          session.ls_callbacks <- (match jac with
+            | None ->
+                BDlsBandCallback { jacfn = no_callback; jmat = none }
+            | Some (NoSens f) ->
+                BDlsBandCallback { jacfn = f; jmat = none }
+            | Some (WithSens f) ->
+                BDlsBandCallbackSens { jacfn_sens = f; jmat = none })
+      | LSI.SpikeBand ->
+          session.ls_callbacks <- (match jac with
+            | None ->
+                BDlsBandCallback { jacfn = no_callback; jmat = none }
+            | Some (NoSens f) ->
+                BDlsBandCallback { jacfn = f; jmat = none }
+            | Some (WithSens f) ->
+                BDlsBandCallbackSens { jacfn_sens = f; jmat = none })
+      | LSI.SparseLu ->
+          session.ls_callbacks <- (match jac with
+            | None -> invalid_arg "SparseLu requires Jacobian function";
+            | Some (NoSens f) ->
+                BDirectCustomCallback { jacfn = f; jmat = none }
+            | Some (WithSens f) ->
+                BDirectCustomCallbackSens { jacfn_sens = f; jmat = none })
+      | LSI.ReorderedBand ->
+          session.ls_callbacks <- (match jac with
+            | None -> invalid_arg "Reordered requires Jacobian function";
+            | Some (NoSens f) ->
+                BDirectCustomCallback { jacfn = f; jmat = none }
+            | Some (WithSens f) ->
+                BDirectCustomCallbackSens { jacfn_sens = f; jmat = none })
       | LSI.Klu _ ->
           session.ls_callbacks <- (match jac with
             | None -> invalid_arg "Klu requires Jacobian function";
@@ -1680,6 +1721,87 @@ module Adjoint = struct (* {{{ *)
 
     let get_stats bs = Quadrature.get_stats (tosession bs)
   end (* }}} *)
+
+  type revolve_budget = Sundials_impl.Revolve.budget =
+    | Snapshots of int
+    | Bytes of int
+
+  type revolve_stats = Sundials_impl.Revolve.stats = {
+      num_segments : int;
+      num_snapshots : int;
+      num_advances : int;
+      num_forward_steps : int;
+      num_taped_steps : int;
+      recomputation_ratio : float;
+    }
+
+  type ('d, 'k) revolve_backward = {
+      rev_bsession : ('d, 'k) bsession;
+      rev_yb : ('d, 'k) Nvector.t;
+      rev_yb' : ('d, 'k) Nvector.t;
+      rev_yqb : ('d, 'k) Nvector.t option;
+    }
+
+  external adj_reinit : ('a, 'k) session -> unit
+      = "sunml_idas_adj_adj_reinit"
+
+  let backward_revolve s budget times y0 y'0 init_backward =
+    let num_segments = Array.length times - 1 in
+    if num_segments < 1 then
+      invalid_arg "backward_revolve: at least two times are required";
+    if Sundials_configuration.safe then (s.checkvec y0; s.checkvec y'0);
+    let lrw, liw = Nvector.Ops.space y0 in
+    let num_snapshots =
+      Sundials_impl.Revolve.num_snapshots budget
+        ~snapshot_bytes:(16 * (lrw + liw)) ~num_segments
+    in
+    let snapshots =
+      Array.init num_snapshots (fun _ -> Nvector.clone y0, Nvector.clone y'0)
+    in
+    let y = Nvector.clone y0 and y' = Nvector.clone y'0 in
+    let store_state (sy, sy') =
+      Nvector.Ops.scale 1.0 y sy;
+      Nvector.Ops.scale 1.0 y' sy'
+    in
+    Nvector.Ops.scale 1.0 y0 (fst snapshots.(0));
+    Nvector.Ops.scale 1.0 y'0 (snd snapshots.(0));
+    let bps = ref [] in
+    let restore k i =
+      let sy, sy' = snapshots.(k) in
+      Ida.reinit s times.(i) sy sy'
+    in
+    let advance i j =
+      ignore (Ida.solve_normal s times.(j) y y');
+      let nst = Ida.get_num_steps s in
+      Ida.reinit s times.(j) y y';
+      nst
+    in
+    let store k = store_state snapshots.(k) in
+    let tape i =
+      adj_reinit s;
+      ignore (forward_normal s times.(i + 1) y y');
+      Ida.get_num_steps s
+    in
+    let reinit_backward i bp =
+      reinit bp.rev_bsession times.(i + 1) bp.rev_yb bp.rev_yb';
+      match bp.rev_yqb with
+      | Some yqb -> Quadrature.reinit bp.rev_bsession yqb
+      | None -> ()
+    in
+    let get_backward bp =
+      ignore (get bp.rev_bsession bp.rev_yb bp.rev_yb');
+      match bp.rev_yqb with
+      | Some yqb -> ignore (Quadrature.get bp.rev_bsession yqb)
+      | None -> ()
+    in
+    let backward i =
+      if i = num_segments - 1 then bps := init_backward times.(num_segments)
+      else List.iter (reinit_backward i) !bps;
+      backward_normal s times.(i);
+      List.iter get_backward !bps
+    in
+    Sundials_impl.Revolve.run ~num_segments ~num_snapshots
+      ~restore ~advance ~store ~tape ~backward
 end (* }}} *)
 
 (* Let C code know about some of the values in this module.  *)
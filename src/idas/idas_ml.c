@@ -2091,6 +2091,16 @@ CAMLprim value sunml_idas_adj_init(value vdata, value vnd, value vinterptype)
     CAMLreturn (Val_unit);
 }
 
+CAMLprim value sunml_idas_adj_adj_reinit(value vdata)
+{
+    CAMLparam1(vdata);
+
+    int flag = IDAAdjReInit(IDA_MEM_FROM_ML(vdata));
+    SCHECK_FLAG("IDAAdjReInit", flag);
+
+    CAMLreturn (Val_unit);
+}
+
 CAMLprim value sunml_idas_adj_ss_tolerances(value vparent, value vwhich,
 					value vreltol, value vabstol)
 {
@@ -198,10 +198,22 @@ module Dls = struct (* {{{ *)
         session.ls_callbacks <- DlsDenseCallback cb
     | LSI.LapackDense ->
         session.ls_callbacks <- DlsDenseCallback cb
+    | LSI.MixedDense ->
+        session.ls_callbacks <- DlsDenseCallback cb
     | LSI.Band ->
         session.ls_callbacks <- DlsBandCallback cb
     | LSI.LapackBand ->
         session.ls_callbacks <- DlsBandCallback cb
+    | LSI.MixedBand ->
+        session.ls_callbacks <- DlsBandCallback cb
+    | LSI.SpikeBand ->
+        session.ls_callbacks <- DlsBandCallback cb
+    | LSI.SparseLu ->
+        if jac = None then invalid_arg "SparseLu requires Jacobian function";
+        session.ls_callbacks <- DirectCustomCallback cb
+    | LSI.ReorderedBand ->
+        if jac = None then invalid_arg "Reordered requires Jacobian function";
+        session.ls_callbacks <- DirectCustomCallback cb
     | LSI.Klu _ ->
         if jac = None then invalid_arg "Klu requires Jacobian function";
         session.ls_callbacks <- SlsKluCallback cb
@@ -729,6 +741,228 @@ let solve s u strategy u_scale f_scale =
   then raise MissingLinearSolver
   else c_solve s u strategy u_scale f_scale
 
+module Continuation = struct (* {{{ *)
+
+  type predictor =
+    | Constant
+    | Secant
+
+  type stats = {
+      num_points       : int;
+      num_solves       : int;
+      num_rejected     : int;
+      num_nonlin_iters : int;
+    }
+
+  type counters = {
+      mutable points   : int;
+      mutable solves   : int;
+      mutable rejected : int;
+      mutable iters    : int;
+    }
+
+  let stats_of c = {
+      num_points       = c.points;
+      num_solves       = c.solves;
+      num_rejected     = c.rejected;
+      num_nonlin_iters = c.iters;
+    }
+
+  (* Failures that a smaller step or a fresh Jacobian may cure. *)
+  let is_convergence_failure = function
+    | LineSearchNonConvergence
+    | MaxIterationsReached
+    | MaxNewtonStepExceeded
+    | LineSearchBetaConditionFailure
+    | LinearSolverNoRecovery
+    | LinearSetupFailure _
+    | LinearSolveFailure _
+    | FirstSystemFunctionFailure
+    | RepeatedSystemFunctionFailure -> true
+    | _ -> false
+
+  (* The Jacobian is approximated from the system function, so that it
+     follows any change of unknowns made through set_sys_func.  *)
+  let dq_jacobian s =
+    match s.ls_callbacks with
+    | DlsDenseCallback { DirectTypes.jacfn; _ } ->
+        jacfn == DirectTypes.no_callback
+    | DlsBandCallback { DirectTypes.jacfn; _ } ->
+        jacfn == DirectTypes.no_callback
+    | SpilsCallback1 None -> true
+    | _ -> false
+
+  (* Solve at one point; the Jacobian of the previous point is kept
+     unless fresh is true.  The system function and the initial setup
+     flag are restored by the callers.  *)
+  let correct c s strategy u_scale f_scale fresh sysfn u =
+    if fresh then set_init_setup s else set_no_init_setup s;
+    s.sysfn <- sysfn;
+    c.solves <- c.solves + 1;
+    match solve s u strategy u_scale f_scale with
+    | _ -> c.iters <- c.iters + get_num_nonlin_solv_iters s
+    | exception e ->
+        c.iters <- c.iters + get_num_nonlin_solv_iters s;
+        raise e
+
+  let with_restore s f =
+    let sysfn0 = s.sysfn in
+    let restore () = s.sysfn <- sysfn0; set_init_setup s in
+    match f () with
+    | r -> restore (); r
+    | exception e -> restore (); raise e
+
+  let step_factor target_iters iters =
+    min 2.0 (max 0.5 (float target_iters /. float (max 1 iters)))
+
+  let sweep ?(predictor=Secant) ?(strategy=Newton) ?(target_iters=2)
+            ?(max_halvings=10) s f u_scale f_scale u params point =
+    let c = { points = 0; solves = 0; rejected = 0; iters = 0 } in
+    let np = Array.length params in
+    if np > 0 then begin
+      let uc = Nvector.clone u and up = Nvector.clone u in
+      let lc = ref params.(0) and lp = ref params.(0)
+      and have_prev = ref false in
+      (* the secant is undefined between equal parameter values *)
+      let predict l =
+        if predictor = Secant && !have_prev && !lc <> !lp then
+          let r = (l -. !lc) /. (!lc -. !lp) in
+          Nvector.Ops.linearsum (1.0 +. r) uc (-. r) up u
+        else Nvector.Ops.scale 1.0 uc u
+      in
+      (* a slow convergence suggests that the Jacobian is out of date *)
+      let stale () = get_num_nonlin_solv_iters s > target_iters in
+      let accept l =
+        Nvector.Ops.scale 1.0 uc up;
+        Nvector.Ops.scale 1.0 u uc;
+        lp := !lc;
+        lc := l;
+        have_prev := true
+      in
+      (* advance from !lc to target, halving the step on failure and
+         scaling it by step_factor after an intermediate point *)
+      let rec advance target l halvings fresh =
+        predict l;
+        match correct c s strategy u_scale f_scale fresh (f l) u with
+        | () ->
+            let h = (l -. !lc)
+                    *. step_factor target_iters (get_num_nonlin_solv_iters s)
+            in
+            accept l;
+            if l <> target then
+              let next = if (target -. l) /. h <= 1.0 then target
+                         else l +. h in
+              advance target next halvings (stale ())
+        | exception e when is_convergence_failure e ->
+            c.rejected <- c.rejected + 1;
+            if not fresh then advance target l halvings true
+            else if halvings >= max_halvings then raise e
+            else advance target (!lc +. 0.5 *. (l -. !lc)) (halvings + 1) true
+      in
+      with_restore s (fun () ->
+        correct c s strategy u_scale f_scale true (f params.(0)) u;
+        Nvector.Ops.scale 1.0 u uc;
+        c.points <- 1;
+        point params.(0) u;
+        for i = 1 to np - 1 do
+          advance params.(i) params.(i) 0 (stale ());
+          c.points <- c.points + 1;
+          point params.(i) u
+        done)
+    end;
+    stats_of c
+
+  let arclength ?(strategy=Newton) ?(target_iters=3) ?min_step ?max_step
+                ?(max_points=max_int) s f u_scale f_scale u l0 ds point =
+    if not (dq_jacobian s) then
+      invalid_arg "Kinsol.Continuation.arclength: \
+                   the Jacobian must be approximated by difference quotients";
+    let min_step = match min_step with
+                   | Some h -> h | None -> 1.0e-6 *. abs_float ds in
+    let max_step = match max_step with
+                   | Some h -> h | None -> 100.0 *. abs_float ds in
+    let c = { points = 0; solves = 0; rejected = 0; iters = 0 } in
+    let ud = Nvector.unwrap u and w = Nvector.unwrap u_scale in
+    let n = RealArray.length ud in
+    let v = Nvector.clone u and v_scale = Nvector.clone u_scale in
+    let vd = Nvector.unwrap v and vs = Nvector.unwrap v_scale in
+    let uc = RealArray.copy ud and tu = RealArray.make n 0.0
+    and utmp = RealArray.create n in
+    let lc = ref l0 and tl = ref (if ds < 0.0 then -1.0 else 1.0) in
+    let last_k = ref n in
+    (* the unknowns are u with component k replaced by the parameter, and
+       u_k is fixed at u_k0 *)
+    let local_sysfn k uk0 x fx =
+      RealArray.blit ~src:x ~dst:utmp;
+      utmp.{k} <- uk0;
+      f x.{k} utmp fx
+    in
+    (* predict along the tangent, choose the component that changes most
+       as the parameter, and correct; returns the new parameter value *)
+    let predict_correct h fresh =
+      for i = 0 to n - 1 do vd.{i} <- uc.{i} +. h *. tu.{i} done;
+      let l = !lc +. h *. !tl in
+      let k = ref n and tmax = ref (abs_float !tl) in
+      for i = 0 to n - 1 do
+        let ti = abs_float (w.{i} *. tu.{i}) in
+        if ti > !tmax then (k := i; tmax := ti)
+      done;
+      let k = !k in
+      let fresh = fresh || k <> !last_k in
+      last_k := k;
+      if k = n then begin
+        correct c s strategy u_scale f_scale fresh (f l) v;
+        l
+      end else begin
+        let uk0 = vd.{k} in
+        vd.{k} <- l;
+        RealArray.blit ~src:w ~dst:vs;
+        vs.{k} <- 1.0;
+        correct c s strategy v_scale f_scale fresh (local_sysfn k uk0) v;
+        let l = vd.{k} in
+        vd.{k} <- uk0;
+        l
+      end
+    in
+    let accept ?(tangent=true) l =
+      let sum = ref ((l -. !lc) *. (l -. !lc)) in
+      for i = 0 to n - 1 do
+        let d = w.{i} *. (vd.{i} -. uc.{i}) in
+        sum := !sum +. d *. d
+      done;
+      let norm = sqrt !sum in
+      if tangent && norm > 0.0 then begin
+        for i = 0 to n - 1 do tu.{i} <- (vd.{i} -. uc.{i}) /. norm done;
+        tl := (l -. !lc) /. norm
+      end;
+      RealArray.blit ~src:vd ~dst:uc;
+      RealArray.blit ~src:vd ~dst:ud;
+      lc := l;
+      c.points <- c.points + 1;
+      point l u
+    in
+    let rec continue_from h fresh =
+      if c.points < max_points then
+        match predict_correct h fresh with
+        | l ->
+            let iters = get_num_nonlin_solv_iters s in
+            let h' = h *. step_factor target_iters iters in
+            if accept l
+            then continue_from (min max_step h') (iters > target_iters)
+        | exception e when is_convergence_failure e ->
+            c.rejected <- c.rejected + 1;
+            if h *. 0.5 < min_step then raise e
+            else continue_from (h *. 0.5) true
+    in
+    with_restore s (fun () ->
+      RealArray.blit ~src:ud ~dst:vd;
+      RealArray.blit ~src:ud ~dst:uc;
+      let l = predict_correct 0.0 true in
+      if accept ~tangent:false l then continue_from (abs_float ds) false);
+    stats_of c
+
+end (* }}} *)
+
 (* Let C code know about some of the values in this module.  *)
 external c_init_module : exn array -> unit =
   "sunml_kinsol_init_module"
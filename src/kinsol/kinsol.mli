@@ -473,6 +473,132 @@ val solve :
     -> ('d, 'k) Nvector.t
     -> result
 
+(** Parameter continuation.
+
+    Solves a family of systems $F(u, \lambda) = 0$ for a sequence of
+    values of a scalar parameter $\lambda$, each solution providing the
+    initial guess for the next. The functions use the given session and
+    its linear solver: the system function is replaced by
+    [f lambda] for each point (see {!set_sys_func}), and the Jacobian
+    (or preconditioner) computed for one point is reused for the next
+    (see {!set_no_init_setup}), so that a factorization, and for the KLU
+    solver also its symbolic analysis, is carried from point to point.
+    A fresh Jacobian is only computed after a failure or a slowly
+    converging solve, or when KINSOL itself decides to update it
+    (see {!set_max_setup_calls}). Together
+    with a predictor, this typically reduces the number of Newton
+    iterations per point to one or two.
+
+    The original system function and the initial setup behaviour
+    (see {!set_init_setup}) are restored when the functions return.
+
+    {b Note}: the {!MaxNewtonStepExceeded}, {!MaxIterationsReached}, and
+    other convergence failures are only raised when they persist after
+    both refreshing the Jacobian and reducing the parameter step. *)
+module Continuation : sig (* {{{ *)
+
+  (** The initial guess for a new point. *)
+  type predictor =
+    | Constant  (** The solution at the previous point. *)
+    | Secant    (** Linear extrapolation from the solutions at the two
+                    previous points. *)
+
+  (** Statistics for a continuation run. *)
+  type stats = {
+      num_points       : int; (** Number of points returned. *)
+      num_solves       : int; (** Number of calls to {!solve}, including
+                                  those at intermediate and rejected
+                                  points. *)
+      num_rejected     : int; (** Number of failed calls to {!solve}. *)
+      num_nonlin_iters : int; (** Total number of nonlinear iterations. *)
+    }
+
+  (** Solves the system at given parameter values. The call
+      [sweep s f u_scale f_scale u params point] solves
+      [f params.(i) u fu = 0] for each [i] in turn and passes the
+      parameter value and the solution to [point] before moving to the
+      next value. On entry, [u] is the initial guess for [params.(0)];
+      it is overwritten by each solution. The [u_scale], [f_scale], and
+      [strategy] arguments are as for {!solve}.
+
+      A fresh Jacobian is computed for the next point when a solve takes
+      more than [target_iters] nonlinear iterations (default: 2).
+      When a point cannot be reached, the solve is retried with a fresh
+      Jacobian and then from intermediate parameter values obtained by
+      halving the step, at most [max_halvings] times per point (default:
+      10). After an intermediate point, the step is multiplied by
+      [target_iters] over the number of iterations of the last solve,
+      limited to between one half and two, until the point is reached.
+      The solutions at intermediate points are not passed to [point].
+      The {!Secant} predictor falls back to {!Constant} when the two
+      previous parameter values are equal.
+
+      @param predictor Initial guess for each point (default: {!Secant}).
+      @param strategy Strategy used to solve each system
+                      (default: {!Newton}). *)
+  val sweep :
+       ?predictor:predictor
+    -> ?strategy:strategy
+    -> ?target_iters:int
+    -> ?max_halvings:int
+    -> ('d, 'k) session
+    -> (float -> 'd sysfn)
+    -> ('d, 'k) Nvector.t
+    -> ('d, 'k) Nvector.t
+    -> ('d, 'k) Nvector.t
+    -> float array
+    -> (float -> ('d, 'k) Nvector.t -> unit)
+    -> stats
+
+  (** Follows a solution branch through turning points by pseudo-arclength
+      continuation. The call
+      [arclength s f u_scale f_scale u lambda0 ds point] first solves
+      [f lambda0 u fu = 0] and then steps along the curve of solutions
+      $(u, \lambda)$, starting in the direction of increasing
+      $\lambda$ if [ds] is positive and decreasing otherwise. For each
+      point, the parameter value and the solution are passed to [point],
+      which returns [false] to stop the continuation.
+
+      Each step predicts the next point along the secant through the last
+      two points, in the norm weighted by [u_scale] (and by 1 for
+      $\lambda$), and corrects it with the component of $(u, \lambda)$
+      that changes most held fixed. The correction is a system of the
+      same size as [u] in which that component is replaced by
+      $\lambda$; near a turning point, $\lambda$ is thus solved for
+      rather than imposed. The step length starts at [abs ds] and is
+      adapted so that each correction takes about [target_iters]
+      nonlinear iterations (default: 3); it is halved after a failure,
+      and the last exception is raised when it falls below [min_step]
+      (default: [1e-6 *. abs ds]). It never exceeds [max_step]
+      (default: [100. *. abs ds]). At most [max_points] points are
+      computed (default: unlimited).
+
+      Since the corrected system changes when a different component is
+      held fixed, the session must approximate the Jacobian by difference
+      quotients (direct dense and band solvers without a [jac] function
+      or iterative solvers without [jac_times]). The Jacobian is
+      refreshed whenever the fixed component changes and after a
+      correction that takes more than [target_iters] iterations.
+
+      @raise Invalid_argument The session has a user-supplied Jacobian. *)
+  val arclength :
+       ?strategy:strategy
+    -> ?target_iters:int
+    -> ?min_step:float
+    -> ?max_step:float
+    -> ?max_points:int
+    -> 'k serial_session
+    -> (float -> RealArray.t sysfn)
+    -> (RealArray.t, 'k) Nvector.t
+    -> (RealArray.t, 'k) Nvector.t
+    -> (RealArray.t, 'k) Nvector.t
+    -> float
+    -> float
+    -> (float -> (RealArray.t, 'k) Nvector.t -> bool)
+    -> stats
+
+end (* }}} *)
+
 (** {2:set Modifying the solver (optional input functions)} *)
 
 (** Specifies that an initial call to the preconditioner setup function
@@ -0,0 +1,377 @@
+(***********************************************************************)
+(*                                                                     *)
+(*                   OCaml interface to Sundials                       *)
+(*                                                                     *)
+(*             Timothy Bourke, Jun Inoue, and Marc Pouzet              *)
+(*             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *)
+(*                                                                     *)
+(*  Copyright 2026 Institut National de Recherche en Informatique et   *)
+(*  en Automatique.  All rights reserved.  This file is distributed    *)
+(*  under a New BSD License, refer to the file LICENSE.                *)
+(*                                                                     *)
+(***********************************************************************)
+
+open Sundials
+open Bigarray
+
+exception InvalidFile of string
+
+let invalid msg = raise (InvalidFile msg)
+
+type kind =
+  | RealArray
+  | RealArray2
+  | ArrayBand
+  | Dense
+  | Band
+  | SparseCSC
+  | SparseCSR
+
+let int_of_kind = function
+  | RealArray  -> 1
+  | RealArray2 -> 2
+  | ArrayBand  -> 3
+  | Dense      -> 4
+  | Band       -> 5
+  | SparseCSC  -> 6
+  | SparseCSR  -> 7
+
+let kind_of_int = function
+  | 1 -> RealArray
+  | 2 -> RealArray2
+  | 3 -> ArrayBand
+  | 4 -> Dense
+  | 5 -> Band
+  | 6 -> SparseCSC
+  | 7 -> SparseCSR
+  | _ -> invalid "unknown contents"
+
+let string_of_kind = function
+  | RealArray  -> "RealArray"
+  | RealArray2 -> "RealArray2"
+  | ArrayBand  -> "ArrayBand"
+  | Dense      -> "Dense"
+  | Band       -> "Band"
+  | SparseCSC  -> "Sparse (CSC)"
+  | SparseCSR  -> "Sparse (CSR)"
+
+(* Header layout (little endian, 128 bytes):
+      0  magic "SUNMLBIN"
+      8  u32 version
+     12  u32 byte order of the sections (0 = little, 1 = big endian)
+     16  u32 kind
+     20  u32 size of sparse indices in bytes (0, 4, or 8)
+     24  i64 dims[4]
+     56  u64 offsets[3]  (index pointers, index values, data)
+     80  u64 lengths[3]  (in bytes)
+    104  u64 checksum    (filled in by sunml_binaryfile_write)
+    112  reserved
+
+   Sections start at multiples of 64 bytes. The dimensions are:
+      RealArray           length
+      RealArray2          dim1, dim2 of the underlying data
+      ArrayBand           n, smu, mu, ml
+      Dense               m, n
+      Band                n, mu, smu, ml
+      SparseCSC/CSR       m, n, nnz
+
+   Must agree with sundials_binaryfile_ml.c. *)
+let magic = "SUNMLBIN"
+let version = 1
+let header_size = 128
+let alignment = 64
+
+let dims_offset = 24
+let offsets_offset = 56
+let lengths_offset = 80
+let checksum_offset = 104
+
+type header = {
+  kind     : kind;
+  isize    : int;
+  dims     : int array;
+  offsets  : int array;
+  lengths  : int array;
+  checksum : Int64.t;
+}
+
+let set_uint b pos nbytes x =
+  for i = 0 to nbytes - 1 do
+    let byte = Int64.(logand (shift_right_logical x (8 * i)) 0xffL) in
+    Bytes.set b (pos + i) (Char.chr (Int64.to_int byte))
+  done
+
+let get_uint s pos nbytes =
+  let r = ref 0L in
+  for i = nbytes - 1 downto 0 do
+    r := Int64.(logor (shift_left !r 8) (of_int (Char.code s.[pos + i])))
+  done;
+  !r
+
+let get_int s pos nbytes =
+  let x = get_uint s pos nbytes in
+  if x < 0L || x > Int64.of_int max_int then invalid "value out of range";
+  Int64.to_int x
+
+let byte_order = if Sys.big_endian then 1 else 0
+
+let align x = (x + alignment - 1) / alignment * alignment
+
+(* Views of a mapping keep it alive, as do the arrays derived from them. *)
+type mapping
+
+external c_init_module : unit -> unit
+  = "sunml_binaryfile_init_module"
+
+let () = c_init_module ()
+
+external c_map : string -> mapping
+  = "sunml_binaryfile_map"
+
+external c_size : mapping -> int
+  = "sunml_binaryfile_size"
+
+external c_header : mapping -> string
+  = "sunml_binaryfile_header"
+
+external c_checksum : mapping -> int array -> int array -> Int64.t
+  = "sunml_binaryfile_checksum"
+
+external c_array1 : mapping -> int -> int -> RealArray.t
+  = "sunml_binaryfile_array1"
+
+external c_array2 : mapping -> int -> int -> int -> RealArray2.data
+  = "sunml_binaryfile_array2"
+
+external c_read_floats
+  : mapping -> int -> (float, float64_elt, c_layout) Genarray.t -> unit
+  = "sunml_binaryfile_read_floats"
+
+external c_read_indices
+  : mapping -> int -> int -> Matrix.Sparse.index_array -> unit
+  = "sunml_binaryfile_read_indices"
+
+external c_write
+  : string -> Bytes.t
+    -> Matrix.Sparse.index_array
+    -> Matrix.Sparse.index_array
+    -> (float, float64_elt, c_layout) Genarray.t
+    -> unit
+  = "sunml_binaryfile_write"
+
+external c_no_indices : unit -> Matrix.Sparse.index_array
+  = "sunml_binaryfile_no_indices"
+
+let no_indices = c_no_indices ()
+
+(* Saving *)
+
+let write path kind dims ?(ptrs=no_indices) ?(vals=no_indices) data =
+  let isize = if kind = SparseCSC || kind = SparseCSR
+              then kind_size_in_bytes (Array1.kind vals) else 0 in
+  let lengths = [| Array1.dim ptrs * isize;
+                   Array1.dim vals * isize;
+                   8 * Array.fold_left ( * ) 1 (Genarray.dims data) |] in
+  let offsets = Array.make 3 header_size in
+  for i = 1 to 2 do
+    offsets.(i) <- align (offsets.(i - 1) + lengths.(i - 1))
+  done;
+  let h = Bytes.make header_size '\000' in
+  String.iteri (Bytes.set h) magic;
+  set_uint h 8 4 (Int64.of_int version);
+  set_uint h 12 4 (Int64.of_int byte_order);
+  set_uint h 16 4 (Int64.of_int (int_of_kind kind));
+  set_uint h 20 4 (Int64.of_int isize);
+  Array.iteri (fun i d -> set_uint h (dims_offset + 8 * i) 8 (Int64.of_int d))
+    dims;
+  for i = 0 to 2 do
+    set_uint h (offsets_offset + 8 * i) 8 (Int64.of_int offsets.(i));
+    set_uint h (lengths_offset + 8 * i) 8 (Int64.of_int lengths.(i))
+  done;
+  c_write path h ptrs vals data
+
+let save_realarray path a =
+  write path RealArray [| Array1.dim a; 0; 0; 0 |] (genarray_of_array1 a)
+
+let save_realarray2 path a =
+  let d = RealArray2.unwrap a in
+  write path RealArray2 [| Array2.dim1 d; Array2.dim2 d; 0; 0 |]
+    (genarray_of_array2 d)
+
+let save_arraydense = save_realarray2
+
+let save_arrayband path ((a, (smu, mu, ml)) : Matrix.ArrayBand.t) =
+  let d = RealArray2.unwrap a in
+  write path ArrayBand [| Array2.dim1 d; smu; mu; ml |] (genarray_of_array2 d)
+
+let save_dense path a =
+  let m, n = Matrix.Dense.size a in
+  write path Dense [| m; n; 0; 0 |] (genarray_of_array2 (Matrix.Dense.unwrap a))
+
+let save_band path a =
+  let { Matrix.Band.n; mu; smu; ml } = Matrix.Band.dims a in
+  write path Band [| n; mu; smu; ml |]
+    (genarray_of_array2 (Matrix.Band.unwrap a))
+
+let save_sparse path a =
+  let m, n = Matrix.Sparse.size a in
+  let vals, ptrs, data = Matrix.Sparse.unwrap a in
+  let nnz = Index.to_int ptrs.{Array1.dim ptrs - 1} in
+  write path (if Matrix.Sparse.is_csc a then SparseCSC else SparseCSR)
+    [| m; n; nnz; 0 |]
+    ~ptrs ~vals:(Array1.sub vals 0 nnz)
+    (genarray_of_array1 (Array1.sub data 0 nnz))
+
+(* Loading *)
+
+let read_header m =
+  let s = c_header m in
+  let size = c_size m in
+  if String.length s < header_size || String.sub s 0 8 <> magic
+    then invalid "not a Sundials/ML binary file";
+  if get_int s 8 4 <> version then invalid "unsupported version";
+  if get_int s 12 4 <> byte_order then invalid "different byte order";
+  let kind = kind_of_int (get_int s 16 4) in
+  let isize = get_int s 20 4 in
+  if isize <> 0 && isize <> 4 && isize <> 8 then invalid "bad index size";
+  let dims = Array.init 4 (fun i -> get_int s (dims_offset + 8 * i) 8) in
+  let offsets = Array.init 3 (fun i -> get_int s (offsets_offset + 8 * i) 8) in
+  let lengths = Array.init 3 (fun i -> get_int s (lengths_offset + 8 * i) 8) in
+  Array.iter (fun d -> if d > size then invalid "bad dimensions") dims;
+  for i = 0 to 2 do
+    if offsets.(i) < header_size || offsets.(i) mod alignment <> 0
+       || offsets.(i) > size || lengths.(i) > size - offsets.(i)
+      then invalid "truncated file"
+  done;
+  { kind; isize; dims; offsets; lengths;
+    checksum = get_uint s checksum_offset 8 }
+
+let open_file verify path kinds =
+  let m = c_map path in
+  let h = read_header m in
+  if not (List.mem h.kind kinds) then
+    invalid (Printf.sprintf "expected %s but found %s"
+               (String.concat " or " (List.map string_of_kind kinds))
+               (string_of_kind h.kind));
+  if verify && c_checksum m h.offsets h.lengths <> h.checksum
+    then invalid "checksum mismatch";
+  m, h
+
+let check_length h i len =
+  if h.lengths.(i) <> len then invalid "inconsistent dimensions"
+
+let kind path = (read_header (c_map path)).kind
+
+let load_realarray ?(verify=true) path =
+  let m, h = open_file verify path [RealArray] in
+  let n = h.dims.(0) in
+  check_length h 2 (8 * n);
+  c_array1 m h.offsets.(2) n
+
+let load_realarray2 ?(verify=true) path =
+  let m, h = open_file verify path [RealArray2] in
+  let d1, d2 = h.dims.(0), h.dims.(1) in
+  check_length h 2 (8 * d1 * d2);
+  RealArray2.wrap (c_array2 m h.offsets.(2) d1 d2)
+
+let load_arraydense = load_realarray2
+
+let load_arrayband ?(verify=true) path =
+  let m, h = open_file verify path [ArrayBand] in
+  let n, smu, mu, ml = h.dims.(0), h.dims.(1), h.dims.(2), h.dims.(3) in
+  check_length h 2 (8 * n * (smu + ml + 1));
+  let d = c_array2 m h.offsets.(2) n (smu + ml + 1) in
+  (RealArray2.wrap d, (smu, mu, ml))
+
+let load_dense ?(verify=true) path =
+  let m, h = open_file verify path [Dense] in
+  let rows, cols = h.dims.(0), h.dims.(1) in
+  if rows <= 0 || cols <= 0 then invalid "bad dimensions";
+  check_length h 2 (8 * rows * cols);
+  let a = Matrix.Dense.create rows cols in
+  c_read_floats m h.offsets.(2) (genarray_of_array2 (Matrix.Dense.unwrap a));
+  a
+
+let load_band ?(verify=true) path =
+  let m, h = open_file verify path [Band] in
+  let n, mu, smu, ml = h.dims.(0), h.dims.(1), h.dims.(2), h.dims.(3) in
+  if n <= 0 then invalid "bad dimensions";
+  check_length h 2 (8 * n * (smu + ml + 1));
+  let a = Matrix.Band.create { Matrix.Band.n; mu; smu; ml } in
+  let d = Matrix.Band.unwrap a in
+  if Array2.dim1 d * Array2.dim2 d * 8 <> h.lengths.(2)
+    then invalid "inconsistent dimensions";
+  c_read_floats m h.offsets.(2) (genarray_of_array2 d);
+  a
+
+let load_sparse (type s) ?(verify=true) (fmt : s Matrix.Sparse.sformat) path
+    : s Matrix.Sparse.t =
+  let kind = match fmt with
+             | Matrix.Sparse.CSC -> SparseCSC
+             | Matrix.Sparse.CSR -> SparseCSR in
+  let m, h = open_file verify path [kind] in
+  let rows, cols, nnz = h.dims.(0), h.dims.(1), h.dims.(2) in
+  let np = if kind = SparseCSC then cols else rows in
+  if h.isize = 0 then invalid "bad index size";
+  check_length h 0 ((np + 1) * h.isize);
+  check_length h 1 (nnz * h.isize);
+  check_length h 2 (8 * nnz);
+  let a = Matrix.Sparse.make fmt rows cols (max nnz 1) in
+  let vals, ptrs, data = Matrix.Sparse.unwrap a in
+  c_read_indices m h.offsets.(0) h.isize ptrs;
+  c_read_indices m h.offsets.(1) h.isize (Array1.sub vals 0 nnz);
+  c_read_floats m h.offsets.(2) (genarray_of_array1 (Array1.sub data 0 nnz));
+  if Index.to_int ptrs.{0} <> 0 || Index.to_int ptrs.{np} <> nnz
+    then invalid "inconsistent index pointers";
+  let minor = if kind = SparseCSC then rows else cols in
+  for j = 0 to np - 1 do
+    let p0 = Index.to_int ptrs.{j} and p1 = Index.to_int ptrs.{j + 1} in
+    if p1 < p0 || p1 > nnz then invalid "index pointers not monotone";
+    for p = p0 to p1 - 1 do
+      let i = Index.to_int vals.{p} in
+      if i < 0 || i >= minor then invalid "index value out of range"
+    done
+  done;
+  a
+
+(* MatrixMarket import *)
+
+(* Must agree with sundials_binaryfile_ml.c: enum mm_info *)
+type mm_info = int array
+
+external c_mm_header : mapping -> mm_info
+  = "sunml_binaryfile_mm_header"
+
+external c_mm_read
+  : mapping -> mm_info -> bool
+    -> Matrix.Sparse.index_array
+    -> Matrix.Sparse.index_array
+    -> RealArray.t
+    -> int
+  = "sunml_binaryfile_mm_read_byte"
+    "sunml_binaryfile_mm_read"
+
+(* Must agree with sundials_binaryfile_ml.c: enum mm_error *)
+let matrix_market_error = function
+  | -1 -> "missing %%MatrixMarket matrix banner"
+  | -2 -> "only the coordinate format is supported"
+  | -3 -> "only real, integer, and pattern fields are supported"
+  | -4 -> "unknown symmetry"
+  | -5 -> "malformed size line"
+  | -6 -> "malformed or missing entry"
+  | -7 -> "entry index out of range"
+  | _  -> "unknown error"
+
+let import_matrix_market fmt path =
+  let m = c_map path in
+  let info = c_mm_header m in
+  if info.(0) < 0 then invalid (matrix_market_error info.(0));
+  let rows, cols, nnz = info.(2), info.(3), info.(4) in
+  let general = info.(1) = 0 in
+  let cap = max 1 (if general then nnz else 2 * nnz) in
+  let a = Matrix.Sparse.make fmt rows cols cap in
+  let vals, ptrs, data = Matrix.Sparse.unwrap a in
+  let r = c_mm_read m info (Matrix.Sparse.is_csc a) vals ptrs data in
+  if r < 0 then invalid (matrix_market_error r);
+  if 0 < r && r < cap then Matrix.Sparse.resize a;
+  a
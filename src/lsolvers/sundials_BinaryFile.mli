@@ -0,0 +1,169 @@
+(***********************************************************************)
+(*                                                                     *)
+(*                   OCaml interface to Sundials                       *)
+(*                                                                     *)
+(*             Timothy Bourke, Jun Inoue, and Marc Pouzet              *)
+(*             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *)
+(*                                                                     *)
+(*  Copyright 2026 Institut National de Recherche en Informatique et   *)
+(*  en Automatique.  All rights reserved.  This file is distributed    *)
+(*  under a New BSD License, refer to the file LICENSE.                *)
+(*                                                                     *)
+(***********************************************************************)
+
+(** Binary files of matrices and arrays.
+
+    The functions of this module save and load the contents of arrays,
+    dense, band, and sparse matrices in a simple binary format, and import
+    sparse matrices from
+    {{:https://math.nist.gov/MatrixMarket/formats.html}MatrixMarket}
+    files. They are meant for large Jacobians, initial conditions, and
+    reference solutions that would be slow to read as text.
+
+    A file comprises a 128-byte header followed by up to three sections:
+    the index pointers and index values of a sparse matrix, and the
+    floating-point data. The header gives the kind of contents, their
+    dimensions, the size of sparse indices, the position and length of
+    each section, and a checksum of the sections. Sections start at
+    multiples of 64 bytes and are stored in the byte order of the machine
+    that wrote the file; files with a different byte order are rejected.
+
+    Files are loaded by mapping them into memory. Arrays, including
+    {!Matrix.ArrayDense} and {!Matrix.ArrayBand} matrices, are loaded
+    without copying: the result is a view of the mapping and the file is
+    only read as the elements are accessed. The mapping is private: the
+    elements of a view can be modified, but the changes are not written
+    back to the file. The file is unmapped once the view and all the
+    arrays derived from it (e.g., by [Bigarray.Array1.sub] or
+    {!Sundials.RealArray2.col}) are unreachable. {!Matrix.Dense},
+    {!Matrix.Band}, and {!Matrix.Sparse} matrices are stored by
+    Sundials, so their contents are copied from the mapping with a single
+    block copy per section.
+
+    The payload of a serial nvector is saved by
+    [save_realarray file (Nvector_serial.unwrap v)] and loaded without
+    copying by [Nvector_serial.wrap (load_realarray file)], and similarly
+    for the local arrays of other nvectors.
+
+    The checksum is verified on loading unless the optional [verify]
+    argument is [false]. Verifying reads the whole file; to load an array
+    lazily, pass [~verify:false].
+
+    @version VERSION()
+    @author Timothy Bourke (Inria/ENS)
+    @author Jun Inoue (Inria/ENS)
+    @author Marc Pouzet (UPMC/ENS/Inria) *)
+
+open Sundials
+
+(** Raised when a file is not a valid binary file, does not contain the
+    expected kind of data, or fails checksum verification. The argument
+    describes the problem. *)
+exception InvalidFile of string
+
+(** The contents of a binary file. *)
+type kind =
+  | RealArray   (** A {!Sundials.RealArray.t}. *)
+  | RealArray2  (** A {!Sundials.RealArray2.t} or {!Matrix.ArrayDense.t}. *)
+  | ArrayBand   (** A {!Matrix.ArrayBand.t}. *)
+  | Dense       (** A {!Matrix.Dense.t}. *)
+  | Band        (** A {!Matrix.Band.t}. *)
+  | SparseCSC   (** A {!Matrix.Sparse.t} in CSC format. *)
+  | SparseCSR   (** A {!Matrix.Sparse.t} in CSR format. *)
+
+(** Returns the kind of contents of a binary file, without reading more
+    than its header.
+
+    @raise InvalidFile The file is not a valid binary file.
+    @raise Failure The file cannot be opened. *)
+val kind : string -> kind
+
+(** {2:save Saving} *)
+
+(** [save_realarray file a] writes [a] to [file], which is created or
+    truncated. The other saving functions work similarly.
+
+    @raise Failure The file cannot be written. *)
+val save_realarray : string -> RealArray.t -> unit
+
+(** Writes a two-dimensional array (in the same format as
+    {!save_arraydense}). *)
+val save_realarray2 : string -> RealArray2.t -> unit
+
+(** Writes an array-based dense matrix. *)
+val save_arraydense : string -> Matrix.ArrayDense.t -> unit
+
+(** Writes an array-based band matrix. *)
+val save_arrayband : string -> Matrix.ArrayBand.t -> unit
+
+(** Writes a dense matrix. *)
+val save_dense : string -> Matrix.Dense.t -> unit
+
+(** Writes a band matrix, including the storage for the factorization
+    (see {!Matrix.Band.dimensions}). *)
+val save_band : string -> Matrix.Band.t -> unit
+
+(** Writes a sparse matrix. Only the nonzero elements in use (up to
+    [idxptrs.{np}], see {!Matrix.Sparse.unwrap}) are written. *)
+val save_sparse : string -> 's Matrix.Sparse.t -> unit
+
+(** {2:load Loading} *)
+
+(** Maps a file written by {!save_realarray} into memory.
+
+    @raise InvalidFile The file does not contain a {!RealArray}, or its
+                       checksum is wrong.
+    @raise Failure The file cannot be opened or mapped. *)
+val load_realarray : ?verify:bool -> string -> RealArray.t
+
+(** Maps a file written by {!save_realarray2} or {!save_arraydense} into
+    memory. *)
+val load_realarray2 : ?verify:bool -> string -> RealArray2.t
+
+(** Maps a file written by {!save_realarray2} or {!save_arraydense} into
+    memory. *)
+val load_arraydense : ?verify:bool -> string -> Matrix.ArrayDense.t
+
+(** Maps a file written by {!save_arrayband} into memory. *)
+val load_arrayband : ?verify:bool -> string -> Matrix.ArrayBand.t
+
+(** Creates a dense matrix from a file written by {!save_dense}. *)
+val load_dense : ?verify:bool -> string -> Matrix.Dense.t
+
+(** Creates a band matrix from a file written by {!save_band}. *)
+val load_band : ?verify:bool -> string -> Matrix.Band.t
+
+(** Creates a sparse matrix in the given format from a file written by
+    {!save_sparse}. Indices written with a different size (32 or 64 bits)
+    from that of {!Sundials.Index} are converted. The index pointers
+    must start at zero, be nondecreasing, and end at the number of
+    nonzero elements, and the index values must be valid row (CSC) or
+    column (CSR) indices.
+
+    @raise InvalidFile The file does not contain a sparse matrix in the
+                       given format, its checksum is wrong, or its
+                       indices are invalid. *)
+val load_sparse : ?verify:bool -> 's Matrix.Sparse.sformat -> string
+                  -> 's Matrix.Sparse.t
+
+(** {2:import Importing} *)
+
+(** Creates a sparse matrix in the given format from a file in the
+    MatrixMarket coordinate format. Real, integer, and pattern (all
+    values are 1.0) fields are supported, with general, symmetric
+    (or Hermitian), and skew-symmetric symmetries. The entries of
+    symmetric and skew-symmetric matrices are mirrored so that the result
+    contains both triangles. In the result, the row (CSC) or column (CSR)
+    indices are sorted within each column or row; duplicate entries are
+    not summed.
+
+    The file is mapped into memory and parsed in place, and the entries
+    are sorted by two counting sorts, so the time is linear in the size of
+    the file and the matrix dimensions.
+
+    @raise InvalidFile The file is not in the MatrixMarket coordinate
+                       format, has an unsupported field or symmetry, or
+                       has malformed or out-of-range entries.
+    @raise Failure The file cannot be opened or mapped. *)
+val import_matrix_market : 's Matrix.Sparse.sformat -> string
+                           -> 's Matrix.Sparse.t
@@ -75,14 +75,15 @@ module Direct = struct (* {{{ *)
   external c_dense
            : 'k Nvector.serial
              -> 'k Matrix.dense
+             -> bool
              -> Sundials.Context.t
              -> (Matrix.Dense.t, Nvector_serial.data, 'k) cptr
     = "sunml_lsolver_dense"
 
-  let dense ?context nvec mat =
+  let dense ?context ?(blocked=false) nvec mat =
     let ctx = Sundials_impl.Context.get context in
     LS {
-      rawptr = c_dense nvec mat ctx;
+      rawptr = c_dense nvec mat blocked ctx;
       solver = Dense;
       matrix = Some mat;
       compat = LSI.Iterative.info;
@@ -283,6 +284,267 @@ module Direct = struct (* {{{ *)
 
   let superlumt = Superlumt.make
 
+  module Mixed = struct (* {{{ *)
+
+    (* Must correspond with sundials_lsolver_mixed_ml.c:
+       sunml_lsolver_mixed_get_stats *)
+    type stats = {
+      num_solves : int;
+      num_refinements : int;
+      num_fallbacks : int;
+    }
+
+    external c_dense
+             : 'k Nvector.serial
+               -> 'k Matrix.dense
+               -> int option
+               -> Sundials.Context.t
+               -> (Matrix.Dense.t, Nvector_serial.data, 'k) cptr
+      = "sunml_lsolver_mixed_dense"
+
+    external c_band
+             : 'k Nvector.serial
+               -> 'k Matrix.band
+               -> int option
+               -> Sundials.Context.t
+               -> (Matrix.Band.t, Nvector_serial.data, 'k) cptr
+      = "sunml_lsolver_mixed_band"
+
+    let check_max_refinements = function
+      | Some n when n < 0 -> invalid_arg "max_refinements must be non-negative"
+      | _ -> ()
+
+    let dense ?context ?max_refinements nvec mat =
+      if Sundials_impl.Version.lt500
+      then raise Config.NotImplementedBySundialsVersion;
+      check_max_refinements max_refinements;
+      let ctx = Sundials_impl.Context.get context in
+      LS {
+        rawptr = c_dense nvec mat max_refinements ctx;
+        solver = MixedDense;
+        matrix = Some mat;
+        compat = LSI.Iterative.info;
+        context = ctx;
+        check_prec_type = (fun _ -> true);
+        ocaml_callbacks = empty_ocaml_callbacks ();
+        info_file = None;
+        attached = false;
+      }
+
+    let band ?context ?max_refinements nvec mat =
+      if Sundials_impl.Version.lt500
+      then raise Config.NotImplementedBySundialsVersion;
+      check_max_refinements max_refinements;
+      let ctx = Sundials_impl.Context.get context in
+      LS {
+        rawptr = c_band nvec mat max_refinements ctx;
+        solver = MixedBand;
+        matrix = Some mat;
+        compat = LSI.Iterative.info;
+        context = ctx;
+        check_prec_type = (fun _ -> true);
+        ocaml_callbacks = empty_ocaml_callbacks ();
+        info_file = None;
+        attached = false;
+      }
+
+    external c_set_max_refinements
+             : ('m, Nvector_serial.data, 'k) cptr -> int -> unit
+      = "sunml_lsolver_mixed_set_max_refinements"
+
+    let set_max_refinements (LS { rawptr }) n = c_set_max_refinements rawptr n
+
+    external c_get_stats : ('m, Nvector_serial.data, 'k) cptr -> stats
+      = "sunml_lsolver_mixed_get_stats"
+
+    let get_stats (LS { rawptr }) = c_get_stats rawptr
+
+    let get_num_refinements ls = (get_stats ls).num_refinements
+
+    let get_num_fallbacks ls = (get_stats ls).num_fallbacks
+
+  end (* }}} *)
+
+  let mixed_dense = Mixed.dense
+  let mixed_band = Mixed.band
+
+  module Spike = struct (* {{{ *)
+
+    (* Must correspond with sundials_lsolver_spike_ml.c:
+       sunml_lsolver_spike_get_stats *)
+    type stats = {
+      num_partitions : int;
+      num_fallbacks : int;
+    }
+
+    external c_band
+             : 'k Nvector.serial
+               -> 'k Matrix.band
+               -> int option
+               -> Sundials.Context.t
+               -> (Matrix.Band.t, Nvector_serial.data, 'k) cptr
+      = "sunml_lsolver_spike_band"
+
+    let band ?context ?partitions nvec mat =
+      if Sundials_impl.Version.lt500
+      then raise Config.NotImplementedBySundialsVersion;
+      (match partitions with
+       | Some p when p < 1 -> invalid_arg "partitions must be positive"
+       | _ -> ());
+      let ctx = Sundials_impl.Context.get context in
+      LS {
+        rawptr = c_band nvec mat partitions ctx;
+        solver = SpikeBand;
+        matrix = Some mat;
+        compat = LSI.Iterative.info;
+        context = ctx;
+        check_prec_type = (fun _ -> true);
+        ocaml_callbacks = empty_ocaml_callbacks ();
+        info_file = None;
+        attached = false;
+      }
+
+    external c_get_stats : ('m, Nvector_serial.data, 'k) cptr -> stats
+      = "sunml_lsolver_spike_get_stats"
+
+    let get_stats (LS { rawptr }) = c_get_stats rawptr
+
+  end (* }}} *)
+
+  let spike_band = Spike.band
+
+  module SparseLu = struct (* {{{ *)
+
+    (* Must correspond with sundials_lsolver_sparselu_ml.c:
+       enum sparselu_ordering *)
+    type ordering =
+      | Natural
+      | MinDegree
+
+    (* Must correspond with sundials_lsolver_sparselu_ml.c:
+       sunml_lsolver_sparselu_get_stats *)
+    type stats = {
+      num_symbolic : int;
+      num_numeric : int;
+      num_perturbed : int;
+      num_refinements : int;
+      factor_nnz : int;
+      num_levels : int;
+    }
+
+    external c_sparselu
+             : 'k Nvector.serial
+               -> ('s, 'k) Matrix.sparse
+               -> ordering
+               -> Sundials.Context.t
+               -> ('s Matrix.Sparse.t, Nvector_serial.data, 'k) cptr
+      = "sunml_lsolver_sparselu"
+
+    let make ?context ?(ordering=MinDegree) nvec mat =
+      if Sundials_impl.Version.lt500
+      then raise Config.NotImplementedBySundialsVersion;
+      let ctx = Sundials_impl.Context.get context in
+      LS {
+        rawptr = c_sparselu nvec mat ordering ctx;
+        solver = SparseLu;
+        matrix = Some mat;
+        compat = LSI.Iterative.info;
+        context = ctx;
+        check_prec_type = (fun _ -> true);
+        ocaml_callbacks = empty_ocaml_callbacks ();
+        info_file = None;
+        attached = false;
+      }
+
+    external c_set_ordering
+             : ('m, Nvector_serial.data, 'k) cptr -> ordering -> unit
+      = "sunml_lsolver_sparselu_set_ordering"
+
+    let set_ordering (LS { rawptr }) o = c_set_ordering rawptr o
+
+    external c_set_max_refinements
+             : ('m, Nvector_serial.data, 'k) cptr -> int -> unit
+      = "sunml_lsolver_sparselu_set_max_refinements"
+
+    let set_max_refinements (LS { rawptr }) n =
+      c_set_max_refinements rawptr n
+
+    external c_get_stats : ('m, Nvector_serial.data, 'k) cptr -> stats
+      = "sunml_lsolver_sparselu_get_stats"
+
+    let get_stats (LS { rawptr }) = c_get_stats rawptr
+
+  end (* }}} *)
+
+  let sparse_lu = SparseLu.make
+
+  module Reordered = struct (* {{{ *)
+
+    (* Must correspond with sundials_lsolver_reordered_ml.c:
+       enum reordered_ordering *)
+    type ordering =
+      | Natural
+      | Rcm
+
+    (* Must correspond with sundials_lsolver_reordered_ml.c:
+       sunml_lsolver_reordered_get_stats *)
+    type stats = {
+      original_mu : int;
+      original_ml : int;
+      reordered_mu : int;
+      reordered_ml : int;
+      num_orderings : int;
+      num_setups : int;
+    }
+
+    external c_band
+             : 'k Nvector.serial
+               -> ('s, 'k) Matrix.sparse
+               -> ordering
+               -> int option
+               -> Sundials.Context.t
+               -> ('s Matrix.Sparse.t, Nvector_serial.data, 'k) cptr
+      = "sunml_lsolver_reordered_band"
+
+    let band ?context ?(ordering=Rcm) ?partitions nvec mat =
+      if Sundials_impl.Version.lt500
+      then raise Config.NotImplementedBySundialsVersion;
+      (match partitions with
+       | Some p when p < 1 -> invalid_arg "partitions must be positive"
+       | _ -> ());
+      let ctx = Sundials_impl.Context.get context in
+      LS {
+        rawptr = c_band nvec mat ordering partitions ctx;
+        solver = ReorderedBand;
+        matrix = Some mat;
+        compat = LSI.Iterative.info;
+        context = ctx;
+        check_prec_type = (fun _ -> true);
+        ocaml_callbacks = empty_ocaml_callbacks ();
+        info_file = None;
+        attached = false;
+      }
+
+    external c_get_stats : ('m, Nvector_serial.data, 'k) cptr -> stats
+      = "sunml_lsolver_reordered_get_stats"
+
+    let get_stats (LS { rawptr }) = c_get_stats rawptr
+
+    (* Flops of a band LU with partial pivoting: 2 n ml (mu + ml) *)
+    let estimated_speedup ls =
+      let { original_mu; original_ml; reordered_mu; reordered_ml; _ } =
+        get_stats ls in
+      let cost mu ml = float (ml + 1) *. float (mu + ml + 1) in
+      cost original_mu original_ml /. cost reordered_mu reordered_ml
+
+    external c_get_permutation
+             : ('m, Nvector_serial.data, 'k) cptr -> int array
+      = "sunml_lsolver_reordered_get_permutation"
+
+    let get_permutation (LS { rawptr }) = c_get_permutation rawptr
+
+  end (* }}} *)
+
 end (* }}} *)
 
 module Iterative = struct (* {{{ *)
@@ -334,8 +596,32 @@ module Iterative = struct (* {{{ *)
      -> unit
    = "sunml_lsolver_set_print_level"
 
+  external c_gcrodr_set_print_level : ('m, 'nd, 'nk) cptr -> int -> unit
+   = "sunml_lsolver_gcrodr_set_print_level"
+
+  external c_pipelined_set_print_level : ('m, 'nd, 'nk) cptr -> int -> unit
+   = "sunml_lsolver_pipelined_set_print_level"
+
+  (* The GCRO-DR and pipelined solvers are implemented in
+     sundials_lsolver_{gcrodr,pipelined}_ml.c and not by Sundials, so some
+     settings are dispatched here. *)
+  type native = NotNative | NativeGcrodr | NativePipelined
+
+  let native (type t) (solver : ('m, 'nd, 'nk, t) solver_data) =
+    match solver with
+    | Gcrodr -> NativeGcrodr
+    | Pipelined -> NativePipelined
+    | _ -> NotNative
+
+  let set_print_level' rawptr solver level =
+    let level = if level then 1 else 0 in
+    match native solver with
+    | NativeGcrodr -> c_gcrodr_set_print_level rawptr level
+    | NativePipelined -> c_pipelined_set_print_level rawptr level
+    | NotNative -> c_set_print_level rawptr solver level
+
   let set_print_level (LS { rawptr; solver; _ }) level =
-    c_set_print_level rawptr solver (if level then 1 else 0)
+    set_print_level' rawptr solver level
 
   external c_set_info_file
    : ('m, 'nd, 'nk) cptr
@@ -344,11 +630,21 @@ module Iterative = struct (* {{{ *)
      -> unit
    = "sunml_lsolver_set_info_file"
 
+  external c_gcrodr_set_info_file : ('m, 'nd, 'nk) cptr -> Logfile.t -> unit
+   = "sunml_lsolver_gcrodr_set_info_file"
+
+  external c_pipelined_set_info_file
+   : ('m, 'nd, 'nk) cptr -> Logfile.t -> unit
+   = "sunml_lsolver_pipelined_set_info_file"
+
   let set_info_file (LS ({ rawptr; solver; _ } as lsdata)) ?print_level file =
     lsdata.info_file <- Some file;
-    c_set_info_file rawptr solver file;
+    (match native solver with
+     | NativeGcrodr -> c_gcrodr_set_info_file rawptr file
+     | NativePipelined -> c_pipelined_set_info_file rawptr file
+     | NotNative -> c_set_info_file rawptr solver file);
     (match print_level with None -> ()
-     | Some level -> c_set_print_level rawptr solver (if level then 1 else 0))
+     | Some level -> set_print_level' rawptr solver level)
 
   let default = function
     | Some x -> x
@@ -516,6 +812,138 @@ module Iterative = struct (* {{{ *)
       attached = false;
     }
 
+  module Gcrodr = struct (* {{{ *)
+
+    (* Must correspond with sundials_lsolver_gcrodr_ml.c:
+       sunml_lsolver_gcrodr_get_stats *)
+    type stats = {
+      num_solves : int;
+      num_iters : int;
+      num_recycle_matvecs : int;
+      recycle_dim : int;
+    }
+
+    external c_make
+      : int -> int -> ('d, 'k) Nvector.t -> Sundials.Context.t
+        -> ('m, 'nd, 'nk) cptr
+      = "sunml_lsolver_gcrodr"
+
+    external c_set_max_restarts : ('m, 'nd, 'nk) cptr -> int -> unit
+      = "sunml_lsolver_gcrodr_set_max_restarts"
+
+    external c_set_gs_type
+      : ('m, 'nd, 'nk) cptr -> gramschmidt_type -> unit
+      = "sunml_lsolver_gcrodr_set_gs_type"
+
+    external c_reset : ('m, 'nd, 'nk) cptr -> unit
+      = "sunml_lsolver_gcrodr_reset_recycled"
+
+    external c_get_stats : ('m, 'nd, 'nk) cptr -> stats
+      = "sunml_lsolver_gcrodr_get_stats"
+
+    let make ?context ?(maxl=0) ?recycle ?max_restarts ?gs_type nvec =
+      if Sundials_impl.Version.lt500
+      then raise Config.NotImplementedBySundialsVersion;
+      let recycle = match recycle with
+        | None -> -1
+        | Some k when k < 1 || (maxl > 0 && k > maxl) ->
+            invalid_arg "recycle must be in 1..maxl"
+        | Some k -> k
+      in
+      let ctx = Sundials_impl.Context.get context in
+      let cptr = c_make maxl recycle nvec ctx in
+      (match max_restarts with
+       | Some mr -> c_set_max_restarts cptr mr
+       | None -> ());
+      (match gs_type with
+       | Some gst -> c_set_gs_type cptr gst
+       | None -> ());
+      LS {
+        rawptr = cptr;
+        solver = Gcrodr;
+        matrix = None;
+        compat = info;
+        context = ctx;
+        check_prec_type = (fun _ -> true);
+        ocaml_callbacks = empty_ocaml_callbacks ();
+        info_file = None;
+        attached = false;
+      }
+
+    let set_max_restarts (LS { rawptr; _ }) max_restarts =
+      c_set_max_restarts rawptr max_restarts
+
+    let set_gs_type (LS { rawptr; _ }) gs_type = c_set_gs_type rawptr gs_type
+
+    let reset (LS { rawptr; _ }) = c_reset rawptr
+
+    let get_stats (LS { rawptr; _ }) = c_get_stats rawptr
+
+    let get_recycle_dim ls = (get_stats ls).recycle_dim
+
+  end (* }}} *)
+
+  let gcrodr = Gcrodr.make
+
+  module Pipelined = struct (* {{{ *)
+
+    (* Must correspond with sundials_lsolver_pipelined_ml.c:
+       sunml_lsolver_pipelined_get_stats *)
+    type stats = {
+      num_reductions : int;
+      num_norm_fallbacks : int;
+      overlapped : bool;
+    }
+
+    external c_make
+      : bool -> int -> ('d, 'k) Nvector.t -> Sundials.Context.t
+        -> ('m, 'nd, 'nk) cptr
+      = "sunml_lsolver_pipelined"
+
+    external c_set_max_restarts : ('m, 'nd, 'nk) cptr -> int -> unit
+      = "sunml_lsolver_pipelined_set_max_restarts"
+
+    external c_get_stats : ('m, 'nd, 'nk) cptr -> stats
+      = "sunml_lsolver_pipelined_get_stats"
+
+    let make is_gmres ?context ?(maxl=0) nvec =
+      if Sundials_impl.Version.lt600
+      then raise Config.NotImplementedBySundialsVersion;
+      let ctx = Sundials_impl.Context.get context in
+      let cptr = c_make is_gmres maxl nvec ctx in
+      LS {
+        rawptr = cptr;
+        solver = Pipelined;
+        matrix = None;
+        compat = info;
+        context = ctx;
+        check_prec_type = (fun _ -> true);
+        ocaml_callbacks = empty_ocaml_callbacks ();
+        info_file = None;
+        attached = false;
+      }
+
+    let set_max_restarts (LS { rawptr; _ }) max_restarts =
+      c_set_max_restarts rawptr max_restarts
+
+    let pcg ?context ?maxl nvec = make false ?context ?maxl nvec
+
+    let gmres ?context ?maxl ?max_restarts nvec =
+      let ls = make true ?context ?maxl nvec in
+      (match max_restarts with
+       | Some mr -> set_max_restarts ls mr
+       | None -> ());
+      ls
+
+    let get_stats (LS { rawptr; _ }) = c_get_stats rawptr
+
+    let get_num_reductions ls = (get_stats ls).num_reductions
+
+  end (* }}} *)
+
+  let pipelined_pcg = Pipelined.pcg
+  let pipelined_gmres = Pipelined.gmres
+
   module Algorithms = struct (* {{{ *)
 
     external qr_fact : int
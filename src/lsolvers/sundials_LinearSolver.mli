@@ -112,9 +112,16 @@ module Direct : sig (* {{{ *)
     The matrix is used internally after the linear solver is attached to a
     session.
 
+    If [blocked] is [true], the factorization is done by a
+    cache-blocked recursive LU (see {!Matrix.ArrayDense.getrf}) rather
+    than by the unblocked Sundials routine (the default). Both agree up to
+    rounding; the blocked version is faster for systems of more than a few
+    hundred equations.
+
   @linsol_module SUNLinSol_Dense *)
   val dense :
        ?context:Context.t
+    -> ?blocked:bool
     -> 'k Nvector.serial
     -> 'k Matrix.dense
     -> (Matrix.Dense.t, 'k, [`Dls]) serial_t
@@ -266,6 +273,340 @@ module Direct : sig (* {{{ *)
     -> ('s, 'k) Matrix.sparse
     -> ('s Matrix.Sparse.t, 'k, [>`Slu|`Dls]) serial_t
 
+  (** Mixed-precision direct linear solvers on dense and banded matrices.
+
+      The matrix is copied to single precision and factored there (LU
+      with partial pivoting), which halves the storage needed for the
+      factors and is typically faster than a double-precision
+      factorization. Each solution is then improved by iterative
+      refinement against the double-precision matrix until the residual
+      satisfies
+      {% $\lVert b - Ax \rVert_\infty \leq
+          \lVert x \rVert_\infty \lVert A \rVert_\infty
+          \epsilon \sqrt{n}$ %}.
+      When the single-precision factorization fails, or when refinement
+      does not converge within the allowed number of steps, the solver
+      falls back to a double-precision factorization, which is kept until
+      the next setup.
+
+      These solvers are implemented in Sundials/ML (they are not part of
+      Sundials) and require
+      {{!Sundials_Config.sundials_version}Config.sundials_version} >= 5.0.0. *)
+  module Mixed : sig (* {{{ *)
+
+    (** Creates a mixed-precision direct linear solver on dense matrices.
+        The nvector and matrix argument are used to determine the linear
+        system size and to assess compatibility with the linear solver
+        implementation. The matrix is used internally after the linear
+        solver is attached to a session.
+
+        The [max_refinements] argument bounds the number of refinement
+        steps per solve (the default is 10).
+
+        @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+    val dense :
+         ?context:Context.t
+      -> ?max_refinements:int
+      -> 'k Nvector.serial
+      -> 'k Matrix.dense
+      -> (Matrix.Dense.t, 'k, [`Dls|`Mixed]) serial_t
+
+    (** Creates a mixed-precision direct linear solver on banded matrices.
+        See {!dense}. The stored upper bandwidth of the matrix must be at
+        least the sum of its upper and lower bandwidths (as for
+        {!Sundials_LinearSolver.Direct.band}).
+
+        @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+    val band :
+         ?context:Context.t
+      -> ?max_refinements:int
+      -> 'k Nvector.serial
+      -> 'k Matrix.band
+      -> (Matrix.Band.t, 'k, [`Dls|`Mixed]) serial_t
+
+    (** Sets the maximum number of refinement steps per solve. Setting it
+        to zero falls back to double precision whenever the
+        single-precision solution is not accurate enough. *)
+    val set_max_refinements : ('m, 'k, [>`Mixed]) serial_t -> int -> unit
+
+    (** Summaries of the work done by a mixed-precision solver. *)
+    type stats = {
+      num_solves : int;
+        (** Number of calls to solve. *)
+      num_refinements : int;
+        (** Total number of iterative refinement steps. *)
+      num_fallbacks : int;
+        (** Number of times that the solver fell back to a
+            double-precision factorization. *)
+    }
+
+    (** Returns the cumulative statistics of a mixed-precision solver. *)
+    val get_stats : ('m, 'k, [>`Mixed]) serial_t -> stats
+
+    (** Returns the total number of iterative refinement steps. *)
+    val get_num_refinements : ('m, 'k, [>`Mixed]) serial_t -> int
+
+    (** Returns the number of fallbacks to double precision. *)
+    val get_num_fallbacks : ('m, 'k, [>`Mixed]) serial_t -> int
+
+  end (* }}} *)
+
+  (** Creates a mixed-precision direct linear solver on dense matrices.
+      See {!Mixed.dense}.
+
+      @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+  val mixed_dense :
+       ?context:Context.t
+    -> ?max_refinements:int
+    -> 'k Nvector.serial
+    -> 'k Matrix.dense
+    -> (Matrix.Dense.t, 'k, [`Dls|`Mixed]) serial_t
+
+  (** Creates a mixed-precision direct linear solver on banded matrices.
+      See {!Mixed.band}.
+
+      @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+  val mixed_band :
+       ?context:Context.t
+    -> ?max_refinements:int
+    -> 'k Nvector.serial
+    -> 'k Matrix.band
+    -> (Matrix.Band.t, 'k, [`Dls|`Mixed]) serial_t
+
+  (** Partitioned (SPIKE) direct linear solver on banded matrices.
+
+      The rows and columns are split into contiguous partitions whose
+      diagonal blocks are factored independently (LU with partial
+      pivoting). The couplings between neighbouring partitions give a
+      small banded system in the first {% $\mathit{mu}$ %} and last
+      {% $\mathit{ml}$ %} unknowns of each partition, which is factored
+      with partial pivoting, after which the partitions are solved
+      independently again. The reduced system is not truncated, so
+      solutions agree with those of {!Sundials_LinearSolver.Direct.band} up
+      to rounding errors.
+
+      The partitions are processed in parallel when Sundials/ML is
+      compiled with OpenMP. A setup costs two to three times as many
+      operations as a band factorization, so the solver pays off for
+      large systems with several threads. Partitions have at least
+      {% $\max(32, 2(\mathit{mu}+\mathit{ml}))$ %} rows; smaller systems
+      are factored as a whole. If a diagonal block is singular, the setup
+      fails and the next one factors the whole matrix.
+
+      This solver is implemented in Sundials/ML (it is not part of
+      Sundials) and requires
+      {{!Sundials_Config.sundials_version}Config.sundials_version} >= 5.0.0. *)
+  module Spike : sig (* {{{ *)
+
+    (** Creates a partitioned direct linear solver on banded matrices.
+        The nvector and matrix argument are used to determine the linear
+        system size and to assess compatibility with the linear solver
+        implementation. The matrix is used internally after the linear
+        solver is attached to a session. The stored upper bandwidth of
+        the matrix must be at least the sum of its upper and lower
+        bandwidths (as for {!Sundials_LinearSolver.Direct.band}).
+
+        The [partitions] argument gives the maximum number of partitions.
+        The default is the number of OpenMP threads, or 1 (a single band
+        factorization) without OpenMP.
+
+        @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+    val band :
+         ?context:Context.t
+      -> ?partitions:int
+      -> 'k Nvector.serial
+      -> 'k Matrix.band
+      -> (Matrix.Band.t, 'k, [`Dls|`Spike]) serial_t
+
+    (** Summaries of the work done by a partitioned solver. *)
+    type stats = {
+      num_partitions : int;
+        (** Number of partitions used at the last setup. *)
+      num_fallbacks : int;
+        (** Number of setups that failed on a singular diagonal block or
+            reduced system. *)
+    }
+
+    (** Returns the statistics of a partitioned solver. *)
+    val get_stats : ('m, 'k, [>`Spike]) serial_t -> stats
+
+  end (* }}} *)
+
+  (** Creates a partitioned direct linear solver on banded matrices.
+      See {!Spike.band}.
+
+      @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+  val spike_band :
+       ?context:Context.t
+    -> ?partitions:int
+    -> 'k Nvector.serial
+    -> 'k Matrix.band
+    -> (Matrix.Band.t, 'k, [`Dls|`Spike]) serial_t
+
+  (** A sparse LU solver that is always available.
+
+      The unknowns are reordered symmetrically to reduce fill-in and the
+      structure of the factors is computed once (the symbolic
+      factorization). Later setups with the same sparsity pattern only
+      recompute the values of the factors (the numeric factorization),
+      which proceeds up the elimination tree, in parallel when
+      Sundials/ML is compiled with OpenMP.
+
+      Pivoting is static: before the symbolic factorization, the rows
+      are permuted so as to maximize the product of the magnitudes of the
+      diagonal entries (a maximum-product matching, as in MC64), which
+      places nonzero pivots on the diagonal of any structurally nonsingular
+      matrix. Pivots smaller in magnitude than
+      {% $\sqrt{\epsilon}\lVert A \rVert_{\max}$ %} are replaced by that
+      value, and a few steps of iterative refinement are then applied to
+      each solution. The row permutation is recomputed when a later setup
+      with the same pattern has to replace pivots that it had avoided.
+      Systems that need dynamic pivoting for stability should use {!Klu}
+      or {!Sundials_LinearSolver.Direct.superlumt}.
+
+      This solver is implemented in Sundials/ML (it is not part of
+      Sundials) and requires
+      {{!Sundials_Config.sundials_version}Config.sundials_version} >= 5.0.0. *)
+  module SparseLu : sig (* {{{ *)
+
+    (** The ordering algorithm used for reducing fill. *)
+    type ordering =
+      | Natural   (** Natural ordering. *)
+      | MinDegree (** (Exact) minimum degree on the graph of
+                      {% $A + A^T$ %}. *)
+
+    (** Creates a sparse LU solver. The nvector and matrix argument are
+        used to determine the linear system size and to assess
+        compatibility with the linear solver implementation. The matrix
+        is used internally after the linear solver is attached to a
+        session. Both {{!Sundials_Matrix.Sparse.sformat}CSC and CSR}
+        matrices are accepted. The default ordering is [MinDegree].
+
+        @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+    val make :
+         ?context:Context.t
+      -> ?ordering:ordering
+      -> 'k Nvector.serial
+      -> ('s, 'k) Matrix.sparse
+      -> ('s Matrix.Sparse.t, 'k, [`Dls|`SparseLu]) serial_t
+
+    (** Sets the ordering algorithm. A new symbolic factorization is
+        done at the next setup. *)
+    val set_ordering : ('s Matrix.Sparse.t, 'k, [>`SparseLu]) serial_t
+                       -> ordering -> unit
+
+    (** Sets the maximum number of iterative refinement steps applied to
+        solutions when pivots have been perturbed. The default is 3.
+        A solve fails recoverably if the refined solution does not
+        satisfy the system to a relative residual of
+        {% $\sqrt{\epsilon}$ %}.
+
+        @raise Invalid_argument If the argument is negative. *)
+    val set_max_refinements :
+      ('s Matrix.Sparse.t, 'k, [>`SparseLu]) serial_t -> int -> unit
+
+    (** Summaries of the work done by a sparse LU solver. *)
+    type stats = {
+      num_symbolic : int;
+        (** Number of symbolic factorizations (changes of pattern). *)
+      num_numeric : int;
+        (** Number of numeric factorizations. *)
+      num_perturbed : int;
+        (** Number of pivots perturbed in the last numeric
+            factorization. *)
+      num_refinements : int;
+        (** Total number of iterative refinement steps. *)
+      factor_nnz : int;
+        (** Number of off-diagonal entries in {% $L$ %} (and in
+            {% $U$ %}). *)
+      num_levels : int;
+        (** Height of the elimination tree, that is, the number of
+            sequential steps in a parallel numeric factorization. *)
+    }
+
+    (** Returns the statistics of a sparse LU solver. *)
+    val get_stats : ('s Matrix.Sparse.t, 'k, [>`SparseLu]) serial_t -> stats
+
+  end (* }}} *)
+
+  (** Creates a sparse LU solver. See {!SparseLu.make}.
+
+      @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+  val sparse_lu :
+       ?context:Context.t
+    -> ?ordering:SparseLu.ordering
+    -> 'k Nvector.serial
+    -> ('s, 'k) Matrix.sparse
+    -> ('s Matrix.Sparse.t, 'k, [`Dls|`SparseLu]) serial_t
+
+  (** A band solver for sparse matrices that become narrow-banded once
+      their unknowns are renumbered.
+
+      At the first setup, and whenever the sparsity pattern of the matrix
+      changes, the solver computes a symmetric permutation {% $P$ %} that
+      reduces the bandwidth ({!Sundials_Matrix.Sparse.rcm}). Each setup
+      copies {% $PAP^T$ %} into an internal band matrix and factors it
+      with the partitioned band solver of {!Spike} (a single band LU
+      without OpenMP). Solves permute the right-hand side and the solution,
+      so the session, and the Jacobian function, work on the original
+      ordering.
+
+      This solver is implemented in Sundials/ML (it is not part of
+      Sundials) and requires
+      {{!Sundials_Config.sundials_version}Config.sundials_version} >= 5.0.0. *)
+  module Reordered : sig (* {{{ *)
+
+    (** The ordering of the unknowns. *)
+    type ordering =
+      | Natural (** The original ordering. *)
+      | Rcm     (** Reverse Cuthill-McKee. *)
+
+    (** Creates a band solver for sparse matrices. The nvector and matrix
+        argument are used to determine the linear system size and to
+        assess compatibility with the linear solver implementation. The
+        matrix is used internally after the linear solver is attached to a
+        session. The default ordering is [Rcm]. The [partitions] argument
+        is as for {!Spike.band}.
+
+        @raise Config.NotImplementedBySundialsVersion Solver not available. *)
+    val band :
+         ?context:Context.t
+      -> ?ordering:ordering
+      -> ?partitions:int
+      -> 'k Nvector.serial
+      -> ('s, 'k) Matrix.sparse
+      -> ('s Matrix.Sparse.t, 'k, [`Dls|`Reordered]) serial_t
+
+    (** Summaries of the work done by a reordered band solver. The
+        bandwidths are those at the last reordering (all zero before the
+        first setup). *)
+    type stats = {
+      original_mu : int;   (** Upper bandwidth of the matrix. *)
+      original_ml : int;   (** Lower bandwidth of the matrix. *)
+      reordered_mu : int;  (** Upper bandwidth after reordering. *)
+      reordered_ml : int;  (** Lower bandwidth after reordering. *)
+      num_orderings : int; (** Number of reorderings (pattern changes). *)
+      num_setups : int;    (** Number of band factorizations. *)
+    }
+
+    (** Returns the statistics of a reordered band solver. *)
+    val get_stats :
+      ('s Matrix.Sparse.t, 'k, [>`Reordered]) serial_t -> stats
+
+    (** Returns the ratio of the operation counts of band factorizations
+        without and with the reordering, that is, an estimate of the
+        speedup of each setup. *)
+    val estimated_speedup :
+      ('s Matrix.Sparse.t, 'k, [>`Reordered]) serial_t -> float
+
+    (** Returns the permutation of the last reordering (with the
+        convention of {!Sundials_Matrix.Sparse.rcm}), or an empty array
+        before the first setup. *)
+    val get_permutation :
+      ('s Matrix.Sparse.t, 'k, [>`Reordered]) serial_t -> int array
+
+  end (* }}} *)
+
 end (* }}} *)
 
 (** Iterative Linear Solvers *)
@@ -358,6 +699,176 @@ module Iterative : sig (* {{{ *)
     -> ('d, 'k) Nvector.t
     -> ('m, 'd, 'k, [`Iter|`Pcg]) t
 
+  (** Krylov iterative solver using the GCRO-DR method (generalized
+      conjugate residual with inner orthogonalization and deflated
+      restarting) that carries a subspace from one solve into the next.
+
+      Newton iterations and successive time steps produce sequences of
+      closely-related linear systems. This solver keeps a small subspace of
+      directions that were hard to resolve (those for which the scaled and
+      preconditioned system matrix has the smallest singular values),
+      removes them from the residual at the start of each solve, and only
+      then runs GMRES cycles on the complement. This typically reduces the
+      number of linear iterations once the subspace has been established.
+
+      The solver is implemented in the OCaml library (not by Sundials) and
+      works with any nvector that provides the standard operations.
+
+      @since 5.0.0 *)
+  module Gcrodr : sig (* {{{ *)
+
+    (** Statistics on the recycled space.
+        Linear iteration counts do not include the [recycle_dim]
+        additional applications of the system matrix that are needed at
+        the start of each solve to update the recycled space
+        ([num_recycle_matvecs]). *)
+    type stats = {
+      num_solves : int;           (** Total number of calls to solve. *)
+      num_iters : int;            (** Total number of linear iterations. *)
+      num_recycle_matvecs : int;  (** Total number of matrix-vector products
+                                      spent updating the recycled space. *)
+      recycle_dim : int;          (** Current dimension of the recycled
+                                      space. *)
+    }
+
+    (** Creates a GCRO-DR solver. The nvector argument is used as a template.
+        The [maxl] argument gives the number of Arnoldi steps per cycle
+        (defaults to 10), [recycle] gives the maximum dimension of the
+        recycled space (defaults to 4, must be between 1 and [maxl]),
+        [max_restarts] gives the number of additional cycles allowed
+        per solve (defaults to 0, as for {!spgmr}), and [gs_type] chooses the
+        orthogonalization method (defaults to [ModifiedGS]).
+
+        @raise Invalid_argument if [recycle] is out of range. *)
+    val make :
+         ?context:Context.t
+      -> ?maxl:int
+      -> ?recycle:int
+      -> ?max_restarts:int
+      -> ?gs_type:gramschmidt_type
+      -> ('d, 'k) Nvector.t
+      -> ('m, 'd, 'k, [`Iter|`Gcrodr]) t
+
+    (** Sets the number of additional cycles allowed per solve. *)
+    val set_max_restarts : ('m, 'd, 'k, [>`Gcrodr]) t -> int -> unit
+
+    (** Sets the Gram-Schmidt orthogonalization method. *)
+    val set_gs_type : ('m, 'd, 'k, [>`Gcrodr]) t -> gramschmidt_type -> unit
+
+    (** Discards the recycled space, for instance after a large change in
+        the system. *)
+    val reset : ('m, 'd, 'k, [>`Gcrodr]) t -> unit
+
+    (** Returns statistics on solves and the recycled space. Comparing
+        [num_iters] against a {!spgmr} solver on the same problem shows the
+        iterations saved by recycling. *)
+    val get_stats : ('m, 'd, 'k, [>`Gcrodr]) t -> stats
+
+    (** Returns the current dimension of the recycled space. *)
+    val get_recycle_dim : ('m, 'd, 'k, [>`Gcrodr]) t -> int
+
+  end (* }}} *)
+
+  (** Krylov iterative solver with subspace recycling.
+      An alias for {!Gcrodr.make}. *)
+  val gcrodr :
+       ?context:Context.t
+    -> ?maxl:int
+    -> ?recycle:int
+    -> ?max_restarts:int
+    -> ?gs_type:gramschmidt_type
+    -> ('d, 'k) Nvector.t
+    -> ('m, 'd, 'k, [`Iter|`Gcrodr]) t
+
+  (** Pipelined Krylov solvers for distributed nvectors.
+
+      The standard solvers perform several global reductions per iteration
+      (for orthogonalization and norms), and, on many MPI ranks, their
+      latency can dominate the cost of a linear iteration. The solvers in
+      this module instead combine all the inner products of an iteration
+      into a single reduction and overlap it with the next application of
+      the preconditioner and system matrix.
+
+      When the {!Nvector_parallel} module is linked, and the nvector is a
+      parallel, MPI many-vector, or MPI+X nvector, the reduction is
+      performed with a nonblocking {cconst MPI_Iallreduce}. Otherwise the
+      solvers use {cconst N_VDotProdMultiAllReduce} (or ordinary dot
+      products for nvectors without local reduction operations) and only
+      the reduction count is improved.
+
+      The pipelined variants trade some numerical robustness for fewer
+      synchronizations. In particular, the residual norm that they monitor
+      is a recurrence and may drift slightly from the true residual norm.
+
+      @since 6.0.0 *)
+  module Pipelined : sig (* {{{ *)
+
+    (** Statistics on global reductions. *)
+    type stats = {
+      num_reductions : int;     (** Total number of global reductions.
+                                    Without local operations, each dot
+                                    product counts as one, unless the
+                                    vector fuses them. *)
+      num_norm_fallbacks : int; (** Number of GMRES iterations where
+                                    cancellation forced an extra blocking
+                                    norm computation. *)
+      overlapped : bool;        (** Whether the last solve used nonblocking
+                                    reductions. *)
+    }
+
+    (** Pipelined preconditioned conjugate gradient method (Ghysels and
+        Vanroose). The system matrix and preconditioner must be symmetric.
+        The [maxl] argument gives the maximum number of iterations
+        (defaults to 5), and the nvector argument is used as a template.
+        As for {!pcg}, only the first scaling vector is used, to weight
+        the residual norm. *)
+    val pcg :
+         ?context:Context.t
+      -> ?maxl:int
+      -> ('d, 'k) Nvector.t
+      -> ('m, 'd, 'k, [`Iter|`Pipelined]) t
+
+    (** Pipelined GMRES method (the p(1) variant of Ghysels, Ashby,
+        Meerbergen, and Vanroose). The [maxl] argument gives the maximum
+        dimension of the Krylov subspace (defaults to 5), and
+        [max_restarts] the number of restarts (defaults to 0).
+        The nvector argument is used as a template. *)
+    val gmres :
+         ?context:Context.t
+      -> ?maxl:int
+      -> ?max_restarts:int
+      -> ('d, 'k) Nvector.t
+      -> ('m, 'd, 'k, [`Iter|`Pipelined]) t
+
+    (** Sets the number of GMRES restarts. It has no effect on
+        {!pcg} solvers. *)
+    val set_max_restarts : ('m, 'd, 'k, [>`Pipelined]) t -> int -> unit
+
+    (** Returns statistics on global reductions. *)
+    val get_stats : ('m, 'd, 'k, [>`Pipelined]) t -> stats
+
+    (** Returns the total number of global reductions. *)
+    val get_num_reductions : ('m, 'd, 'k, [>`Pipelined]) t -> int
+
+  end (* }}} *)
+
+  (** Pipelined conjugate gradient solver.
+      An alias for {!Pipelined.pcg}. *)
+  val pipelined_pcg :
+       ?context:Context.t
+    -> ?maxl:int
+    -> ('d, 'k) Nvector.t
+    -> ('m, 'd, 'k, [`Iter|`Pipelined]) t
+
+  (** Pipelined GMRES solver.
+      An alias for {!Pipelined.gmres}. *)
+  val pipelined_gmres :
+       ?context:Context.t
+    -> ?maxl:int
+    -> ?max_restarts:int
+    -> ('d, 'k) Nvector.t
+    -> ('m, 'd, 'k, [`Iter|`Pipelined]) t
+
   (** Low-level routines on arrays. *)
   module Algorithms : sig (* {{{ *)
 
@@ -217,11 +217,20 @@ type (_, 'nd, 'nk, _) solver_data =
   | Spgmr       : ('m, 'nd, 'nk, [>`Spgmr])   solver_data
   | Sptfqmr     : ('m, 'nd, 'nk, [>`Sptfqmr]) solver_data
   | Pcg         : ('m, 'nd, 'nk, [>`Pcg])     solver_data
+  | Gcrodr      : ('m, 'nd, 'nk, [>`Gcrodr])  solver_data
+  | Pipelined   : ('m, 'nd, 'nk, [>`Pipelined]) solver_data
   (* Direct Linear Solvers *)
   | Dense       : (Matrix.Dense.t, 'nd, 'nk, [>`Dls]) solver_data
   | LapackDense : (Matrix.Dense.t, 'nd, 'nk, [>`Dls]) solver_data
   | Band        : (Matrix.Band.t,  'nd, 'nk, [>`Dls]) solver_data
   | LapackBand  : (Matrix.Band.t,  'nd, 'nk, [>`Dls]) solver_data
+  | MixedDense  : (Matrix.Dense.t, 'nd, 'nk, [>`Mixed]) solver_data
+  | MixedBand   : (Matrix.Band.t,  'nd, 'nk, [>`Mixed]) solver_data
+  | SpikeBand   : (Matrix.Band.t,  'nd, 'nk, [>`Spike]) solver_data
+  | SparseLu    : ('s Matrix.Sparse.t, 'nd, 'nk, [>`SparseLu]) solver_data
+  | ReorderedBand : ('s Matrix.Sparse.t, 'nd, 'nk, [>`Reordered]) solver_data
+  (* A direct solver wrapped by sunml_lsolver_cached_wrap *)
+  | Cached      : ('m, 'nd, 'nk, [>`Cached]) solver_data
   | Klu         : Klu.info
                   -> ('s Matrix.Sparse.t, 'nd, 'nk, [>`Klu]) solver_data
   | Superlumt   : Superlumt.info
@@ -319,9 +328,19 @@ external c_set_prec_type
     -> unit
   = "sunml_lsolver_set_prec_type"
 
+external c_gcrodr_set_prec_type
+  : ('m, 'nd, 'nk) cptr -> Iterative.preconditioning_type -> bool -> unit
+  = "sunml_lsolver_gcrodr_set_prec_type"
+
+external c_pipelined_set_prec_type
+  : ('m, 'nd, 'nk) cptr -> Iterative.preconditioning_type -> bool -> unit
+  = "sunml_lsolver_pipelined_set_prec_type"
+
 let impl_set_prec_type (type t) rawptr solver prec_type docheck =
   match (solver : ('m, 'nd, 'nk, t) solver_data) with
   | Custom (ldata, { Custom.set_prec_type = f }) -> f ldata prec_type
+  | Gcrodr -> c_gcrodr_set_prec_type rawptr prec_type docheck
+  | Pipelined -> c_pipelined_set_prec_type rawptr prec_type docheck
   | _ -> c_set_prec_type rawptr solver prec_type docheck
 
 external c_make_custom
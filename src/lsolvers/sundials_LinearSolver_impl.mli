@@ -107,10 +107,20 @@ type (_, 'nd, 'nk, _) solver_data =
   | Spgmr : ('m, 'nd, 'nk, [> `Spgmr ]) solver_data
   | Sptfqmr : ('m, 'nd, 'nk, [> `Sptfqmr ]) solver_data
   | Pcg : ('m, 'nd, 'nk, [> `Pcg ]) solver_data
+  | Gcrodr : ('m, 'nd, 'nk, [> `Gcrodr ]) solver_data
+  | Pipelined : ('m, 'nd, 'nk, [> `Pipelined ]) solver_data
   | Dense : (Sundials.Matrix.Dense.t, 'nd, 'nk, [> `Dls ]) solver_data
   | LapackDense : (Sundials.Matrix.Dense.t, 'nd, 'nk, [> `Dls ]) solver_data
   | Band : (Sundials.Matrix.Band.t, 'nd, 'nk, [> `Dls ]) solver_data
   | LapackBand : (Sundials.Matrix.Band.t, 'nd, 'nk, [> `Dls ]) solver_data
+  | MixedDense : (Sundials.Matrix.Dense.t, 'nd, 'nk, [> `Mixed ]) solver_data
+  | MixedBand : (Sundials.Matrix.Band.t, 'nd, 'nk, [> `Mixed ]) solver_data
+  | SpikeBand : (Sundials.Matrix.Band.t, 'nd, 'nk, [> `Spike ]) solver_data
+  | SparseLu :
+      ('s Sundials.Matrix.Sparse.t, 'nd, 'nk, [> `SparseLu ]) solver_data
+  | ReorderedBand :
+      ('s Sundials.Matrix.Sparse.t, 'nd, 'nk, [> `Reordered ]) solver_data
+  | Cached : ('m, 'nd, 'nk, [> `Cached ]) solver_data
   | Klu :
       Klu.info -> ('s Sundials.Matrix.Sparse.t, 'nd, 'nk, [> `Klu ])
                   solver_data
@@ -159,6 +169,12 @@ external c_set_prec_type :
   ('m, 'nd, 'nk, 't) solver_data ->
   Iterative.preconditioning_type -> bool -> unit
   = "sunml_lsolver_set_prec_type"
+external c_gcrodr_set_prec_type :
+  ('m, 'nd, 'nk) cptr -> Iterative.preconditioning_type -> bool -> unit
+  = "sunml_lsolver_gcrodr_set_prec_type"
+external c_pipelined_set_prec_type :
+  ('m, 'nd, 'nk) cptr -> Iterative.preconditioning_type -> bool -> unit
+  = "sunml_lsolver_pipelined_set_prec_type"
 val impl_set_prec_type :
   ('m, 'nd, 'nk) cptr ->
   ('m, 'nd, 'nk, 't) solver_data ->
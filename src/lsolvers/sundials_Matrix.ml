@@ -738,6 +738,114 @@ module Sparse = struct (* {{{ *)
     if check_valid && not valid then raise Invalidated;
     tocsc rawptr
 
+  external c_rcm : cptr -> int array
+      = "sunml_matrix_sparse_rcm"
+
+  let rcm { rawptr; valid } =
+    if check_valid && not valid then raise Invalidated;
+    c_rcm rawptr
+
+  external c_bandwidths : cptr -> int array option -> int * int
+      = "sunml_matrix_sparse_bandwidths"
+
+  let bandwidths ?perm { rawptr; valid } =
+    if check_valid && not valid then raise Invalidated;
+    c_bandwidths rawptr perm
+
+  type probe =
+    | NaN
+    | Perturb of int
+
+  (* Columns at the same offset in different diagonal blocks are probed
+     together: the rows that respond identify the block, hence the column. *)
+  let detect ?(probe=NaN) ?blocks ?x n f =
+    if n <= 0 then invalid_arg "n";
+    let x = match x with
+            | Some x when RealArray.length x <> n -> invalid_arg "x"
+            | Some x -> x
+            | None -> RealArray.make n 0.0
+    in
+    let sizes = match blocks with None -> [| n |] | Some b -> b in
+    if Array.exists (fun s -> s <= 0) sizes
+       || Array.fold_left (+) 0 sizes <> n
+    then invalid_arg "blocks";
+    let start = Array.make (Array.length sizes) 0 in
+    for b = 1 to Array.length sizes - 1 do
+      start.(b) <- start.(b - 1) + sizes.(b - 1)
+    done;
+    let block = Array.make n 0 in
+    Array.iteri (fun b s -> Array.fill block start.(b) s b) sizes;
+    let ngroups = Array.fold_left max 0 sizes in
+    (* Group g perturbs column g of each block in a subset of the blocks.
+       With several blocks, the subsets are those whose index has a given
+       bit set or clear: any two blocks are separated by one of them, so a
+       change outside the perturbed blocks reveals a coupling.  *)
+    let nblocks = Array.length sizes in
+    let subsets =
+      if nblocks = 1 then [ fun _ -> true ]
+      else
+        let rec bits k acc =
+          if 1 lsl k >= nblocks then acc
+          else bits (k + 1) ((fun b -> (b lsr k) land 1 = 0)
+                             :: (fun b -> (b lsr k) land 1 = 1) :: acc)
+        in
+        bits 0 []
+    in
+
+    let cols = Array.make n [] in
+    let y = RealArray.create n and out0 = RealArray.create n
+    and out = RealArray.create n in
+    let is_nan v = v <> v in
+    let record g r =
+      let b = block.(r) in
+      if g >= sizes.(b) then invalid_arg "blocks: coupled blocks";
+      let c = start.(b) + g in
+      cols.(c) <- r :: cols.(c)
+    in
+    let sweep base perturb changed =
+      f base out0;
+      if RealArray.fold_left (fun a v -> a || is_nan v) false out0
+      then invalid_arg "x: function is not finite";
+      for g = 0 to ngroups - 1 do
+        List.iter (fun sel ->
+          RealArray.blit ~src:base ~dst:y;
+          Array.iteri (fun b s -> if g < s && sel b then
+                                    let c = start.(b) + g in
+                                    y.{c} <- perturb y.{c}) sizes;
+          f y out;
+          for r = 0 to n - 1 do
+            if changed out0.{r} out.{r} then
+              if sel block.(r) then record g r
+              else invalid_arg "blocks: coupled blocks"
+          done) subsets
+      done
+    in
+    (match probe with
+     | NaN -> sweep x (fun _ -> nan) (fun _ v -> is_nan v)
+     | Perturb k ->
+         if k <= 0 then invalid_arg "probe";
+         let st = Random.State.make [| n; k |] in
+         let base = RealArray.create n in
+         for _i = 1 to k do
+           for i = 0 to n - 1 do
+             let v = x.{i} in
+             base.{i} <- v +. 0.1 *. (1.0 +. abs_float v)
+                                 *. (Random.State.float st 2.0 -. 1.0)
+           done;
+           sweep base (fun v -> v +. 1.0e-3 *. (1.0 +. abs_float v))
+                      (fun v0 v -> v <> v0)
+         done);
+
+    let cols = Array.map (List.sort_uniq compare) cols in
+    let nnz = Array.fold_left (fun s l -> s + List.length l) 0 cols in
+    let a = make CSC n n (max nnz 1) in
+    let idx = ref 0 in
+    Array.iteri (fun c rows ->
+        set_col a c !idx;
+        List.iter (fun r -> set a !idx r 0.0; incr idx) rows) cols;
+    set_col a n !idx;
+    a
+
   external c_space : cptr -> int * int
       = "sunml_matrix_sparse_space"
 
@@ -603,6 +603,74 @@ module Sparse : sig (* {{{ *)
       @matrix SUNMatSpace (SUNMatSpace_Sparse) *)
   val space : 's t -> int * int
 
+  (** {3:sparse_reorder Reordering} *)
+
+  (** Returns the reverse Cuthill-McKee ordering of a square matrix,
+      computed on the graph of its sparsity pattern symmetrized
+      ({% $A + A^T$ %}). In the result [p], row and column [p.(i)] of the
+      matrix become row and column [i] of the reordered matrix. The
+      ordering tends to reduce the bandwidth, so that
+      {!Sundials_LinearSolver.Direct.Reordered} can use a band
+      factorization.
+
+      Only the stored pattern matters: explicitly stored zeros count as
+      nonzeros.
+
+      @raise Invalid_argument The matrix is not square.
+      @raise Config.NotImplementedBySundialsVersion Not available. *)
+  val rcm : 's t -> int array
+
+  (** [mu, ml = bandwidths ?perm a] returns the upper and lower bandwidths
+      of the stored pattern of a square matrix [a], or, if [perm] is given,
+      of the matrix reordered symmetrically by [perm] (with the convention
+      of {!rcm}).
+
+      @raise Invalid_argument The matrix is not square or [perm] is not a
+                              permutation of the right length.
+      @raise Config.NotImplementedBySundialsVersion Not available. *)
+  val bandwidths : ?perm:int array -> 's t -> int * int
+
+  (** {3:sparse_detect Pattern detection} *)
+
+  (** How {!detect} finds the dependencies of a function. *)
+  type probe =
+    | NaN
+      (** Set inputs to [nan] and mark the outputs that become [nan].
+          This finds structural dependencies in one sweep, but misses those
+          hidden by comparisons or functions that discard [nan]. *)
+    | Perturb of int
+      (** [Perturb k] makes small changes to the inputs at [k] random
+          points near [x] and marks the outputs that change. Dependencies
+          whose derivative vanishes at all [k] points are missed. *)
+
+  (** [detect ?probe ?blocks ?x n f] returns, in CSC format, the sparsity
+      pattern of the Jacobian of a function [f y out] that computes [out]
+      from [y], both of length [n]. All stored values are [0.0]. For a
+      right-hand side function, take [fun y out -> f t0 y out].
+
+      The function is evaluated near the point [x] (by default, zero), where
+      it must be finite. A sweep (by default, [NaN]) evaluates [f] once plus
+      once per column, or, if [blocks] lists the sizes of the diagonal
+      blocks of a block-diagonal Jacobian (like the lengths of the
+      subvectors of a {!Nvector_many}), {% $2\lceil\log_2 b\rceil$ %}
+      times per column of the largest of the {% $b > 1$ %} blocks, so as
+      to check that no block depends on another.
+
+      The pattern can be passed to {!rcm} or copied into the matrix of a
+      sparse Jacobian function. The diagonal is only included where [f]
+      depends on it.
+
+      @raise Invalid_argument [x] has the wrong length, [f] is not finite
+                              at [x], or [blocks] does not partition [n] or
+                              the Jacobian couples its blocks. *)
+  val detect :
+       ?probe:probe
+    -> ?blocks:int array
+    -> ?x:RealArray.t
+    -> int
+    -> (RealArray.t -> RealArray.t -> unit)
+    -> csc t
+
   (** {3:sparse_lowlevel Low-level details} *)
 
   (** [set_rowval a idx i] sets the [idx]th row to [i]. *)
@@ -730,6 +798,11 @@ module ArrayDense : sig (* {{{ *)
       and [j] were swapped (in order, where [p.{0}] swaps against the
       original matrix [a]).
 
+      The factorization is cache-blocked: the columns are split
+      recursively and most of the work is done in matrix-matrix updates.
+      Matrices with at most 64 columns give exactly the same results as
+      the Sundials routine; larger ones agree with them up to rounding.
+
       @nodoc SUNDlsMat_denseGETRF
       @raise ZeroDiagonalElement Zero found in matrix diagonal *)
   val getrf : t -> LintArray.t -> unit
@@ -117,6 +117,18 @@ external c_set_print_level_fixedpoint : ('d, 'k, 's, 'v) cptr -> int -> unit
 external c_set_print_level_newton : ('d, 'k, 's, 'v) cptr -> int -> unit
   = "sunml_nlsolver_set_print_level_newton"
 
+external c_set_info_file_broyden : ('d, 'k, 's, 'v) cptr -> Logfile.t -> unit
+  = "sunml_nlsolver_set_info_file_broyden"
+
+external c_set_print_level_broyden : ('d, 'k, 's, 'v) cptr -> int -> unit
+  = "sunml_nlsolver_set_print_level_broyden"
+
+external c_set_info_file_tasklocal : ('d, 'k, 's, 'v) cptr -> Logfile.t -> unit
+  = "sunml_nlsolver_set_info_file_tasklocal"
+
+external c_set_print_level_tasklocal : ('d, 'k, 's, 'v) cptr -> int -> unit
+  = "sunml_nlsolver_set_print_level_tasklocal"
+
 (* - - - OCaml invoking init/setup/solve - - - *)
 
 let uw = Nvector.unwrap
@@ -130,6 +142,8 @@ let init (type v) ({ rawptr; solver } : ('d, 'k, 's, v) t) =
   | CustomSolverSens _   -> ()
   | FixedPointSolver _ -> c_init rawptr                      (* O/Cnls *)
   | NewtonSolver _ -> c_init rawptr
+  | BroydenSolver _ -> c_init rawptr
+  | TaskLocalSolver _ -> c_init rawptr
   | FixedPointSolverSens _ -> c_init rawptr
   | NewtonSolverSens _ -> c_init rawptr
 
@@ -138,7 +152,7 @@ let setup { rawptr; solver } ~y s =
   match solver with
   | CustomSolver     (_, { setup = Some f }) -> f (uw y) s   (* O/Onls *)
   | CustomSolver     (_, { setup = None   }) -> ()
-  | FixedPointSolver _ | NewtonSolver _
+  | FixedPointSolver _ | NewtonSolver _ | BroydenSolver _ | TaskLocalSolver _
       -> c_setup rawptr y s                                  (* O/Cnls *)
 
 let solve { rawptr; solver } ~y0 ~ycor ~w tol callLSetup s =
@@ -146,7 +160,7 @@ let solve { rawptr; solver } ~y0 ~ycor ~w tol callLSetup s =
   match solver with
   | CustomSolver (_, { solve = f })                          (* O/Onls *)
       -> f (uw y0) (uw ycor) (uw w) tol callLSetup s
-  | FixedPointSolver _ | NewtonSolver _
+  | FixedPointSolver _ | NewtonSolver _ | BroydenSolver _ | TaskLocalSolver _
       -> c_solve rawptr (y0, ycor, w, tol, callLSetup) s     (* O/Cnls *)
 
 (* - - - OCaml callback configuration - - - *)
@@ -157,6 +171,7 @@ let set_sys_fn { rawptr; solver; _ } cbf =
   | CustomSolver (_, { set_sys_fn = set })                   (* O/Onls *)
       -> set (fun y fg -> cbf (uw y) (uw fg))
   | FixedPointSolver (callbacks, _) | NewtonSolver callbacks (* O/Cnls *)
+  | BroydenSolver callbacks | TaskLocalSolver callbacks
       -> callbacks.sysfn <- cbf;
          c_set_sys_fn rawptr
 
@@ -173,6 +188,12 @@ let set_lsetup_fn (type v) ({ rawptr; solver; _ } : ('d, 'k, 's, v) t) cbf =
   | NewtonSolver callbacks ->
       callbacks.lsetupfn <- cbf;
       c_set_lsetup_fn rawptr
+  | BroydenSolver callbacks ->
+      callbacks.lsetupfn <- cbf;
+      c_set_lsetup_fn rawptr
+  | TaskLocalSolver callbacks ->
+      callbacks.lsetupfn <- cbf;
+      c_set_lsetup_fn rawptr
   | FixedPointSolverSens (callbacks, _) ->
       callbacks.lsetupfn <- cbf;
       c_set_lsetup_fn rawptr
@@ -187,6 +208,7 @@ let set_lsolve_fn { rawptr; solver; _ } cbf =
       -> set (fun b -> cbf (uw b))
   | CustomSolver (_, { set_lsolve_fn = None }) -> ()
   | FixedPointSolver (callbacks, _) | NewtonSolver callbacks  (* O/Cnls *)
+  | BroydenSolver callbacks | TaskLocalSolver callbacks
       -> callbacks.lsolvefn <- cbf;
          c_set_lsolve_fn rawptr
 
@@ -203,6 +225,7 @@ let set_convtest_fn (type d k s)
   | CustomSolver (_, { set_convtest_fn = Some set }) -> set ctfn  (* O/Onls *)
   | CustomSolver _ -> ()
   | FixedPointSolver (callbacks, _) | NewtonSolver callbacks      (* O/Cnls *)
+  | BroydenSolver callbacks | TaskLocalSolver callbacks
       -> (match ctfn with
         | CConvTest cfun ->
               callbacks.convtestfn <- empty_convtestfn;
@@ -282,6 +305,8 @@ let set_max_iters (type d k s v) ({ rawptr; solver; _ } : (d, k, s, v) t) i =
   | NewtonSolverSens _ -> c_set_max_iters rawptr i
   | FixedPointSolver _ -> c_set_max_iters rawptr i
   | NewtonSolver _ -> c_set_max_iters rawptr i
+  | BroydenSolver _ -> c_set_max_iters rawptr i
+  | TaskLocalSolver _ -> c_set_max_iters rawptr i
 
 let set_print_level (type d k s v) ({ rawptr; solver; _ } : (d, k, s, v) t) level =
   if Sundials_impl.Version.lt530
@@ -296,6 +321,8 @@ let set_print_level (type d k s v) ({ rawptr; solver; _ } : (d, k, s, v) t) leve
   | NewtonSolverSens _ -> c_set_print_level_newton rawptr level
   | FixedPointSolver _ -> c_set_print_level_fixedpoint rawptr level
   | NewtonSolver _ -> c_set_print_level_newton rawptr level
+  | BroydenSolver _ -> c_set_print_level_broyden rawptr level
+  | TaskLocalSolver _ -> c_set_print_level_tasklocal rawptr level
 
 let set_info_file (type d k s v)
                   ({ rawptr; solver; _ } as s : (d, k, s, v) t) ?print_level file =
@@ -310,7 +337,9 @@ let set_info_file (type d k s v)
    | FixedPointSolverSens _ -> c_set_info_file_fixedpoint rawptr file
    | FixedPointSolver _ -> c_set_info_file_fixedpoint rawptr file
    | NewtonSolverSens _ -> c_set_info_file_newton rawptr file
-   | NewtonSolver _ -> c_set_info_file_newton rawptr file);
+   | NewtonSolver _ -> c_set_info_file_newton rawptr file
+   | BroydenSolver _ -> c_set_info_file_broyden rawptr file
+   | TaskLocalSolver _ -> c_set_info_file_tasklocal rawptr file);
   (match print_level with None -> () | Some level -> set_print_level s level)
 
 let get_num_iters (type d k s v) ({ rawptr; solver; _ } : (d, k, s, v) t) =
@@ -324,6 +353,8 @@ let get_num_iters (type d k s v) ({ rawptr; solver; _ } : (d, k, s, v) t) =
   | NewtonSolverSens _ -> c_get_num_iters rawptr
   | FixedPointSolver _ -> c_get_num_iters rawptr
   | NewtonSolver _ -> c_get_num_iters rawptr
+  | BroydenSolver _ -> c_get_num_iters rawptr
+  | TaskLocalSolver _ -> c_get_num_iters rawptr
 
 let get_cur_iter (type d k s v) ({ rawptr; solver; _ } : (d, k, s, v) t) =
   check_compat ();
@@ -336,6 +367,8 @@ let get_cur_iter (type d k s v) ({ rawptr; solver; _ } : (d, k, s, v) t) =
   | NewtonSolverSens _ -> c_get_cur_iter rawptr
   | FixedPointSolver _ -> c_get_cur_iter rawptr
   | NewtonSolver _ -> c_get_cur_iter rawptr
+  | BroydenSolver _ -> c_get_cur_iter rawptr
+  | TaskLocalSolver _ -> c_get_cur_iter rawptr
 
 let get_num_conv_fails (type d k s v)
                        ({ rawptr; solver; _ } : (d, k, s, v) t) =
@@ -349,6 +382,8 @@ let get_num_conv_fails (type d k s v)
   | NewtonSolverSens _ -> c_get_num_conv_fails rawptr
   | FixedPointSolver _ -> c_get_num_conv_fails rawptr
   | NewtonSolver _ -> c_get_num_conv_fails rawptr
+  | BroydenSolver _ -> c_get_num_conv_fails rawptr
+  | TaskLocalSolver _ -> c_get_num_conv_fails rawptr
 
 type ('d, 's) c_sysfn
 type ('d, 's) c_lsetupfn
@@ -487,7 +522,9 @@ module Newton = struct (* {{{ *)
          | true, _ -> Some (fun y fg -> callbacks.sysfn (uw y) (uw fg))
          | _, None -> None
          | _, Some cfns -> Some (c_call_sys_fn cfns))
-    | FixedPointSolver _ | CustomSolver _ -> invalid_arg "not a Newton solver"
+    | FixedPointSolver _ | BroydenSolver _ | TaskLocalSolver _
+    | CustomSolver _ ->
+        invalid_arg "not a Newton solver"
 
 end (* }}} *)
 
@@ -550,13 +587,103 @@ module FixedPoint = struct (* {{{ *)
          | true, _ -> Some (fun y fg -> callbacks.sysfn (uw y) (uw fg))
          | _, None -> None
          | _, Some cfns -> Some (c_call_sys_fn cfns))
-    | NewtonSolver _ | CustomSolver _ -> invalid_arg "not a Newton solver"
+    | NewtonSolver _ | BroydenSolver _ | TaskLocalSolver _
+    | CustomSolver _ ->
+        invalid_arg "not a Newton solver"
 
   let set_damping { rawptr; _ } beta =
     c_set_damping rawptr beta
 
 end (* }}} *)
 
+module Broyden = struct (* {{{ *)
+
+  external c_make
+    : ('d, 'k) Nvector.t
+      -> int
+      -> ('d, 's) callbacks Weak.t
+      -> Sundials.Context.t
+      -> ('d, 'k, 's, [`Nvec]) cptr
+    = "sunml_nlsolver_broyden_make"
+
+  external c_get_num_restarts : ('d, 'k, 's, [`Nvec]) cptr -> int
+    = "sunml_nlsolver_broyden_get_num_restarts"
+
+  let make ?context ?(max_vectors=5) y =
+    if Sundials_impl.Version.lt500
+      then raise Config.NotImplementedBySundialsVersion;
+    if max_vectors < 1 then invalid_arg "max_vectors must be positive";
+    let ctx = Sundials_impl.Context.get context in
+    let callbacks = empty_callbacks () in
+    {
+      rawptr    = c_make y max_vectors (weak_wrap callbacks) ctx;
+      solver    = BroydenSolver callbacks;
+      context   = ctx;
+      info_file = None;
+      attached  = false;
+    }
+
+  let get_num_restarts { rawptr; solver; _ } =
+    match (solver : ('d, 'k, 's, [`Nvec]) solver) with
+    | BroydenSolver _ -> c_get_num_restarts rawptr
+    | NewtonSolver _ | FixedPointSolver _ | TaskLocalSolver _
+    | CustomSolver _ ->
+        invalid_arg "not a Broyden solver"
+
+end (* }}} *)
+
+module TaskLocal = struct (* {{{ *)
+
+  external c_make
+    : ('d, 'k) Nvector.t
+      -> int
+      -> int
+      -> (int * int) option
+      -> bool
+      -> ('d, 's) callbacks Weak.t
+      -> Sundials.Context.t
+      -> ('d, 'k, 's, [`Nvec]) cptr
+    = "sunml_nlsolver_tasklocal_make_byte"
+      "sunml_nlsolver_tasklocal_make"
+
+  external c_get_num_setups : ('d, 'k, 's, [`Nvec]) cptr -> int
+    = "sunml_nlsolver_tasklocal_get_num_setups"
+
+  let make ?context ?bandwidths ?(full_newton=false)
+           ~block_size ?local_length y =
+    if Sundials_impl.Version.lt500
+      then raise Config.NotImplementedBySundialsVersion;
+    if block_size < 1 then invalid_arg "block_size must be positive";
+    let local_length =
+      match local_length with
+      | None -> -1
+      | Some n when n < 0 -> invalid_arg "local_length must not be negative"
+      | Some n -> n
+    in
+    (match bandwidths with
+     | Some (mu, ml) when mu < 0 || ml < 0 ->
+         invalid_arg "bandwidths must not be negative"
+     | _ -> ());
+    let ctx = Sundials_impl.Context.get context in
+    let callbacks = empty_callbacks () in
+    {
+      rawptr    = c_make y local_length block_size bandwidths full_newton
+                         (weak_wrap callbacks) ctx;
+      solver    = TaskLocalSolver callbacks;
+      context   = ctx;
+      info_file = None;
+      attached  = false;
+    }
+
+  let get_num_setups { rawptr; solver; _ } =
+    match (solver : ('d, 'k, 's, [`Nvec]) solver) with
+    | TaskLocalSolver _ -> c_get_num_setups rawptr
+    | NewtonSolver _ | FixedPointSolver _ | BroydenSolver _
+    | CustomSolver _ ->
+        invalid_arg "not a task-local solver"
+
+end (* }}} *)
+
 module Custom = struct (* {{{ *)
 
   external c_make
@@ -455,6 +455,114 @@ module FixedPoint : sig (* {{{ *)
 
 end (* }}} *)
 
+(** Quasi-Newton nonlinear solver with limited-memory Broyden updates.
+
+    The solver is used like {!Newton}, with the same callbacks, but the
+    solutions of linear systems with the iteration matrix only provide the
+    initial approximation of the inverse Jacobian. Within each call to
+    {!solve}, the approximation is improved by "good" Broyden updates
+    computed from the previous steps, in a norm weighted by the error
+    weights. This retains fast convergence when the iteration matrix is
+    out of date, so that an integrator fails to converge, and reevaluates
+    and refactors the Jacobian, less often than with {!Newton},
+    particularly on mildly nonlinear problems. Each iteration costs a
+    residual evaluation, a linear solve, and some vector operations on the
+    stored steps. See examples/extensions/broyden_roberts.ml.
+
+    With {!set_print_level}, the weighted norm of each step is printed,
+    whether or not Sundials is built with
+    {cconst SUNDIALS_BUILD_WITH_MONITORING}. *)
+module Broyden : sig (* {{{ *)
+
+  (** Creates a quasi-Newton nonlinear solver for systems of the form
+      {% $F(y) = 0$ %}. At most [max_vectors] previous steps are kept
+      (the default is 5); the updates are then restarted.
+
+      @raise Config.NotImplementedBySundialsVersion Requires Sundials >= 5.0.0 *)
+  val make :
+       ?context:Context.t
+    -> ?max_vectors:int
+    -> ('d, 'k) Nvector.t
+    -> ('d, 'k, 's, [`Nvec]) t
+
+  (** Returns the number of times that the Broyden updates were discarded,
+      either because [max_vectors] was reached or because an update was
+      nearly singular.
+
+      Raises [Invalid_argument] if called on a nonlinear solver that was not
+      created by this module. *)
+  val get_num_restarts : ('d, 'k, 's, [`Nvec]) t -> int
+
+end (* }}} *)
+
+(** Newton solver for nonlinear systems whose Jacobian is block diagonal.
+
+    The local part of the unknowns (on each rank, for parallel nvectors)
+    is split into contiguous blocks of [block_size] unknowns, and the
+    Jacobian {% $J$ %} of the nonlinear system is approximated by its
+    diagonal blocks {% $J_1, \ldots, J_m$ %}. This is exact when the
+    implicit terms are local to a block, e.g., stiff reactions within each
+    cell of a grid, or all the unknowns of a rank. The blocks are computed
+    by difference quotients of the system function, where the same column
+    of every block is perturbed at once, and factored by dense (or band) LU
+    decomposition. The Newton steps are then computed block by block.
+
+    The Jacobian, the factorizations, and the steps require no
+    communication: each iteration involves a single global reduction, for
+    the convergence test of the integrator, plus any communication done
+    by the system function itself. The solver replaces both the nonlinear
+    and the linear solver of an integrator, and works with the
+    implicit parts of ARKStep, and with CVODE and IDA: no linear solver
+    need be given, and if one is, it is not used by this solver. The
+    nvectors must provide a local data array, which is the case for the
+    serial, OpenMP, Pthreads, parallel, and MPIPlusX nvectors, but not for
+    many-vectors.
+
+    Since the system function includes the scaling of the implicit terms by
+    the integrator, the Jacobian is recomputed at the beginning of each
+    call to {!solve}, at a cost of [block_size] (or [mu + ml + 1]) system
+    function evaluations, and its factorization is checked for singularity
+    with one extra reduction. The blocks are computed, factored, and
+    solved in parallel when Sundials/ML is built with OpenMP. See
+    examples/extensions/tasklocal_cells.ml.
+
+    With {!set_print_level}, the weighted norm of each step is printed,
+    at the cost of one more reduction per iteration. *)
+module TaskLocal : sig (* {{{ *)
+
+  (** Creates a task-local Newton solver for systems of the form
+      {% $F(y) = 0$ %}. The [local_length] unknowns of the local array
+      of the nvector are split into blocks of [block_size] unknowns;
+      [local_length] must be a multiple of [block_size]. It is taken from
+      the nvector when omitted, and must match the local length of the
+      nvector when the nvector provides one. The blocks are
+      dense unless [bandwidths] gives their upper and lower bandwidths
+      [(mu, ml)]. If [full_newton] is [true], the blocks are recomputed and
+      refactored at every iteration rather than only at the start of each
+      solve (the default is [false]).
+
+      @raise Invalid_argument The nvector has no local data array, or the
+                              lengths or bandwidths are invalid or do not
+                              match the nvector.
+      @raise Config.NotImplementedBySundialsVersion Requires Sundials >= 5.0.0 *)
+  val make :
+       ?context:Context.t
+    -> ?bandwidths:int * int
+    -> ?full_newton:bool
+    -> block_size:int
+    -> ?local_length:int
+    -> ('d, 'k) Nvector.t
+    -> ('d, 'k, 's, [`Nvec]) t
+
+  (** Returns the number of times that the diagonal blocks of the Jacobian
+      were computed and factored.
+
+      Raises [Invalid_argument] if called on a nonlinear solver that was not
+      created by this module. *)
+  val get_num_setups : ('d, 'k, 's, [`Nvec]) t -> int
+
+end (* }}} *)
+
 (** Custom nonlinear solvers.
 
     @nonlinsol <SUNNonlinSol_API_link.html#implementing-a-custom-sunnonlinearsolver-module> Implementing a Custom SUNNonlinearSolver Module *)
@@ -91,6 +91,16 @@ type ('d, 'k, 's, _) solver =
                             C-NLS to OCaml callback: backlink to 'd *)
       -> ('d, 'k, 's, [`Sens]) solver
 
+  (* C-NLS used from C or OCaml *)
+  | BroydenSolver :
+      ('d, 's) callbacks (* as for NewtonSolver *)
+      -> ('d, 'k, 's, [`Nvec]) solver
+
+  (* C-NLS used from C or OCaml *)
+  | TaskLocalSolver :
+      ('d, 's) callbacks (* as for NewtonSolver *)
+      -> ('d, 'k, 's, [`Nvec]) solver
+
   (* C-NLS used from C or OCaml *)
   | FixedPointSolver :
       ('d, 's) callbacks (* C-NLS to C callback: only used for convtestfn
@@ -199,6 +209,8 @@ let get_type (type d k s v) ({ solver; _ } : (d, k, s, v) nonlinear_solver) =
   | FixedPointSolverSens _ -> FixedPoint
   | NewtonSolver _ -> RootFind
   | NewtonSolverSens _ -> RootFind
+  | BroydenSolver _ -> RootFind
+  | TaskLocalSolver _ -> RootFind
   | CustomSolver (_, { nls_type }) -> nls_type
   | CustomSolverSens (_, { nls_type }) -> nls_type
 
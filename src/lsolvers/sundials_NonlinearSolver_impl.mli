@@ -27,6 +27,8 @@ type ('d, 'k, 's, _) solver =
   | NewtonSolverSens :
       (('d, 'k) Senswrapper.t, 's) callbacks -> ('d, 'k, 's, [ `Sens ])
                                                 solver
+  | BroydenSolver : ('d, 's) callbacks -> ('d, 'k, 's, [ `Nvec ]) solver
+  | TaskLocalSolver : ('d, 's) callbacks -> ('d, 'k, 's, [ `Nvec ]) solver
   | FixedPointSolver : ('d, 's) callbacks *
       int -> ('d, 'k, 's, [ `Nvec ]) solver
   | FixedPointSolverSens : (('d, 'k) Senswrapper.t, 's) callbacks *
@@ -0,0 +1,750 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Binary files of matrices and arrays, and MatrixMarket import.
+ *
+ * A file is read by mapping it into memory (privately, so writes to the
+ * views are copy-on-write and never reach the file).  The header is
+ * decoded in Sundials_BinaryFile; the functions here only create views of
+ * the mapping, copy sections into existing bigarrays, compute checksums,
+ * and write files.
+ *
+ * A mapping is described by a bigarray proxy, shared by a custom block
+ * (passed to the functions below) and by the views.  The views are
+ * bigarrays of kind CAML_BA_MAPPED_FILE, like those of Unix.map_file, so
+ * the runtime also shares the proxy with the subarrays and slices taken
+ * from them, and the file is unmapped once the custom block and all of
+ * these arrays are unreachable.  Without mmap, the file is read into a
+ * malloc'ed buffer and the views are managed bigarrays, whose proxy
+ * buffer the runtime frees in the same way.
+ *
+ * The checksum is a 64-bit FNV-1a hash over the bytes of the sections,
+ * chained from one section to the next.
+ *
+ * MatrixMarket files are parsed directly from the mapping in two passes:
+ * the header is read first to size the sparse matrix, then the entries
+ * are read as triplets (mirroring symmetric and skew-symmetric ones) and
+ * put in compressed form by two stable counting sorts, first on the
+ * minor index and then on the major index, so that the minor indices
+ * are sorted within each column (CSC) or row (CSR).  */
+
+#include "../config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+#include <caml/custom.h>
+#include <caml/bigarray.h>
+
+#include "../sundials/sundials_ml.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+/* Must agree with Sundials_BinaryFile. */
+#define HEADER_SIZE	128
+#define CHECKSUM_OFFSET	104
+#define OFFSETS_OFFSET	56
+#define NUM_SECTIONS	3
+
+#define FNV_OFFSET_BASIS	UINT64_C(0xcbf29ce484222325)
+#define FNV_PRIME		UINT64_C(0x100000001b3)
+
+/* The data and size of the proxy are the address and size of the whole
+ * mapping. */
+#define MAPPING(v) (*(struct caml_ba_proxy **)Data_custom_val(v))
+
+/* The reference count of a proxy is atomic from OCaml 5. */
+static void retain_mapping(struct caml_ba_proxy *m)
+{
+#if 50000 <= OCAML_VERSION
+    atomic_fetch_add(&m->refcount, 1);
+#else
+    ++m->refcount;
+#endif
+}
+
+static void release_mapping(struct caml_ba_proxy *m)
+{
+#if 50000 <= OCAML_VERSION
+    if (atomic_fetch_sub(&m->refcount, 1) != 1) return;
+#else
+    if (--m->refcount != 0) return;
+#endif
+#ifndef _WIN32
+    if (m->data != NULL) munmap(m->data, m->size);
+#else
+    free(m->data);
+#endif
+    free(m);
+}
+
+static void finalize_mapping(value vm)
+{
+    if (MAPPING(vm) != NULL) release_mapping(MAPPING(vm));
+}
+
+#ifndef _WIN32
+/* The operations of the views are those of other bigarrays, except for
+ * finalization (as for Unix.map_file). */
+static struct custom_operations view_ops;
+
+static void finalize_view(value v)
+{
+    struct caml_ba_array *b = Caml_ba_array_val(v);
+
+    if (b->proxy != NULL) release_mapping(b->proxy);
+}
+#endif
+
+CAMLprim value sunml_binaryfile_init_module(value vunit)
+{
+    CAMLparam1(vunit);
+#ifndef _WIN32
+    view_ops = *Custom_ops_val(caml_ba_alloc_dims(BIGARRAY_FLOAT, 1, NULL, 0));
+    view_ops.finalize = finalize_view;
+#endif
+    CAMLreturn(Val_unit);
+}
+
+CAMLprim value sunml_binaryfile_map(value vpath)
+{
+    CAMLparam1(vpath);
+    CAMLlocal1(vm);
+    struct caml_ba_proxy *m;
+
+    vm = caml_alloc_final(1, &finalize_mapping, 1, 10);
+    MAPPING(vm) = NULL;
+
+    m = calloc(1, sizeof(struct caml_ba_proxy));
+    if (m == NULL) caml_raise_out_of_memory();
+    m->refcount = 1;
+
+#ifndef _WIN32
+    {
+	struct stat st;
+	int fd = open(String_val(vpath), O_RDONLY);
+
+	if (fd < 0 || fstat(fd, &st) < 0) {
+	    int err = errno;
+	    if (fd >= 0) close(fd);
+	    free(m);
+	    caml_failwith(strerror(err));
+	}
+
+	m->size = st.st_size;
+	if (m->size > 0) {
+	    m->data = mmap(NULL, m->size, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE, fd, 0);
+	    if (m->data == MAP_FAILED) {
+		int err = errno;
+		close(fd);
+		free(m);
+		caml_failwith(strerror(err));
+	    }
+	}
+	close(fd);
+    }
+#else
+    {
+	/* Without mmap, read the whole file into memory. */
+	FILE *file = fopen(String_val(vpath), "rb");
+	long size;
+
+	if (file == NULL) {
+	    free(m);
+	    caml_failwith(strerror(errno));
+	}
+	if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0
+		|| fseek(file, 0, SEEK_SET) != 0) {
+	    int err = errno;
+	    fclose(file);
+	    free(m);
+	    caml_failwith(strerror(err));
+	}
+	m->size = size;
+	if (size > 0) {
+	    m->data = malloc(size);
+	    if (m->data == NULL) {
+		fclose(file);
+		free(m);
+		caml_raise_out_of_memory();
+	    }
+	    if (fread(m->data, 1, size, file) != (size_t)size) {
+		fclose(file);
+		free(m->data);
+		free(m);
+		caml_failwith("short read");
+	    }
+	}
+	fclose(file);
+    }
+#endif
+
+    MAPPING(vm) = m;
+    CAMLreturn(vm);
+}
+
+CAMLprim value sunml_binaryfile_size(value vm)
+{
+    CAMLparam1(vm);
+    CAMLreturn(Val_long(MAPPING(vm)->size));
+}
+
+/* The header, or all of the file if it is shorter. */
+CAMLprim value sunml_binaryfile_header(value vm)
+{
+    CAMLparam1(vm);
+    CAMLlocal1(vr);
+    struct caml_ba_proxy *m = MAPPING(vm);
+    size_t n = m->size < HEADER_SIZE ? m->size : HEADER_SIZE;
+
+    vr = caml_alloc_string(n);
+    if (n > 0) memcpy(Bytes_val(vr), m->data, n);
+
+    CAMLreturn(vr);
+}
+
+static char *section(struct caml_ba_proxy *m, value voff, size_t len)
+{
+    intnat off = Long_val(voff);
+
+    if (off < 0 || (size_t)off > m->size || len > m->size - off)
+	caml_invalid_argument("BinaryFile: section outside of file");
+    return (char *)m->data + off;
+}
+
+static uintnat float_byte_size(value vba)
+{
+    struct caml_ba_array *ba = Caml_ba_array_val(vba);
+    uintnat n = sizeof(double);
+    int i;
+
+    for (i = 0; i < ba->num_dims; ++i) n *= ba->dim[i];
+    return n;
+}
+
+static int index_size(value vba)
+{
+    switch (Caml_ba_array_val(vba)->flags & CAML_BA_KIND_MASK) {
+    case CAML_BA_INT32:
+	return 4;
+    default:
+	return 8;
+    }
+}
+
+static int64_t get_index(const char *p, int size, uintnat i)
+{
+    int32_t i32;
+    int64_t i64;
+
+    if (size == 4) {
+	memcpy(&i32, p + 4 * i, 4);
+	return i32;
+    }
+    memcpy(&i64, p + 8 * i, 8);
+    return i64;
+}
+
+static void set_index(char *p, int size, uintnat i, int64_t x)
+{
+    int32_t i32 = (int32_t)x;
+
+    if (size == 4) memcpy(p + 4 * i, &i32, 4);
+    else memcpy(p + 8 * i, &x, 8);
+}
+
+/* Views of the mapping. */
+
+static value alloc_view(struct caml_ba_proxy *m, char *p,
+			int num_dims, intnat *dims)
+{
+    value v;
+
+#ifndef _WIN32
+    v = caml_ba_alloc(BIGARRAY_FLOAT | CAML_BA_MAPPED_FILE, num_dims, p, dims);
+    Custom_ops_val(v) = &view_ops;
+#else
+    v = caml_ba_alloc(BIGARRAY_FLOAT | CAML_BA_MANAGED, num_dims, p, dims);
+#endif
+    Caml_ba_array_val(v)->proxy = m;
+    retain_mapping(m);
+    return v;
+}
+
+CAMLprim value sunml_binaryfile_array1(value vm, value voff, value vn)
+{
+    CAMLparam3(vm, voff, vn);
+    intnat n = Long_val(vn);
+    char *p;
+
+    if (n < 0) caml_invalid_argument("BinaryFile: negative size");
+    p = section(MAPPING(vm), voff, (size_t)n * sizeof(double));
+
+    CAMLreturn(alloc_view(MAPPING(vm), p, 1, &n));
+}
+
+CAMLprim value sunml_binaryfile_array2(value vm, value voff,
+				       value vd0, value vd1)
+{
+    CAMLparam4(vm, voff, vd0, vd1);
+    intnat dims[2] = { Long_val(vd0), Long_val(vd1) };
+    char *p;
+
+    if (dims[0] < 0 || dims[1] < 0)
+	caml_invalid_argument("BinaryFile: negative size");
+    p = section(MAPPING(vm), voff, (size_t)dims[0] * dims[1] * sizeof(double));
+
+    CAMLreturn(alloc_view(MAPPING(vm), p, 2, dims));
+}
+
+/* Copying sections into existing bigarrays. */
+
+CAMLprim value sunml_binaryfile_read_floats(value vm, value voff, value vdst)
+{
+    CAMLparam3(vm, voff, vdst);
+    uintnat n = float_byte_size(vdst);
+
+    memcpy(Caml_ba_data_val(vdst), section(MAPPING(vm), voff, n), n);
+
+    CAMLreturn(Val_unit);
+}
+
+/* Indices are converted if they were written with a different size. */
+CAMLprim value sunml_binaryfile_read_indices(value vm, value voff,
+					     value visize, value vdst)
+{
+    CAMLparam4(vm, voff, visize, vdst);
+    int isize = Int_val(visize);
+    int dsize = index_size(vdst);
+    uintnat n = Caml_ba_array_val(vdst)->dim[0];
+    char *dst = Caml_ba_data_val(vdst);
+    const char *src;
+    uintnat i;
+
+    if (isize != 4 && isize != 8)
+	caml_invalid_argument("BinaryFile: bad index size");
+    src = section(MAPPING(vm), voff, n * isize);
+
+    if (isize == dsize) {
+	memcpy(dst, src, n * isize);
+    } else {
+	for (i = 0; i < n; ++i)
+	    set_index(dst, dsize, i, get_index(src, isize, i));
+    }
+
+    CAMLreturn(Val_unit);
+}
+
+/* Checksums */
+
+static uint64_t checksum_bytes(uint64_t h, const unsigned char *p, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; ++i) h = (h ^ p[i]) * FNV_PRIME;
+    return h;
+}
+
+CAMLprim value sunml_binaryfile_checksum(value vm, value voffsets,
+					 value vlengths)
+{
+    CAMLparam3(vm, voffsets, vlengths);
+    struct caml_ba_proxy *m = MAPPING(vm);
+    uint64_t h = FNV_OFFSET_BASIS;
+    size_t len;
+    int i;
+
+    for (i = 0; i < NUM_SECTIONS; ++i) {
+	len = Long_val(Field(vlengths, i));
+	h = checksum_bytes(h,
+		(unsigned char *)section(m, Field(voffsets, i), len), len);
+    }
+
+    CAMLreturn(caml_copy_int64(h));
+}
+
+/* Writing files */
+
+static uint64_t get_u64_le(const unsigned char *p)
+{
+    uint64_t x = 0;
+    int i;
+
+    for (i = 7; i >= 0; --i) x = (x << 8) | p[i];
+    return x;
+}
+
+/* Write the header, then the sections at the offsets given in the header
+ * (padding with zeros), and finally fill in the checksum.  */
+CAMLprim value sunml_binaryfile_write(value vpath, value vheader,
+				      value vptrs, value vvals, value vdata)
+{
+    CAMLparam5(vpath, vheader, vptrs, vvals, vdata);
+    static const char zeros[64] = { 0 };
+    unsigned char header[HEADER_SIZE];
+    const char *data[NUM_SECTIONS];
+    uintnat lens[NUM_SECTIONS];
+    uint64_t h = FNV_OFFSET_BASIS, off, pos = HEADER_SIZE;
+    FILE *file;
+    int i, ok;
+
+    if (caml_string_length(vheader) != HEADER_SIZE)
+	caml_invalid_argument("BinaryFile: bad header");
+    memcpy(header, String_val(vheader), HEADER_SIZE);
+
+    data[0] = Caml_ba_data_val(vptrs);
+    lens[0] = Caml_ba_array_val(vptrs)->dim[0] * index_size(vptrs);
+    data[1] = Caml_ba_data_val(vvals);
+    lens[1] = Caml_ba_array_val(vvals)->dim[0] * index_size(vvals);
+    data[2] = Caml_ba_data_val(vdata);
+    lens[2] = float_byte_size(vdata);
+
+    file = fopen(String_val(vpath), "wb");
+    if (file == NULL) caml_failwith(strerror(errno));
+
+    ok = fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE;
+    for (i = 0; ok && i < NUM_SECTIONS; ++i) {
+	off = get_u64_le(header + OFFSETS_OFFSET + 8 * i);
+	if (off < pos || off - pos > sizeof(zeros)) {
+	    fclose(file);
+	    caml_invalid_argument("BinaryFile: bad section offset");
+	}
+	ok = fwrite(zeros, 1, off - pos, file) == off - pos
+	     && fwrite(data[i], 1, lens[i], file) == lens[i];
+	pos = off + lens[i];
+	h = checksum_bytes(h, (const unsigned char *)data[i], lens[i]);
+    }
+
+    for (i = 0; i < 8; ++i) header[CHECKSUM_OFFSET + i] = h >> (8 * i);
+    ok = ok && fseek(file, CHECKSUM_OFFSET, SEEK_SET) == 0
+	    && fwrite(header + CHECKSUM_OFFSET, 1, 8, file) == 8;
+
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) caml_failwith(strerror(errno));
+
+    CAMLreturn(Val_unit);
+}
+
+CAMLprim value sunml_binaryfile_no_indices(value vunit)
+{
+    CAMLparam1(vunit);
+    CAMLreturn(caml_ba_alloc_dims(BIGARRAY_INDEX, 1, NULL, 0));
+}
+
+/* MatrixMarket import */
+
+/* Must agree with matrix_market_error in Sundials_BinaryFile. */
+enum mm_error {
+    MM_BANNER	= -1,
+    MM_FORMAT	= -2,
+    MM_FIELD	= -3,
+    MM_SYMMETRY	= -4,
+    MM_SIZE	= -5,
+    MM_ENTRY	= -6,
+    MM_RANGE	= -7,
+};
+
+enum mm_field { MM_REAL = 0, MM_PATTERN = 1 };
+enum mm_symmetry { MM_GENERAL = 0, MM_SYMMETRIC = 1, MM_SKEW = 2 };
+
+/* Fields of the array returned by sunml_binaryfile_mm_header. */
+enum mm_info {
+    INFO_FIELD = 0,
+    INFO_SYMMETRY,
+    INFO_ROWS,
+    INFO_COLS,
+    INFO_NNZ,
+    INFO_BODY,
+    INFO_SIZE
+};
+
+#define MAX_TOKEN 64
+
+static int is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/* Copy the next token into buf, skipping spaces and, unless in_line,
+ * newlines and comments (from '%' to the end of the line).  Returns 0 if
+ * there is no token or if it is too long.  */
+static int next_token(const char **pp, const char *end, int in_line,
+		      char *buf)
+{
+    const char *p = *pp;
+    int n = 0;
+
+    for (;;) {
+	while (p < end && is_space(*p) && !(in_line && *p == '\n')) ++p;
+	if (p < end && *p == '%' && !in_line) {
+	    while (p < end && *p != '\n') ++p;
+	    continue;
+	}
+	break;
+    }
+
+    while (p < end && !is_space(*p) && n < MAX_TOKEN - 1) buf[n++] = *p++;
+    buf[n] = '\0';
+    *pp = p;
+    return n > 0 && (p == end || is_space(*p));
+}
+
+static int token_is(const char *tok, const char *word)
+{
+    for (; *tok != '\0' && *word != '\0'; ++tok, ++word) {
+	char c = *tok;
+	if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+	if (c != *word) return 0;
+    }
+    return *tok == *word;
+}
+
+static int parse_long(const char *tok, long *x)
+{
+    char *e;
+
+    errno = 0;
+    *x = strtol(tok, &e, 10);
+    return e != tok && *e == '\0' && errno == 0;
+}
+
+static int parse_header(const char *p, const char *end, intnat *info,
+			const char **body)
+{
+    char tok[MAX_TOKEN];
+    long m, n, nnz;
+    const char *q;
+
+    if (!next_token(&p, end, 1, tok) || !token_is(tok, "%%matrixmarket")
+	    || !next_token(&p, end, 1, tok) || !token_is(tok, "matrix"))
+	return MM_BANNER;
+
+    if (!next_token(&p, end, 1, tok) || !token_is(tok, "coordinate"))
+	return MM_FORMAT;
+
+    if (!next_token(&p, end, 1, tok)) return MM_FIELD;
+    if (token_is(tok, "real") || token_is(tok, "integer"))
+	info[INFO_FIELD] = MM_REAL;
+    else if (token_is(tok, "pattern"))
+	info[INFO_FIELD] = MM_PATTERN;
+    else
+	return MM_FIELD;
+
+    if (!next_token(&p, end, 1, tok)) return MM_SYMMETRY;
+    if (token_is(tok, "general"))
+	info[INFO_SYMMETRY] = MM_GENERAL;
+    else if (token_is(tok, "symmetric") || token_is(tok, "hermitian"))
+	info[INFO_SYMMETRY] = MM_SYMMETRIC;
+    else if (token_is(tok, "skew-symmetric"))
+	info[INFO_SYMMETRY] = MM_SKEW;
+    else
+	return MM_SYMMETRY;
+
+    /* Skip the rest of the banner; the comments are skipped as spaces. */
+    while (p < end && *p != '\n') ++p;
+
+    if (!next_token(&p, end, 0, tok) || !parse_long(tok, &m)
+	    || !next_token(&p, end, 1, tok) || !parse_long(tok, &n)
+	    || !next_token(&p, end, 1, tok) || !parse_long(tok, &nnz)
+	    || m < 0 || n < 0 || nnz < 0)
+	return MM_SIZE;
+    q = p;
+    if (next_token(&q, end, 1, tok)) return MM_SIZE;
+    if (info[INFO_SYMMETRY] != MM_GENERAL && m != n) return MM_SIZE;
+
+    info[INFO_ROWS] = m;
+    info[INFO_COLS] = n;
+    info[INFO_NNZ] = nnz;
+    *body = p;
+    return 0;
+}
+
+CAMLprim value sunml_binaryfile_mm_header(value vm)
+{
+    CAMLparam1(vm);
+    CAMLlocal1(vr);
+    struct caml_ba_proxy *m = MAPPING(vm);
+    const char *addr = m->data;
+    const char *body = NULL;
+    intnat info[INFO_SIZE] = { 0 };
+    int i, err;
+
+    err = parse_header(addr, addr + m->size, info, &body);
+    if (err == 0) info[INFO_BODY] = body - addr;
+
+    vr = caml_alloc_tuple(INFO_SIZE);
+    for (i = 0; i < INFO_SIZE; ++i) Store_field(vr, i, Val_long(info[i]));
+    if (err != 0) Store_field(vr, INFO_FIELD, Val_int(err));
+
+    CAMLreturn(vr);
+}
+
+/* Stable counting sort of the entries src by key, into dst; count must
+ * have np + 1 elements.  */
+static void sort_by(intnat np, intnat ne, const intnat *key,
+		    const intnat *srow, const intnat *scol, const double *sval,
+		    intnat *drow, intnat *dcol, double *dval, intnat *count)
+{
+    intnat i, k, t, sum = 0;
+
+    memset(count, 0, (np + 1) * sizeof(intnat));
+    for (k = 0; k < ne; ++k) ++count[key[k]];
+    for (i = 0; i <= np; ++i) {
+	t = count[i];
+	count[i] = sum;
+	sum += t;
+    }
+    for (k = 0; k < ne; ++k) {
+	t = count[key[k]]++;
+	drow[t] = srow[k];
+	dcol[t] = scol[k];
+	dval[t] = sval[k];
+    }
+}
+
+/* Returns the number of stored entries or an mm_error.  */
+CAMLprim value sunml_binaryfile_mm_read(value vm, value vinfo, value vcsc,
+					value vidxvals, value vidxptrs,
+					value vdata)
+{
+    CAMLparam5(vm, vinfo, vcsc, vidxvals, vidxptrs);
+    CAMLxparam1(vdata);
+    struct caml_ba_proxy *m = MAPPING(vm);
+    const char *end = (const char *)m->data + m->size;
+    const char *p = (const char *)m->data + Long_val(Field(vinfo, INFO_BODY));
+    int pattern = Long_val(Field(vinfo, INFO_FIELD)) == MM_PATTERN;
+    int symmetry = Long_val(Field(vinfo, INFO_SYMMETRY));
+    intnat nrows = Long_val(Field(vinfo, INFO_ROWS));
+    intnat ncols = Long_val(Field(vinfo, INFO_COLS));
+    intnat nnz = Long_val(Field(vinfo, INFO_NNZ));
+    int csc = Bool_val(vcsc);
+    intnat np = csc ? ncols : nrows;
+    intnat cap = Caml_ba_array_val(vidxvals)->dim[0];
+    int isize = index_size(vidxvals);
+    char *idxvals = Caml_ba_data_val(vidxvals);
+    char *idxptrs = Caml_ba_data_val(vidxptrs);
+    double *data = REAL_ARRAY(vdata);
+    char tok[MAX_TOKEN];
+    intnat *rows, *cols, *trows, *tcols, *count;
+    double *vals, *tvals;
+    intnat k, ne = 0, nmax = 0;
+    long i, j;
+    double x;
+    char *e;
+    int err = 0;
+
+    rows = malloc(2 * cap * sizeof(intnat) + 1);
+    cols = malloc(2 * cap * sizeof(intnat) + 1);
+    vals = malloc(2 * cap * sizeof(double) + 1);
+    count = malloc(((nrows > ncols ? nrows : ncols) + 1) * sizeof(intnat));
+    if (rows == NULL || cols == NULL || vals == NULL || count == NULL) {
+	free(rows);
+	free(cols);
+	free(vals);
+	free(count);
+	caml_raise_out_of_memory();
+    }
+    trows = rows + cap;
+    tcols = cols + cap;
+    tvals = vals + cap;
+
+    for (k = 0; k < nnz && err == 0; ++k) {
+	if (!next_token(&p, end, 0, tok) || !parse_long(tok, &i)
+		|| !next_token(&p, end, 1, tok) || !parse_long(tok, &j)) {
+	    err = MM_ENTRY;
+	    break;
+	}
+	if (pattern) {
+	    x = 1.0;
+	} else {
+	    if (!next_token(&p, end, 1, tok)) {
+		err = MM_ENTRY;
+		break;
+	    }
+	    x = strtod(tok, &e);
+	    if (e == tok || *e != '\0') {
+		err = MM_ENTRY;
+		break;
+	    }
+	}
+	if (i < 1 || i > nrows || j < 1 || j > ncols) {
+	    err = MM_RANGE;
+	    break;
+	}
+	if (ne >= cap) {
+	    err = MM_ENTRY;
+	    break;
+	}
+	rows[ne] = i - 1;
+	cols[ne] = j - 1;
+	vals[ne++] = x;
+
+	if (symmetry != MM_GENERAL && i != j) {
+	    if (ne >= cap) {
+		err = MM_ENTRY;
+		break;
+	    }
+	    rows[ne] = j - 1;
+	    cols[ne] = i - 1;
+	    vals[ne++] = symmetry == MM_SKEW ? -x : x;
+	}
+    }
+
+    if (err == 0) {
+	/* Sort by the minor index into t*, then by the major index back. */
+	if (csc) {
+	    sort_by(nrows, ne, rows, rows, cols, vals,
+		    trows, tcols, tvals, count);
+	    sort_by(ncols, ne, tcols, trows, tcols, tvals,
+		    rows, cols, vals, count);
+	} else {
+	    sort_by(ncols, ne, cols, rows, cols, vals,
+		    trows, tcols, tvals, count);
+	    sort_by(nrows, ne, trows, trows, tcols, tvals,
+		    rows, cols, vals, count);
+	}
+
+	/* After the second sort, count[i] is the end of major index i. */
+	set_index(idxptrs, isize, 0, 0);
+	for (k = 0; k < np; ++k)
+	    set_index(idxptrs, isize, k + 1, count[k]);
+	for (k = 0; k < ne; ++k) {
+	    set_index(idxvals, isize, k, csc ? rows[k] : cols[k]);
+	    data[k] = vals[k];
+	}
+	nmax = ne;
+    }
+
+    free(rows);
+    free(cols);
+    free(vals);
+    free(count);
+
+    CAMLreturn(Val_long(err == 0 ? nmax : err));
+}
+
+BYTE_STUB6(sunml_binaryfile_mm_read)
@@ -0,0 +1,227 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Cache-blocked LU factorization with partial pivoting.
+ *
+ * The interface and the result are those of SUNDlsMat_denseGETRF: a is an
+ * array of n column pointers to m >= n rows, p[k] = l records that rows k
+ * and l were exchanged at step k, and a positive return value k+1 signals
+ * a zero pivot in column k.
+ *
+ * The columns are split recursively in two halves (Toledo's right-looking
+ * recursive LU):
+ *
+ *	[ A11 A12 ]   factor [A11; A21] recursively,
+ *	[ A21 A22 ]   swap the rows of [A12; A22],
+ *		      A12 := L11^-1 A12,  A22 := A22 - A21 A12,
+ *		      factor A22 recursively and swap the rows of [A11; A21].
+ *
+ * Almost all of the work is in the update of A22, which is done by tiles
+ * of GEMM_MB rows by GEMM_KB columns of A21 so that the tile stays in
+ * cache while it is applied to every column of A22.  The innermost loop
+ * applies four columns of the tile at once with unit stride, which
+ * compilers vectorize, and loads and stores A22 a quarter as often as
+ * the unblocked algorithm.  When the library is compiled with OpenMP
+ * (CFLAGS_OPENMP), the columns of A22 are updated in parallel once the
+ * update exceeds PAR_MIN_FLOPS.  Panels of at most PANEL_NB columns are
+ * factored with the unblocked algorithm, so matrices with n <= PANEL_NB
+ * give exactly the same factors as SUNDlsMat_denseGETRF.  */
+
+#include "../config.h"
+
+#include <math.h>
+#include <sundials/sundials_dense.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../lsolvers/sundials_matrix_ml.h"
+
+#define PANEL_NB      64
+#define GEMM_MB       256
+#define GEMM_KB       128
+#define PAR_MIN_FLOPS 4000000.0
+
+/* Unblocked LU of columns c0..c0+nc-1 (rows c0..m-1); the rows are only
+   exchanged within these columns.  */
+static sundials_ml_index panel_getrf(sunrealtype **a, sundials_ml_index m,
+				     sundials_ml_index c0,
+				     sundials_ml_index nc,
+				     sundials_ml_index *p)
+{
+    sundials_ml_index i, j, k, l;
+    sunrealtype *col_j, *col_k, mult, a_kj, temp;
+
+    for (k = c0; k < c0 + nc; k++) {
+	col_k = a[k];
+
+	l = k;
+	for (i = k + 1; i < m; i++)
+	    if (fabs(col_k[i]) > fabs(col_k[l])) l = i;
+	p[k] = l;
+
+	if (col_k[l] == 0.0) return (k + 1);
+
+	if (l != k) {
+	    for (j = c0; j < c0 + nc; j++) {
+		temp = a[j][l];
+		a[j][l] = a[j][k];
+		a[j][k] = temp;
+	    }
+	}
+
+	mult = 1.0 / col_k[k];
+	for (i = k + 1; i < m; i++) col_k[i] *= mult;
+
+	for (j = k + 1; j < c0 + nc; j++) {
+	    col_j = a[j];
+	    a_kj = col_j[k];
+	    if (a_kj != 0.0) {
+		for (i = k + 1; i < m; i++)
+		    col_j[i] -= a_kj * col_k[i];
+	    }
+	}
+    }
+
+    return 0;
+}
+
+/* Apply the exchanges p[k0..k1-1] to the rows of columns j0..j1-1.  */
+static void swap_rows(sunrealtype **a, sundials_ml_index k0,
+		      sundials_ml_index k1, sundials_ml_index j0,
+		      sundials_ml_index j1, sundials_ml_index *p)
+{
+    sundials_ml_index j, k, l;
+    sunrealtype temp;
+
+    for (j = j0; j < j1; j++) {
+	sunrealtype *col_j = a[j];
+	for (k = k0; k < k1; k++) {
+	    l = p[k];
+	    if (l != k) {
+		temp = col_j[l];
+		col_j[l] = col_j[k];
+		col_j[k] = temp;
+	    }
+	}
+    }
+}
+
+/* A12 := L11^-1 A12 where L11 is the unit lower triangle of the columns
+   c0..c0+n1-1 and A12 holds the rows c0..c0+n1-1 of columns j0..j1-1.  */
+static void trsm_lower_unit(sunrealtype **a, sundials_ml_index c0,
+			    sundials_ml_index n1, sundials_ml_index j0,
+			    sundials_ml_index j1)
+{
+    sundials_ml_index i, j, k;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(i, k) schedule(static) \
+	if ((double)n1 * n1 * (j1 - j0) > PAR_MIN_FLOPS)
+#endif
+    for (j = j0; j < j1; j++) {
+	sunrealtype *col_j = a[j];
+	for (k = c0; k < c0 + n1; k++) {
+	    sunrealtype t = col_j[k];
+	    sunrealtype *col_k = a[k];
+	    if (t != 0.0) {
+		for (i = k + 1; i < c0 + n1; i++)
+		    col_j[i] -= t * col_k[i];
+	    }
+	}
+    }
+}
+
+/* A22 := A22 - A21 A12 with A21 = rows r0..m-1 of columns c0..c0+n1-1,
+   A12 = rows c0..c0+n1-1 of columns j0..j1-1, and A22 = rows r0..m-1 of
+   the same columns.  */
+static void gemm_update(sunrealtype **a, sundials_ml_index m,
+			sundials_ml_index r0, sundials_ml_index c0,
+			sundials_ml_index n1, sundials_ml_index j0,
+			sundials_ml_index j1)
+{
+    sundials_ml_index ib, kb, i, j, k, iend, kend;
+
+    for (kb = c0; kb < c0 + n1; kb += GEMM_KB) {
+	kend = (kb + GEMM_KB < c0 + n1) ? kb + GEMM_KB : c0 + n1;
+
+	for (ib = r0; ib < m; ib += GEMM_MB) {
+	    iend = (ib + GEMM_MB < m) ? ib + GEMM_MB : m;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(i, k) schedule(static) \
+	if ((double)(iend - ib) * (kend - kb) * (j1 - j0) > PAR_MIN_FLOPS)
+#endif
+	    for (j = j0; j < j1; j++) {
+		sunrealtype *restrict col_j = a[j];
+
+		/* four columns of A21 per sweep over the tile of col_j */
+		for (k = kb; k + 3 < kend; k += 4) {
+		    const sunrealtype *restrict l0 = a[k];
+		    const sunrealtype *restrict l1 = a[k + 1];
+		    const sunrealtype *restrict l2 = a[k + 2];
+		    const sunrealtype *restrict l3 = a[k + 3];
+		    sunrealtype t0 = col_j[k],     t1 = col_j[k + 1],
+				t2 = col_j[k + 2], t3 = col_j[k + 3];
+		    for (i = ib; i < iend; i++)
+			col_j[i] -= t0 * l0[i] + t1 * l1[i]
+				    + t2 * l2[i] + t3 * l3[i];
+		}
+		for (; k < kend; k++) {
+		    const sunrealtype *restrict col_k = a[k];
+		    sunrealtype t = col_j[k];
+		    for (i = ib; i < iend; i++)
+			col_j[i] -= t * col_k[i];
+		}
+	    }
+	}
+    }
+}
+
+static sundials_ml_index rec_getrf(sunrealtype **a, sundials_ml_index m,
+				   sundials_ml_index c0,
+				   sundials_ml_index nc,
+				   sundials_ml_index *p)
+{
+    sundials_ml_index n1, n2, r;
+
+    if (nc <= PANEL_NB) return panel_getrf(a, m, c0, nc, p);
+
+    /* keep the left half a multiple of the panel width */
+    n1 = ((nc / 2 + PANEL_NB - 1) / PANEL_NB) * PANEL_NB;
+    n2 = nc - n1;
+
+    r = rec_getrf(a, m, c0, n1, p);
+    if (r != 0) return r;
+
+    swap_rows(a, c0, c0 + n1, c0 + n1, c0 + nc, p);
+    trsm_lower_unit(a, c0, n1, c0 + n1, c0 + nc);
+    gemm_update(a, m, c0 + n1, c0, n1, c0 + n1, c0 + nc);
+
+    r = rec_getrf(a, m, c0 + n1, n2, p);
+    if (r != 0) return r;
+
+    swap_rows(a, c0 + n1, c0 + nc, c0, c0 + n1, p);
+    return 0;
+}
+
+sundials_ml_index sunml_dense_getrf(sunrealtype **a, sundials_ml_index m,
+				    sundials_ml_index n, sundials_ml_index *p)
+{
+    if (m < n) {
+#if 600 <= SUNDIALS_LIB_VERSION
+	return SUNDlsMat_denseGETRF(a, m, n, p);
+#else
+	return denseGETRF(a, m, n, p);
+#endif
+    }
+    return rec_getrf(a, m, 0, n, p);
+}
@@ -180,15 +180,42 @@ static value alloc_lsolver(SUNLinearSolver ls, int custom)
 
     CAMLreturn(vcptr);
 }
+
+value sunml_lsolver_wrap(SUNLinearSolver ls)
+{
+    return alloc_lsolver(ls, 0);
+}
 #endif
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Direct
  */
 
-CAMLprim value sunml_lsolver_dense(value vnvec, value vdmat, value vctx)
+#if 300 <= SUNDIALS_LIB_VERSION
+/* SUNLinSolSetup_Dense with the cache-blocked factorization. */
+static int lsolver_dense_blocked_setup(SUNLinearSolver ls, SUNMatrix a)
 {
-    CAMLparam3(vnvec, vdmat, vctx);
+    SUNLinearSolverContent_Dense content =
+	(SUNLinearSolverContent_Dense)ls->content;
+
+    if (a == NULL) return SUNLS_MEM_NULL;
+    if (SUNMatGetID(a) != SUNMATRIX_DENSE) {
+	content->last_flag = SUNLS_ILL_INPUT;
+	return SUNLS_ILL_INPUT;
+    }
+
+    content->last_flag = sunml_dense_getrf(SUNDenseMatrix_Cols(a),
+					   SUNDenseMatrix_Rows(a),
+					   SUNDenseMatrix_Columns(a),
+					   content->pivots);
+    return (content->last_flag > 0) ? SUNLS_LUFACT_FAIL : SUNLS_SUCCESS;
+}
+#endif
+
+CAMLprim value sunml_lsolver_dense(value vnvec, value vdmat, value vblocked,
+				   value vctx)
+{
+    CAMLparam4(vnvec, vdmat, vblocked, vctx);
 #if 300 <= SUNDIALS_LIB_VERSION
     SUNMatrix dmat = MAT_VAL(vdmat);
 #if 600 <= SUNDIALS_LIB_VERSION
@@ -208,6 +235,7 @@ CAMLprim value sunml_lsolver_dense(value vnvec, value vdmat, value vctx)
 
 	caml_raise_out_of_memory();
     }
+    if (Bool_val(vblocked)) ls->ops->setup = lsolver_dense_blocked_setup;
 
     CAMLreturn(alloc_lsolver(ls, 0));
 #else
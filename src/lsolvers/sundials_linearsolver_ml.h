@@ -17,10 +17,36 @@
 #include <caml/mlvalues.h>
 
 #if SUNDIALS_LIB_VERSION >= 300
+#include <sundials/sundials_linearsolver.h>
 
 // turn a cptr into SUNLinearSolver
 #define LSOLVER_VAL(v) (*(SUNLinearSolver *)Data_custom_val(v))
 
+// turn a SUNLinearSolver implemented in C into a cptr (freed by the GC)
+value sunml_lsolver_wrap(SUNLinearSolver ls);
+
+#if 500 <= SUNDIALS_LIB_VERSION
+// The partitioned band solver of sundials_lsolver_spike_ml.c on n x n band
+// matrices with the given (stored) bandwidths and at most max_parts blocks.
+// Returns NULL if memory cannot be allocated.
+SUNLinearSolver sunml_lsolver_spike_create(sunindextype n, sunindextype mu,
+					   sunindextype ml, sunindextype smu,
+					   int max_parts);
+#endif
+
+#if 600 <= SUNDIALS_LIB_VERSION
+// Nonblocking global sums for the pipelined Krylov solvers: start begins
+// summing buf[0..n-1] over the communicator of x and sets *request, which
+// it leaves NULL on failure; finish waits for the result and releases the
+// request. Both return 0 on success.
+typedef int (*sunml_reduction_start_fn)(N_Vector x, sunrealtype *buf, int n,
+					void **request);
+typedef int (*sunml_reduction_finish_fn)(void *request);
+
+void sunml_lsolver_pipelined_register_reductions(
+	sunml_reduction_start_fn start, sunml_reduction_finish_fn finish);
+#endif
+
 #endif
 
 enum preconditioning_type_tag {
@@ -42,11 +68,19 @@ enum lsolver_solver_data_tag {
     VARIANT_LSOLVER_SOLVER_DATA_SPGMR,
     VARIANT_LSOLVER_SOLVER_DATA_SPTFQMR,
     VARIANT_LSOLVER_SOLVER_DATA_PCG,
+    VARIANT_LSOLVER_SOLVER_DATA_GCRODR,
+    VARIANT_LSOLVER_SOLVER_DATA_PIPELINED,
     /* direct */
     VARIANT_LSOLVER_SOLVER_DATA_DENSE,
     VARIANT_LSOLVER_SOLVER_DATA_LAPACKDENSE,
     VARIANT_LSOLVER_SOLVER_DATA_BAND,
     VARIANT_LSOLVER_SOLVER_DATA_LAPACKBAND,
+    VARIANT_LSOLVER_SOLVER_DATA_MIXEDDENSE,
+    VARIANT_LSOLVER_SOLVER_DATA_MIXEDBAND,
+    VARIANT_LSOLVER_SOLVER_DATA_SPIKEBAND,
+    VARIANT_LSOLVER_SOLVER_DATA_SPARSELU,
+    VARIANT_LSOLVER_SOLVER_DATA_REORDEREDBAND,
+    VARIANT_LSOLVER_SOLVER_DATA_CACHED,
     // NO! VARIANT_LSOLVER_SOLVER_DATA_KLU,
     // NO! VARIANT_LSOLVER_SOLVER_DATA_SUPERLUMT,
     /* custom */
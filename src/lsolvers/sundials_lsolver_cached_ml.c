@@ -0,0 +1,426 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* A direct linear solver that reuses the factorization of another one.
+ *
+ * The wrapper keeps two private copies of the matrix: the one given to the
+ * last effective setup (aref) and the one factored by the wrapped solver
+ * (alu).  A setup only refactors when the new matrix differs from aref by
+ * more than tol in the relative max norm,
+ *
+ *	max |A - aref| > tol * max |aref|,
+ *
+ * or when the sparsity pattern has changed.  Solves use the factors of alu.
+ *
+ * In lumped mode, the wrapped solver is not used: a setup replaces the
+ * matrix by the diagonal of its row sums and a solve divides by it.
+ *
+ * The wrapper initializes the wrapped solver (in cached_initialize) but
+ * does not free it.  The wrapper holds a generational global root on its OCaml value (vinner),
+ * which keeps it alive until the wrapper itself is freed.  */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../nvectors/nvector_ml.h"
+#include "../lsolvers/sundials_linearsolver_ml.h"
+#include "../lsolvers/sundials_matrix_ml.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <sundials/sundials_linearsolver.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+
+struct cached_content {
+    SUNLinearSolver inner;
+    value vinner;		/* generational global root */
+    sunrealtype tol;
+    int lumped;
+
+    SUNMatrix aref;		/* matrix of the last effective setup */
+    SUNMatrix alu;		/* copy factored by inner */
+    int valid;			/* aref and the factors are usable */
+
+    sunindextype n;		/* lumped diagonal */
+    sunrealtype *diag;
+
+    long int num_setups;
+    long int num_factorizations;
+    sunindextype last_flag;
+};
+
+typedef struct cached_content *CachedContent;
+
+#define CACHED_CONTENT(ls) ((CachedContent)((ls)->content))
+
+static SUNLinearSolver_Type cached_gettype(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_DIRECT;
+}
+
+static SUNLinearSolver_ID cached_getid(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_CUSTOM;
+}
+
+static int cached_initialize(SUNLinearSolver ls)
+{
+    CachedContent c = CACHED_CONTENT(ls);
+
+    c->valid = 0;
+    c->last_flag = c->lumped ? SUNLS_SUCCESS : SUNLinSolInitialize(c->inner);
+    return c->last_flag;
+}
+
+/* The stored values of a dense, band, or sparse matrix. */
+static int matrix_values(SUNMatrix A, sunrealtype **data, sunindextype *len)
+{
+    switch (SUNMatGetID(A)) {
+    case SUNMATRIX_DENSE:
+	*data = SUNDenseMatrix_Data(A);
+	*len = SUNDenseMatrix_LData(A);
+	return 1;
+
+    case SUNMATRIX_BAND:
+	*data = SUNBandMatrix_Data(A);
+	*len = SUNBandMatrix_LData(A);
+	return 1;
+
+    case SUNMATRIX_SPARSE:
+	*data = SUNSparseMatrix_Data(A);
+	*len = SUNSparseMatrix_IndexPointers(A)[SUNSparseMatrix_NP(A)];
+	return 1;
+
+    default:
+	return 0;
+    }
+}
+
+static int same_pattern(SUNMatrix A, SUNMatrix B)
+{
+    sunindextype np, nnz;
+
+    if (SUNMatGetID(A) != SUNMATRIX_SPARSE) return 1;
+
+    np = SUNSparseMatrix_NP(A);
+    if (np != SUNSparseMatrix_NP(B)
+	    || SUNSparseMatrix_SparseType(A) != SUNSparseMatrix_SparseType(B))
+	return 0;
+    if (memcmp(SUNSparseMatrix_IndexPointers(A),
+	       SUNSparseMatrix_IndexPointers(B),
+	       (np + 1) * sizeof(sunindextype)) != 0)
+	return 0;
+
+    nnz = SUNSparseMatrix_IndexPointers(A)[np];
+    return memcmp(SUNSparseMatrix_IndexValues(A),
+		  SUNSparseMatrix_IndexValues(B),
+		  nnz * sizeof(sunindextype)) == 0;
+}
+
+static int drifted(CachedContent c, SUNMatrix A)
+{
+    sunrealtype *a, *r, dmax = 0.0, rmax = 0.0;
+    sunindextype i, len, rlen;
+
+    if (!matrix_values(A, &a, &len)
+	    || !matrix_values(c->aref, &r, &rlen)
+	    || len != rlen
+	    || !same_pattern(A, c->aref))
+	return 1;
+
+    for (i = 0; i < len; i++) {
+	dmax = SUNMAX(dmax, SUNRabs(a[i] - r[i]));
+	rmax = SUNMAX(rmax, SUNRabs(r[i]));
+    }
+
+    return (dmax > c->tol * rmax) || (dmax > 0.0 && rmax == 0.0);
+}
+
+/* Row-sum lumping: diag[i] = sum_j a_ij */
+static int lump(CachedContent c, SUNMatrix A)
+{
+    sunindextype i, j, k, n, mu, ml;
+    sunrealtype *col, *data;
+    sunindextype *ptrs, *vals;
+
+    switch (SUNMatGetID(A)) {
+    case SUNMATRIX_DENSE:
+	n = SUNDenseMatrix_Rows(A);
+	break;
+    case SUNMATRIX_BAND:
+	n = SUNBandMatrix_Rows(A);
+	break;
+    case SUNMATRIX_SPARSE:
+	n = SUNSparseMatrix_Rows(A);
+	break;
+    default:
+	return SUNLS_ILL_INPUT;
+    }
+
+    if (c->diag == NULL || c->n != n) {
+	free(c->diag);
+	c->diag = (sunrealtype *)malloc(n * sizeof(sunrealtype));
+	if (c->diag == NULL) return SUNLS_MEM_FAIL;
+	c->n = n;
+    }
+    for (i = 0; i < n; i++) c->diag[i] = 0.0;
+
+    switch (SUNMatGetID(A)) {
+    case SUNMATRIX_DENSE:
+	for (j = 0; j < SUNDenseMatrix_Columns(A); j++) {
+	    col = SUNDenseMatrix_Column(A, j);
+	    for (i = 0; i < n; i++) c->diag[i] += col[i];
+	}
+	break;
+
+    case SUNMATRIX_BAND:
+	mu = SUNBandMatrix_UpperBandwidth(A);
+	ml = SUNBandMatrix_LowerBandwidth(A);
+	for (j = 0; j < n; j++) {
+	    col = SUNBandMatrix_Column(A, j);
+	    for (i = SUNMAX(0, j - mu); i <= SUNMIN(n - 1, j + ml); i++)
+		c->diag[i] += col[i - j];
+	}
+	break;
+
+    default:
+	ptrs = SUNSparseMatrix_IndexPointers(A);
+	vals = SUNSparseMatrix_IndexValues(A);
+	data = SUNSparseMatrix_Data(A);
+	for (j = 0; j < SUNSparseMatrix_NP(A); j++) {
+	    for (k = ptrs[j]; k < ptrs[j + 1]; k++) {
+		i = (SUNSparseMatrix_SparseType(A) == CSC_MAT) ? vals[k] : j;
+		c->diag[i] += data[k];
+	    }
+	}
+	break;
+    }
+
+    for (i = 0; i < n; i++) {
+	if (c->diag[i] == 0.0) return (int)(i + 1);
+    }
+    return SUNLS_SUCCESS;
+}
+
+static int cached_setup(SUNLinearSolver ls, SUNMatrix A)
+{
+    CachedContent c = CACHED_CONTENT(ls);
+    int r;
+
+    c->num_setups++;
+
+    if (c->aref == NULL) {
+	c->aref = SUNMatClone(A);
+	if (!c->lumped) c->alu = SUNMatClone(A);
+	if (c->aref == NULL || (!c->lumped && c->alu == NULL)) {
+	    c->last_flag = SUNLS_MEM_FAIL;
+	    return SUNLS_MEM_FAIL;
+	}
+    }
+
+    if (c->valid && !drifted(c, A)) {
+	c->last_flag = SUNLS_SUCCESS;
+	return SUNLS_SUCCESS;
+    }
+
+    c->valid = 0;
+    if (SUNMatCopy(A, c->aref) != 0) {
+	c->last_flag = SUNLS_MEM_FAIL;
+	return SUNLS_MEM_FAIL;
+    }
+
+    if (c->lumped) {
+	r = lump(c, A);
+	if (r > 0) {
+	    c->last_flag = r;
+	    return SUNLS_LUFACT_FAIL;
+	}
+    } else {
+	r = SUNMatCopy(A, c->alu);
+	if (r == 0) r = SUNLinSolSetup(c->inner, c->alu);
+	else r = SUNLS_MEM_FAIL;
+    }
+    c->last_flag = r;
+    if (r != SUNLS_SUCCESS) return r;
+
+    c->valid = 1;
+    c->num_factorizations++;
+    return SUNLS_SUCCESS;
+}
+
+static int cached_solve(SUNLinearSolver ls, SUNMatrix A, N_Vector x,
+			N_Vector b, sunrealtype tol)
+{
+    CachedContent c = CACHED_CONTENT(ls);
+    sunrealtype *xd, *bd;
+    sunindextype i;
+
+    if (!c->valid) {
+	c->last_flag = SUNLS_ILL_INPUT;
+	return SUNLS_ILL_INPUT;
+    }
+
+    if (c->lumped) {
+	xd = N_VGetArrayPointer(x);
+	bd = N_VGetArrayPointer(b);
+	if (xd == NULL || bd == NULL) {
+	    c->last_flag = SUNLS_ILL_INPUT;
+	    return SUNLS_ILL_INPUT;
+	}
+	for (i = 0; i < c->n; i++) xd[i] = bd[i] / c->diag[i];
+	c->last_flag = SUNLS_SUCCESS;
+    } else {
+	c->last_flag = SUNLinSolSolve(c->inner, c->alu, x, b, tol);
+    }
+    return c->last_flag;
+}
+
+static sunindextype cached_lastflag(SUNLinearSolver ls)
+{
+    return CACHED_CONTENT(ls)->last_flag;
+}
+
+static int cached_space(SUNLinearSolver ls, long int *lenrw, long int *leniw)
+{
+    CachedContent c = CACHED_CONTENT(ls);
+    long int lrw = 0, liw = 0, mrw, miw;
+
+    if (!c->lumped && c->inner->ops->space != NULL)
+	SUNLinSolSpace(c->inner, &lrw, &liw);
+    if (c->aref != NULL && SUNMatSpace(c->aref, &mrw, &miw) == 0) {
+	lrw += (c->lumped ? 1 : 2) * mrw;
+	liw += (c->lumped ? 1 : 2) * miw;
+    }
+
+    *lenrw = lrw + c->n + 1;
+    *leniw = liw + 8;
+    return SUNLS_SUCCESS;
+}
+
+static int cached_free(SUNLinearSolver ls)
+{
+    CachedContent c;
+
+    if (ls == NULL) return SUNLS_SUCCESS;
+
+    c = CACHED_CONTENT(ls);
+    if (c != NULL) {
+	caml_remove_generational_global_root(&c->vinner);
+	if (c->aref != NULL) SUNMatDestroy(c->aref);
+	if (c->alu != NULL) SUNMatDestroy(c->alu);
+	free(c->diag);
+	free(c);
+    }
+    free(ls->ops);
+    free(ls);
+
+    return SUNLS_SUCCESS;
+}
+
+static SUNLinearSolver cached_create(value vinner, sunrealtype tol,
+				     int lumped)
+{
+    SUNLinearSolver ls;
+    SUNLinearSolver_Ops ops;
+    CachedContent c;
+
+    ls = (SUNLinearSolver)malloc(sizeof *ls);
+    if (ls == NULL) return NULL;
+
+    ops = (SUNLinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNLinearSolver_Ops));
+    c = (CachedContent) calloc(1, sizeof(struct cached_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(ls);
+	return NULL;
+    }
+
+    ops->gettype    = cached_gettype;
+    ops->getid      = cached_getid;
+    ops->initialize = cached_initialize;
+    ops->setup      = cached_setup;
+    ops->solve      = cached_solve;
+    ops->lastflag   = cached_lastflag;
+    ops->space      = cached_space;
+    ops->free       = cached_free;
+
+    ls->ops = ops;
+    ls->content = c;
+
+    c->inner = LSOLVER_VAL(vinner);
+    c->vinner = vinner;
+    caml_register_generational_global_root(&c->vinner);
+    c->tol = tol;
+    c->lumped = lumped;
+    c->last_flag = SUNLS_SUCCESS;
+
+    return ls;
+}
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Interface functions
+ */
+
+CAMLprim value sunml_lsolver_cached_wrap(value vinner, value vtol,
+					 value vlumped, value vctx)
+{
+    CAMLparam4(vinner, vtol, vlumped, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SUNLinearSolver inner = LSOLVER_VAL(vinner);
+    SUNLinearSolver ls;
+
+    if (Double_val(vtol) < 0.0)
+	caml_invalid_argument("reuse_tol must be non-negative");
+    if (!Bool_val(vlumped) && SUNLinSolGetType(inner) != SUNLINEARSOLVER_DIRECT)
+	caml_raise_constant(LSOLVER_EXN(InvalidLinearSolver));
+
+    ls = cached_create(vinner, Double_val(vtol), Bool_val(vlumped));
+    if (ls == NULL) caml_raise_out_of_memory();
+#if 600 <= SUNDIALS_LIB_VERSION
+    ls->sunctx = ML_CONTEXT(vctx);
+#endif
+
+    CAMLreturn(sunml_lsolver_wrap(ls));
+#else
+    CAMLreturn(Val_unit);
+#endif
+}
+
+/* Returns -1 if the solver is not a wrapper.  */
+CAMLprim value sunml_lsolver_cached_num_factorizations(value vcptr)
+{
+    CAMLparam1(vcptr);
+    long int r = -1;
+#if 500 <= SUNDIALS_LIB_VERSION
+    SUNLinearSolver ls = LSOLVER_VAL(vcptr);
+
+    if (ls->ops->setup == cached_setup)
+	r = CACHED_CONTENT(ls)->num_factorizations;
+#endif
+    CAMLreturn(Val_long(r));
+}
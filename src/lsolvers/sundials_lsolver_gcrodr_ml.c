@@ -0,0 +1,1120 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Krylov subspace recycling: GCRO-DR (Parks, de Sturler, Mackey, Johnson,
+ * and Maiti, SIAM J. Sci. Comput. 28(5), 2006).
+ *
+ * The solver works on the scaled and preconditioned operator
+ *
+ *	Ah = S1 P1^{-1} A P2^{-1} S2^{-1}
+ *
+ * like SUNLinSol_SPGMR, and keeps a subspace U (with C = Ah U orthonormal)
+ * of dimension at most kmax between calls to solve. Each cycle performs
+ * maxl Arnoldi steps on (I - C C^T) Ah and then selects a new recycled
+ * space from the k directions y of span [U V] that minimize
+ * ||Ah y|| / ||y|| (Ritz singular vectors). This is a symmetric
+ * (generalized) eigenproblem and so avoids a dense nonsymmetric
+ * eigensolver; for normal operators these directions coincide with the
+ * harmonic Ritz vectors of the original method.
+ *
+ * Since the operator changes between Newton iterations and time steps,
+ * C = Ah U is recomputed and reorthonormalized at the start of each solve
+ * (k extra products, counted separately in the statistics).  */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+#include <caml/custom.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../nvectors/nvector_ml.h"
+#include "../lsolvers/sundials_linearsolver_ml.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_iterative.h>
+#include <sundials/sundials_math.h>
+
+#if SUNDIALS_LIB_VERSION < 600
+#define SUNATimesFn ATimesFn
+#define SUNPSetupFn PSetupFn
+#define SUNPSolveFn PSolveFn
+#define SUNModifiedGS ModifiedGS
+#define SUNClassicalGS ClassicalGS
+#define SUN_PREC_NONE PREC_NONE
+#define SUN_PREC_LEFT PREC_LEFT
+#define SUN_PREC_RIGHT PREC_RIGHT
+#define SUN_PREC_BOTH PREC_BOTH
+#define SUN_MODIFIED_GS MODIFIED_GS
+#endif
+
+#define DEFAULT_MAXL	10
+#define DEFAULT_RECYCLE	4
+
+struct gcrodr_content {
+    int maxl;			/* Arnoldi steps per cycle */
+    int kmax;			/* maximum dimension of recycled space */
+    int max_restarts;
+    int gstype;
+    int pretype;
+    sunbooleantype zeroguess;
+
+    int kc;			/* current dimension of recycled space */
+    N_Vector *V;		/* maxl + 1 Arnoldi vectors */
+    N_Vector *U;		/* kmax recycled vectors, Ah U = C */
+    N_Vector *C;		/* kmax orthonormal vectors */
+    N_Vector *Unew;
+    N_Vector *Cnew;
+    N_Vector xcor;
+    N_Vector resid;
+    N_Vector vtemp;
+    N_Vector vtemp2;
+    N_Vector s1;
+    N_Vector s2;
+
+    SUNATimesFn ATimes;
+    void *ATData;
+    SUNPSetupFn Psetup;
+    SUNPSolveFn Psolve;
+    void *PData;
+
+    sunrealtype **Hes;		/* (maxl + 1) x maxl, rows */
+    sunrealtype *rhes;		/* rotated Hes, column-major */
+    sunrealtype *gc, *gs;	/* Givens rotations */
+    sunrealtype *g;
+    sunrealtype *y;
+    sunrealtype *B;		/* kmax x maxl, C^T Ah V */
+    sunrealtype *d;		/* 1 / ||U_i|| */
+    sunrealtype *cv;		/* linear combination coefficients */
+    N_Vector *Xv;
+
+    /* dense work space for the choice of recycled space (q = kmax + maxl) */
+    sunrealtype *G;		/* (q + 1) x q projected operator */
+    sunrealtype *M;		/* q x q */
+    sunrealtype *L;		/* q x q Gram matrix / Cholesky factor */
+    sunrealtype *Z;		/* q x q eigenvectors */
+    sunrealtype *ev;		/* q eigenvalues */
+    sunrealtype *Y;		/* (q + 1) x kmax */
+    sunrealtype *R;		/* kmax x kmax */
+    sunrealtype *P;		/* q x kmax */
+    int *order;
+
+    int numiters;
+    sunrealtype resnorm;
+    long int last_flag;
+
+    long int num_solves;
+    long int num_iters;
+    long int num_recycle_matvecs;
+
+    FILE *info_file;
+    int print_level;
+};
+
+typedef struct gcrodr_content *GcrodrContent;
+
+#define GCRODR_CONTENT(ls) ((GcrodrContent)((ls)->content))
+
+/* column-major access */
+#define ELEM(a, ld, i, j) ((a)[(j) * (ld) + (i)])
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Small dense kernels
+ */
+
+/* Cholesky factorization (lower) in place; returns 0 or -1 if a is not
+   (numerically) positive definite.  */
+static int dense_cholesky(sunrealtype *a, int n, int lda)
+{
+    int i, j, k;
+    sunrealtype s, amax = 0.0;
+
+    for (i = 0; i < n; i++)
+	if (ELEM(a, lda, i, i) > amax) amax = ELEM(a, lda, i, i);
+
+    for (j = 0; j < n; j++) {
+	s = ELEM(a, lda, j, j);
+	for (k = 0; k < j; k++) s -= ELEM(a, lda, j, k) * ELEM(a, lda, j, k);
+	if (s <= 1.0e3 * DBL_EPSILON * amax) return -1;
+	s = sqrt(s);
+	ELEM(a, lda, j, j) = s;
+
+	for (i = j + 1; i < n; i++) {
+	    sunrealtype t = ELEM(a, lda, i, j);
+	    for (k = 0; k < j; k++) t -= ELEM(a, lda, i, k) * ELEM(a, lda, j, k);
+	    ELEM(a, lda, i, j) = t / s;
+	}
+    }
+
+    return 0;
+}
+
+/* Cyclic Jacobi method for symmetric a (overwritten); eigenvectors in
+   the columns of v, eigenvalues in d.  */
+static void dense_jacobi(sunrealtype *a, int n, sunrealtype *v, sunrealtype *d)
+{
+    int i, j, k, sweep;
+    sunrealtype off, tot, theta, t, c, s, akp, akq;
+
+    for (j = 0; j < n; j++)
+	for (i = 0; i < n; i++)
+	    ELEM(v, n, i, j) = (i == j) ? 1.0 : 0.0;
+
+    for (sweep = 0; sweep < 50; sweep++) {
+	off = 0.0;
+	tot = 0.0;
+	for (j = 0; j < n; j++)
+	    for (i = 0; i < n; i++) {
+		t = ELEM(a, n, i, j) * ELEM(a, n, i, j);
+		tot += t;
+		if (i != j) off += t;
+	    }
+	if (off <= DBL_EPSILON * DBL_EPSILON * tot) break;
+
+	for (i = 0; i < n - 1; i++) {
+	    for (j = i + 1; j < n; j++) {
+		if (ELEM(a, n, i, j) == 0.0) continue;
+
+		theta = (ELEM(a, n, j, j) - ELEM(a, n, i, i))
+			/ (2.0 * ELEM(a, n, i, j));
+		t = 1.0 / (fabs(theta) + sqrt(theta * theta + 1.0));
+		if (theta < 0.0) t = -t;
+		c = 1.0 / sqrt(t * t + 1.0);
+		s = t * c;
+
+		for (k = 0; k < n; k++) {
+		    akp = ELEM(a, n, k, i);
+		    akq = ELEM(a, n, k, j);
+		    ELEM(a, n, k, i) = c * akp - s * akq;
+		    ELEM(a, n, k, j) = s * akp + c * akq;
+		}
+		for (k = 0; k < n; k++) {
+		    akp = ELEM(a, n, i, k);
+		    akq = ELEM(a, n, j, k);
+		    ELEM(a, n, i, k) = c * akp - s * akq;
+		    ELEM(a, n, j, k) = s * akp + c * akq;
+		}
+		for (k = 0; k < n; k++) {
+		    akp = ELEM(v, n, k, i);
+		    akq = ELEM(v, n, k, j);
+		    ELEM(v, n, k, i) = c * akp - s * akq;
+		    ELEM(v, n, k, j) = s * akp + c * akq;
+		}
+	    }
+	}
+    }
+
+    for (i = 0; i < n; i++) d[i] = ELEM(a, n, i, i);
+}
+
+/* Modified Gram-Schmidt QR of the m x n matrix y (overwritten by Q);
+   returns the number of columns that were kept (stops at the first
+   numerically dependent column).  */
+static int dense_qr(sunrealtype *y, int m, int n, int ldy,
+		    sunrealtype *r, int ldr)
+{
+    int i, j, k;
+    sunrealtype t, nrm0;
+
+    for (j = 0; j < n; j++) {
+	nrm0 = 0.0;
+	for (i = 0; i < m; i++) nrm0 += ELEM(y, ldy, i, j) * ELEM(y, ldy, i, j);
+	nrm0 = sqrt(nrm0);
+
+	for (k = 0; k < j; k++) {
+	    t = 0.0;
+	    for (i = 0; i < m; i++) t += ELEM(y, ldy, i, k) * ELEM(y, ldy, i, j);
+	    ELEM(r, ldr, k, j) = t;
+	    for (i = 0; i < m; i++) ELEM(y, ldy, i, j) -= t * ELEM(y, ldy, i, k);
+	}
+
+	t = 0.0;
+	for (i = 0; i < m; i++) t += ELEM(y, ldy, i, j) * ELEM(y, ldy, i, j);
+	t = sqrt(t);
+	if (t <= 1.0e3 * DBL_EPSILON * nrm0 || t == 0.0) return j;
+
+	ELEM(r, ldr, j, j) = t;
+	for (i = 0; i < m; i++) ELEM(y, ldy, i, j) /= t;
+    }
+
+    return n;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Operator application
+ */
+
+static int atimes_flag(int status)
+{
+    return (status < 0) ? SUNLS_ATIMES_FAIL_UNREC : SUNLS_ATIMES_FAIL_REC;
+}
+
+static int psolve_flag(int status)
+{
+    return (status < 0) ? SUNLS_PSOLVE_FAIL_UNREC : SUNLS_PSOLVE_FAIL_REC;
+}
+
+static int pre_on_left(GcrodrContent c)
+{
+    return (c->Psolve != NULL)
+	&& (c->pretype == SUN_PREC_LEFT || c->pretype == SUN_PREC_BOTH);
+}
+
+static int pre_on_right(GcrodrContent c)
+{
+    return (c->Psolve != NULL)
+	&& (c->pretype == SUN_PREC_RIGHT || c->pretype == SUN_PREC_BOTH);
+}
+
+/* w = S1 P1^{-1} A P2^{-1} S2^{-1} v  (w must differ from v) */
+static int gcrodr_apply(GcrodrContent c, N_Vector v, N_Vector w,
+			sunrealtype delta)
+{
+    int status;
+    N_Vector t;
+
+    if (c->s2 != NULL) N_VDiv(v, c->s2, c->vtemp);
+    else N_VScale(1.0, v, c->vtemp);
+    t = c->vtemp;
+
+    if (pre_on_right(c)) {
+	status = c->Psolve(c->PData, c->vtemp, c->vtemp2, delta, SUN_PREC_RIGHT);
+	if (status != 0) return psolve_flag(status);
+	t = c->vtemp2;
+    }
+
+    status = c->ATimes(c->ATData, t, w);
+    if (status != 0) return atimes_flag(status);
+
+    if (pre_on_left(c)) {
+	status = c->Psolve(c->PData, w, c->vtemp, delta, SUN_PREC_LEFT);
+	if (status != 0) return psolve_flag(status);
+	N_VScale(1.0, c->vtemp, w);
+    }
+
+    if (c->s1 != NULL) N_VProd(c->s1, w, w);
+
+    return SUNLS_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Recycled space
+ */
+
+/* Recompute C = Ah U for the current operator and orthonormalize it,
+   updating U so that Ah U = C still holds.  */
+static int gcrodr_refresh(GcrodrContent c, sunrealtype delta)
+{
+    int i, j, status, k = c->kc;
+    sunrealtype t;
+
+    for (j = 0; j < k; j++) {
+	status = gcrodr_apply(c, c->U[j], c->C[j], delta);
+	if (status != SUNLS_SUCCESS) {
+	    c->kc = 0;
+	    return status;
+	}
+    }
+    c->num_recycle_matvecs += k;
+
+    for (j = 0; j < k; j++) {
+	/* C_j := (C_j - sum_i r_ij C_i) / r_jj, same operations on U_j */
+	if (j > 0) {
+	    N_VDotProdMulti(j, c->C[j], c->C, c->cv + 1);
+	    c->cv[0] = 1.0;
+	    c->Xv[0] = c->C[j];
+	    for (i = 0; i < j; i++) {
+		c->cv[i + 1] = -c->cv[i + 1];
+		c->Xv[i + 1] = c->C[i];
+	    }
+	    N_VLinearCombination(j + 1, c->cv, c->Xv, c->C[j]);
+	    c->Xv[0] = c->U[j];
+	    for (i = 0; i < j; i++) c->Xv[i + 1] = c->U[i];
+	    N_VLinearCombination(j + 1, c->cv, c->Xv, c->U[j]);
+	}
+
+	t = SUNRsqrt(N_VDotProd(c->C[j], c->C[j]));
+	if (t == 0.0 || !(t <= 1.0 / DBL_EPSILON)) {
+	    /* dependent (or useless) direction: truncate the space */
+	    c->kc = j;
+	    break;
+	}
+	N_VScale(1.0 / t, c->C[j], c->C[j]);
+	N_VScale(1.0 / t, c->U[j], c->U[j]);
+    }
+
+    return SUNLS_SUCCESS;
+}
+
+/* Choose a new recycled space from span [U V_0 ... V_{p-1}] after a cycle
+   of p Arnoldi steps. On failure, the current space is kept.  */
+static void gcrodr_select(GcrodrContent c, int p)
+{
+    int kc = c->kc, q = kc + p, ldg = q + 1;
+    int i, j, l, knew, nw;
+    sunrealtype t;
+    N_Vector *tmp;
+
+    /* scaling of the U columns and Gram matrix of [U~ V] */
+    for (i = 0; i < kc; i++) {
+	for (j = 0; j < kc; j++) c->Xv[j] = c->U[j];
+	for (j = 0; j < p; j++) c->Xv[kc + j] = c->V[j];
+	N_VDotProdMulti(q, c->U[i], c->Xv, c->cv);
+	for (j = 0; j < q; j++) ELEM(c->L, q, i, j) = c->cv[j];
+    }
+    for (i = 0; i < kc; i++) {
+	if (!(ELEM(c->L, q, i, i) > 0.0)) return;
+	c->d[i] = 1.0 / SUNRsqrt(ELEM(c->L, q, i, i));
+    }
+    for (i = 0; i < kc; i++) {
+	for (j = 0; j < kc; j++) ELEM(c->L, q, i, j) *= c->d[i] * c->d[j];
+	for (j = kc; j < q; j++) {
+	    ELEM(c->L, q, i, j) *= c->d[i];
+	    ELEM(c->L, q, j, i) = ELEM(c->L, q, i, j);
+	}
+    }
+    for (i = kc; i < q; i++)
+	for (j = kc; j < q; j++) ELEM(c->L, q, i, j) = (i == j) ? 1.0 : 0.0;
+
+    /* projected operator: Ah [U~ V_{0..p-1}] = [C V_{0..p}] G */
+    for (j = 0; j < q; j++)
+	for (i = 0; i <= q; i++) ELEM(c->G, ldg, i, j) = 0.0;
+    for (i = 0; i < kc; i++) ELEM(c->G, ldg, i, i) = c->d[i];
+    for (j = 0; j < p; j++) {
+	for (i = 0; i < kc; i++)
+	    ELEM(c->G, ldg, i, kc + j) = ELEM(c->B, c->kmax, i, j);
+	for (i = 0; i <= j + 1; i++)
+	    ELEM(c->G, ldg, kc + i, kc + j) = c->Hes[i][j];
+    }
+
+    /* M = L^{-1} (G^T G) L^{-T} with Gram = L L^T */
+    if (dense_cholesky(c->L, q, q) != 0) return;
+
+    for (j = 0; j < q; j++)
+	for (i = 0; i < q; i++) {
+	    t = 0.0;
+	    for (l = 0; l <= q; l++)
+		t += ELEM(c->G, ldg, l, i) * ELEM(c->G, ldg, l, j);
+	    ELEM(c->M, q, i, j) = t;
+	}
+    for (j = 0; j < q; j++)		/* M := L^{-1} M */
+	for (i = 0; i < q; i++) {
+	    t = ELEM(c->M, q, i, j);
+	    for (l = 0; l < i; l++) t -= ELEM(c->L, q, i, l) * ELEM(c->M, q, l, j);
+	    ELEM(c->M, q, i, j) = t / ELEM(c->L, q, i, i);
+	}
+    for (i = 0; i < q; i++)		/* M := M L^{-T} */
+	for (j = 0; j < q; j++) {
+	    t = ELEM(c->M, q, i, j);
+	    for (l = 0; l < j; l++) t -= ELEM(c->M, q, i, l) * ELEM(c->L, q, j, l);
+	    ELEM(c->M, q, i, j) = t / ELEM(c->L, q, j, j);
+	}
+    for (j = 0; j < q; j++)		/* symmetrize */
+	for (i = 0; i < j; i++) {
+	    t = 0.5 * (ELEM(c->M, q, i, j) + ELEM(c->M, q, j, i));
+	    ELEM(c->M, q, i, j) = ELEM(c->M, q, j, i) = t;
+	}
+
+    dense_jacobi(c->M, q, c->Z, c->ev);
+
+    /* the knew smallest eigenvalues */
+    knew = SUNMIN(c->kmax, q);
+    for (i = 0; i < q; i++) c->order[i] = i;
+    for (i = 0; i < knew; i++)
+	for (j = i + 1; j < q; j++)
+	    if (c->ev[c->order[j]] < c->ev[c->order[i]]) {
+		l = c->order[i];
+		c->order[i] = c->order[j];
+		c->order[j] = l;
+	    }
+
+    /* P = L^{-T} Z(:, order) */
+    for (j = 0; j < knew; j++) {
+	for (i = q - 1; i >= 0; i--) {
+	    t = ELEM(c->Z, q, i, c->order[j]);
+	    for (l = i + 1; l < q; l++) t -= ELEM(c->L, q, l, i) * ELEM(c->P, q, l, j);
+	    ELEM(c->P, q, i, j) = t / ELEM(c->L, q, i, i);
+	}
+    }
+
+    /* Y = G P = Q R */
+    for (j = 0; j < knew; j++)
+	for (i = 0; i <= q; i++) {
+	    t = 0.0;
+	    for (l = 0; l < q; l++) t += ELEM(c->G, ldg, i, l) * ELEM(c->P, q, l, j);
+	    ELEM(c->Y, ldg, i, j) = t;
+	}
+    knew = dense_qr(c->Y, q + 1, knew, ldg, c->R, c->kmax);
+    if (knew == 0) return;
+
+    /* P := P R^{-1} */
+    for (j = 0; j < knew; j++)
+	for (i = 0; i < q; i++) {
+	    t = ELEM(c->P, q, i, j);
+	    for (l = 0; l < j; l++) t -= ELEM(c->R, c->kmax, l, j) * ELEM(c->P, q, i, l);
+	    ELEM(c->P, q, i, j) = t / ELEM(c->R, c->kmax, j, j);
+	}
+
+    /* Cnew = [C V_{0..p}] Q,  Unew = [U~ V_{0..p-1}] P */
+    nw = q + 1;
+    for (i = 0; i < kc; i++) c->Xv[i] = c->C[i];
+    for (i = 0; i <= p; i++) c->Xv[kc + i] = c->V[i];
+    for (j = 0; j < knew; j++) {
+	for (i = 0; i < nw; i++) c->cv[i] = ELEM(c->Y, ldg, i, j);
+	N_VLinearCombination(nw, c->cv, c->Xv, c->Cnew[j]);
+    }
+
+    for (i = 0; i < kc; i++) c->Xv[i] = c->U[i];
+    for (j = 0; j < knew; j++) {
+	for (i = 0; i < kc; i++) c->cv[i] = c->d[i] * ELEM(c->P, q, i, j);
+	for (i = kc; i < q; i++) c->cv[i] = ELEM(c->P, q, i, j);
+	N_VLinearCombination(q, c->cv, c->Xv, c->Unew[j]);
+    }
+
+    tmp = c->U; c->U = c->Unew; c->Unew = tmp;
+    tmp = c->C; c->C = c->Cnew; c->Cnew = tmp;
+    c->kc = knew;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * SUNLinearSolver operations
+ */
+
+static SUNLinearSolver_Type gcrodr_gettype(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_ITERATIVE;
+}
+
+static SUNLinearSolver_ID gcrodr_getid(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_CUSTOM;
+}
+
+static int gcrodr_initialize(SUNLinearSolver ls)
+{
+    GcrodrContent c = GCRODR_CONTENT(ls);
+
+    if (c->pretype != SUN_PREC_LEFT && c->pretype != SUN_PREC_RIGHT
+	    && c->pretype != SUN_PREC_BOTH)
+	c->pretype = SUN_PREC_NONE;
+
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int gcrodr_setatimes(SUNLinearSolver ls, void *A_data,
+			    SUNATimesFn ATimes)
+{
+    GcrodrContent c = GCRODR_CONTENT(ls);
+    c->ATimes = ATimes;
+    c->ATData = A_data;
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int gcrodr_setpreconditioner(SUNLinearSolver ls, void *P_data,
+				    SUNPSetupFn Psetup, SUNPSolveFn Psolve)
+{
+    GcrodrContent c = GCRODR_CONTENT(ls);
+    c->Psetup = Psetup;
+    c->Psolve = Psolve;
+    c->PData = P_data;
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int gcrodr_setscalingvectors(SUNLinearSolver ls,
+				    N_Vector s1, N_Vector s2)
+{
+    GcrodrContent c = GCRODR_CONTENT(ls);
+    c->s1 = s1;
+    c->s2 = s2;
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+#if 580 <= SUNDIALS_LIB_VERSION
+static int gcrodr_setzeroguess(SUNLinearSolver ls, sunbooleantype onoff)
+{
+    GCRODR_CONTENT(ls)->zeroguess = onoff;
+    return SUNLS_SUCCESS;
+}
+#endif
+
+static int gcrodr_setup(SUNLinearSolver ls, SUNMatrix A)
+{
+    GcrodrContent c = GCRODR_CONTENT(ls);
+    int status;
+
+    if (c->Psetup != NULL) {
+	status = c->Psetup(c->PData);
+	if (status != 0) {
+	    c->last_flag = (status < 0) ? SUNLS_PSET_FAIL_UNREC
+					: SUNLS_PSET_FAIL_REC;
+	    return c->last_flag;
+	}
+    }
+
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+/* One cycle of p <= maxl Arnoldi steps on (I - C C^T) Ah; updates xcor,
+   resid and *rnorm. Returns a SUNLS_* flag.  */
+static int gcrodr_cycle(GcrodrContent c, sunrealtype delta,
+			sunrealtype *rnorm, int *pout)
+{
+    int i, j, p = 0, kc = c->kc, status;
+    sunrealtype beta = *rnorm, t1, t2, den;
+
+    N_VScale(1.0 / beta, c->resid, c->V[0]);
+    for (i = 0; i <= c->maxl; i++) c->g[i] = 0.0;
+    c->g[0] = beta;
+
+    for (j = 0; j < c->maxl; j++) {
+	status = gcrodr_apply(c, c->V[j], c->V[j + 1], delta);
+	if (status != SUNLS_SUCCESS) {
+	    *pout = p;
+	    return status;
+	}
+	c->numiters++;
+	c->num_iters++;
+
+	if (kc > 0) {
+	    N_VDotProdMulti(kc, c->V[j + 1], c->C, &ELEM(c->B, c->kmax, 0, j));
+	    c->cv[0] = 1.0;
+	    c->Xv[0] = c->V[j + 1];
+	    for (i = 0; i < kc; i++) {
+		c->cv[i + 1] = -ELEM(c->B, c->kmax, i, j);
+		c->Xv[i + 1] = c->C[i];
+	    }
+	    N_VLinearCombination(kc + 1, c->cv, c->Xv, c->V[j + 1]);
+	}
+
+	if (c->gstype == SUN_MODIFIED_GS)
+	    status = SUNModifiedGS(c->V, c->Hes, j + 1, c->maxl,
+				   &(c->Hes[j + 1][j]));
+	else
+	    status = SUNClassicalGS(c->V, c->Hes, j + 1, c->maxl,
+				    &(c->Hes[j + 1][j]), c->cv, c->Xv);
+	if (status != 0) {
+	    *pout = p;
+	    return SUNLS_GS_FAIL;
+	}
+
+	/* QR of the Hessenberg matrix by Givens rotations */
+	for (i = 0; i <= j + 1; i++)
+	    ELEM(c->rhes, c->maxl + 1, i, j) = c->Hes[i][j];
+	for (i = 0; i < j; i++) {
+	    t1 = ELEM(c->rhes, c->maxl + 1, i, j);
+	    t2 = ELEM(c->rhes, c->maxl + 1, i + 1, j);
+	    ELEM(c->rhes, c->maxl + 1, i, j) = c->gc[i] * t1 - c->gs[i] * t2;
+	    ELEM(c->rhes, c->maxl + 1, i + 1, j) = c->gs[i] * t1 + c->gc[i] * t2;
+	}
+	t1 = ELEM(c->rhes, c->maxl + 1, j, j);
+	t2 = ELEM(c->rhes, c->maxl + 1, j + 1, j);
+	if (t2 == 0.0) {
+	    c->gc[j] = 1.0;
+	    c->gs[j] = 0.0;
+	} else {
+	    den = SUNRsqrt(t1 * t1 + t2 * t2);
+	    c->gc[j] = t1 / den;
+	    c->gs[j] = -t2 / den;
+	    ELEM(c->rhes, c->maxl + 1, j, j) = den;
+	}
+	ELEM(c->rhes, c->maxl + 1, j + 1, j) = 0.0;
+	c->g[j + 1] = c->gs[j] * c->g[j];
+	c->g[j] = c->gc[j] * c->g[j];
+
+	p = j + 1;
+	*rnorm = SUNRabs(c->g[j + 1]);
+
+	if (c->print_level && c->info_file != NULL)
+	    fprintf(c->info_file,
+		    "SUNLinSolSolve_GCRODR: iter = %d, res_norm = %.16g\n",
+		    c->numiters, *rnorm);
+
+	if (c->Hes[j + 1][j] != 0.0)
+	    N_VScale(1.0 / c->Hes[j + 1][j], c->V[j + 1], c->V[j + 1]);
+	if (*rnorm <= delta || c->Hes[j + 1][j] == 0.0) break;
+    }
+
+    if (ELEM(c->rhes, c->maxl + 1, p - 1, p - 1) == 0.0) {
+	*pout = p;
+	return SUNLS_QRSOL_FAIL;
+    }
+
+    /* y = R^{-1} g */
+    for (i = p - 1; i >= 0; i--) {
+	t1 = c->g[i];
+	for (j = i + 1; j < p; j++) t1 -= ELEM(c->rhes, c->maxl + 1, i, j) * c->y[j];
+	c->y[i] = t1 / ELEM(c->rhes, c->maxl + 1, i, i);
+    }
+
+    /* xcor += V y - U (B y) */
+    c->cv[0] = 1.0;
+    c->Xv[0] = c->xcor;
+    for (j = 0; j < p; j++) {
+	c->cv[1 + j] = c->y[j];
+	c->Xv[1 + j] = c->V[j];
+    }
+    for (i = 0; i < kc; i++) {
+	t1 = 0.0;
+	for (j = 0; j < p; j++) t1 += ELEM(c->B, c->kmax, i, j) * c->y[j];
+	c->cv[1 + p + i] = -t1;
+	c->Xv[1 + p + i] = c->U[i];
+    }
+    N_VLinearCombination(1 + p + kc, c->cv, c->Xv, c->xcor);
+
+    /* resid = V (beta e1 - Hbar y) */
+    for (i = 0; i <= p; i++) {
+	t1 = (i == 0) ? beta : 0.0;
+	for (j = SUNMAX(i - 1, 0); j < p; j++) t1 -= c->Hes[i][j] * c->y[j];
+	c->cv[i] = t1;
+    }
+    N_VLinearCombination(p + 1, c->cv, c->V, c->resid);
+
+    *pout = p;
+    return SUNLS_SUCCESS;
+}
+
+static int gcrodr_solve(SUNLinearSolver ls, SUNMatrix A, N_Vector x,
+			N_Vector b, sunrealtype delta)
+{
+    GcrodrContent c = GCRODR_CONTENT(ls);
+    sunbooleantype zeroguess = c->zeroguess;
+    sunrealtype r0norm, rnorm;
+    int i, cycle, p, status, converged = 0;
+
+    c->zeroguess = SUNFALSE;
+    c->numiters = 0;
+    c->num_solves++;
+
+    if (c->ATimes == NULL) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+
+#if SUNDIALS_LIB_VERSION < 580
+    zeroguess = (N_VDotProd(x, x) == 0.0);
+#endif
+
+    /* resid = S1 P1^{-1} (b - A x) */
+    if (zeroguess) {
+	N_VScale(1.0, b, c->vtemp);
+    } else {
+	status = c->ATimes(c->ATData, x, c->vtemp);
+	if (status != 0) {
+	    c->last_flag = atimes_flag(status);
+	    return c->last_flag;
+	}
+	N_VLinearSum(1.0, b, -1.0, c->vtemp, c->vtemp);
+    }
+    if (pre_on_left(c)) {
+	status = c->Psolve(c->PData, c->vtemp, c->resid, delta, SUN_PREC_LEFT);
+	if (status != 0) {
+	    c->last_flag = psolve_flag(status);
+	    return c->last_flag;
+	}
+    } else {
+	N_VScale(1.0, c->vtemp, c->resid);
+    }
+    if (c->s1 != NULL) N_VProd(c->s1, c->resid, c->resid);
+
+    r0norm = rnorm = SUNRsqrt(N_VDotProd(c->resid, c->resid));
+    c->resnorm = r0norm;
+    if (r0norm <= delta) {
+	if (zeroguess) N_VConst(0.0, x);
+	c->last_flag = SUNLS_SUCCESS;
+	return SUNLS_SUCCESS;
+    }
+
+    N_VConst(0.0, c->xcor);
+
+    /* project the residual onto the complement of the recycled space */
+    if (c->kc > 0) {
+	status = gcrodr_refresh(c, delta);
+	if (status != SUNLS_SUCCESS) {
+	    c->last_flag = status;
+	    return status;
+	}
+    }
+    if (c->kc > 0) {
+	N_VDotProdMulti(c->kc, c->resid, c->C, c->cv + 1);
+
+	c->cv[0] = 1.0;
+	c->Xv[0] = c->xcor;
+	for (i = 0; i < c->kc; i++) c->Xv[i + 1] = c->U[i];
+	N_VLinearCombination(c->kc + 1, c->cv, c->Xv, c->xcor);
+
+	c->Xv[0] = c->resid;
+	for (i = 0; i < c->kc; i++) {
+	    c->cv[i + 1] = -c->cv[i + 1];
+	    c->Xv[i + 1] = c->C[i];
+	}
+	N_VLinearCombination(c->kc + 1, c->cv, c->Xv, c->resid);
+
+	rnorm = SUNRsqrt(N_VDotProd(c->resid, c->resid));
+    }
+
+    for (cycle = 0; ; cycle++) {
+	if (rnorm <= delta) {
+	    converged = 1;
+	    break;
+	}
+
+	status = gcrodr_cycle(c, delta, &rnorm, &p);
+	if (status != SUNLS_SUCCESS) {
+	    c->resnorm = rnorm;
+	    c->last_flag = status;
+	    return status;
+	}
+
+	gcrodr_select(c, p);
+
+	if (rnorm <= delta) {
+	    converged = 1;
+	    break;
+	}
+	if (cycle >= c->max_restarts) break;
+    }
+
+    c->resnorm = rnorm;
+    if (!converged && !(rnorm < r0norm)) {
+	c->last_flag = SUNLS_CONV_FAIL;
+	return SUNLS_CONV_FAIL;
+    }
+
+    /* x += P2^{-1} S2^{-1} xcor */
+    if (c->s2 != NULL) N_VDiv(c->xcor, c->s2, c->xcor);
+    if (pre_on_right(c)) {
+	status = c->Psolve(c->PData, c->xcor, c->vtemp, delta, SUN_PREC_RIGHT);
+	if (status != 0) {
+	    c->last_flag = psolve_flag(status);
+	    return c->last_flag;
+	}
+	N_VScale(1.0, c->vtemp, c->xcor);
+    }
+    if (zeroguess) N_VScale(1.0, c->xcor, x);
+    else N_VLinearSum(1.0, x, 1.0, c->xcor, x);
+
+    c->last_flag = converged ? SUNLS_SUCCESS : SUNLS_RES_REDUCED;
+    return c->last_flag;
+}
+
+static int gcrodr_numiters(SUNLinearSolver ls)
+{
+    return GCRODR_CONTENT(ls)->numiters;
+}
+
+static sunrealtype gcrodr_resnorm(SUNLinearSolver ls)
+{
+    return GCRODR_CONTENT(ls)->resnorm;
+}
+
+static N_Vector gcrodr_resid(SUNLinearSolver ls)
+{
+    return GCRODR_CONTENT(ls)->resid;
+}
+
+static sunindextype gcrodr_lastflag(SUNLinearSolver ls)
+{
+    return GCRODR_CONTENT(ls)->last_flag;
+}
+
+static int gcrodr_space(SUNLinearSolver ls, long int *lenrw, long int *leniw)
+{
+    GcrodrContent c = GCRODR_CONTENT(ls);
+    sunindextype lrw1 = 0, liw1 = 0;
+    long int q = c->kmax + c->maxl;
+
+    if (c->vtemp->ops->nvspace) N_VSpace(c->vtemp, &lrw1, &liw1);
+
+    *lenrw = lrw1 * (c->maxl + 1 + 4 * c->kmax + 4)
+	     + (c->maxl + 1) * c->maxl * 2 + c->kmax * c->maxl
+	     + 3 * q * q + 2 * (q + 1) * c->kmax + q * c->kmax + 4 * q;
+    *leniw = liw1 * (c->maxl + 1 + 4 * c->kmax + 4) + q;
+    return SUNLS_SUCCESS;
+}
+
+static int gcrodr_free(SUNLinearSolver ls)
+{
+    GcrodrContent c;
+    int i;
+
+    if (ls == NULL) return SUNLS_SUCCESS;
+
+    c = GCRODR_CONTENT(ls);
+    if (c != NULL) {
+	if (c->V) N_VDestroyVectorArray(c->V, c->maxl + 1);
+	if (c->U) N_VDestroyVectorArray(c->U, c->kmax);
+	if (c->C) N_VDestroyVectorArray(c->C, c->kmax);
+	if (c->Unew) N_VDestroyVectorArray(c->Unew, c->kmax);
+	if (c->Cnew) N_VDestroyVectorArray(c->Cnew, c->kmax);
+	if (c->xcor) N_VDestroy(c->xcor);
+	if (c->resid) N_VDestroy(c->resid);
+	if (c->vtemp) N_VDestroy(c->vtemp);
+	if (c->vtemp2) N_VDestroy(c->vtemp2);
+	if (c->Hes) {
+	    for (i = 0; i <= c->maxl; i++) free(c->Hes[i]);
+	    free(c->Hes);
+	}
+	free(c->rhes);
+	free(c->gc);
+	free(c->gs);
+	free(c->g);
+	free(c->y);
+	free(c->B);
+	free(c->d);
+	free(c->cv);
+	free(c->Xv);
+	free(c->G);
+	free(c->M);
+	free(c->L);
+	free(c->Z);
+	free(c->ev);
+	free(c->Y);
+	free(c->R);
+	free(c->P);
+	free(c->order);
+	free(c);
+    }
+    free(ls->ops);
+    free(ls);
+
+    return SUNLS_SUCCESS;
+}
+
+static SUNLinearSolver gcrodr_create(N_Vector y, int maxl, int kmax)
+{
+    SUNLinearSolver ls;
+    SUNLinearSolver_Ops ops;
+    GcrodrContent c;
+    int i, q = maxl + kmax, nwork = maxl + 2 * kmax + 2;
+
+    ls = (SUNLinearSolver)malloc(sizeof *ls);
+    if (ls == NULL) return NULL;
+
+    ops = (SUNLinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNLinearSolver_Ops));
+    c = (GcrodrContent) calloc(1, sizeof(struct gcrodr_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(ls);
+	return NULL;
+    }
+
+    ops->gettype           = gcrodr_gettype;
+    ops->getid             = gcrodr_getid;
+    ops->setatimes         = gcrodr_setatimes;
+    ops->setpreconditioner = gcrodr_setpreconditioner;
+    ops->setscalingvectors = gcrodr_setscalingvectors;
+#if 580 <= SUNDIALS_LIB_VERSION
+    ops->setzeroguess      = gcrodr_setzeroguess;
+#endif
+    ops->initialize        = gcrodr_initialize;
+    ops->setup             = gcrodr_setup;
+    ops->solve             = gcrodr_solve;
+    ops->numiters          = gcrodr_numiters;
+    ops->resnorm           = gcrodr_resnorm;
+    ops->resid             = gcrodr_resid;
+    ops->lastflag          = gcrodr_lastflag;
+    ops->space             = gcrodr_space;
+    ops->free              = gcrodr_free;
+
+    ls->ops = ops;
+    ls->content = c;
+
+    c->maxl = maxl;
+    c->kmax = kmax;
+    c->max_restarts = 0;
+    c->gstype = SUN_MODIFIED_GS;
+    c->pretype = SUN_PREC_NONE;
+    c->zeroguess = SUNFALSE;
+    c->last_flag = SUNLS_SUCCESS;
+
+    c->V = N_VCloneVectorArray(maxl + 1, y);
+    c->U = N_VCloneVectorArray(kmax, y);
+    c->C = N_VCloneVectorArray(kmax, y);
+    c->Unew = N_VCloneVectorArray(kmax, y);
+    c->Cnew = N_VCloneVectorArray(kmax, y);
+    c->xcor = N_VClone(y);
+    c->resid = N_VClone(y);
+    c->vtemp = N_VClone(y);
+    c->vtemp2 = N_VClone(y);
+
+    c->Hes = (sunrealtype **)calloc(maxl + 1, sizeof(sunrealtype *));
+    if (c->Hes != NULL)
+	for (i = 0; i <= maxl; i++)
+	    c->Hes[i] = (sunrealtype *)calloc(maxl, sizeof(sunrealtype));
+
+    c->rhes  = (sunrealtype *)calloc((maxl + 1) * maxl, sizeof(sunrealtype));
+    c->gc    = (sunrealtype *)calloc(maxl, sizeof(sunrealtype));
+    c->gs    = (sunrealtype *)calloc(maxl, sizeof(sunrealtype));
+    c->g     = (sunrealtype *)calloc(maxl + 1, sizeof(sunrealtype));
+    c->y     = (sunrealtype *)calloc(maxl, sizeof(sunrealtype));
+    c->B     = (sunrealtype *)calloc(kmax * maxl, sizeof(sunrealtype));
+    c->d     = (sunrealtype *)calloc(kmax, sizeof(sunrealtype));
+    c->cv    = (sunrealtype *)calloc(nwork, sizeof(sunrealtype));
+    c->Xv    = (N_Vector *)calloc(nwork, sizeof(N_Vector));
+    c->G     = (sunrealtype *)calloc((q + 1) * q, sizeof(sunrealtype));
+    c->M     = (sunrealtype *)calloc(q * q, sizeof(sunrealtype));
+    c->L     = (sunrealtype *)calloc(q * q, sizeof(sunrealtype));
+    c->Z     = (sunrealtype *)calloc(q * q, sizeof(sunrealtype));
+    c->ev    = (sunrealtype *)calloc(q, sizeof(sunrealtype));
+    c->Y     = (sunrealtype *)calloc((q + 1) * kmax, sizeof(sunrealtype));
+    c->R     = (sunrealtype *)calloc(kmax * kmax, sizeof(sunrealtype));
+    c->P     = (sunrealtype *)calloc(q * kmax, sizeof(sunrealtype));
+    c->order = (int *)calloc(q, sizeof(int));
+
+    if (c->V == NULL || c->U == NULL || c->C == NULL || c->Unew == NULL
+	    || c->Cnew == NULL || c->xcor == NULL || c->resid == NULL
+	    || c->vtemp == NULL || c->vtemp2 == NULL || c->Hes == NULL
+	    || c->rhes == NULL || c->gc == NULL || c->gs == NULL
+	    || c->g == NULL || c->y == NULL || c->B == NULL || c->d == NULL
+	    || c->cv == NULL || c->Xv == NULL || c->G == NULL || c->M == NULL
+	    || c->L == NULL || c->Z == NULL || c->ev == NULL || c->Y == NULL
+	    || c->R == NULL || c->P == NULL || c->order == NULL) {
+	gcrodr_free(ls);
+	return NULL;
+    }
+    for (i = 0; i <= maxl; i++)
+	if (c->Hes[i] == NULL) {
+	    gcrodr_free(ls);
+	    return NULL;
+	}
+
+    return ls;
+}
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Interface functions
+ */
+
+CAMLprim value sunml_lsolver_gcrodr(value vmaxl, value vrecycle,
+				    value vnvec, value vctx)
+{
+    CAMLparam4(vmaxl, vrecycle, vnvec, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SUNLinearSolver ls;
+    int maxl = Int_val(vmaxl) <= 0 ? DEFAULT_MAXL : Int_val(vmaxl);
+    int recycle = Int_val(vrecycle) < 0 ? DEFAULT_RECYCLE : Int_val(vrecycle);
+
+    if (recycle == 0 || recycle > maxl)
+	caml_invalid_argument("Gcrodr: recycle must be in 1..maxl");
+
+    ls = gcrodr_create(NVEC_VAL(vnvec), maxl, recycle);
+    if (ls == NULL) caml_raise_out_of_memory();
+#if 600 <= SUNDIALS_LIB_VERSION
+    ls->sunctx = ML_CONTEXT(vctx);
+#endif
+
+    CAMLreturn(sunml_lsolver_wrap(ls));
+#else
+    CAMLreturn(Val_unit);
+#endif
+}
+
+CAMLprim void sunml_lsolver_gcrodr_set_prec_type(value vcptr, value vpretype,
+						 value vdocheck)
+{
+    CAMLparam3(vcptr, vpretype, vdocheck);
+#if 500 <= SUNDIALS_LIB_VERSION
+    GcrodrContent c = GCRODR_CONTENT(LSOLVER_VAL(vcptr));
+    int pretype = sunml_lsolver_precond_type(vpretype);
+
+    if (Bool_val(vdocheck)
+	    && (c->pretype == SUN_PREC_NONE) && (pretype != SUN_PREC_NONE))
+	caml_raise_constant(LSOLVER_EXN(IllegalPrecType));
+
+    c->pretype = pretype;
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_lsolver_gcrodr_set_gs_type(value vcptr, value vgst)
+{
+    CAMLparam2(vcptr, vgst);
+#if 500 <= SUNDIALS_LIB_VERSION
+    GCRODR_CONTENT(LSOLVER_VAL(vcptr))->gstype = sunml_lsolver_gs_type(vgst);
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_lsolver_gcrodr_set_max_restarts(value vcptr, value vmaxr)
+{
+    CAMLparam2(vcptr, vmaxr);
+#if 500 <= SUNDIALS_LIB_VERSION
+    GCRODR_CONTENT(LSOLVER_VAL(vcptr))->max_restarts =
+	Int_val(vmaxr) < 0 ? 0 : Int_val(vmaxr);
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_lsolver_gcrodr_reset_recycled(value vcptr)
+{
+    CAMLparam1(vcptr);
+#if 500 <= SUNDIALS_LIB_VERSION
+    GCRODR_CONTENT(LSOLVER_VAL(vcptr))->kc = 0;
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_lsolver_gcrodr_set_info_file(value vcptr, value vfile)
+{
+    CAMLparam2(vcptr, vfile);
+#if 500 <= SUNDIALS_LIB_VERSION
+    GCRODR_CONTENT(LSOLVER_VAL(vcptr))->info_file = ML_CFILE(vfile);
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_lsolver_gcrodr_set_print_level(value vcptr, value vlevel)
+{
+    CAMLparam2(vcptr, vlevel);
+#if 500 <= SUNDIALS_LIB_VERSION
+    GCRODR_CONTENT(LSOLVER_VAL(vcptr))->print_level = Int_val(vlevel);
+#endif
+    CAMLreturn0;
+}
+
+// must correspond with LinearSolver.Iterative.Gcrodr.stats
+CAMLprim value sunml_lsolver_gcrodr_get_stats(value vcptr)
+{
+    CAMLparam1(vcptr);
+    CAMLlocal1(vr);
+#if 500 <= SUNDIALS_LIB_VERSION
+    GcrodrContent c = GCRODR_CONTENT(LSOLVER_VAL(vcptr));
+
+    vr = caml_alloc_tuple(4);
+    Store_field(vr, 0, Val_long(c->num_solves));
+    Store_field(vr, 1, Val_long(c->num_iters));
+    Store_field(vr, 2, Val_long(c->num_recycle_matvecs));
+    Store_field(vr, 3, Val_int(c->kc));
+#else
+    vr = Val_unit;
+#endif
+    CAMLreturn(vr);
+}
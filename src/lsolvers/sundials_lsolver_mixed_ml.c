@@ -0,0 +1,679 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Mixed-precision direct linear solvers for dense and banded matrices.
+ *
+ * The iteration matrix is copied to single precision and factored there
+ * (LU with partial pivoting), which halves the storage of the factors and
+ * roughly doubles the speed of the factorization.  Each solve starts from
+ * the single-precision solution and then applies iterative refinement
+ * against the original double-precision matrix:
+ *
+ *	r = b - A x,  solve (LU) d = r in single precision,  x = x + d
+ *
+ * until ||r||_inf <= ||x||_inf * ||A||_inf * eps * sqrt(n) (the criterion
+ * of LAPACK's dsgesv). If the single-precision factorization fails or the
+ * refinement does not converge within max_refine steps, the solver falls
+ * back to a double-precision factorization of the same matrix and uses it
+ * until the next setup.  */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../nvectors/nvector_ml.h"
+#include "../lsolvers/sundials_linearsolver_ml.h"
+#include "../lsolvers/sundials_matrix_ml.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_dense.h>
+#include <sundials/sundials_band.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <nvector/nvector_serial.h>
+
+#if SUNDIALS_LIB_VERSION < 600
+#define SUNDlsMat_denseGETRS denseGETRS
+#define SUNDlsMat_bandGBTRF  bandGBTRF
+#define SUNDlsMat_bandGBTRS  bandGBTRS
+#endif
+
+#define DEFAULT_MAX_REFINE 10
+
+struct mixed_content {
+    int is_band;
+    sunindextype n;
+    sunindextype mu;
+    sunindextype ml;
+    sunindextype smu;
+    sunindextype ldim;		/* n for dense, smu + ml + 1 for band */
+
+    float *lu;			/* single-precision factors */
+    sunindextype *pivots;
+
+    sunrealtype *dlu;		/* double-precision factors, on demand */
+    sunrealtype **dcols;
+
+    sunrealtype *rhs;		/* copy of b (x and b may alias), length n */
+    sunrealtype *res;		/* residual, length n */
+    float *fwork;		/* single-precision rhs, length n */
+
+    sunrealtype anorm;		/* ||A||_inf at the last setup */
+    int use_double;		/* fallback in force until next setup */
+    int max_refine;
+
+    long int num_solves;
+    long int num_refine;
+    long int num_fallbacks;
+    sunindextype last_flag;
+};
+
+typedef struct mixed_content *MixedContent;
+
+#define MIXED_CONTENT(ls) ((MixedContent)((ls)->content))
+
+/* element (i, j) of the single-precision band factors */
+#define FBAND(c, i, j) ((c)->lu[(j) * (c)->ldim + (i) - (j) + (c)->smu])
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Single-precision factorization and solution
+ */
+
+static int pivot_ok(float p)
+{
+    return (p != 0.0f) && (fabsf(p) <= FLT_MAX);
+}
+
+/* Dense LU with partial pivoting (whole rows are exchanged); returns 0 on
+   success or k + 1 if the k-th pivot is zero or not finite.  */
+static sunindextype sgetrf(float *a, sunindextype n, sunindextype *p)
+{
+    sunindextype i, j, k, l;
+    float *col_k, *col_j, tmp, mult, a_kj;
+
+    for (k = 0; k < n; k++) {
+	col_k = a + k * n;
+
+	l = k;
+	for (i = k + 1; i < n; i++)
+	    if (fabsf(col_k[i]) > fabsf(col_k[l])) l = i;
+	p[k] = l;
+
+	if (!pivot_ok(col_k[l])) return (k + 1);
+
+	if (l != k) {
+	    for (j = 0; j < n; j++) {
+		tmp = a[j * n + l];
+		a[j * n + l] = a[j * n + k];
+		a[j * n + k] = tmp;
+	    }
+	}
+
+	mult = 1.0f / col_k[k];
+	for (i = k + 1; i < n; i++) col_k[i] *= mult;
+
+	for (j = k + 1; j < n; j++) {
+	    col_j = a + j * n;
+	    a_kj = col_j[k];
+	    if (a_kj != 0.0f)
+		for (i = k + 1; i < n; i++) col_j[i] -= a_kj * col_k[i];
+	}
+    }
+
+    return 0;
+}
+
+static void sgetrs(float *a, sunindextype n, sunindextype *p, float *b)
+{
+    sunindextype i, k;
+    float *col_k, tmp, b_k;
+
+    for (k = 0; k < n; k++) {
+	if (p[k] != k) {
+	    tmp = b[k];
+	    b[k] = b[p[k]];
+	    b[p[k]] = tmp;
+	}
+    }
+
+    for (k = 0; k < n - 1; k++) {
+	col_k = a + k * n;
+	b_k = b[k];
+	for (i = k + 1; i < n; i++) b[i] -= col_k[i] * b_k;
+    }
+
+    for (k = n - 1; k >= 0; k--) {
+	col_k = a + k * n;
+	b[k] /= col_k[k];
+	b_k = b[k];
+	for (i = 0; i < k; i++) b[i] -= col_k[i] * b_k;
+    }
+}
+
+/* Banded LU with partial pivoting; rows are only exchanged within the
+   stored upper bandwidth (as in SUNDlsMat_bandGBTRF).  */
+static sunindextype sgbtrf(MixedContent c)
+{
+    sunindextype i, j, k, l, last_row, last_col;
+    sunindextype n = c->n;
+    float tmp, mult, a_kj;
+
+    for (k = 0; k < n; k++) {
+	last_row = SUNMIN(n - 1, k + c->ml);
+	last_col = SUNMIN(n - 1, k + c->smu);
+
+	l = k;
+	for (i = k + 1; i <= last_row; i++)
+	    if (fabsf(FBAND(c, i, k)) > fabsf(FBAND(c, l, k))) l = i;
+	c->pivots[k] = l;
+
+	if (!pivot_ok(FBAND(c, l, k))) return (k + 1);
+
+	if (l != k) {
+	    for (j = k; j <= last_col; j++) {
+		tmp = FBAND(c, l, j);
+		FBAND(c, l, j) = FBAND(c, k, j);
+		FBAND(c, k, j) = tmp;
+	    }
+	}
+
+	mult = 1.0f / FBAND(c, k, k);
+	for (i = k + 1; i <= last_row; i++) FBAND(c, i, k) *= mult;
+
+	for (j = k + 1; j <= last_col; j++) {
+	    a_kj = FBAND(c, k, j);
+	    if (a_kj != 0.0f)
+		for (i = k + 1; i <= last_row; i++)
+		    FBAND(c, i, j) -= a_kj * FBAND(c, i, k);
+	}
+    }
+
+    return 0;
+}
+
+static void sgbtrs(MixedContent c, float *b)
+{
+    sunindextype i, k, l, last_row;
+    sunindextype n = c->n;
+    float tmp, b_k;
+
+    for (k = 0; k < n - 1; k++) {
+	l = c->pivots[k];
+	if (l != k) {
+	    tmp = b[k];
+	    b[k] = b[l];
+	    b[l] = tmp;
+	}
+	b_k = b[k];
+	last_row = SUNMIN(n - 1, k + c->ml);
+	for (i = k + 1; i <= last_row; i++) b[i] -= FBAND(c, i, k) * b_k;
+    }
+
+    for (k = n - 1; k >= 0; k--) {
+	b[k] /= FBAND(c, k, k);
+	b_k = b[k];
+	for (i = SUNMAX(0, k - c->smu); i < k; i++)
+	    b[i] -= FBAND(c, i, k) * b_k;
+    }
+}
+
+static void mixed_single_solve(MixedContent c, float *b)
+{
+    if (c->is_band) sgbtrs(c, b);
+    else sgetrs(c->lu, c->n, c->pivots, b);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Double-precision helpers
+ */
+
+/* Copies A to single precision and returns ||A||_inf.  */
+static sunrealtype mixed_demote(MixedContent c, SUNMatrix A)
+{
+    sunindextype i, j, first, last;
+    sunindextype n = c->n;
+    sunrealtype *col, anorm = 0.0;
+    sunrealtype *rowsum = c->res;
+
+    for (i = 0; i < n; i++) rowsum[i] = 0.0;
+
+    if (c->is_band) {
+	memset(c->lu, 0, sizeof(float) * c->ldim * n);
+	for (j = 0; j < n; j++) {
+	    col = SUNBandMatrix_Column(A, j);
+	    first = SUNMAX(0, j - c->mu);
+	    last = SUNMIN(n - 1, j + c->ml);
+	    for (i = first; i <= last; i++) {
+		FBAND(c, i, j) = (float)col[i - j];
+		rowsum[i] += SUNRabs(col[i - j]);
+	    }
+	}
+    } else {
+	for (j = 0; j < n; j++) {
+	    col = SUNDenseMatrix_Column(A, j);
+	    for (i = 0; i < n; i++) {
+		c->lu[j * n + i] = (float)col[i];
+		rowsum[i] += SUNRabs(col[i]);
+	    }
+	}
+    }
+
+    for (i = 0; i < n; i++)
+	if (rowsum[i] > anorm) anorm = rowsum[i];
+
+    return anorm;
+}
+
+/* r = b - A x */
+static void mixed_residual(MixedContent c, SUNMatrix A,
+			   sunrealtype *x, sunrealtype *b, sunrealtype *r)
+{
+    sunindextype i, j, first, last;
+    sunindextype n = c->n;
+    sunrealtype *col, x_j;
+
+    for (i = 0; i < n; i++) r[i] = b[i];
+
+    for (j = 0; j < n; j++) {
+	x_j = x[j];
+	if (x_j == 0.0) continue;
+
+	if (c->is_band) {
+	    col = SUNBandMatrix_Column(A, j);
+	    first = SUNMAX(0, j - c->mu);
+	    last = SUNMIN(n - 1, j + c->ml);
+	    for (i = first; i <= last; i++) r[i] -= col[i - j] * x_j;
+	} else {
+	    col = SUNDenseMatrix_Column(A, j);
+	    for (i = 0; i < n; i++) r[i] -= col[i] * x_j;
+	}
+    }
+}
+
+static sunrealtype max_norm(sunrealtype *v, sunindextype n)
+{
+    sunindextype i;
+    sunrealtype m = 0.0;
+
+    for (i = 0; i < n; i++)
+	if (!(SUNRabs(v[i]) <= m)) m = SUNRabs(v[i]);  /* propagates NaN */
+
+    return m;
+}
+
+/* Factors a double-precision copy of A; returns 0 or k + 1 for a zero
+   pivot (as sunml_dense_getrf/bandGBTRF).  */
+static sunindextype mixed_double_setup(MixedContent c, SUNMatrix A)
+{
+    sunindextype j, n = c->n;
+
+    if (c->dlu == NULL) {
+	c->dlu = (sunrealtype *)malloc(sizeof(sunrealtype) * c->ldim * n);
+	c->dcols = (sunrealtype **)malloc(sizeof(sunrealtype *) * n);
+	if (c->dlu == NULL || c->dcols == NULL) {
+	    free(c->dlu);
+	    free(c->dcols);
+	    c->dlu = NULL;
+	    c->dcols = NULL;
+	    return -1;
+	}
+	for (j = 0; j < n; j++) c->dcols[j] = c->dlu + j * c->ldim;
+    }
+
+    if (c->is_band) {
+	memcpy(c->dlu, SUNBandMatrix_Data(A),
+	       sizeof(sunrealtype) * c->ldim * n);
+	return SUNDlsMat_bandGBTRF(c->dcols, n, c->mu, c->ml, c->smu,
+				   c->pivots);
+    } else {
+	memcpy(c->dlu, SUNDenseMatrix_Data(A), sizeof(sunrealtype) * n * n);
+	return sunml_dense_getrf(c->dcols, n, n, c->pivots);
+    }
+}
+
+static void mixed_double_solve(MixedContent c, sunrealtype *x)
+{
+    if (c->is_band)
+	SUNDlsMat_bandGBTRS(c->dcols, c->n, c->smu, c->ml, c->pivots, x);
+    else
+	SUNDlsMat_denseGETRS(c->dcols, c->n, c->pivots, x);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * SUNLinearSolver operations
+ */
+
+static SUNLinearSolver_Type mixed_gettype(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_DIRECT;
+}
+
+static SUNLinearSolver_ID mixed_getid(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_CUSTOM;
+}
+
+static int mixed_initialize(SUNLinearSolver ls)
+{
+    MIXED_CONTENT(ls)->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int mixed_setup(SUNLinearSolver ls, SUNMatrix A)
+{
+    MixedContent c = MIXED_CONTENT(ls);
+    sunindextype r;
+
+    if (A == NULL) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+
+    c->anorm = mixed_demote(c, A);
+    c->use_double = 0;
+
+    if (c->anorm <= FLT_MAX) {
+	r = c->is_band ? sgbtrf(c) : sgetrf(c->lu, c->n, c->pivots);
+	if (r == 0) {
+	    c->last_flag = SUNLS_SUCCESS;
+	    return SUNLS_SUCCESS;
+	}
+    }
+
+    /* the matrix cannot be represented or factored in single precision */
+    c->num_fallbacks++;
+    c->use_double = 1;
+    r = mixed_double_setup(c, A);
+    if (r < 0) {
+	c->last_flag = SUNLS_MEM_FAIL;
+	return SUNLS_MEM_FAIL;
+    }
+    c->last_flag = r;
+    return (r > 0) ? SUNLS_LUFACT_FAIL : SUNLS_SUCCESS;
+}
+
+static int mixed_solve(SUNLinearSolver ls, SUNMatrix A, N_Vector x,
+		       N_Vector b, sunrealtype tol)
+{
+    MixedContent c = MIXED_CONTENT(ls);
+    sunindextype i, n = c->n, r;
+    sunrealtype *xd, *bd, cte;
+    int iter;
+
+    if (A == NULL || x == NULL || b == NULL) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+
+    xd = N_VGetArrayPointer(x);
+    bd = N_VGetArrayPointer(b);
+    if (xd == NULL || bd == NULL) {
+	c->last_flag = SUNLS_MEM_FAIL;
+	return SUNLS_MEM_FAIL;
+    }
+    memcpy(c->rhs, bd, sizeof(sunrealtype) * n);
+    bd = c->rhs;
+
+    c->num_solves++;
+
+    if (!c->use_double) {
+	cte = c->anorm * DBL_EPSILON * SUNRsqrt((sunrealtype)n);
+
+	for (i = 0; i < n; i++) c->fwork[i] = (float)bd[i];
+	mixed_single_solve(c, c->fwork);
+	for (i = 0; i < n; i++) xd[i] = c->fwork[i];
+
+	for (iter = 0; ; iter++) {
+	    mixed_residual(c, A, xd, bd, c->res);
+	    if (max_norm(c->res, n) <= max_norm(xd, n) * cte) {
+		c->last_flag = SUNLS_SUCCESS;
+		return SUNLS_SUCCESS;
+	    }
+	    if (iter == c->max_refine
+		    || !(max_norm(c->res, n) <= FLT_MAX)) break;
+
+	    for (i = 0; i < n; i++) c->fwork[i] = (float)c->res[i];
+	    mixed_single_solve(c, c->fwork);
+	    for (i = 0; i < n; i++) xd[i] += c->fwork[i];
+	    c->num_refine++;
+	}
+
+	/* refinement stagnated: switch to double precision until the next
+	   setup */
+	c->num_fallbacks++;
+	c->use_double = 1;
+	r = mixed_double_setup(c, A);
+	if (r < 0) {
+	    c->last_flag = SUNLS_MEM_FAIL;
+	    return SUNLS_MEM_FAIL;
+	} else if (r > 0) {
+	    c->last_flag = r;
+	    return SUNLS_LUFACT_FAIL;
+	}
+    }
+
+    for (i = 0; i < n; i++) xd[i] = bd[i];
+    mixed_double_solve(c, xd);
+
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static sunindextype mixed_lastflag(SUNLinearSolver ls)
+{
+    return MIXED_CONTENT(ls)->last_flag;
+}
+
+static int mixed_space(SUNLinearSolver ls, long int *lenrw, long int *leniw)
+{
+    MixedContent c = MIXED_CONTENT(ls);
+
+    /* floats are counted as half a real */
+    *lenrw = (c->ldim * c->n + c->n + 1) / 2 + 2 * c->n + 1
+		+ (c->dlu == NULL ? 0 : c->ldim * c->n);
+    *leniw = 12 + c->n;
+    return SUNLS_SUCCESS;
+}
+
+static int mixed_free(SUNLinearSolver ls)
+{
+    MixedContent c;
+
+    if (ls == NULL) return SUNLS_SUCCESS;
+
+    c = MIXED_CONTENT(ls);
+    if (c != NULL) {
+	free(c->lu);
+	free(c->pivots);
+	free(c->dlu);
+	free(c->dcols);
+	free(c->rhs);
+	free(c->res);
+	free(c->fwork);
+	free(c);
+    }
+    free(ls->ops);
+    free(ls);
+
+    return SUNLS_SUCCESS;
+}
+
+static SUNLinearSolver mixed_create(int is_band, sunindextype n,
+				    sunindextype mu, sunindextype ml,
+				    sunindextype smu, int max_refine)
+{
+    SUNLinearSolver ls;
+    SUNLinearSolver_Ops ops;
+    MixedContent c;
+
+    ls = (SUNLinearSolver)malloc(sizeof *ls);
+    if (ls == NULL) return NULL;
+
+    ops = (SUNLinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNLinearSolver_Ops));
+    c = (MixedContent) calloc(1, sizeof(struct mixed_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(ls);
+	return NULL;
+    }
+
+    ops->gettype    = mixed_gettype;
+    ops->getid      = mixed_getid;
+    ops->initialize = mixed_initialize;
+    ops->setup      = mixed_setup;
+    ops->solve      = mixed_solve;
+    ops->lastflag   = mixed_lastflag;
+    ops->space      = mixed_space;
+    ops->free       = mixed_free;
+
+    ls->ops = ops;
+    ls->content = c;
+
+    c->is_band = is_band;
+    c->n = n;
+    c->mu = mu;
+    c->ml = ml;
+    c->smu = smu;
+    c->ldim = is_band ? smu + ml + 1 : n;
+    c->max_refine = max_refine;
+    c->last_flag = SUNLS_SUCCESS;
+
+    c->lu = (float *)malloc(sizeof(float) * c->ldim * n);
+    c->pivots = (sunindextype *)malloc(sizeof(sunindextype) * n);
+    c->rhs = (sunrealtype *)malloc(sizeof(sunrealtype) * n);
+    c->res = (sunrealtype *)malloc(sizeof(sunrealtype) * n);
+    c->fwork = (float *)malloc(sizeof(float) * n);
+    if (c->lu == NULL || c->pivots == NULL || c->rhs == NULL
+	    || c->res == NULL || c->fwork == NULL) {
+	mixed_free(ls);
+	return NULL;
+    }
+
+    return ls;
+}
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Interface functions
+ */
+
+CAMLprim value sunml_lsolver_mixed_dense(value vnvec, value vdmat,
+					 value vmaxrefine, value vctx)
+{
+    CAMLparam4(vnvec, vdmat, vmaxrefine, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SUNMatrix dmat = MAT_VAL(vdmat);
+    SUNLinearSolver ls;
+    sunindextype n = SUNDenseMatrix_Rows(dmat);
+
+    if (SUNMatGetID(dmat) != SUNMATRIX_DENSE)
+	caml_raise_constant(LSOLVER_EXN(InvalidLinearSolver));
+    if (n != SUNDenseMatrix_Columns(dmat))
+	caml_raise_constant(LSOLVER_EXN(MatrixNotSquare));
+    if (n != NV_LENGTH_S(NVEC_VAL(vnvec)))
+	caml_raise_constant(LSOLVER_EXN(MatrixVectorMismatch));
+
+    ls = mixed_create(0, n, 0, 0, 0,
+		      Is_block(vmaxrefine) ? Int_val(Some_val(vmaxrefine))
+					   : DEFAULT_MAX_REFINE);
+    if (ls == NULL) caml_raise_out_of_memory();
+#if 600 <= SUNDIALS_LIB_VERSION
+    ls->sunctx = ML_CONTEXT(vctx);
+#endif
+
+    CAMLreturn(sunml_lsolver_wrap(ls));
+#else
+    CAMLreturn(Val_unit);
+#endif
+}
+
+CAMLprim value sunml_lsolver_mixed_band(value vnvec, value vbmat,
+					value vmaxrefine, value vctx)
+{
+    CAMLparam4(vnvec, vbmat, vmaxrefine, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SUNMatrix bmat = MAT_VAL(vbmat);
+    SUNLinearSolver ls;
+    sunindextype n = SUNBandMatrix_Rows(bmat);
+
+    if (SUNMatGetID(bmat) != SUNMATRIX_BAND)
+	caml_raise_constant(LSOLVER_EXN(InvalidLinearSolver));
+    if (n != SUNBandMatrix_Columns(bmat))
+	caml_raise_constant(LSOLVER_EXN(MatrixNotSquare));
+    if (SUNBandMatrix_StoredUpperBandwidth(bmat) <
+	    SUNMIN(n - 1, SUNBandMatrix_LowerBandwidth(bmat)
+			  + SUNBandMatrix_UpperBandwidth(bmat)))
+	caml_raise_constant(LSOLVER_EXN(InsufficientStorageUpperBandwidth));
+    if (n != NV_LENGTH_S(NVEC_VAL(vnvec)))
+	caml_raise_constant(LSOLVER_EXN(MatrixVectorMismatch));
+
+    ls = mixed_create(1, n,
+		      SUNBandMatrix_UpperBandwidth(bmat),
+		      SUNBandMatrix_LowerBandwidth(bmat),
+		      SUNBandMatrix_StoredUpperBandwidth(bmat),
+		      Is_block(vmaxrefine) ? Int_val(Some_val(vmaxrefine))
+					   : DEFAULT_MAX_REFINE);
+    if (ls == NULL) caml_raise_out_of_memory();
+#if 600 <= SUNDIALS_LIB_VERSION
+    ls->sunctx = ML_CONTEXT(vctx);
+#endif
+
+    CAMLreturn(sunml_lsolver_wrap(ls));
+#else
+    CAMLreturn(Val_unit);
+#endif
+}
+
+CAMLprim value sunml_lsolver_mixed_set_max_refinements(value vcptr,
+						       value vmaxrefine)
+{
+    CAMLparam2(vcptr, vmaxrefine);
+#if 500 <= SUNDIALS_LIB_VERSION
+    if (Int_val(vmaxrefine) < 0)
+	caml_invalid_argument("max_refinements must be non-negative");
+    MIXED_CONTENT(LSOLVER_VAL(vcptr))->max_refine = Int_val(vmaxrefine);
+#endif
+    CAMLreturn(Val_unit);
+}
+
+// must correspond with LinearSolver.Direct.Mixed.stats
+CAMLprim value sunml_lsolver_mixed_get_stats(value vcptr)
+{
+    CAMLparam1(vcptr);
+    CAMLlocal1(vr);
+#if 500 <= SUNDIALS_LIB_VERSION
+    MixedContent c = MIXED_CONTENT(LSOLVER_VAL(vcptr));
+
+    vr = caml_alloc_tuple(3);
+    Store_field(vr, 0, Val_long(c->num_solves));
+    Store_field(vr, 1, Val_long(c->num_refine));
+    Store_field(vr, 2, Val_long(c->num_fallbacks));
+#else
+    vr = Val_unit;
+#endif
+    CAMLreturn(vr);
+}
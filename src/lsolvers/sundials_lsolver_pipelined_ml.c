@@ -0,0 +1,961 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Pipelined Krylov solvers: each iteration combines all of its inner
+ * products into a single global reduction which is started before, and
+ * completed after, the next application of the preconditioner and
+ * system matrix.
+ *
+ *  - Conjugate gradients: Ghysels and Vanroose, "Hiding global synchroni-
+ *    zation latency in the preconditioned Conjugate Gradient algorithm",
+ *    Parallel Computing 40(7), 2014.
+ *
+ *  - GMRES: the p(1) variant of Ghysels, Ashby, Meerbergen, and Vanroose,
+ *    "Hiding global communication latency in the GMRES algorithm on
+ *    massively parallel machines", SIAM J. Sci. Comput. 35(1), 2013.
+ *    The basis Z = Ah V is carried along so that Ah v_{i+1} can be formed
+ *    from Ah (Ah v_i) while the inner products for v_{i+1} are in flight.
+ *    Orthogonalization is classical Gram-Schmidt with the norm obtained
+ *    from the same reduction; when cancellation makes that norm
+ *    unreliable the iteration falls back to an explicit (blocking) norm.
+ *
+ * Local contributions are computed with N_VDotProdMultiLocal and
+ * N_VDotProdLocal and reduced in one buffer. When the nvector has an MPI
+ * communicator and nonblocking reductions have been registered (see
+ * sunml_lsolver_pipelined_register_reductions, called by the Nvector_parallel
+ * module), the reduction is overlapped with the operator application.
+ * Otherwise it is done with N_VDotProdMultiAllReduce, and, for nvectors
+ * without local reduction operations, with ordinary dot products.  */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+#include <caml/custom.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../nvectors/nvector_ml.h"
+#include "../lsolvers/sundials_linearsolver_ml.h"
+
+#if 600 <= SUNDIALS_LIB_VERSION
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_math.h>
+
+#define DEFAULT_MAXL	5
+
+enum pipelined_method { PIPELINED_CG = 0, PIPELINED_GMRES = 1 };
+
+enum reduction_mode {
+    REDUCE_GLOBAL,	/* no local operations: use ordinary dot products */
+    REDUCE_LOCAL,	/* no communicator: local sums are global */
+    REDUCE_ALLREDUCE,	/* blocking N_VDotProdMultiAllReduce */
+    REDUCE_NONBLOCKING	/* registered start/finish functions */
+};
+
+static sunml_reduction_start_fn nonblocking_start = NULL;
+static sunml_reduction_finish_fn nonblocking_finish = NULL;
+
+void sunml_lsolver_pipelined_register_reductions(
+	sunml_reduction_start_fn start, sunml_reduction_finish_fn finish)
+{
+    nonblocking_start = start;
+    nonblocking_finish = finish;
+}
+
+struct pipelined_content {
+    int method;
+    int maxl;
+    int max_restarts;		/* GMRES only */
+    int pretype;
+    sunbooleantype zeroguess;
+
+    SUNATimesFn ATimes;
+    void *ATData;
+    SUNPSetupFn Psetup;
+    SUNPSolveFn Psolve;
+    void *PData;
+    N_Vector s1;
+    N_Vector s2;
+
+    /* CG: r, u, w, m, n, z, q, s, p;  GMRES: V[maxl + 1], Z[maxl + 1] */
+    N_Vector *V;
+    N_Vector *Z;
+    N_Vector vtemp;
+    N_Vector vtemp2;
+    N_Vector xcor;
+    N_Vector resid;
+    N_Vector resid0;
+
+    sunrealtype *Hes;		/* (maxl + 1) x maxl, column-major */
+    sunrealtype *rhes;		/* rotated copy */
+    sunrealtype *gc, *gs, *g, *y;
+    sunrealtype *cv;
+    N_Vector *Xv;
+
+    int mode;
+    sunrealtype *buf;		/* reduction buffer (maxl + 2) */
+    void *request;
+
+    int numiters;
+    sunrealtype resnorm;
+    long int last_flag;
+    long int num_reductions;
+    long int num_fallbacks;
+
+    FILE *info_file;
+    int print_level;
+};
+
+typedef struct pipelined_content *PipelinedContent;
+
+#define PIPELINED_CONTENT(ls) ((PipelinedContent)((ls)->content))
+#define HES(c, i, j) ((c)->Hes[(j) * ((c)->maxl + 1) + (i)])
+#define RHES(c, i, j) ((c)->rhes[(j) * ((c)->maxl + 1) + (i)])
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Reductions
+ */
+
+static int choose_mode(N_Vector x)
+{
+    void *comm = NULL;
+    N_Vector_ID id = N_VGetVectorID(x);
+
+    if (x->ops->nvdotprodlocal == NULL) return REDUCE_GLOBAL;
+    if (x->ops->nvgetcommunicator != NULL) comm = N_VGetCommunicator(x);
+    if (comm == NULL) return REDUCE_LOCAL;
+
+    if (nonblocking_start != NULL
+	    && (id == SUNDIALS_NVEC_PARALLEL
+		|| id == SUNDIALS_NVEC_MPIMANYVECTOR
+		|| id == SUNDIALS_NVEC_MPIPLUSX))
+	return REDUCE_NONBLOCKING;
+
+    if (x->ops->nvdotprodmultiallreduce != NULL) return REDUCE_ALLREDUCE;
+    return REDUCE_GLOBAL;
+}
+
+/* In REDUCE_GLOBAL mode the dot products are themselves the reductions,
+   and are counted here rather than in reduce_start.  */
+static sunrealtype local_dot(PipelinedContent c, N_Vector x, N_Vector y)
+{
+    if (c->mode != REDUCE_GLOBAL) return N_VDotProdLocal(x, y);
+    c->num_reductions++;
+    return N_VDotProd(x, y);
+}
+
+static void local_dots(PipelinedContent c, int n, N_Vector x, N_Vector *Y,
+		       sunrealtype *d)
+{
+    int j;
+
+    if (c->mode == REDUCE_GLOBAL) {
+	/* without a fused operation, one reduction per dot product */
+	c->num_reductions += (x->ops->nvdotprodmulti != NULL) ? 1 : n;
+	N_VDotProdMulti(n, x, Y, d);
+    }
+    else if (x->ops->nvdotprodmultilocal != NULL)
+	N_VDotProdMultiLocal(n, x, Y, d);
+    else
+	for (j = 0; j < n; j++) d[j] = N_VDotProdLocal(x, Y[j]);
+}
+
+/* Start the global sum of c->buf[0..n-1] */
+static int reduce_start(PipelinedContent c, N_Vector x, int n)
+{
+    switch (c->mode) {
+    case REDUCE_NONBLOCKING:
+	c->num_reductions++;
+	/* On failure, c->request is left NULL so that reduce_finish does
+	   not wait on a request that was never started.  */
+	return nonblocking_start(x, c->buf, n, &c->request);
+
+    case REDUCE_ALLREDUCE:
+	c->num_reductions++;
+	return N_VDotProdMultiAllReduce(n, x, c->buf);
+
+    default:
+	return 0;
+    }
+}
+
+static int reduce_finish(PipelinedContent c)
+{
+    int r = 0;
+
+    if (c->mode == REDUCE_NONBLOCKING && c->request != NULL) {
+	r = nonblocking_finish(c->request);
+	c->request = NULL;
+    }
+    return r;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Operator application
+ */
+
+static int atimes_flag(int status)
+{
+    return (status < 0) ? SUNLS_ATIMES_FAIL_UNREC : SUNLS_ATIMES_FAIL_REC;
+}
+
+static int psolve_flag(int status)
+{
+    return (status < 0) ? SUNLS_PSOLVE_FAIL_UNREC : SUNLS_PSOLVE_FAIL_REC;
+}
+
+static int preconditioned(PipelinedContent c)
+{
+    return (c->Psolve != NULL) && (c->pretype != SUN_PREC_NONE);
+}
+
+static int pre_on_left(PipelinedContent c)
+{
+    return (c->Psolve != NULL)
+	&& (c->pretype == SUN_PREC_LEFT || c->pretype == SUN_PREC_BOTH);
+}
+
+static int pre_on_right(PipelinedContent c)
+{
+    return (c->Psolve != NULL)
+	&& (c->pretype == SUN_PREC_RIGHT || c->pretype == SUN_PREC_BOTH);
+}
+
+/* w = S1 P1^{-1} A P2^{-1} S2^{-1} v  (w must differ from v) */
+static int gmres_apply(PipelinedContent c, N_Vector v, N_Vector w,
+		       sunrealtype delta)
+{
+    int status;
+    N_Vector t;
+
+    if (c->s2 != NULL) N_VDiv(v, c->s2, c->vtemp);
+    else N_VScale(1.0, v, c->vtemp);
+    t = c->vtemp;
+
+    if (pre_on_right(c)) {
+	status = c->Psolve(c->PData, c->vtemp, c->vtemp2, delta, SUN_PREC_RIGHT);
+	if (status != 0) return psolve_flag(status);
+	t = c->vtemp2;
+    }
+
+    status = c->ATimes(c->ATData, t, w);
+    if (status != 0) return atimes_flag(status);
+
+    if (pre_on_left(c)) {
+	status = c->Psolve(c->PData, w, c->vtemp, delta, SUN_PREC_LEFT);
+	if (status != 0) return psolve_flag(status);
+	N_VScale(1.0, c->vtemp, w);
+    }
+
+    if (c->s1 != NULL) N_VProd(c->s1, w, w);
+
+    return SUNLS_SUCCESS;
+}
+
+/* z = M^{-1} r (symmetric preconditioning for CG) */
+static int cg_psolve(PipelinedContent c, N_Vector r, N_Vector z,
+		     sunrealtype delta)
+{
+    int status;
+
+    if (!preconditioned(c)) {
+	N_VScale(1.0, r, z);
+	return SUNLS_SUCCESS;
+    }
+
+    status = c->Psolve(c->PData, r, z, delta, SUN_PREC_LEFT);
+    return (status == 0) ? SUNLS_SUCCESS : psolve_flag(status);
+}
+
+static void print_iter(PipelinedContent c, const char *name, sunrealtype rnorm)
+{
+    if (c->print_level && c->info_file != NULL)
+	fprintf(c->info_file, "SUNLinSolSolve_%s: iter = %d, res_norm = %.16g\n",
+		name, c->numiters, rnorm);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Pipelined conjugate gradients
+ */
+
+static int pipecg_solve(PipelinedContent c, N_Vector x, N_Vector b,
+			sunrealtype delta, sunbooleantype zeroguess)
+{
+    N_Vector r = c->V[0], u = c->V[1], w = c->V[2], m = c->V[3], n = c->V[4],
+	     z = c->V[5], q = c->V[6], s = c->V[7], p = c->V[8];
+    sunrealtype gamma, gamma_old = 0.0, dlt, alpha = 0.0, beta, rho, rho0 = 0.0;
+    int i, status, converged = 0;
+
+    /* r = b - A x,  u = M^{-1} r,  w = A u */
+    if (zeroguess) {
+	N_VConst(0.0, x);
+	N_VScale(1.0, b, r);
+    } else {
+	status = c->ATimes(c->ATData, x, r);
+	if (status != 0) return atimes_flag(status);
+	N_VLinearSum(1.0, b, -1.0, r, r);
+    }
+
+    status = cg_psolve(c, r, u, delta);
+    if (status != SUNLS_SUCCESS) return status;
+    status = c->ATimes(c->ATData, u, w);
+    if (status != 0) return atimes_flag(status);
+
+    for (i = 0; ; i++) {
+	/* one reduction: (r, u), (w, u), ||s r||^2 */
+	c->buf[0] = local_dot(c, r, u);
+	c->buf[1] = local_dot(c, w, u);
+	if (c->s1 != NULL) {
+	    N_VProd(c->s1, r, c->vtemp);
+	    c->buf[2] = local_dot(c, c->vtemp, c->vtemp);
+	} else {
+	    c->buf[2] = local_dot(c, r, r);
+	}
+	if (reduce_start(c, r, 3) != 0) return SUNLS_VECTOROP_ERR;
+
+	/* overlapped: m = M^{-1} w,  n = A m */
+	if (i < c->maxl) {
+	    status = cg_psolve(c, w, m, delta);
+	    if (status == SUNLS_SUCCESS) {
+		status = c->ATimes(c->ATData, m, n);
+		if (status != 0) status = atimes_flag(status);
+	    }
+	    if (status != SUNLS_SUCCESS) {
+		reduce_finish(c);
+		return status;
+	    }
+	}
+
+	if (reduce_finish(c) != 0) return SUNLS_VECTOROP_ERR;
+
+	rho = SUNRsqrt(c->buf[2]);
+	c->resnorm = rho;
+	if (i == 0) rho0 = rho;
+	else print_iter(c, "PIPECG", rho);
+
+	if (rho <= delta) {
+	    converged = 1;
+	    break;
+	}
+	if (i == c->maxl) break;
+
+	gamma = c->buf[0];
+	dlt = c->buf[1];
+	if (i == 0) {
+	    beta = 0.0;
+	    if (dlt == 0.0) return SUNLS_CONV_FAIL;
+	    alpha = gamma / dlt;
+	} else {
+	    beta = gamma / gamma_old;
+	    dlt -= beta * gamma / alpha;
+	    if (dlt == 0.0 || gamma_old == 0.0) break;
+	    alpha = gamma / dlt;
+	}
+	gamma_old = gamma;
+
+	if (i == 0) {
+	    N_VScale(1.0, n, z);
+	    N_VScale(1.0, m, q);
+	    N_VScale(1.0, w, s);
+	    N_VScale(1.0, u, p);
+	} else {
+	    N_VLinearSum(1.0, n, beta, z, z);
+	    N_VLinearSum(1.0, m, beta, q, q);
+	    N_VLinearSum(1.0, w, beta, s, s);
+	    N_VLinearSum(1.0, u, beta, p, p);
+	}
+
+	N_VLinearSum(1.0, x, alpha, p, x);
+	N_VLinearSum(1.0, r, -alpha, s, r);
+	N_VLinearSum(1.0, u, -alpha, q, u);
+	N_VLinearSum(1.0, w, -alpha, z, w);
+
+	c->numiters++;
+    }
+
+    if (converged) return SUNLS_SUCCESS;
+    return (c->resnorm < rho0) ? SUNLS_RES_REDUCED : SUNLS_CONV_FAIL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Pipelined GMRES
+ */
+
+/* One cycle of at most maxl steps from the residual in c->resid with norm
+   beta. Adds the correction to c->xcor, updates c->resid, and returns the
+   estimated norm of the new residual in *rnorm.  */
+static int pipegmres_cycle(PipelinedContent c, sunrealtype delta,
+			   sunrealtype beta, sunrealtype *rnorm)
+{
+    N_Vector *V = c->V, *Z = c->Z;
+    int i, j, p = 0, status;
+    sunrealtype ss, h, t1, t2, den;
+
+    N_VScale(1.0 / beta, c->resid, V[0]);
+    for (i = 0; i <= c->maxl; i++) c->g[i] = 0.0;
+    c->g[0] = beta;
+
+    status = gmres_apply(c, V[0], Z[0], delta);
+    if (status != SUNLS_SUCCESS) return status;
+
+    for (i = 0; i < c->maxl; i++) {
+	/* one reduction: (z_i, v_j) for j <= i, and (z_i, z_i) */
+	for (j = 0; j <= i; j++) c->Xv[j] = V[j];
+	c->Xv[i + 1] = Z[i];
+	local_dots(c, i + 2, Z[i], c->Xv, c->buf);
+	if (reduce_start(c, Z[i], i + 2) != 0) return SUNLS_VECTOROP_ERR;
+
+	/* overlapped: t = Ah z_i */
+	if (i + 1 < c->maxl) {
+	    status = gmres_apply(c, Z[i], Z[i + 1], delta);
+	    if (status != SUNLS_SUCCESS) {
+		reduce_finish(c);
+		return status;
+	    }
+	}
+
+	if (reduce_finish(c) != 0) return SUNLS_VECTOROP_ERR;
+
+	ss = c->buf[i + 1];
+	for (j = 0; j <= i; j++) {
+	    HES(c, j, i) = c->buf[j];
+	    ss -= c->buf[j] * c->buf[j];
+	}
+
+	/* v_{i+1} = (z_i - sum_j h_ji v_j) / h */
+	c->cv[0] = 1.0;
+	c->Xv[0] = Z[i];
+	for (j = 0; j <= i; j++) {
+	    c->cv[j + 1] = -HES(c, j, i);
+	    c->Xv[j + 1] = V[j];
+	}
+	N_VLinearCombination(i + 2, c->cv, c->Xv, V[i + 1]);
+
+	if (ss > 1.0e-8 * c->buf[i + 1]) {
+	    h = SUNRsqrt(ss);
+	} else {
+	    /* cancellation: the norm from the reduction is unreliable */
+	    h = SUNRsqrt(N_VDotProd(V[i + 1], V[i + 1]));
+	    c->num_reductions++;
+	    c->num_fallbacks++;
+	}
+	HES(c, i + 1, i) = h;
+	if (h != 0.0) N_VScale(1.0 / h, V[i + 1], V[i + 1]);
+
+	/* z_{i+1} = Ah v_{i+1} = (Ah z_i - sum_j h_ji z_j) / h */
+	if (i + 1 < c->maxl && h != 0.0) {
+	    if (ss > 1.0e-8 * c->buf[i + 1]) {
+		c->cv[0] = 1.0 / h;
+		c->Xv[0] = Z[i + 1];
+		for (j = 0; j <= i; j++) {
+		    c->cv[j + 1] = -HES(c, j, i) / h;
+		    c->Xv[j + 1] = Z[j];
+		}
+		N_VLinearCombination(i + 2, c->cv, c->Xv, Z[i + 1]);
+	    } else {
+		status = gmres_apply(c, V[i + 1], Z[i + 1], delta);
+		if (status != SUNLS_SUCCESS) return status;
+	    }
+	}
+
+	/* QR of the Hessenberg matrix by Givens rotations */
+	for (j = 0; j <= i + 1; j++) RHES(c, j, i) = HES(c, j, i);
+	for (j = 0; j < i; j++) {
+	    t1 = RHES(c, j, i);
+	    t2 = RHES(c, j + 1, i);
+	    RHES(c, j, i) = c->gc[j] * t1 - c->gs[j] * t2;
+	    RHES(c, j + 1, i) = c->gs[j] * t1 + c->gc[j] * t2;
+	}
+	t1 = RHES(c, i, i);
+	t2 = RHES(c, i + 1, i);
+	if (t2 == 0.0) {
+	    c->gc[i] = 1.0;
+	    c->gs[i] = 0.0;
+	} else {
+	    den = SUNRsqrt(t1 * t1 + t2 * t2);
+	    c->gc[i] = t1 / den;
+	    c->gs[i] = -t2 / den;
+	    RHES(c, i, i) = den;
+	}
+	RHES(c, i + 1, i) = 0.0;
+	c->g[i + 1] = c->gs[i] * c->g[i];
+	c->g[i] = c->gc[i] * c->g[i];
+
+	p = i + 1;
+	c->numiters++;
+	*rnorm = SUNRabs(c->g[i + 1]);
+	print_iter(c, "PIPEGMRES", *rnorm);
+
+	if (*rnorm <= delta || h == 0.0) break;
+    }
+
+    if (RHES(c, p - 1, p - 1) == 0.0) return SUNLS_QRSOL_FAIL;
+
+    for (i = p - 1; i >= 0; i--) {
+	t1 = c->g[i];
+	for (j = i + 1; j < p; j++) t1 -= RHES(c, i, j) * c->y[j];
+	c->y[i] = t1 / RHES(c, i, i);
+    }
+
+    /* xcor += V y */
+    c->cv[0] = 1.0;
+    c->Xv[0] = c->xcor;
+    for (j = 0; j < p; j++) {
+	c->cv[j + 1] = c->y[j];
+	c->Xv[j + 1] = V[j];
+    }
+    N_VLinearCombination(p + 1, c->cv, c->Xv, c->xcor);
+
+    /* resid -= V H y, since Ah V = V H over the cycle; a restart replaces
+       it with the recomputed residual */
+    for (j = 0; j <= p; j++) {
+	t1 = 0.0;
+	for (i = (j > 0) ? j - 1 : 0; i < p; i++) t1 += HES(c, j, i) * c->y[i];
+	c->cv[j + 1] = -t1;
+	c->Xv[j + 1] = V[j];
+    }
+    c->Xv[0] = c->resid;
+    N_VLinearCombination(p + 2, c->cv, c->Xv, c->resid);
+
+    return SUNLS_SUCCESS;
+}
+
+static int pipegmres_solve(PipelinedContent c, N_Vector x, N_Vector b,
+			   sunrealtype delta, sunbooleantype zeroguess)
+{
+    sunrealtype r0norm, rnorm;
+    int status, cycle, converged = 0;
+
+    /* resid = S1 P1^{-1} (b - A x) */
+    if (zeroguess) {
+	N_VScale(1.0, b, c->vtemp);
+    } else {
+	status = c->ATimes(c->ATData, x, c->vtemp);
+	if (status != 0) return atimes_flag(status);
+	N_VLinearSum(1.0, b, -1.0, c->vtemp, c->vtemp);
+    }
+    if (pre_on_left(c)) {
+	status = c->Psolve(c->PData, c->vtemp, c->resid, delta, SUN_PREC_LEFT);
+	if (status != 0) return psolve_flag(status);
+    } else {
+	N_VScale(1.0, c->vtemp, c->resid);
+    }
+    if (c->s1 != NULL) N_VProd(c->s1, c->resid, c->resid);
+
+    c->buf[0] = local_dot(c, c->resid, c->resid);
+    if (reduce_start(c, c->resid, 1) != 0 || reduce_finish(c) != 0)
+	return SUNLS_VECTOROP_ERR;
+    r0norm = rnorm = SUNRsqrt(c->buf[0]);
+    c->resnorm = rnorm;
+
+    if (r0norm <= delta) {
+	if (zeroguess) N_VConst(0.0, x);
+	return SUNLS_SUCCESS;
+    }
+
+    N_VConst(0.0, c->xcor);
+    N_VScale(1.0, c->resid, c->resid0);
+    for (cycle = 0; ; cycle++) {
+	status = pipegmres_cycle(c, delta, rnorm, &rnorm);
+	c->resnorm = rnorm;
+	if (status != SUNLS_SUCCESS) return status;
+
+	if (rnorm <= delta) {
+	    converged = 1;
+	    break;
+	}
+	if (cycle >= c->max_restarts) break;
+
+	/* The basis is only approximately orthogonal, so the residual for
+	   the restart is recomputed: resid = resid0 - Ah xcor */
+	status = gmres_apply(c, c->xcor, c->resid, delta);
+	if (status != SUNLS_SUCCESS) return status;
+	N_VLinearSum(1.0, c->resid0, -1.0, c->resid, c->resid);
+
+	c->buf[0] = local_dot(c, c->resid, c->resid);
+	if (reduce_start(c, c->resid, 1) != 0 || reduce_finish(c) != 0)
+	    return SUNLS_VECTOROP_ERR;
+	rnorm = SUNRsqrt(c->buf[0]);
+	c->resnorm = rnorm;
+	if (rnorm <= delta) {
+	    converged = 1;
+	    break;
+	}
+    }
+
+    if (!converged && !(rnorm < r0norm)) return SUNLS_CONV_FAIL;
+
+    /* x += P2^{-1} S2^{-1} xcor */
+    if (c->s2 != NULL) N_VDiv(c->xcor, c->s2, c->xcor);
+    if (pre_on_right(c)) {
+	status = c->Psolve(c->PData, c->xcor, c->vtemp, delta, SUN_PREC_RIGHT);
+	if (status != 0) return psolve_flag(status);
+	N_VScale(1.0, c->vtemp, c->xcor);
+    }
+    if (zeroguess) N_VScale(1.0, c->xcor, x);
+    else N_VLinearSum(1.0, x, 1.0, c->xcor, x);
+
+    return converged ? SUNLS_SUCCESS : SUNLS_RES_REDUCED;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * SUNLinearSolver operations
+ */
+
+static SUNLinearSolver_Type pipelined_gettype(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_ITERATIVE;
+}
+
+static SUNLinearSolver_ID pipelined_getid(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_CUSTOM;
+}
+
+static int pipelined_initialize(SUNLinearSolver ls)
+{
+    PipelinedContent c = PIPELINED_CONTENT(ls);
+
+    if (c->pretype != SUN_PREC_LEFT && c->pretype != SUN_PREC_RIGHT
+	    && c->pretype != SUN_PREC_BOTH)
+	c->pretype = SUN_PREC_NONE;
+
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int pipelined_setatimes(SUNLinearSolver ls, void *A_data,
+			       SUNATimesFn ATimes)
+{
+    PipelinedContent c = PIPELINED_CONTENT(ls);
+    c->ATimes = ATimes;
+    c->ATData = A_data;
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int pipelined_setpreconditioner(SUNLinearSolver ls, void *P_data,
+				       SUNPSetupFn Psetup, SUNPSolveFn Psolve)
+{
+    PipelinedContent c = PIPELINED_CONTENT(ls);
+    c->Psetup = Psetup;
+    c->Psolve = Psolve;
+    c->PData = P_data;
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int pipelined_setscalingvectors(SUNLinearSolver ls,
+				       N_Vector s1, N_Vector s2)
+{
+    PipelinedContent c = PIPELINED_CONTENT(ls);
+    c->s1 = s1;
+    c->s2 = s2;
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int pipelined_setzeroguess(SUNLinearSolver ls, sunbooleantype onoff)
+{
+    PIPELINED_CONTENT(ls)->zeroguess = onoff;
+    return SUNLS_SUCCESS;
+}
+
+static int pipelined_setup(SUNLinearSolver ls, SUNMatrix A)
+{
+    PipelinedContent c = PIPELINED_CONTENT(ls);
+    int status;
+
+    if (c->Psetup != NULL) {
+	status = c->Psetup(c->PData);
+	if (status != 0) {
+	    c->last_flag = (status < 0) ? SUNLS_PSET_FAIL_UNREC
+					: SUNLS_PSET_FAIL_REC;
+	    return c->last_flag;
+	}
+    }
+
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int pipelined_solve(SUNLinearSolver ls, SUNMatrix A, N_Vector x,
+			   N_Vector b, sunrealtype delta)
+{
+    PipelinedContent c = PIPELINED_CONTENT(ls);
+    sunbooleantype zeroguess = c->zeroguess;
+
+    c->zeroguess = SUNFALSE;
+    c->numiters = 0;
+
+    if (c->ATimes == NULL) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+
+    c->mode = choose_mode(b);
+    c->last_flag = (c->method == PIPELINED_CG)
+		    ? pipecg_solve(c, x, b, delta, zeroguess)
+		    : pipegmres_solve(c, x, b, delta, zeroguess);
+    return c->last_flag;
+}
+
+static int pipelined_numiters(SUNLinearSolver ls)
+{
+    return PIPELINED_CONTENT(ls)->numiters;
+}
+
+static sunrealtype pipelined_resnorm(SUNLinearSolver ls)
+{
+    return PIPELINED_CONTENT(ls)->resnorm;
+}
+
+static N_Vector pipelined_resid(SUNLinearSolver ls)
+{
+    PipelinedContent c = PIPELINED_CONTENT(ls);
+    return (c->method == PIPELINED_CG) ? c->V[0] : c->resid;
+}
+
+static sunindextype pipelined_lastflag(SUNLinearSolver ls)
+{
+    return PIPELINED_CONTENT(ls)->last_flag;
+}
+
+static int pipelined_space(SUNLinearSolver ls, long int *lenrw,
+			   long int *leniw)
+{
+    PipelinedContent c = PIPELINED_CONTENT(ls);
+    sunindextype lrw1 = 0, liw1 = 0;
+    long int nvecs = (c->method == PIPELINED_CG) ? 10 : 2 * c->maxl + 7;
+
+    if (c->vtemp->ops->nvspace) N_VSpace(c->vtemp, &lrw1, &liw1);
+    *lenrw = lrw1 * nvecs + 2 * (c->maxl + 1) * c->maxl + 6 * c->maxl + 8;
+    *leniw = liw1 * nvecs;
+    return SUNLS_SUCCESS;
+}
+
+static int pipelined_free(SUNLinearSolver ls)
+{
+    PipelinedContent c;
+
+    if (ls == NULL) return SUNLS_SUCCESS;
+
+    c = PIPELINED_CONTENT(ls);
+    if (c != NULL) {
+	if (c->V) N_VDestroyVectorArray(c->V,
+			(c->method == PIPELINED_CG) ? 9 : c->maxl + 1);
+	if (c->Z) N_VDestroyVectorArray(c->Z, c->maxl + 1);
+	if (c->vtemp) N_VDestroy(c->vtemp);
+	if (c->vtemp2) N_VDestroy(c->vtemp2);
+	if (c->xcor) N_VDestroy(c->xcor);
+	if (c->resid) N_VDestroy(c->resid);
+	if (c->resid0) N_VDestroy(c->resid0);
+	free(c->Hes);
+	free(c->rhes);
+	free(c->gc);
+	free(c->gs);
+	free(c->g);
+	free(c->y);
+	free(c->cv);
+	free(c->Xv);
+	free(c->buf);
+	free(c);
+    }
+    free(ls->ops);
+    free(ls);
+
+    return SUNLS_SUCCESS;
+}
+
+static SUNLinearSolver pipelined_create(N_Vector y, int method, int maxl)
+{
+    SUNLinearSolver ls;
+    SUNLinearSolver_Ops ops;
+    PipelinedContent c;
+    int fail;
+
+    ls = (SUNLinearSolver)malloc(sizeof *ls);
+    if (ls == NULL) return NULL;
+
+    ops = (SUNLinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNLinearSolver_Ops));
+    c = (PipelinedContent) calloc(1, sizeof(struct pipelined_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(ls);
+	return NULL;
+    }
+
+    ops->gettype           = pipelined_gettype;
+    ops->getid             = pipelined_getid;
+    ops->setatimes         = pipelined_setatimes;
+    ops->setpreconditioner = pipelined_setpreconditioner;
+    ops->setscalingvectors = pipelined_setscalingvectors;
+    ops->setzeroguess      = pipelined_setzeroguess;
+    ops->initialize        = pipelined_initialize;
+    ops->setup             = pipelined_setup;
+    ops->solve             = pipelined_solve;
+    ops->numiters          = pipelined_numiters;
+    ops->resnorm           = pipelined_resnorm;
+    ops->resid             = pipelined_resid;
+    ops->lastflag          = pipelined_lastflag;
+    ops->space             = pipelined_space;
+    ops->free              = pipelined_free;
+
+    ls->ops = ops;
+    ls->content = c;
+
+    c->method = method;
+    c->maxl = maxl;
+    c->max_restarts = 0;
+    c->pretype = SUN_PREC_NONE;
+    c->zeroguess = SUNFALSE;
+    c->last_flag = SUNLS_SUCCESS;
+
+    c->vtemp = N_VClone(y);
+    c->buf = (sunrealtype *)calloc(maxl + 2, sizeof(sunrealtype));
+    fail = (c->vtemp == NULL || c->buf == NULL);
+
+    if (method == PIPELINED_CG) {
+	c->V = N_VCloneVectorArray(9, y);
+	fail = fail || (c->V == NULL);
+    } else {
+	c->V = N_VCloneVectorArray(maxl + 1, y);
+	c->Z = N_VCloneVectorArray(maxl + 1, y);
+	c->vtemp2 = N_VClone(y);
+	c->xcor = N_VClone(y);
+	c->resid = N_VClone(y);
+	c->resid0 = N_VClone(y);
+	c->Hes  = (sunrealtype *)calloc((maxl + 1) * maxl, sizeof(sunrealtype));
+	c->rhes = (sunrealtype *)calloc((maxl + 1) * maxl, sizeof(sunrealtype));
+	c->gc   = (sunrealtype *)calloc(maxl, sizeof(sunrealtype));
+	c->gs   = (sunrealtype *)calloc(maxl, sizeof(sunrealtype));
+	c->g    = (sunrealtype *)calloc(maxl + 1, sizeof(sunrealtype));
+	c->y    = (sunrealtype *)calloc(maxl, sizeof(sunrealtype));
+	c->cv   = (sunrealtype *)calloc(maxl + 2, sizeof(sunrealtype));
+	c->Xv   = (N_Vector *)calloc(maxl + 2, sizeof(N_Vector));
+	fail = fail || c->V == NULL || c->Z == NULL || c->vtemp2 == NULL
+		|| c->xcor == NULL || c->resid == NULL || c->resid0 == NULL
+		|| c->Hes == NULL
+		|| c->rhes == NULL || c->gc == NULL || c->gs == NULL
+		|| c->g == NULL || c->y == NULL || c->cv == NULL
+		|| c->Xv == NULL;
+    }
+
+    if (fail) {
+	pipelined_free(ls);
+	return NULL;
+    }
+
+    return ls;
+}
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Interface functions
+ */
+
+CAMLprim value sunml_lsolver_pipelined(value vmethod, value vmaxl,
+				       value vnvec, value vctx)
+{
+    CAMLparam4(vmethod, vmaxl, vnvec, vctx);
+#if 600 <= SUNDIALS_LIB_VERSION
+    SUNLinearSolver ls;
+    int maxl = Int_val(vmaxl) <= 0 ? DEFAULT_MAXL : Int_val(vmaxl);
+
+    ls = pipelined_create(NVEC_VAL(vnvec),
+	    Bool_val(vmethod) ? PIPELINED_GMRES : PIPELINED_CG, maxl);
+    if (ls == NULL) caml_raise_out_of_memory();
+    ls->sunctx = ML_CONTEXT(vctx);
+
+    CAMLreturn(sunml_lsolver_wrap(ls));
+#else
+    CAMLreturn(Val_unit);
+#endif
+}
+
+CAMLprim void sunml_lsolver_pipelined_set_prec_type(value vcptr,
+						    value vpretype,
+						    value vdocheck)
+{
+    CAMLparam3(vcptr, vpretype, vdocheck);
+#if 600 <= SUNDIALS_LIB_VERSION
+    PipelinedContent c = PIPELINED_CONTENT(LSOLVER_VAL(vcptr));
+    int pretype = sunml_lsolver_precond_type(vpretype);
+
+    if (Bool_val(vdocheck)
+	    && (c->pretype == SUN_PREC_NONE) && (pretype != SUN_PREC_NONE))
+	caml_raise_constant(LSOLVER_EXN(IllegalPrecType));
+
+    c->pretype = pretype;
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_lsolver_pipelined_set_max_restarts(value vcptr,
+						       value vmaxr)
+{
+    CAMLparam2(vcptr, vmaxr);
+#if 600 <= SUNDIALS_LIB_VERSION
+    PIPELINED_CONTENT(LSOLVER_VAL(vcptr))->max_restarts =
+	Int_val(vmaxr) < 0 ? 0 : Int_val(vmaxr);
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_lsolver_pipelined_set_info_file(value vcptr, value vfile)
+{
+    CAMLparam2(vcptr, vfile);
+#if 600 <= SUNDIALS_LIB_VERSION
+    PIPELINED_CONTENT(LSOLVER_VAL(vcptr))->info_file = ML_CFILE(vfile);
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_lsolver_pipelined_set_print_level(value vcptr,
+						      value vlevel)
+{
+    CAMLparam2(vcptr, vlevel);
+#if 600 <= SUNDIALS_LIB_VERSION
+    PIPELINED_CONTENT(LSOLVER_VAL(vcptr))->print_level = Int_val(vlevel);
+#endif
+    CAMLreturn0;
+}
+
+// must correspond with LinearSolver.Iterative.Pipelined.stats
+CAMLprim value sunml_lsolver_pipelined_get_stats(value vcptr)
+{
+    CAMLparam1(vcptr);
+    CAMLlocal1(vr);
+#if 600 <= SUNDIALS_LIB_VERSION
+    PipelinedContent c = PIPELINED_CONTENT(LSOLVER_VAL(vcptr));
+
+    vr = caml_alloc_tuple(3);
+    Store_field(vr, 0, Val_long(c->num_reductions));
+    Store_field(vr, 1, Val_long(c->num_fallbacks));
+    Store_field(vr, 2, Val_bool(c->mode == REDUCE_NONBLOCKING));
+#else
+    vr = Val_unit;
+#endif
+    CAMLreturn(vr);
+}
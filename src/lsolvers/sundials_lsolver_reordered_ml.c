@@ -0,0 +1,432 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Band direct solver for sparse matrices after a bandwidth-reducing
+ * reordering.
+ *
+ * At the first setup, and whenever the sparsity pattern changes, the
+ * solver computes a symmetric permutation P (reverse Cuthill-McKee, see
+ * sundials_sparse_order_ml.c), the bandwidths of B = P A P^T, an internal
+ * band matrix of those bandwidths, and the position in it of every entry
+ * of A.  Each setup then scatters A into B and factors B with the
+ * partitioned band solver of sundials_lsolver_spike_ml.c (a single band LU
+ * when there is only one partition).  Solves permute the right-hand side,
+ * solve with B, and permute the solution back, so that the integrators
+ * (and the Jacobian functions) only ever see the original ordering.  */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../nvectors/nvector_ml.h"
+#include "../lsolvers/sundials_linearsolver_ml.h"
+#include "../lsolvers/sundials_matrix_ml.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <sundials/sundials_linearsolver.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+#include <nvector/nvector_serial.h>
+
+enum reordered_ordering {
+    REORDERED_NATURAL = 0,
+    REORDERED_RCM,
+};
+
+struct reordered_content {
+    sunindextype n;
+    int ordering;
+    int max_parts;
+
+    /* the input pattern at the last reordering */
+    int analyzed;
+    int in_csr;
+    sunindextype *in_ptrs;
+    sunindextype *in_vals;
+
+    sunindextype *perm;		/* new -> old */
+    sunindextype *map;		/* entry of A -> offset in the data of B */
+    sunindextype mu0, ml0;	/* bandwidths of A */
+    sunindextype mu, ml;	/* bandwidths of B */
+
+    SUNMatrix B;
+    SUNLinearSolver inner;
+    sunrealtype *xb, *bb;
+    N_Vector xv, bv;		/* wrap xb and bb */
+
+    long int num_orderings;
+    long int num_setups;
+    sunindextype last_flag;
+};
+
+typedef struct reordered_content *ReorderedContent;
+
+#define REORDERED_CONTENT(ls) ((ReorderedContent)((ls)->content))
+
+static void reordered_release(ReorderedContent c)
+{
+    free(c->in_ptrs);  c->in_ptrs = NULL;
+    free(c->in_vals);  c->in_vals = NULL;
+    free(c->perm);     c->perm = NULL;
+    free(c->map);      c->map = NULL;
+    if (c->inner != NULL) SUNLinSolFree(c->inner);
+    c->inner = NULL;
+    if (c->B != NULL) SUNMatDestroy(c->B);
+    c->B = NULL;
+    if (c->xv != NULL) N_VDestroy(c->xv);
+    c->xv = NULL;
+    if (c->bv != NULL) N_VDestroy(c->bv);
+    c->bv = NULL;
+    free(c->xb);       c->xb = NULL;
+    free(c->bb);       c->bb = NULL;
+    c->analyzed = 0;
+}
+
+static int reordered_analyze(SUNLinearSolver ls, SUNMatrix A)
+{
+    ReorderedContent c = REORDERED_CONTENT(ls);
+    sunindextype n = c->n, i, j, k, r, col, smu, ldim;
+    sunindextype *ptrs = SUNSparseMatrix_IndexPointers(A);
+    sunindextype *vals = SUNSparseMatrix_IndexValues(A);
+    sunindextype nnz = ptrs[n];
+    sunindextype *iperm = NULL;
+    int csr = (SUNSparseMatrix_SparseType(A) == CSR_MAT);
+
+    reordered_release(c);
+
+    c->in_csr = csr;
+    c->in_ptrs = malloc((n + 1) * sizeof(sunindextype));
+    c->in_vals = malloc((nnz > 0 ? nnz : 1) * sizeof(sunindextype));
+    c->perm = malloc((n > 0 ? n : 1) * sizeof(sunindextype));
+    c->map = malloc((nnz > 0 ? nnz : 1) * sizeof(sunindextype));
+    iperm = malloc((n > 0 ? n : 1) * sizeof(sunindextype));
+    c->xb = malloc((n > 0 ? n : 1) * sizeof(sunrealtype));
+    c->bb = malloc((n > 0 ? n : 1) * sizeof(sunrealtype));
+    if (c->in_ptrs == NULL || c->in_vals == NULL || c->perm == NULL
+	    || c->map == NULL || iperm == NULL || c->xb == NULL
+	    || c->bb == NULL) goto fail;
+    memcpy(c->in_ptrs, ptrs, (n + 1) * sizeof(sunindextype));
+    memcpy(c->in_vals, vals, nnz * sizeof(sunindextype));
+
+    if (c->ordering == REORDERED_RCM) {
+	if (sunml_sparse_rcm(n, ptrs, vals, c->perm) != 0) goto fail;
+    } else {
+	for (i = 0; i < n; i++) c->perm[i] = i;
+    }
+    for (i = 0; i < n; i++) iperm[c->perm[i]] = i;
+
+    sunml_sparse_bandwidths(n, ptrs, vals, csr, NULL, &c->mu0, &c->ml0);
+    sunml_sparse_bandwidths(n, ptrs, vals, csr, iperm, &c->mu, &c->ml);
+
+    smu = SUNMIN(n - 1, c->mu + c->ml);
+#if 600 <= SUNDIALS_LIB_VERSION
+    c->B = SUNBandMatrixStorage(n, c->mu, c->ml, smu, ls->sunctx);
+    c->xv = N_VMake_Serial(n, c->xb, ls->sunctx);
+    c->bv = N_VMake_Serial(n, c->bb, ls->sunctx);
+#else
+    c->B = SUNBandMatrixStorage(n, c->mu, c->ml, smu);
+    c->xv = N_VMake_Serial(n, c->xb);
+    c->bv = N_VMake_Serial(n, c->bb);
+#endif
+    c->inner = sunml_lsolver_spike_create(n, c->mu, c->ml, smu, c->max_parts);
+    if (c->B == NULL || c->xv == NULL || c->bv == NULL || c->inner == NULL)
+	goto fail;
+#if 600 <= SUNDIALS_LIB_VERSION
+    c->inner->sunctx = ls->sunctx;
+#endif
+    if (SUNLinSolInitialize(c->inner) != SUNLS_SUCCESS) goto fail;
+
+    /* element (i, j) of B is at j * ldim + i - j + smu in its data */
+    ldim = SUNBandMatrix_LDim(c->B);
+    for (j = 0; j < n; j++) {
+	for (k = ptrs[j]; k < ptrs[j + 1]; k++) {
+	    r = iperm[csr ? j : vals[k]];
+	    col = iperm[csr ? vals[k] : j];
+	    c->map[k] = col * ldim + r - col + smu;
+	}
+    }
+
+    free(iperm);
+    c->analyzed = 1;
+    c->num_orderings++;
+    return 0;
+
+fail:
+    free(iperm);
+    reordered_release(c);
+    return -1;
+}
+
+static SUNLinearSolver_Type reordered_gettype(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_DIRECT;
+}
+
+static SUNLinearSolver_ID reordered_getid(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_CUSTOM;
+}
+
+static int reordered_initialize(SUNLinearSolver ls)
+{
+    REORDERED_CONTENT(ls)->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int reordered_same_pattern(ReorderedContent c, SUNMatrix A)
+{
+    sunindextype n = c->n;
+    sunindextype *ptrs = SUNSparseMatrix_IndexPointers(A);
+
+    return c->analyzed
+	&& c->in_csr == (SUNSparseMatrix_SparseType(A) == CSR_MAT)
+	&& memcmp(c->in_ptrs, ptrs, (n + 1) * sizeof(sunindextype)) == 0
+	&& memcmp(c->in_vals, SUNSparseMatrix_IndexValues(A),
+		  ptrs[n] * sizeof(sunindextype)) == 0;
+}
+
+static int reordered_setup(SUNLinearSolver ls, SUNMatrix A)
+{
+    ReorderedContent c = REORDERED_CONTENT(ls);
+    sunindextype k, nnz;
+    sunrealtype *adata, *bdata;
+    int r;
+
+    if (A == NULL) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+    if (SUNMatGetID(A) != SUNMATRIX_SPARSE
+	    || SUNSparseMatrix_Rows(A) != c->n
+	    || SUNSparseMatrix_Columns(A) != c->n) {
+	c->last_flag = SUNLS_ILL_INPUT;
+	return SUNLS_ILL_INPUT;
+    }
+
+    if (!reordered_same_pattern(c, A) && reordered_analyze(ls, A) != 0) {
+	c->last_flag = SUNLS_MEM_FAIL;
+	return SUNLS_MEM_FAIL;
+    }
+
+    SUNMatZero(c->B);
+    adata = SUNSparseMatrix_Data(A);
+    bdata = SUNBandMatrix_Data(c->B);
+    nnz = c->in_ptrs[c->n];
+    for (k = 0; k < nnz; k++) bdata[c->map[k]] += adata[k];
+
+    r = SUNLinSolSetup(c->inner, c->B);
+    c->num_setups++;
+    c->last_flag = SUNLinSolLastFlag(c->inner);
+    return r;
+}
+
+static int reordered_solve(SUNLinearSolver ls, SUNMatrix A, N_Vector x,
+			   N_Vector b, sunrealtype tol)
+{
+    ReorderedContent c = REORDERED_CONTENT(ls);
+    sunrealtype *xd = N_VGetArrayPointer(x);
+    sunrealtype *bd = N_VGetArrayPointer(b);
+    sunindextype i;
+    int r;
+
+    if (xd == NULL || bd == NULL || !c->analyzed) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+
+    for (i = 0; i < c->n; i++) c->bb[i] = bd[c->perm[i]];
+    r = SUNLinSolSolve(c->inner, c->B, c->xv, c->bv, tol);
+    for (i = 0; i < c->n; i++) xd[c->perm[i]] = c->xb[i];
+
+    c->last_flag = SUNLinSolLastFlag(c->inner);
+    return r;
+}
+
+static sunindextype reordered_lastflag(SUNLinearSolver ls)
+{
+    return REORDERED_CONTENT(ls)->last_flag;
+}
+
+static int reordered_space(SUNLinearSolver ls, long int *lenrw,
+			   long int *leniw)
+{
+    ReorderedContent c = REORDERED_CONTENT(ls);
+    long int rw = 0, iw = 0, nnz = 0;
+
+    if (c->analyzed) {
+	SUNMatSpace(c->B, &rw, &iw);
+	nnz = c->in_ptrs[c->n];
+	*lenrw = rw + 2 * c->n;
+	*leniw = iw + 2 * nnz + 2 * c->n + 10;
+	SUNLinSolSpace(c->inner, &rw, &iw);
+	*lenrw += rw;
+	*leniw += iw;
+    } else {
+	*lenrw = 0;
+	*leniw = 10;
+    }
+    return SUNLS_SUCCESS;
+}
+
+static int reordered_free(SUNLinearSolver ls)
+{
+    if (ls == NULL) return SUNLS_SUCCESS;
+
+    if (ls->content != NULL) {
+	reordered_release(REORDERED_CONTENT(ls));
+	free(ls->content);
+    }
+    free(ls->ops);
+    free(ls);
+
+    return SUNLS_SUCCESS;
+}
+
+static SUNLinearSolver reordered_create(sunindextype n, int ordering,
+					int max_parts)
+{
+    SUNLinearSolver ls;
+    SUNLinearSolver_Ops ops;
+    ReorderedContent c;
+
+    ls = (SUNLinearSolver)malloc(sizeof *ls);
+    if (ls == NULL) return NULL;
+
+    ops = (SUNLinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNLinearSolver_Ops));
+    c = (ReorderedContent) calloc(1, sizeof(struct reordered_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(ls);
+	return NULL;
+    }
+
+    ops->gettype    = reordered_gettype;
+    ops->getid      = reordered_getid;
+    ops->initialize = reordered_initialize;
+    ops->setup      = reordered_setup;
+    ops->solve      = reordered_solve;
+    ops->lastflag   = reordered_lastflag;
+    ops->space      = reordered_space;
+    ops->free       = reordered_free;
+
+    ls->ops = ops;
+    ls->content = c;
+
+    c->n = n;
+    c->ordering = ordering;
+    c->max_parts = max_parts;
+    c->last_flag = SUNLS_SUCCESS;
+
+    return ls;
+}
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Interface functions
+ */
+
+CAMLprim value sunml_lsolver_reordered_band(value vnvec, value vsmat,
+					    value vordering, value vparts,
+					    value vctx)
+{
+    CAMLparam5(vnvec, vsmat, vordering, vparts, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SUNMatrix smat = MAT_VAL(vsmat);
+    SUNLinearSolver ls;
+    sunindextype n = SUNSparseMatrix_Rows(smat);
+    int parts;
+
+    if (SUNMatGetID(smat) != SUNMATRIX_SPARSE)
+	caml_raise_constant(LSOLVER_EXN(InvalidLinearSolver));
+    if (n != SUNSparseMatrix_Columns(smat))
+	caml_raise_constant(LSOLVER_EXN(MatrixNotSquare));
+    if (n != NV_LENGTH_S(NVEC_VAL(vnvec)))
+	caml_raise_constant(LSOLVER_EXN(MatrixVectorMismatch));
+
+    if (Is_block(vparts)) {
+	parts = Int_val(Some_val(vparts));
+    } else {
+#ifdef _OPENMP
+	parts = omp_get_max_threads();
+#else
+	parts = 1;
+#endif
+    }
+
+    ls = reordered_create(n, Int_val(vordering), parts);
+    if (ls == NULL) caml_raise_out_of_memory();
+#if 600 <= SUNDIALS_LIB_VERSION
+    ls->sunctx = ML_CONTEXT(vctx);
+#endif
+
+    CAMLreturn(sunml_lsolver_wrap(ls));
+#else
+    CAMLreturn(Val_unit);
+#endif
+}
+
+// must correspond with LinearSolver.Direct.Reordered.stats
+CAMLprim value sunml_lsolver_reordered_get_stats(value vcptr)
+{
+    CAMLparam1(vcptr);
+    CAMLlocal1(vr);
+#if 500 <= SUNDIALS_LIB_VERSION
+    ReorderedContent c = REORDERED_CONTENT(LSOLVER_VAL(vcptr));
+
+    vr = caml_alloc_tuple(6);
+    Store_field(vr, 0, Val_long(c->mu0));
+    Store_field(vr, 1, Val_long(c->ml0));
+    Store_field(vr, 2, Val_long(c->mu));
+    Store_field(vr, 3, Val_long(c->ml));
+    Store_field(vr, 4, Val_long(c->num_orderings));
+    Store_field(vr, 5, Val_long(c->num_setups));
+#else
+    vr = Val_unit;
+#endif
+    CAMLreturn(vr);
+}
+
+CAMLprim value sunml_lsolver_reordered_get_permutation(value vcptr)
+{
+    CAMLparam1(vcptr);
+    CAMLlocal1(vr);
+#if 500 <= SUNDIALS_LIB_VERSION
+    ReorderedContent c = REORDERED_CONTENT(LSOLVER_VAL(vcptr));
+    sunindextype i;
+
+    if (!c->analyzed) {
+	vr = Atom(0);
+    } else {
+	vr = caml_alloc(c->n, 0);
+	for (i = 0; i < c->n; i++) Store_field(vr, i, Val_long(c->perm[i]));
+    }
+#else
+    vr = Val_unit;
+#endif
+    CAMLreturn(vr);
+}
@@ -0,0 +1,1254 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* A sparse direct linear solver that does not depend on KLU or SuperLU_MT.
+ *
+ * The symbolic analysis, done at the first setup and whenever the sparsity
+ * pattern changes, first permutes the rows of A so that large entries lie
+ * on the diagonal: row i is matched with a column so as to maximize the
+ * product of the magnitudes of the matched entries (as MC64 does).  It
+ * then orders the unknowns by minimum degree on the graph of
+ * A' + A'^T, where A' = Q A is the row-permuted matrix, using the quotient
+ * graph of the elimination, and computes the structure of the factors of
+ * the symmetrically permuted matrix B = P A' P^T from its elimination
+ * tree.  The structure of
+ * L is that of the Cholesky factor of the pattern of B + B^T and the
+ * structure of U is its transpose, which contains the factors of any
+ * matrix with that pattern when there is no pivoting.
+ *
+ * The numeric factorization is left-looking and column-oriented: column j
+ * of L and U only depends on the columns k < j with U(k, j) != 0, which
+ * are descendants of j in the elimination tree.  Columns are grouped by
+ * their height in the tree and the columns of a group are computed in
+ * parallel (with OpenMP).  Subsequent setups with the same pattern only
+ * redo this numeric phase.
+ *
+ * Pivots are static: the diagonal of B, chosen by the matching, is used,
+ * and a pivot smaller in magnitude than sqrt(eps) ||A||_max is replaced by
+ * that value (with the same sign), as in the GESP strategy of
+ * SuperLU_DIST.  Solves then apply a few steps of iterative refinement
+ * against A', and fail recoverably if the backward error stays above
+ * sqrt(eps).  The matching is computed from the values at the analysis;
+ * if a later factorization with the same pattern has to perturb pivots
+ * that the matching had avoided, the analysis is redone with the new
+ * values.  Matrices that need dynamic pivoting for stability should still
+ * use KLU.
+ */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../nvectors/nvector_ml.h"
+#include "../lsolvers/sundials_linearsolver_ml.h"
+#include "../lsolvers/sundials_matrix_ml.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_math.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+#include <nvector/nvector_serial.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if SUNDIALS_LIB_VERSION < 600
+#define SUN_UNIT_ROUNDOFF UNIT_ROUNDOFF
+#endif
+
+#define DEFAULT_MAX_REFINE 3
+
+enum sparselu_ordering {
+    SPARSELU_NATURAL = 0,
+    SPARSELU_MIN_DEGREE,
+};
+
+struct sparselu_content {
+    sunindextype n;
+    int ordering;
+    int max_refine;
+    int nthreads;
+
+    /* the input pattern at the last symbolic analysis */
+    int symbolic_ok;
+    int in_csr;
+    sunindextype *in_ptrs;
+    sunindextype *in_vals;
+
+    /* A in compressed columns (converted from CSR if necessary) */
+    sunindextype *ap;
+    sunindextype *ai;
+    sunrealtype *ax;
+    sunindextype *csr_map;	/* CSR entry -> position in ax */
+    sunindextype *rowperm;	/* row i of A is row rowperm[i] of A' */
+    long int analysis_perturbed; /* perturbed pivots after the analysis */
+
+    sunindextype *perm;		/* new -> old */
+    sunindextype *iperm;	/* old -> new */
+
+    sunindextype *lp;		/* strictly lower part of L, by columns */
+    sunindextype *li;
+    sunrealtype *lx;
+    sunindextype *up;		/* strictly upper part of U, by columns,  */
+    sunindextype *ui;		/* rows in increasing order */
+    sunrealtype *ux;
+    sunrealtype *ud;		/* diagonal of U */
+
+    sunindextype nlevels;	/* columns grouped by height in the etree */
+    sunindextype *level_ptr;
+    sunindextype *level_cols;
+
+    sunrealtype *work;		/* nthreads * n, kept zero between uses */
+    sunrealtype *y;		/* n, for solves */
+    sunrealtype *bsave;		/* n, b (which may alias x) */
+    sunrealtype *res;		/* n, residual for refinement */
+    sunrealtype *dx;		/* n, correction for refinement */
+    sunrealtype anorm;		/* ||A||_max at the last factorization */
+
+    long int num_symbolic;
+    long int num_numeric;
+    long int num_perturbed;	/* at the last numeric factorization */
+    long int num_refine;
+    sunindextype last_flag;
+};
+
+typedef struct sparselu_content *SparseLUContent;
+
+#define SPARSELU_CONTENT(ls) ((SparseLUContent)((ls)->content))
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Row matching
+ */
+
+struct heap_entry {
+    sunrealtype d;
+    sunindextype i;
+};
+
+static void heap_push(struct heap_entry *h, sunindextype *len,
+		      sunrealtype d, sunindextype i)
+{
+    sunindextype k = (*len)++, p;
+
+    while (k > 0 && h[p = (k - 1) / 2].d > d) {
+	h[k] = h[p];
+	k = p;
+    }
+    h[k].d = d;
+    h[k].i = i;
+}
+
+static struct heap_entry heap_pop(struct heap_entry *h, sunindextype *len)
+{
+    struct heap_entry top = h[0], last = h[--(*len)];
+    sunindextype k = 0, c;
+
+    while ((c = 2 * k + 1) < *len) {
+	if (c + 1 < *len && h[c + 1].d < h[c].d) c++;
+	if (!(h[c].d < last.d)) break;
+	h[k] = h[c];
+	k = c;
+    }
+    h[k] = last;
+    return top;
+}
+
+/* Matches rows with columns so as to maximize the product of the
+   magnitudes of the matched entries, that is, to minimize the sum of
+   the costs c(i, j) = log max_k |a(k, j)| - log |a(i, j)| >= 0 (the
+   problem solved by MC64 with job 5).  After a greedy start on the
+   zero-cost entries, each free column is matched by a shortest
+   augmenting path (Dijkstra's algorithm on the reduced costs
+   c(i, j) - u(i) - v(j), which the row and column potentials u and v keep
+   nonnegative).  Zero entries are never matched.  Sets rowperm[i] to the
+   column matched with row i and returns 0, or returns 1 if there is no
+   perfect matching, or -1 if out of memory.  */
+static int max_product_matching(sunindextype n, sunindextype *ap,
+				sunindextype *ai, sunrealtype *ax,
+				sunindextype *rowperm)
+{
+    sunindextype nnz = ap[n];
+    sunindextype i, j, j0, k, m, nheap, ntouched, nfinal, isink;
+    sunindextype *colmatch = NULL, *pred = NULL, *doneat = NULL;
+    sunindextype *touched = NULL, *final = NULL;
+    sunrealtype *cost = NULL, *u = NULL, *v = NULL, *d = NULL;
+    sunrealtype cmax, nd, dj, dsink;
+    struct heap_entry *heap = NULL, e;
+    int r = -1;
+
+    colmatch = malloc(n * sizeof(sunindextype));
+    pred = malloc(n * sizeof(sunindextype));
+    doneat = malloc(n * sizeof(sunindextype));
+    touched = malloc(n * sizeof(sunindextype));
+    final = malloc(n * sizeof(sunindextype));
+    cost = malloc((nnz > 0 ? nnz : 1) * sizeof(sunrealtype));
+    u = calloc(n, sizeof(sunrealtype));
+    v = calloc(n, sizeof(sunrealtype));
+    d = malloc(n * sizeof(sunrealtype));
+    heap = malloc((nnz + 1) * sizeof(struct heap_entry));
+    if (colmatch == NULL || pred == NULL || doneat == NULL || touched == NULL
+	    || final == NULL || cost == NULL || u == NULL || v == NULL
+	    || d == NULL || heap == NULL) goto cleanup;
+
+    r = 1;
+    for (j = 0; j < n; j++) {
+	cmax = 0.0;
+	for (k = ap[j]; k < ap[j + 1]; k++)
+	    if (SUNRabs(ax[k]) > cmax) cmax = SUNRabs(ax[k]);
+	if (!(cmax > 0.0 && cmax <= SUN_BIG_REAL)) goto cleanup;
+	for (k = ap[j]; k < ap[j + 1]; k++)
+	    cost[k] = (ax[k] != 0.0)
+		? (sunrealtype)(log((double)cmax) - log((double)SUNRabs(ax[k])))
+		: -1.0;	/* not an edge */
+    }
+
+    for (i = 0; i < n; i++) {
+	rowperm[i] = -1;
+	d[i] = SUN_BIG_REAL;
+	doneat[i] = -1;
+    }
+    for (j = 0; j < n; j++) {
+	colmatch[j] = -1;
+	for (k = ap[j]; k < ap[j + 1]; k++) {
+	    if (cost[k] == 0.0 && rowperm[ai[k]] < 0) {
+		rowperm[ai[k]] = j;
+		colmatch[j] = ai[k];
+		break;
+	    }
+	}
+    }
+
+    for (j0 = 0; j0 < n; j0++) {
+	if (colmatch[j0] >= 0) continue;
+
+	nheap = ntouched = nfinal = 0;
+	j = j0;
+	dj = 0.0;
+	for (;;) {
+	    for (k = ap[j]; k < ap[j + 1]; k++) {
+		i = ai[k];
+		if (cost[k] < 0.0 || doneat[i] == j0) continue;
+		nd = dj + cost[k] - u[i] - v[j];
+		if (nd < d[i]) {
+		    if (d[i] == SUN_BIG_REAL) touched[ntouched++] = i;
+		    d[i] = nd;
+		    pred[i] = j;
+		    heap_push(heap, &nheap, nd, i);
+		}
+	    }
+
+	    /* the nearest row that is not final */
+	    do {
+		if (nheap == 0) goto cleanup;	/* structurally singular */
+		e = heap_pop(heap, &nheap);
+	    } while (doneat[e.i] == j0 || e.d > d[e.i]);
+	    i = e.i;
+	    doneat[i] = j0;
+	    final[nfinal++] = i;
+	    if (rowperm[i] < 0) break;
+	    j = rowperm[i];
+	    dj = d[i];
+	}
+	isink = i;
+	dsink = d[isink];
+
+	/* keep the reduced costs nonnegative, and zero along the path and
+	   on the matched entries */
+	v[j0] += dsink;
+	for (k = 0; k < nfinal; k++) {
+	    i = final[k];
+	    u[i] += d[i] - dsink;
+	    if (i != isink) v[rowperm[i]] += dsink - d[i];
+	}
+
+	/* augment */
+	for (i = isink; ; i = m) {
+	    j = pred[i];
+	    m = colmatch[j];
+	    rowperm[i] = j;
+	    colmatch[j] = i;
+	    if (j == j0) break;
+	}
+
+	for (k = 0; k < ntouched; k++) d[touched[k]] = SUN_BIG_REAL;
+    }
+    r = 0;
+
+cleanup:
+    free(colmatch);
+    free(pred);
+    free(doneat);
+    free(touched);
+    free(final);
+    free(cost);
+    free(u);
+    free(v);
+    free(d);
+    free(heap);
+    return r;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Ordering
+ */
+
+/* Adjacency lists of the graph of A + A^T, without self loops.  */
+static int symmetric_graph(sunindextype n, sunindextype *ap, sunindextype *ai,
+			   sunindextype **pgp, sunindextype **pgi)
+{
+    sunindextype i, j, k, p, *gp, *gi, *count, *mark;
+
+    gp = calloc(n + 1, sizeof(sunindextype));
+    count = calloc(n, sizeof(sunindextype));
+    mark = malloc(n * sizeof(sunindextype));
+    if (gp == NULL || count == NULL || mark == NULL) goto fail;
+
+    for (j = 0; j < n; j++) {
+	for (k = ap[j]; k < ap[j + 1]; k++) {
+	    i = ai[k];
+	    if (i == j) continue;
+	    count[i]++;
+	    count[j]++;
+	}
+    }
+    for (j = 0; j < n; j++) gp[j + 1] = gp[j] + count[j];
+
+    gi = malloc((gp[n] > 0 ? gp[n] : 1) * sizeof(sunindextype));
+    if (gi == NULL) goto fail;
+
+    for (j = 0; j < n; j++) count[j] = gp[j];
+    for (j = 0; j < n; j++) {
+	for (k = ap[j]; k < ap[j + 1]; k++) {
+	    i = ai[k];
+	    if (i == j) continue;
+	    gi[count[i]++] = j;
+	    gi[count[j]++] = i;
+	}
+    }
+
+    /* remove duplicates, compacting in place */
+    for (j = 0; j < n; j++) mark[j] = -1;
+    p = 0;
+    for (j = 0; j < n; j++) {
+	k = gp[j];
+	gp[j] = p;
+	for (; k < count[j]; k++) {
+	    i = gi[k];
+	    if (mark[i] == j) continue;
+	    mark[i] = j;
+	    gi[p++] = i;
+	}
+    }
+    gp[n] = p;
+
+    free(count);
+    free(mark);
+    *pgp = gp;
+    *pgi = gi;
+    return 0;
+
+fail:
+    free(gp);
+    free(count);
+    free(mark);
+    return -1;
+}
+
+struct nodeset {
+    sunindextype len, cap;
+    sunindextype *v;
+};
+
+static int nodeset_add(struct nodeset *s, sunindextype x)
+{
+    sunindextype *nv;
+
+    if (s->len == s->cap) {
+	s->cap = (s->cap < 4) ? 8 : 2 * s->cap;
+	nv = realloc(s->v, s->cap * sizeof(sunindextype));
+	if (nv == NULL) return -1;
+	s->v = nv;
+    }
+    s->v[s->len++] = x;
+    return 0;
+}
+
+/* Minimum degree on the quotient graph of the elimination.  An
+   eliminated node p becomes an element whose boundary lv[p] is the set of
+   its uneliminated neighbours; the elements adjacent to p are absorbed
+   into it, and the variables of lv[p] drop p and each other from their
+   variable lists.  The elimination graph is never formed: the degree of
+   a variable is the size of the union of its variable list and of the
+   boundaries of its elements.  Degrees are exact; nodes of equal degree
+   are taken in increasing order at the start.  */
+static int min_degree(sunindextype n, sunindextype *gp, sunindextype *gi,
+		      sunindextype *perm)
+{
+    struct nodeset *vars = NULL, *elts = NULL, *lv = NULL;
+    sunindextype *head = NULL, *next = NULL, *prev = NULL, *deg = NULL;
+    sunindextype *mark = NULL;
+    char *status = NULL;	/* 0: variable, 1: element, 2: absorbed */
+    sunindextype i, j, k, p, u, v, w, e, d, mindeg, lpstamp, stamp = 0;
+    int r = -1;
+
+    vars = calloc(n, sizeof(struct nodeset));
+    elts = calloc(n, sizeof(struct nodeset));
+    lv = calloc(n, sizeof(struct nodeset));
+    head = malloc(n * sizeof(sunindextype));
+    next = malloc(n * sizeof(sunindextype));
+    prev = malloc(n * sizeof(sunindextype));
+    deg = malloc(n * sizeof(sunindextype));
+    mark = malloc(n * sizeof(sunindextype));
+    status = calloc(n, sizeof(char));
+    if (vars == NULL || elts == NULL || lv == NULL || head == NULL
+	    || next == NULL || prev == NULL || deg == NULL || mark == NULL
+	    || status == NULL) goto cleanup;
+
+    for (i = 0; i < n; i++) {
+	head[i] = -1;
+	mark[i] = -1;
+	for (k = gp[i]; k < gp[i + 1]; k++)
+	    if (nodeset_add(&vars[i], gi[k]) != 0) goto cleanup;
+	deg[i] = vars[i].len;
+    }
+
+    /* degree buckets: insert in decreasing order so that the lists are
+       increasing */
+    for (i = n - 1; i >= 0; i--) {
+	d = deg[i];
+	prev[i] = -1;
+	next[i] = head[d];
+	if (head[d] >= 0) prev[head[d]] = i;
+	head[d] = i;
+    }
+
+#define BUCKET_REMOVE(x)						\
+    do {								\
+	if (prev[x] >= 0) next[prev[x]] = next[x];			\
+	else head[deg[x]] = next[x];					\
+	if (next[x] >= 0) prev[next[x]] = prev[x];			\
+    } while (0)
+
+#define BUCKET_INSERT(x)						\
+    do {								\
+	prev[x] = -1;							\
+	next[x] = head[deg[x]];						\
+	if (head[deg[x]] >= 0) prev[head[deg[x]]] = x;			\
+	head[deg[x]] = x;						\
+	if (deg[x] < mindeg) mindeg = deg[x];				\
+    } while (0)
+
+    mindeg = 0;
+    for (k = 0; k < n; k++) {
+	while (head[mindeg] < 0) mindeg++;
+	p = head[mindeg];
+	BUCKET_REMOVE(p);
+	perm[k] = p;
+	status[p] = 1;
+
+	/* lv[p] = the variables adjacent to p, directly or through its
+	   elements, which are absorbed */
+	lpstamp = ++stamp;
+	mark[p] = lpstamp;
+	for (j = 0; j < vars[p].len; j++) {
+	    u = vars[p].v[j];
+	    if (mark[u] == lpstamp) continue;
+	    mark[u] = lpstamp;
+	    if (nodeset_add(&lv[p], u) != 0) goto cleanup;
+	}
+	for (j = 0; j < elts[p].len; j++) {
+	    e = elts[p].v[j];
+	    for (i = 0; i < lv[e].len; i++) {
+		u = lv[e].v[i];
+		if (mark[u] == lpstamp) continue;
+		mark[u] = lpstamp;
+		if (nodeset_add(&lv[p], u) != 0) goto cleanup;
+	    }
+	    status[e] = 2;
+	    free(lv[e].v);
+	    lv[e].v = NULL;
+	    lv[e].len = lv[e].cap = 0;
+	}
+	free(vars[p].v);
+	free(elts[p].v);
+	vars[p].v = elts[p].v = NULL;
+	vars[p].len = vars[p].cap = elts[p].len = elts[p].cap = 0;
+
+	/* prune the lists of the variables of lv[p]: the variables of
+	   lv[p] (and p) are now reached through p, and absorbed elements
+	   are replaced by p */
+	for (j = 0; j < lv[p].len; j++) {
+	    u = lv[p].v[j];
+	    w = 0;
+	    for (i = 0; i < vars[u].len; i++) {
+		v = vars[u].v[i];
+		if (mark[v] != lpstamp) vars[u].v[w++] = v;
+	    }
+	    vars[u].len = w;
+	    w = 0;
+	    for (i = 0; i < elts[u].len; i++) {
+		e = elts[u].v[i];
+		if (status[e] != 2) elts[u].v[w++] = e;
+	    }
+	    elts[u].len = w;
+	    if (nodeset_add(&elts[u], p) != 0) goto cleanup;
+	}
+
+	/* update the degrees of the variables of lv[p] */
+	for (j = 0; j < lv[p].len; j++) {
+	    u = lv[p].v[j];
+	    BUCKET_REMOVE(u);
+
+	    mark[u] = ++stamp;
+	    d = 0;
+	    for (i = 0; i < vars[u].len; i++) {
+		v = vars[u].v[i];
+		if (mark[v] != stamp) {
+		    mark[v] = stamp;
+		    d++;
+		}
+	    }
+	    for (w = 0; w < elts[u].len; w++) {
+		e = elts[u].v[w];
+		for (i = 0; i < lv[e].len; i++) {
+		    v = lv[e].v[i];
+		    if (mark[v] != stamp) {
+			mark[v] = stamp;
+			d++;
+		    }
+		}
+	    }
+
+	    deg[u] = d;
+	    BUCKET_INSERT(u);
+	}
+    }
+
+#undef BUCKET_REMOVE
+#undef BUCKET_INSERT
+
+    r = 0;
+
+cleanup:
+    for (i = 0; i < n; i++) {
+	if (vars != NULL) free(vars[i].v);
+	if (elts != NULL) free(elts[i].v);
+	if (lv != NULL) free(lv[i].v);
+    }
+    free(vars);
+    free(elts);
+    free(lv);
+    free(head);
+    free(next);
+    free(prev);
+    free(deg);
+    free(mark);
+    free(status);
+    return r;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Symbolic factorization
+ */
+
+/* The structure of L from the graph of B + B^T (gp, gi in the new
+   numbering): struct(L_j) is the set of neighbours i > j of j together
+   with the structures of the children of j in the elimination tree
+   (less j itself).  Also computes the structure of U, by transposition,
+   and the heights of the columns in the tree.  */
+static int symbolic(SparseLUContent c, sunindextype *gp, sunindextype *gi)
+{
+    sunindextype n = c->n;
+    sunindextype *parent = NULL, *child_head = NULL, *child_next = NULL;
+    sunindextype *mark = NULL, *height = NULL, *count = NULL, *li;
+    sunindextype i, j, k, q, ch, cap, len;
+    int r = -1;
+
+    parent = malloc(n * sizeof(sunindextype));
+    child_head = malloc(n * sizeof(sunindextype));
+    child_next = malloc(n * sizeof(sunindextype));
+    mark = malloc(n * sizeof(sunindextype));
+    height = malloc(n * sizeof(sunindextype));
+    c->lp = malloc((n + 1) * sizeof(sunindextype));
+    if (parent == NULL || child_head == NULL || child_next == NULL
+	    || mark == NULL || height == NULL || c->lp == NULL) goto cleanup;
+
+    cap = gp[n] / 2 + n + 1;
+    c->li = malloc(cap * sizeof(sunindextype));
+    if (c->li == NULL) goto cleanup;
+
+    for (j = 0; j < n; j++) {
+	child_head[j] = -1;
+	mark[j] = -1;
+    }
+
+    len = 0;
+    for (j = 0; j < n; j++) {
+	c->lp[j] = len;
+	mark[j] = j;
+
+#define ADD_ROW(x)							\
+	do {								\
+	    if (mark[x] != j) {						\
+		mark[x] = j;						\
+		if (len == cap) {					\
+		    cap *= 2;						\
+		    li = realloc(c->li, cap * sizeof(sunindextype));	\
+		    if (li == NULL) goto cleanup;			\
+		    c->li = li;						\
+		}							\
+		c->li[len++] = x;					\
+	    }								\
+	} while (0)
+
+	for (k = gp[j]; k < gp[j + 1]; k++) {
+	    i = gi[k];
+	    if (i > j) ADD_ROW(i);
+	}
+
+	height[j] = 0;
+	for (ch = child_head[j]; ch >= 0; ch = child_next[ch]) {
+	    if (height[ch] + 1 > height[j]) height[j] = height[ch] + 1;
+	    for (q = c->lp[ch]; q < c->lp[ch + 1]; q++) {
+		i = c->li[q];
+		if (i > j) ADD_ROW(i);
+	    }
+	}
+#undef ADD_ROW
+
+	parent[j] = -1;
+	for (q = c->lp[j]; q < len; q++)
+	    if (parent[j] < 0 || c->li[q] < parent[j]) parent[j] = c->li[q];
+	if (parent[j] >= 0) {
+	    child_next[j] = child_head[parent[j]];
+	    child_head[parent[j]] = j;
+	}
+    }
+    c->lp[n] = len;
+
+    c->lx = malloc((len > 0 ? len : 1) * sizeof(sunrealtype));
+    c->up = calloc(n + 1, sizeof(sunindextype));
+    c->ui = malloc((len > 0 ? len : 1) * sizeof(sunindextype));
+    c->ux = malloc((len > 0 ? len : 1) * sizeof(sunrealtype));
+    c->ud = malloc(n * sizeof(sunrealtype));
+    count = calloc(n + 1, sizeof(sunindextype));
+    if (c->lx == NULL || c->up == NULL || c->ui == NULL || c->ux == NULL
+	    || c->ud == NULL || count == NULL) goto cleanup;
+
+    /* U = L^T (pattern), rows in increasing order */
+    for (q = 0; q < len; q++) c->up[c->li[q] + 1]++;
+    for (j = 0; j < n; j++) c->up[j + 1] += c->up[j];
+    for (j = 0; j < n; j++) count[j] = c->up[j];
+    for (k = 0; k < n; k++)
+	for (q = c->lp[k]; q < c->lp[k + 1]; q++)
+	    c->ui[count[c->li[q]]++] = k;
+
+    /* columns by height */
+    c->nlevels = 0;
+    for (j = 0; j < n; j++)
+	if (height[j] + 1 > c->nlevels) c->nlevels = height[j] + 1;
+    c->level_ptr = calloc(c->nlevels + 1, sizeof(sunindextype));
+    c->level_cols = malloc((n > 0 ? n : 1) * sizeof(sunindextype));
+    if (c->level_ptr == NULL || c->level_cols == NULL) goto cleanup;
+    for (j = 0; j < n; j++) c->level_ptr[height[j] + 1]++;
+    for (k = 0; k < c->nlevels; k++) c->level_ptr[k + 1] += c->level_ptr[k];
+    for (k = 0; k <= c->nlevels; k++) count[k] = c->level_ptr[k];
+    for (j = 0; j < n; j++) c->level_cols[count[height[j]]++] = j;
+
+    r = 0;
+
+cleanup:
+    free(parent);
+    free(child_head);
+    free(child_next);
+    free(mark);
+    free(height);
+    free(count);
+    return r;
+}
+
+static void free_factors(SparseLUContent c)
+{
+    free(c->in_ptrs);   c->in_ptrs = NULL;
+    free(c->in_vals);   c->in_vals = NULL;
+    free(c->ap);        c->ap = NULL;
+    free(c->ai);        c->ai = NULL;
+    free(c->ax);        c->ax = NULL;
+    free(c->csr_map);   c->csr_map = NULL;
+    free(c->rowperm);   c->rowperm = NULL;
+    free(c->perm);      c->perm = NULL;
+    free(c->iperm);     c->iperm = NULL;
+    free(c->lp);        c->lp = NULL;
+    free(c->li);        c->li = NULL;
+    free(c->lx);        c->lx = NULL;
+    free(c->up);        c->up = NULL;
+    free(c->ui);        c->ui = NULL;
+    free(c->ux);        c->ux = NULL;
+    free(c->ud);        c->ud = NULL;
+    free(c->level_ptr); c->level_ptr = NULL;
+    free(c->level_cols); c->level_cols = NULL;
+    free(c->work);      c->work = NULL;
+    free(c->y);         c->y = NULL;
+    free(c->bsave);     c->bsave = NULL;
+    free(c->res);       c->res = NULL;
+    free(c->dx);        c->dx = NULL;
+    c->symbolic_ok = 0;
+}
+
+/* Copies the input pattern and values, converts them to compressed
+   columns, permutes the rows, orders, and computes the structure of the
+   factors.  */
+static int analyze(SparseLUContent c, sunindextype *ptrs, sunindextype *vals,
+		   sunrealtype *data, int csr)
+{
+    sunindextype n = c->n, nnz = ptrs[n];
+    sunindextype i, j, k, *gp = NULL, *gi = NULL, *bgp = NULL, *bgi = NULL;
+    int r = -1;
+
+    free_factors(c);
+
+    c->in_csr = csr;
+    c->in_ptrs = malloc((n + 1) * sizeof(sunindextype));
+    c->in_vals = malloc((nnz > 0 ? nnz : 1) * sizeof(sunindextype));
+    c->ap = calloc(n + 1, sizeof(sunindextype));
+    c->ai = malloc((nnz > 0 ? nnz : 1) * sizeof(sunindextype));
+    c->ax = malloc((nnz > 0 ? nnz : 1) * sizeof(sunrealtype));
+    c->perm = malloc(n * sizeof(sunindextype));
+    c->iperm = malloc(n * sizeof(sunindextype));
+    c->rowperm = malloc(n * sizeof(sunindextype));
+    if (c->in_ptrs == NULL || c->in_vals == NULL || c->ap == NULL
+	    || c->ai == NULL || c->ax == NULL || c->perm == NULL
+	    || c->iperm == NULL || c->rowperm == NULL) goto cleanup;
+
+    memcpy(c->in_ptrs, ptrs, (n + 1) * sizeof(sunindextype));
+    memcpy(c->in_vals, vals, nnz * sizeof(sunindextype));
+
+    if (csr) {
+	/* transpose the pattern: row i of the input is row i of A */
+	c->csr_map = malloc((nnz > 0 ? nnz : 1) * sizeof(sunindextype));
+	gp = malloc((n + 1) * sizeof(sunindextype));
+	if (c->csr_map == NULL || gp == NULL) goto cleanup;
+	for (k = 0; k < nnz; k++) c->ap[vals[k] + 1]++;
+	for (j = 0; j < n; j++) c->ap[j + 1] += c->ap[j];
+	for (j = 0; j <= n; j++) gp[j] = c->ap[j];
+	for (i = 0; i < n; i++) {
+	    for (k = ptrs[i]; k < ptrs[i + 1]; k++) {
+		c->csr_map[k] = gp[vals[k]];
+		c->ai[gp[vals[k]]++] = i;
+	    }
+	}
+	free(gp);
+	gp = NULL;
+	for (k = 0; k < nnz; k++) c->ax[c->csr_map[k]] = data[k];
+    } else {
+	memcpy(c->ap, ptrs, (n + 1) * sizeof(sunindextype));
+	memcpy(c->ai, vals, nnz * sizeof(sunindextype));
+	memcpy(c->ax, data, nnz * sizeof(sunrealtype));
+    }
+
+    /* A' = Q A; without a perfect matching on the nonzero entries, the
+       matrix is singular and the rows are left in place */
+    switch (max_product_matching(n, c->ap, c->ai, c->ax, c->rowperm)) {
+    case 0:
+	break;
+    case 1:
+	for (i = 0; i < n; i++) c->rowperm[i] = i;
+	break;
+    default:
+	goto cleanup;
+    }
+    for (k = 0; k < nnz; k++) c->ai[k] = c->rowperm[c->ai[k]];
+
+    if (symmetric_graph(n, c->ap, c->ai, &gp, &gi) != 0) goto cleanup;
+
+    if (c->ordering == SPARSELU_MIN_DEGREE) {
+	if (min_degree(n, gp, gi, c->perm) != 0) goto cleanup;
+    } else {
+	for (j = 0; j < n; j++) c->perm[j] = j;
+    }
+    for (j = 0; j < n; j++) c->iperm[c->perm[j]] = j;
+
+    /* the graph in the new numbering */
+    bgp = malloc((n + 1) * sizeof(sunindextype));
+    bgi = malloc((gp[n] > 0 ? gp[n] : 1) * sizeof(sunindextype));
+    if (bgp == NULL || bgi == NULL) goto cleanup;
+    bgp[0] = 0;
+    for (j = 0; j < n; j++) {
+	i = c->perm[j];
+	bgp[j + 1] = bgp[j] + (gp[i + 1] - gp[i]);
+	for (k = gp[i]; k < gp[i + 1]; k++)
+	    bgi[bgp[j] + (k - gp[i])] = c->iperm[gi[k]];
+    }
+
+    if (symbolic(c, bgp, bgi) != 0) goto cleanup;
+
+#ifdef _OPENMP
+    c->nthreads = omp_get_max_threads();
+#else
+    c->nthreads = 1;
+#endif
+    c->work = calloc((size_t)c->nthreads * n, sizeof(sunrealtype));
+    c->y = malloc(n * sizeof(sunrealtype));
+    c->bsave = malloc(n * sizeof(sunrealtype));
+    c->res = malloc(n * sizeof(sunrealtype));
+    c->dx = malloc(n * sizeof(sunrealtype));
+    if (c->work == NULL || c->y == NULL || c->bsave == NULL || c->res == NULL
+	    || c->dx == NULL)
+	goto cleanup;
+
+    c->symbolic_ok = 1;
+    c->num_symbolic++;
+    r = 0;
+
+cleanup:
+    free(gp);
+    free(gi);
+    free(bgp);
+    free(bgi);
+    if (r != 0) free_factors(c);
+    return r;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Numeric factorization and solution
+ */
+
+/* Returns 0, or j + 1 if the pivot of column j is not finite.  */
+static sunindextype numeric(SparseLUContent c)
+{
+    sunindextype n = c->n;
+    sunindextype lev, t, j, jold, k, p, q;
+    sunindextype fail = 0;
+    long int perturbed = 0;
+    sunrealtype anorm = 0.0, tau, d, xk, *x;
+
+    for (k = 0; k < c->ap[n]; k++)
+	if (!(SUNRabs(c->ax[k]) <= anorm)) anorm = SUNRabs(c->ax[k]);
+    if (!(anorm <= SUN_BIG_REAL)) return 1;
+    c->anorm = anorm;
+    tau = SUNRsqrt(SUN_UNIT_ROUNDOFF) * (anorm > 0.0 ? anorm : 1.0);
+
+    for (lev = 0; lev < c->nlevels; lev++) {
+#ifdef _OPENMP
+#pragma omp parallel for private(j, jold, k, p, q, d, xk, x) \
+	reduction(+:perturbed) reduction(max:fail) \
+	num_threads(c->nthreads) schedule(dynamic, 16)
+#endif
+	for (t = c->level_ptr[lev]; t < c->level_ptr[lev + 1]; t++) {
+#ifdef _OPENMP
+	    x = c->work + (size_t)omp_get_thread_num() * n;
+#else
+	    x = c->work;
+#endif
+	    j = c->level_cols[t];
+
+	    /* x = B(:, j) */
+	    jold = c->perm[j];
+	    for (k = c->ap[jold]; k < c->ap[jold + 1]; k++)
+		x[c->iperm[c->ai[k]]] += c->ax[k];
+
+	    /* x = L^-1 x over the structure of U(:, j) */
+	    for (p = c->up[j]; p < c->up[j + 1]; p++) {
+		k = c->ui[p];
+		xk = x[k];
+		x[k] = 0.0;
+		c->ux[p] = xk;
+		if (xk != 0.0)
+		    for (q = c->lp[k]; q < c->lp[k + 1]; q++)
+			x[c->li[q]] -= c->lx[q] * xk;
+	    }
+
+	    d = x[j];
+	    x[j] = 0.0;
+	    if (d != d) {
+		if (j + 1 > fail) fail = j + 1;
+		d = 1.0;
+	    } else if (!(SUNRabs(d) >= tau)) {
+		d = (d < 0.0) ? -tau : tau;
+		perturbed++;
+	    }
+	    c->ud[j] = d;
+
+	    for (q = c->lp[j]; q < c->lp[j + 1]; q++) {
+		c->lx[q] = x[c->li[q]] / d;
+		x[c->li[q]] = 0.0;
+	    }
+	}
+    }
+
+    c->num_perturbed = perturbed;
+    c->num_numeric++;
+    return fail;
+}
+
+/* y = (LU)^-1 y in the new numbering */
+static void lu_solve(SparseLUContent c, sunrealtype *y)
+{
+    sunindextype j, q, n = c->n;
+    sunrealtype yj;
+
+    for (j = 0; j < n; j++) {
+	yj = y[j];
+	if (yj != 0.0)
+	    for (q = c->lp[j]; q < c->lp[j + 1]; q++)
+		y[c->li[q]] -= c->lx[q] * yj;
+    }
+
+    for (j = n - 1; j >= 0; j--) {
+	y[j] /= c->ud[j];
+	yj = y[j];
+	if (yj != 0.0)
+	    for (q = c->up[j]; q < c->up[j + 1]; q++)
+		y[c->ui[q]] -= c->ux[q] * yj;
+    }
+}
+
+/* x = A^-1 b through the permutation */
+static void perm_solve(SparseLUContent c, sunrealtype *b, sunrealtype *x)
+{
+    sunindextype i, n = c->n;
+
+    for (i = 0; i < n; i++) c->y[i] = b[c->perm[i]];
+    lu_solve(c, c->y);
+    for (i = 0; i < n; i++) x[c->perm[i]] = c->y[i];
+}
+
+/* res = b' - A' x, returns ||res||_max / (||A||_max ||x||_1 + ||b||_max),
+   a normwise backward error of x */
+static sunrealtype residual(SparseLUContent c, sunrealtype *x)
+{
+    sunindextype i, j, k, n = c->n;
+    sunrealtype rmax = 0.0, xsum = 0.0, bmax = 0.0, denom;
+
+    memcpy(c->res, c->bsave, n * sizeof(sunrealtype));
+    for (j = 0; j < n; j++)
+	if (x[j] != 0.0)
+	    for (k = c->ap[j]; k < c->ap[j + 1]; k++)
+		c->res[c->ai[k]] -= c->ax[k] * x[j];
+
+    for (i = 0; i < n; i++) {
+	if (!(SUNRabs(c->res[i]) <= rmax)) rmax = SUNRabs(c->res[i]);
+	xsum += SUNRabs(x[i]);
+	if (SUNRabs(c->bsave[i]) > bmax) bmax = SUNRabs(c->bsave[i]);
+    }
+    denom = c->anorm * xsum + bmax;
+    return (denom > 0.0) ? rmax / denom : rmax;
+}
+
+/* Solves, then refines when pivots were perturbed.  Refinement stops when
+   the backward error reaches the unit roundoff or stops halving, and a
+   correction that increases it is undone.  If the backward error is still
+   above sqrt(eps), the relative size of the perturbations, the solution
+   is no better than that of the perturbed system and the solve fails
+   recoverably, so that the integrator retries with a fresh matrix or a
+   smaller step.  */
+static int solve_refine(SparseLUContent c, sunrealtype *x, sunrealtype *b)
+{
+    sunindextype i, n = c->n;
+    sunrealtype berr, bprev;
+    int it;
+
+    for (i = 0; i < n; i++) c->bsave[c->rowperm[i]] = b[i];
+    perm_solve(c, c->bsave, x);
+    if (c->num_perturbed == 0) return SUNLS_SUCCESS;
+
+    berr = residual(c, x);
+    for (it = 0; it < c->max_refine && berr > SUN_UNIT_ROUNDOFF; it++) {
+	perm_solve(c, c->res, c->dx);
+	for (i = 0; i < n; i++) x[i] += c->dx[i];
+	c->num_refine++;
+
+	bprev = berr;
+	berr = residual(c, x);
+	if (!(berr <= bprev)) {
+	    for (i = 0; i < n; i++) x[i] -= c->dx[i];
+	    berr = bprev;
+	    break;
+	}
+	if (!(2.0 * berr <= bprev)) break;
+    }
+
+    return (berr <= SUNRsqrt(SUN_UNIT_ROUNDOFF)) ? SUNLS_SUCCESS
+						 : SUNLS_PACKAGE_FAIL_REC;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * SUNLinearSolver operations
+ */
+
+static SUNLinearSolver_Type sparselu_gettype(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_DIRECT;
+}
+
+static SUNLinearSolver_ID sparselu_getid(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_CUSTOM;
+}
+
+static int sparselu_initialize(SUNLinearSolver ls)
+{
+    SparseLUContent c = SPARSELU_CONTENT(ls);
+
+    c->symbolic_ok = 0;
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int same_pattern(SparseLUContent c, SUNMatrix A)
+{
+    sunindextype n = c->n;
+    sunindextype *ptrs = SUNSparseMatrix_IndexPointers(A);
+
+    return c->symbolic_ok
+	&& c->in_csr == (SUNSparseMatrix_SparseType(A) == CSR_MAT)
+	&& memcmp(c->in_ptrs, ptrs, (n + 1) * sizeof(sunindextype)) == 0
+	&& memcmp(c->in_vals, SUNSparseMatrix_IndexValues(A),
+		  ptrs[n] * sizeof(sunindextype)) == 0;
+}
+
+static int sparselu_setup(SUNLinearSolver ls, SUNMatrix A)
+{
+    SparseLUContent c = SPARSELU_CONTENT(ls);
+    sunindextype k, nnz, r;
+    sunrealtype *data;
+    int fresh;
+
+    if (A == NULL) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+    if (SUNMatGetID(A) != SUNMATRIX_SPARSE
+	    || SUNSparseMatrix_Rows(A) != c->n
+	    || SUNSparseMatrix_Columns(A) != c->n) {
+	c->last_flag = SUNLS_ILL_INPUT;
+	return SUNLS_ILL_INPUT;
+    }
+
+    data = SUNSparseMatrix_Data(A);
+    fresh = !same_pattern(c, A);
+    for (;;) {
+	if (fresh) {
+	    if (analyze(c, SUNSparseMatrix_IndexPointers(A),
+			SUNSparseMatrix_IndexValues(A), data,
+			SUNSparseMatrix_SparseType(A) == CSR_MAT) != 0) {
+		c->last_flag = SUNLS_MEM_FAIL;
+		return SUNLS_MEM_FAIL;
+	    }
+	} else {
+	    nnz = c->ap[c->n];
+	    if (c->in_csr) {
+		for (k = 0; k < nnz; k++) c->ax[c->csr_map[k]] = data[k];
+	    } else {
+		memcpy(c->ax, data, nnz * sizeof(sunrealtype));
+	    }
+	}
+
+	r = numeric(c);
+	if (fresh) {
+	    c->analysis_perturbed = c->num_perturbed;
+	    break;
+	}
+	/* the values have drifted from those the rows were matched for */
+	if (r != 0 || c->num_perturbed == 0 || c->analysis_perturbed != 0)
+	    break;
+	fresh = 1;
+    }
+    if (r != 0) {
+	c->last_flag = r;
+	return SUNLS_LUFACT_FAIL;
+    }
+
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int sparselu_solve(SUNLinearSolver ls, SUNMatrix A, N_Vector x,
+			  N_Vector b, sunrealtype tol)
+{
+    SparseLUContent c = SPARSELU_CONTENT(ls);
+    sunrealtype *xd = N_VGetArrayPointer(x);
+    sunrealtype *bd = N_VGetArrayPointer(b);
+
+    if (xd == NULL || bd == NULL || !c->symbolic_ok) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+
+    c->last_flag = solve_refine(c, xd, bd);
+    return c->last_flag;
+}
+
+static sunindextype sparselu_lastflag(SUNLinearSolver ls)
+{
+    return SPARSELU_CONTENT(ls)->last_flag;
+}
+
+static int sparselu_space(SUNLinearSolver ls, long int *lenrw,
+			  long int *leniw)
+{
+    SparseLUContent c = SPARSELU_CONTENT(ls);
+    long int nnz = 0, nl = 0;
+
+    if (c->symbolic_ok) {
+	nnz = c->ap[c->n];
+	nl = c->lp[c->n];
+    }
+    *lenrw = nnz + 2 * nl + ((long int)c->nthreads + 5) * c->n;
+    *leniw = 3 * nnz + 2 * nl + 8 * c->n + 20;
+    return SUNLS_SUCCESS;
+}
+
+static int sparselu_free(SUNLinearSolver ls)
+{
+    if (ls == NULL) return SUNLS_SUCCESS;
+
+    if (ls->content != NULL) {
+	free_factors(SPARSELU_CONTENT(ls));
+	free(ls->content);
+    }
+    free(ls->ops);
+    free(ls);
+
+    return SUNLS_SUCCESS;
+}
+
+static SUNLinearSolver sparselu_create(sunindextype n, int ordering)
+{
+    SUNLinearSolver ls;
+    SUNLinearSolver_Ops ops;
+    SparseLUContent c;
+
+    ls = (SUNLinearSolver)malloc(sizeof *ls);
+    if (ls == NULL) return NULL;
+
+    ops = (SUNLinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNLinearSolver_Ops));
+    c = (SparseLUContent) calloc(1, sizeof(struct sparselu_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(ls);
+	return NULL;
+    }
+
+    ops->gettype    = sparselu_gettype;
+    ops->getid      = sparselu_getid;
+    ops->initialize = sparselu_initialize;
+    ops->setup      = sparselu_setup;
+    ops->solve      = sparselu_solve;
+    ops->lastflag   = sparselu_lastflag;
+    ops->space      = sparselu_space;
+    ops->free       = sparselu_free;
+
+    ls->ops = ops;
+    ls->content = c;
+
+    c->n = n;
+    c->ordering = ordering;
+    c->max_refine = DEFAULT_MAX_REFINE;
+    c->nthreads = 1;
+    c->last_flag = SUNLS_SUCCESS;
+
+    return ls;
+}
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Interface functions
+ */
+
+CAMLprim value sunml_lsolver_sparselu(value vnvec, value vsmat,
+				      value vordering, value vctx)
+{
+    CAMLparam4(vnvec, vsmat, vordering, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SUNMatrix smat = MAT_VAL(vsmat);
+    SUNLinearSolver ls;
+    sunindextype n = SUNSparseMatrix_Rows(smat);
+
+    if (SUNMatGetID(smat) != SUNMATRIX_SPARSE)
+	caml_raise_constant(LSOLVER_EXN(InvalidLinearSolver));
+    if (n != SUNSparseMatrix_Columns(smat))
+	caml_raise_constant(LSOLVER_EXN(MatrixNotSquare));
+    if (n != NV_LENGTH_S(NVEC_VAL(vnvec)))
+	caml_raise_constant(LSOLVER_EXN(MatrixVectorMismatch));
+
+    ls = sparselu_create(n, Int_val(vordering));
+    if (ls == NULL) caml_raise_out_of_memory();
+#if 600 <= SUNDIALS_LIB_VERSION
+    ls->sunctx = ML_CONTEXT(vctx);
+#endif
+
+    CAMLreturn(sunml_lsolver_wrap(ls));
+#else
+    CAMLreturn(Val_unit);
+#endif
+}
+
+CAMLprim value sunml_lsolver_sparselu_set_ordering(value vcptr,
+						   value vordering)
+{
+    CAMLparam2(vcptr, vordering);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SparseLUContent c = SPARSELU_CONTENT(LSOLVER_VAL(vcptr));
+
+    c->ordering = Int_val(vordering);
+    c->symbolic_ok = 0;
+#endif
+    CAMLreturn(Val_unit);
+}
+
+CAMLprim value sunml_lsolver_sparselu_set_max_refinements(value vcptr,
+							  value vmaxrefine)
+{
+    CAMLparam2(vcptr, vmaxrefine);
+#if 500 <= SUNDIALS_LIB_VERSION
+    if (Int_val(vmaxrefine) < 0)
+	caml_invalid_argument("max_refinements must be non-negative");
+    SPARSELU_CONTENT(LSOLVER_VAL(vcptr))->max_refine = Int_val(vmaxrefine);
+#endif
+    CAMLreturn(Val_unit);
+}
+
+// must correspond with LinearSolver.Direct.SparseLu.stats
+CAMLprim value sunml_lsolver_sparselu_get_stats(value vcptr)
+{
+    CAMLparam1(vcptr);
+    CAMLlocal1(vr);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SparseLUContent c = SPARSELU_CONTENT(LSOLVER_VAL(vcptr));
+
+    vr = caml_alloc_tuple(6);
+    Store_field(vr, 0, Val_long(c->num_symbolic));
+    Store_field(vr, 1, Val_long(c->num_numeric));
+    Store_field(vr, 2, Val_long(c->num_perturbed));
+    Store_field(vr, 3, Val_long(c->num_refine));
+    Store_field(vr, 4, Val_long(c->symbolic_ok ? c->lp[c->n] : 0));
+    Store_field(vr, 5, Val_long(c->nlevels));
+#else
+    vr = Val_unit;
+#endif
+    CAMLreturn(vr);
+}
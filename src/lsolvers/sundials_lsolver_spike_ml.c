@@ -0,0 +1,582 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Partitioned (SPIKE) direct linear solver for banded matrices.
+ *
+ * The rows and columns are split into p contiguous blocks.  Writing A = D S
+ * with D = diag(A_1, ..., A_p), the diagonal blocks are factored
+ * independently (band LU with partial pivoting, in place in A), and S has
+ * identity diagonal blocks and the "spikes"
+ *
+ *	V_j = A_j^-1 [0; B_j]	(B_j couples block j to the first mu
+ *				 unknowns of block j+1),
+ *	W_j = A_j^-1 [C_j; 0]	(C_j couples block j to the last ml
+ *				 unknowns of block j-1).
+ *
+ * Only the first mu and the last ml rows of each spike are kept: they form
+ * a reduced banded system of order p (mu + ml) in these unknowns, which is
+ * factored with partial pivoting.  A solve then takes
+ *
+ *	g = D^-1 b,  the reduced solve for the interface unknowns t, and
+ *	x_j = A_j^-1 (b_j - B_j t_{j+1} - C_j t_{j-1}),
+ *
+ * where the block operations are independent.  The coupling entries B_j and
+ * C_j are read from A itself: they lie outside the rows and columns touched
+ * by the factorizations of the diagonal blocks.
+ *
+ * Unlike the truncated variants, the reduced system is exact, so the
+ * results agree with the unpartitioned band LU up to rounding provided the
+ * diagonal blocks are nonsingular.  If one of them is singular, the setup
+ * fails (as for a singular matrix) and the next setup uses a single block,
+ * i.e., the standard band LU.  The block loops run in parallel when the
+ * library is compiled with OpenMP; setup costs two to three times as many
+ * operations as a band LU, which is recovered with four or more threads. */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../nvectors/nvector_ml.h"
+#include "../lsolvers/sundials_linearsolver_ml.h"
+#include "../lsolvers/sundials_matrix_ml.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_band.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <nvector/nvector_serial.h>
+
+#if SUNDIALS_LIB_VERSION < 600
+#define SUNDlsMat_bandGBTRF  bandGBTRF
+#define SUNDlsMat_bandGBTRS  bandGBTRS
+#endif
+
+struct spike_content {
+    sunindextype n;
+    sunindextype mu;
+    sunindextype ml;
+    sunindextype smu;
+
+    int max_parts;		/* requested number of blocks */
+    int nparts;			/* number of blocks at the last setup */
+    int single_next;		/* use one block at the next setup */
+    sunindextype *start;	/* block boundaries, max_parts + 1 */
+    sunindextype *pivots;	/* length n */
+    sunindextype *flags;	/* factorization result per block */
+
+    sunindextype rn;		/* reduced system: nparts * (mu + ml) */
+    sunindextype rmu;
+    sunindextype rml;
+    sunindextype rsmu;
+    sunrealtype *red;		/* band storage of the reduced system */
+    sunrealtype **redcols;
+    sunindextype *redpiv;
+    sunrealtype *rx;		/* reduced right-hand side and solution */
+
+    sunrealtype *rhs;		/* copy of b (x and b may alias), length n */
+    sunrealtype *work;		/* spike columns, n * SPIKE_GROUP */
+
+    long int num_fallbacks;
+    sunindextype last_flag;
+};
+
+typedef struct spike_content *SpikeContent;
+
+#define SPIKE_CONTENT(ls) ((SpikeContent)((ls)->content))
+
+/* spike columns computed per traversal of the factors of a block */
+#define SPIKE_GROUP 16
+
+/* element (i, j) of band storage with column pointers */
+#define BAND_ELEM(cols, smu, i, j) ((cols)[j][(i) - (j) + (smu)])
+
+/* Each block must have at least 2 (mu + ml) rows so that the top and
+   bottom interface unknowns are distinct; small blocks are not worth it.  */
+static int spike_num_parts(SpikeContent c)
+{
+    sunindextype minsize = SUNMAX(2 * (c->mu + c->ml), 32);
+    int p = c->max_parts;
+
+    while (p > 1 && c->n / p < minsize) p--;
+    return p;
+}
+
+/* Band dimensions and zeroed storage of the reduced system.  */
+static void spike_reduced_init(SpikeContent c)
+{
+    sunindextype k = c->mu + c->ml, j;
+
+    c->rn = c->nparts * k;
+    c->rmu = SUNMIN(c->rn - 1, 2 * c->mu + c->ml - 1);
+    c->rml = SUNMIN(c->rn - 1, c->mu + 2 * c->ml - 1);
+    c->rsmu = SUNMIN(c->rn - 1, c->rmu + c->rml);
+    for (j = 0; j < c->rn; j++)
+	c->redcols[j] = c->red + j * (c->rsmu + c->rml + 1);
+    memset(c->red, 0, sizeof(sunrealtype) * c->rn * (c->rsmu + c->rml + 1));
+}
+
+/* Solve A_j Y = Y for the nr right-hand sides stored row by row in Y (as
+   SUNDlsMat_bandGBTRS does for one).  The factors are traversed once for
+   all of them, rather than once per column, and the forward substitution
+   starts at row k0 when the rows above k0 + ml of Y are zero.  */
+static void spike_band_getrs(sunrealtype **a, sunindextype n, sunindextype smu,
+			     sunindextype ml, sunindextype *p,
+			     sunrealtype *y, sunindextype nr, sunindextype k0)
+{
+    sunindextype i, k, l, q;
+    sunrealtype *diag_k, *yk, *yi, t;
+
+    for (k = k0; k < n - 1; k++) {
+	yk = y + k * nr;
+	l = p[k];
+	if (l != k) {
+	    yi = y + l * nr;
+	    for (q = 0; q < nr; q++) {
+		t = yi[q];
+		yi[q] = yk[q];
+		yk[q] = t;
+	    }
+	}
+	diag_k = a[k] + smu;
+	for (i = k + 1; i <= SUNMIN(n - 1, k + ml); i++) {
+	    yi = y + i * nr;
+	    t = diag_k[i - k];
+	    for (q = 0; q < nr; q++) yi[q] += t * yk[q];
+	}
+    }
+
+    for (k = n - 1; k >= 0; k--) {
+	yk = y + k * nr;
+	diag_k = a[k] + smu;
+	t = 1.0 / *diag_k;
+	for (q = 0; q < nr; q++) yk[q] *= t;
+	for (i = SUNMAX(0, k - smu); i < k; i++) {
+	    yi = y + i * nr;
+	    t = diag_k[i - k];
+	    for (q = 0; q < nr; q++) yi[q] -= t * yk[q];
+	}
+    }
+}
+
+/* Spike columns q0, ..., q0+nr-1 of block j, where spike column q < mu is
+   that of V_j for the column e + q of B_j and q >= mu that of W_j for the
+   column s - ml + (q - mu) of C_j.  Only the top mu and the bottom ml rows
+   are stored, into the reduced system, whose column for q is that of the
+   corresponding interface unknown of block j+1 or j-1.  */
+static void spike_columns(SpikeContent c, sunrealtype **cols, int j,
+			  sunindextype q0, sunindextype nr)
+{
+    sunindextype s = c->start[j], e = c->start[j + 1], nj = e - s;
+    sunindextype mu = c->mu, ml = c->ml, smu = c->smu, k = mu + ml;
+    sunindextype i, q, col, rcol, k0 = nj;
+    sunrealtype *y = c->work + s * SPIKE_GROUP;
+
+    memset(y, 0, sizeof(sunrealtype) * nj * nr);
+    for (q = q0; q < q0 + nr; q++) {
+	if (q < mu) {
+	    col = e + q;
+	    for (i = SUNMAX(col - mu, s); i < e; i++)
+		y[(i - s) * nr + q - q0] = BAND_ELEM(cols, smu, i, col);
+	    k0 = SUNMIN(k0, SUNMAX(0, nj - mu - ml));
+	} else {
+	    col = s - ml + (q - mu);
+	    for (i = s; i < SUNMIN(e, col + ml + 1); i++)
+		y[(i - s) * nr + q - q0] = BAND_ELEM(cols, smu, i, col);
+	    k0 = 0;
+	}
+    }
+
+    spike_band_getrs(cols + s, nj, smu, ml, c->pivots + s, y, nr, k0);
+
+    for (q = q0; q < q0 + nr; q++) {
+	rcol = (q < mu) ? (j + 1) * k + q : (j - 1) * k + q;
+	for (i = 0; i < mu; i++)
+	    BAND_ELEM(c->redcols, c->rsmu, j * k + i, rcol)
+		= y[i * nr + q - q0];
+	for (i = 0; i < ml; i++)
+	    BAND_ELEM(c->redcols, c->rsmu, j * k + mu + i, rcol)
+		= y[(nj - ml + i) * nr + q - q0];
+    }
+}
+
+/* Factor block j and fill its rows of the reduced system.  */
+static sunindextype spike_setup_block(SpikeContent c, sunrealtype **cols,
+				      int j)
+{
+    sunindextype s = c->start[j], nj = c->start[j + 1] - s;
+    sunindextype mu = c->mu, k = mu + c->ml;
+    sunindextype q, qlo, qhi, r;
+
+    r = SUNDlsMat_bandGBTRF(cols + s, nj, mu, c->ml, c->smu, c->pivots + s);
+    if (r != 0) return r;
+
+    for (q = 0; q < k; q++)
+	BAND_ELEM(c->redcols, c->rsmu, j * k + q, j * k + q) = 1.0;
+
+    /* V_j (there is no B_j in the last block) */
+    qhi = (j < c->nparts - 1) ? mu : 0;
+    for (q = 0; q < qhi; q += SPIKE_GROUP)
+	spike_columns(c, cols, j, q, SUNMIN(SPIKE_GROUP, qhi - q));
+
+    /* W_j (there is no C_j in the first block) */
+    qlo = (j > 0) ? mu : k;
+    for (q = qlo; q < k; q += SPIKE_GROUP)
+	spike_columns(c, cols, j, q, SUNMIN(SPIKE_GROUP, k - q));
+
+    return 0;
+}
+
+/* x_j := b_j - B_j t_{j+1} - C_j t_{j-1}  */
+static void spike_subtract_coupling(SpikeContent c, sunrealtype **cols,
+				    int j, sunrealtype *x)
+{
+    sunindextype s = c->start[j], e = c->start[j + 1];
+    sunindextype mu = c->mu, ml = c->ml, smu = c->smu, k = mu + ml;
+    sunindextype i, q, col;
+    sunrealtype t;
+
+    for (q = 0; j < c->nparts - 1 && q < mu; q++) {
+	col = e + q;
+	t = c->rx[(j + 1) * k + q];
+	for (i = SUNMAX(col - mu, s); i < e; i++)
+	    x[i] -= BAND_ELEM(cols, smu, i, col) * t;
+    }
+
+    for (q = 0; j > 0 && q < ml; q++) {
+	col = s - ml + q;
+	t = c->rx[(j - 1) * k + mu + q];
+	for (i = s; i < SUNMIN(e, col + ml + 1); i++)
+	    x[i] -= BAND_ELEM(cols, smu, i, col) * t;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * SUNLinearSolver operations
+ */
+
+static SUNLinearSolver_Type spike_gettype(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_DIRECT;
+}
+
+static SUNLinearSolver_ID spike_getid(SUNLinearSolver ls)
+{
+    return SUNLINEARSOLVER_CUSTOM;
+}
+
+static int spike_initialize(SUNLinearSolver ls)
+{
+    SPIKE_CONTENT(ls)->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int spike_setup(SUNLinearSolver ls, SUNMatrix A)
+{
+    SpikeContent c = SPIKE_CONTENT(ls);
+    sunrealtype **cols;
+    sunindextype r;
+    int j;
+
+    if (A == NULL) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+    cols = SUNBandMatrix_Cols(A);
+
+    c->nparts = c->single_next ? 1 : spike_num_parts(c);
+    c->single_next = 0;
+
+    if (c->nparts == 1) {
+	r = SUNDlsMat_bandGBTRF(cols, c->n, c->mu, c->ml, c->smu, c->pivots);
+	c->last_flag = r;
+	return (r > 0) ? SUNLS_LUFACT_FAIL : SUNLS_SUCCESS;
+    }
+
+    for (j = 0; j <= c->nparts; j++)
+	c->start[j] = (sunindextype)(((long long)c->n * j) / c->nparts);
+    spike_reduced_init(c);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (j = 0; j < c->nparts; j++)
+	c->flags[j] = spike_setup_block(c, cols, j);
+
+    r = 0;
+    for (j = 0; j < c->nparts && r == 0; j++) r = c->flags[j];
+    if (r == 0 && c->rn > 0) {
+	r = SUNDlsMat_bandGBTRF(c->redcols, c->rn, c->rmu, c->rml, c->rsmu,
+				c->redpiv);
+	if (r > 0) r = c->n;
+    }
+
+    if (r != 0) {
+	/* A diagonal block or the reduced system is singular: A has been
+	   partly overwritten, so fail and use one block from the next setup
+	   (which is given a freshly computed matrix).  */
+	c->num_fallbacks++;
+	c->single_next = 1;
+	c->last_flag = r;
+	return SUNLS_LUFACT_FAIL;
+    }
+
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static int spike_solve(SUNLinearSolver ls, SUNMatrix A, N_Vector x,
+		       N_Vector b, sunrealtype tol)
+{
+    SpikeContent c = SPIKE_CONTENT(ls);
+    sunindextype mu = c->mu, ml = c->ml, k = mu + ml, i, nj;
+    sunrealtype **cols, *xd, *bd;
+    int j;
+
+    if (A == NULL || x == NULL || b == NULL) {
+	c->last_flag = SUNLS_MEM_NULL;
+	return SUNLS_MEM_NULL;
+    }
+
+    cols = SUNBandMatrix_Cols(A);
+    xd = N_VGetArrayPointer(x);
+    bd = N_VGetArrayPointer(b);
+    if (cols == NULL || xd == NULL || bd == NULL) {
+	c->last_flag = SUNLS_MEM_FAIL;
+	return SUNLS_MEM_FAIL;
+    }
+
+    if (c->nparts == 1) {
+	if (xd != bd) memcpy(xd, bd, sizeof(sunrealtype) * c->n);
+	SUNDlsMat_bandGBTRS(cols, c->n, c->smu, ml, c->pivots, xd);
+	c->last_flag = SUNLS_SUCCESS;
+	return SUNLS_SUCCESS;
+    }
+
+    memcpy(c->rhs, bd, sizeof(sunrealtype) * c->n);
+    memcpy(xd, c->rhs, sizeof(sunrealtype) * c->n);
+
+    /* g = D^-1 b and the interface values of g */
+#ifdef _OPENMP
+#pragma omp parallel for private(i, nj) schedule(static)
+#endif
+    for (j = 0; j < c->nparts; j++) {
+	nj = c->start[j + 1] - c->start[j];
+	SUNDlsMat_bandGBTRS(cols + c->start[j], nj, c->smu, ml,
+			    c->pivots + c->start[j], xd + c->start[j]);
+	for (i = 0; i < mu; i++)
+	    c->rx[j * k + i] = xd[c->start[j] + i];
+	for (i = 0; i < ml; i++)
+	    c->rx[j * k + mu + i] = xd[c->start[j + 1] - ml + i];
+    }
+
+    SUNDlsMat_bandGBTRS(c->redcols, c->rn, c->rsmu, c->rml, c->redpiv, c->rx);
+
+    memcpy(xd, c->rhs, sizeof(sunrealtype) * c->n);
+#ifdef _OPENMP
+#pragma omp parallel for private(nj) schedule(static)
+#endif
+    for (j = 0; j < c->nparts; j++) {
+	nj = c->start[j + 1] - c->start[j];
+	spike_subtract_coupling(c, cols, j, xd);
+	SUNDlsMat_bandGBTRS(cols + c->start[j], nj, c->smu, ml,
+			    c->pivots + c->start[j], xd + c->start[j]);
+    }
+
+    c->last_flag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+static sunindextype spike_lastflag(SUNLinearSolver ls)
+{
+    return SPIKE_CONTENT(ls)->last_flag;
+}
+
+static int spike_space(SUNLinearSolver ls, long int *lenrw, long int *leniw)
+{
+    SpikeContent c = SPIKE_CONTENT(ls);
+    sunindextype k = c->mu + c->ml;
+    sunindextype rn = c->max_parts * k;
+
+    *lenrw = (1 + SPIKE_GROUP) * c->n + rn * (3 * (2 * k) + 1) + rn;
+    *leniw = 12 + c->n + 2 * (c->max_parts + 1) + rn;
+    return SUNLS_SUCCESS;
+}
+
+static int spike_free(SUNLinearSolver ls)
+{
+    SpikeContent c;
+
+    if (ls == NULL) return SUNLS_SUCCESS;
+
+    c = SPIKE_CONTENT(ls);
+    if (c != NULL) {
+	free(c->start);
+	free(c->pivots);
+	free(c->flags);
+	free(c->red);
+	free(c->redcols);
+	free(c->redpiv);
+	free(c->rx);
+	free(c->rhs);
+	free(c->work);
+	free(c);
+    }
+    free(ls->ops);
+    free(ls);
+
+    return SUNLS_SUCCESS;
+}
+
+SUNLinearSolver sunml_lsolver_spike_create(sunindextype n, sunindextype mu,
+					   sunindextype ml, sunindextype smu,
+					   int max_parts)
+{
+    SUNLinearSolver ls;
+    SUNLinearSolver_Ops ops;
+    SpikeContent c;
+    sunindextype rn = (sunindextype)max_parts * (mu + ml);
+    sunindextype rldim = 3 * 2 * (mu + ml) + 1; /* rsmu + rml + 1 bound */
+
+    ls = (SUNLinearSolver)malloc(sizeof *ls);
+    if (ls == NULL) return NULL;
+
+    ops = (SUNLinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNLinearSolver_Ops));
+    c = (SpikeContent) calloc(1, sizeof(struct spike_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(ls);
+	return NULL;
+    }
+
+    ops->gettype    = spike_gettype;
+    ops->getid      = spike_getid;
+    ops->initialize = spike_initialize;
+    ops->setup      = spike_setup;
+    ops->solve      = spike_solve;
+    ops->lastflag   = spike_lastflag;
+    ops->space      = spike_space;
+    ops->free       = spike_free;
+
+    ls->ops = ops;
+    ls->content = c;
+
+    c->n = n;
+    c->mu = mu;
+    c->ml = ml;
+    c->smu = smu;
+    c->max_parts = max_parts;
+    c->nparts = 1;
+    c->last_flag = SUNLS_SUCCESS;
+
+    c->start = (sunindextype *)malloc(sizeof(sunindextype) * (max_parts + 1));
+    c->pivots = (sunindextype *)malloc(sizeof(sunindextype) * n);
+    c->flags = (sunindextype *)malloc(sizeof(sunindextype) * max_parts);
+    c->red = (sunrealtype *)malloc(sizeof(sunrealtype) * (rn * rldim + 1));
+    c->redcols = (sunrealtype **)malloc(sizeof(sunrealtype *) * (rn + 1));
+    c->redpiv = (sunindextype *)malloc(sizeof(sunindextype) * (rn + 1));
+    c->rx = (sunrealtype *)malloc(sizeof(sunrealtype) * (rn + 1));
+    c->rhs = (sunrealtype *)malloc(sizeof(sunrealtype) * n);
+    c->work = (sunrealtype *)malloc(sizeof(sunrealtype) * n * SPIKE_GROUP);
+    if (c->start == NULL || c->pivots == NULL || c->flags == NULL
+	    || c->red == NULL || c->redcols == NULL || c->redpiv == NULL
+	    || c->rx == NULL || c->rhs == NULL || c->work == NULL) {
+	spike_free(ls);
+	return NULL;
+    }
+
+    return ls;
+}
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Interface functions
+ */
+
+CAMLprim value sunml_lsolver_spike_band(value vnvec, value vbmat,
+					value vparts, value vctx)
+{
+    CAMLparam4(vnvec, vbmat, vparts, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SUNMatrix bmat = MAT_VAL(vbmat);
+    SUNLinearSolver ls;
+    sunindextype n = SUNBandMatrix_Rows(bmat);
+    int parts;
+
+    if (SUNMatGetID(bmat) != SUNMATRIX_BAND)
+	caml_raise_constant(LSOLVER_EXN(InvalidLinearSolver));
+    if (n != SUNBandMatrix_Columns(bmat))
+	caml_raise_constant(LSOLVER_EXN(MatrixNotSquare));
+    if (SUNBandMatrix_StoredUpperBandwidth(bmat) <
+	    SUNMIN(n - 1, SUNBandMatrix_LowerBandwidth(bmat)
+			  + SUNBandMatrix_UpperBandwidth(bmat)))
+	caml_raise_constant(LSOLVER_EXN(InsufficientStorageUpperBandwidth));
+    if (n != NV_LENGTH_S(NVEC_VAL(vnvec)))
+	caml_raise_constant(LSOLVER_EXN(MatrixVectorMismatch));
+
+    if (Is_block(vparts)) {
+	parts = Int_val(Some_val(vparts));
+    } else {
+#ifdef _OPENMP
+	parts = omp_get_max_threads();
+#else
+	parts = 1;
+#endif
+    }
+
+    ls = sunml_lsolver_spike_create(n,
+				    SUNBandMatrix_UpperBandwidth(bmat),
+				    SUNBandMatrix_LowerBandwidth(bmat),
+				    SUNBandMatrix_StoredUpperBandwidth(bmat),
+				    parts);
+    if (ls == NULL) caml_raise_out_of_memory();
+#if 600 <= SUNDIALS_LIB_VERSION
+    ls->sunctx = ML_CONTEXT(vctx);
+#endif
+
+    CAMLreturn(sunml_lsolver_wrap(ls));
+#else
+    CAMLreturn(Val_unit);
+#endif
+}
+
+// must correspond with LinearSolver.Direct.Spike.stats
+CAMLprim value sunml_lsolver_spike_get_stats(value vcptr)
+{
+    CAMLparam1(vcptr);
+    CAMLlocal1(vr);
+#if 500 <= SUNDIALS_LIB_VERSION
+    SpikeContent c = SPIKE_CONTENT(LSOLVER_VAL(vcptr));
+
+    vr = caml_alloc_tuple(2);
+    Store_field(vr, 0, Val_int(c->nparts));
+    Store_field(vr, 1, Val_long(c->num_fallbacks));
+#else
+    vr = Val_unit;
+#endif
+    CAMLreturn(vr);
+}
@@ -2923,12 +2923,8 @@ CAMLprim value sunml_arraydensematrix_getrf(value va, value vp)
 	caml_invalid_argument("pivot array too small.");
 #endif
 
-#if 600 <= SUNDIALS_LIB_VERSION
-    sundials_ml_index r = SUNDlsMat_denseGETRF(ARRAY2_ACOLS(va), m, n,
-					       INDEX_ARRAY(vp));
-#else
-    sundials_ml_index r = denseGETRF(ARRAY2_ACOLS(va), m, n, INDEX_ARRAY(vp));
-#endif
+    sundials_ml_index r = sunml_dense_getrf(ARRAY2_ACOLS(va), m, n,
+					    INDEX_ARRAY(vp));
 
     if (r != 0) {
 	caml_raise_with_arg(MATRIX_EXN_TAG(ZeroDiagonalElement),
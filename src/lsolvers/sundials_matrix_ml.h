@@ -15,6 +15,7 @@
 #define _MATRIX_ML_H__
 
 #include <caml/mlvalues.h>
+#include "../sundials/sundials_ml.h"
 
 #if SUNDIALS_LIB_VERSION >= 300
 #include <sundials/sundials_matrix.h>
@@ -297,5 +298,25 @@ enum mat_exn_index {
 #define MATRIX_EXN(name)     REGISTERED_EXN(MATRIX, name)
 #define MATRIX_EXN_TAG(name) REGISTERED_EXN_TAG(MATRIX, name)
 
+/* Cache-blocked replacement for SUNDlsMat_denseGETRF (same arguments,
+ * pivots, and return value); see sundials_dense_lu_ml.c.  */
+sundials_ml_index sunml_dense_getrf(sunrealtype **a, sundials_ml_index m,
+				    sundials_ml_index n, sundials_ml_index *p);
+
+/* Reverse Cuthill-McKee ordering of the graph of A + A^T for an n x n
+ * matrix in compressed (CSC or CSR) storage; perm[i] is the old index of
+ * the new row and column i.  Returns 0, or -1 if memory cannot be
+ * allocated.  See sundials_sparse_order_ml.c.  */
+int sunml_sparse_rcm(sundials_ml_index n, sundials_ml_index *ptrs,
+		     sundials_ml_index *vals, sundials_ml_index *perm);
+
+/* Upper (mu) and lower (ml) bandwidths of an n x n matrix in compressed
+ * storage (CSR if csr is nonzero), reordered by the inverse permutation
+ * iperm (old -> new) unless it is NULL.  */
+void sunml_sparse_bandwidths(sundials_ml_index n, sundials_ml_index *ptrs,
+			     sundials_ml_index *vals, int csr,
+			     sundials_ml_index *iperm,
+			     sundials_ml_index *mu, sundials_ml_index *ml);
+
 #endif
 
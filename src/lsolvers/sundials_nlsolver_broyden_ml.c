@@ -0,0 +1,362 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Quasi-Newton nonlinear solver with Broyden updates.
+ *
+ * The solver has the same interface as the Sundials Newton solver and is
+ * driven by the same integrator callbacks (sysfn, lsetupfn, lsolvefn and
+ * convtestfn), but the linear solves with the (lagged) iteration matrix M
+ * are only used as the initial approximation H_0 = M^-1 of the inverse
+ * Jacobian.  Within one call to solve, the approximation is corrected by
+ * "good" Broyden updates from the previous steps s_0, ..., s_n, which are
+ * applied in limited-memory form (Kelley, Iterative Methods for Linear and
+ * Nonlinear Equations, Algorithm brsol, with full steps):
+ *
+ *	z = -H_0 F(y_{n+1}),
+ *	z := z + s_{j+1} <s_j, z> / <s_j, s_j>	for j = 0, ..., n-1,
+ *	s_{n+1} = z / (1 - <s_n, z> / <s_n, s_n>).
+ *
+ * The inner product is weighted by the error weights passed to solve, so
+ * that the updates are scaled like the convergence test.  Each iteration
+ * costs one evaluation of F and one linear solve, as for Newton, but the
+ * convergence rate degrades much less when M is out of date.  Fewer
+ * convergence failures in turn mean fewer forced Jacobian evaluations and
+ * factorizations.  At most max_vectors steps are kept; the history is then
+ * restarted, as it is when the denominator of the update is too small.
+ *
+ * With a nonzero print level, the weighted norm of each step is written
+ * to the info file (stdout by default), as by the Sundials Newton solver.  */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../lsolvers/sundials_nonlinearsolver_ml.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <sundials/sundials_nonlinearsolver.h>
+#include <sundials/sundials_nvector.h>
+
+#define BROYDEN_MIN_DENOM 1.0e-4
+
+struct broyden_content {
+    SUNNonlinSolSysFn Sys;
+    SUNNonlinSolLSetupFn LSetup;
+    SUNNonlinSolLSolveFn LSolve;
+    SUNNonlinSolConvTestFn CTest;
+    void *ctest_data;
+
+    N_Vector delta;	/* residual, then the current step */
+    N_Vector z0;	/* -H_0 F */
+    N_Vector w2;	/* squared weights */
+    N_Vector *s;	/* previous steps */
+    N_Vector *ws;	/* w2 * s[j] */
+    sunrealtype *snrm2;	/* <s_j, s_j> */
+    int max_vectors;
+    int nvec;
+
+    sunbooleantype jcur;
+    int curiter;
+    int maxiters;
+    long int niters;
+    long int nconvfails;
+    long int nrestarts;
+
+    int print_level;
+    FILE *info_file;
+};
+typedef struct broyden_content *BroydenContent;
+
+#define BROYDEN_CONTENT(nls) ((BroydenContent)(nls->content))
+
+static SUNNonlinearSolver_Type broyden_gettype(SUNNonlinearSolver nls)
+{
+    return SUNNONLINEARSOLVER_ROOTFIND;
+}
+
+static int broyden_initialize(SUNNonlinearSolver nls)
+{
+    BroydenContent c = BROYDEN_CONTENT(nls);
+
+    if (c->Sys == NULL || c->LSolve == NULL || c->CTest == NULL)
+	return SUN_NLS_MEM_NULL;
+
+    c->niters = 0;
+    c->nconvfails = 0;
+    c->nrestarts = 0;
+    c->jcur = SUNFALSE;
+    return SUN_NLS_SUCCESS;
+}
+
+/* Turn z = -H_0 F into the next Broyden step, and record it.  The history
+   is discarded when it is full or when the update is nearly singular, in
+   which case the step is z itself.  */
+static void broyden_step(BroydenContent c, N_Vector z)
+{
+    int j, n = c->nvec;
+    sunrealtype d;
+
+    if (n > 0) {
+	N_VScale(1.0, z, c->z0);
+
+	for (j = 0; j < n - 1; j++)
+	    N_VLinearSum(N_VDotProd(c->ws[j], z) / c->snrm2[j], c->s[j + 1],
+			 1.0, z, z);
+
+	d = 1.0 - N_VDotProd(c->ws[n - 1], z) / c->snrm2[n - 1];
+	if (fabs(d) < BROYDEN_MIN_DENOM) {
+	    N_VScale(1.0, c->z0, z);
+	    n = 0;
+	    c->nrestarts++;
+	} else {
+	    N_VScale(1.0 / d, z, z);
+	}
+    }
+
+    if (n == c->max_vectors) {
+	n = 0;
+	c->nrestarts++;
+    }
+
+    N_VScale(1.0, z, c->s[n]);
+    N_VProd(c->w2, z, c->ws[n]);
+    c->snrm2[n] = N_VDotProd(c->ws[n], z);
+    c->nvec = (c->snrm2[n] > 0.0) ? n + 1 : 0;
+}
+
+static int broyden_solve(SUNNonlinearSolver nls, N_Vector y0, N_Vector ycor,
+			 N_Vector w, sunrealtype tol,
+			 sunbooleantype callLSetup, void *mem)
+{
+    BroydenContent c = BROYDEN_CONTENT(nls);
+    N_Vector delta = c->delta;
+    sunbooleantype jbad = SUNFALSE;
+    int retval;
+
+    if (c->LSetup == NULL) callLSetup = SUNFALSE;
+
+    N_VProd(w, w, c->w2);
+    N_VScale(1.0, y0, ycor);
+
+    for (;;) {
+	retval = c->Sys(ycor, delta, mem);
+	if (retval != SUN_NLS_SUCCESS) break;
+
+	if (callLSetup) {
+	    retval = c->LSetup(jbad, &(c->jcur), mem);
+	    if (retval != SUN_NLS_SUCCESS) break;
+	}
+
+	c->curiter = 0;
+	c->nvec = 0;
+
+	for (;;) {
+	    c->niters++;
+
+	    N_VScale(-1.0, delta, delta);
+	    retval = c->LSolve(delta, mem);
+	    if (retval != SUN_NLS_SUCCESS) break;
+
+	    broyden_step(c, delta);
+	    N_VLinearSum(1.0, ycor, 1.0, delta, ycor);
+
+	    if (c->print_level > 0)
+		fprintf(c->info_file == NULL ? stdout : c->info_file,
+			"SUNNonlinSolSolve_Broyden: iter = %d, nvec = %d, "
+			"nrm = %.16g\n", c->curiter, c->nvec,
+			(double)N_VWrmsNorm(delta, w));
+
+	    retval = c->CTest(nls, ycor, delta, tol, w, c->ctest_data);
+	    if (retval == SUN_NLS_SUCCESS) {
+		c->jcur = SUNFALSE;
+		return SUN_NLS_SUCCESS;
+	    }
+	    if (retval != SUN_NLS_CONTINUE) break;
+
+	    c->curiter++;
+	    if (c->curiter >= c->maxiters) {
+		retval = SUN_NLS_CONV_RECVR;
+		break;
+	    }
+
+	    retval = c->Sys(ycor, delta, mem);
+	    if (retval != SUN_NLS_SUCCESS) break;
+	}
+
+	/* retry from the initial guess with a fresh iteration matrix */
+	if (retval > 0 && !c->jcur && c->LSetup != NULL) {
+	    c->nconvfails++;
+	    callLSetup = SUNTRUE;
+	    jbad = SUNTRUE;
+	    N_VScale(1.0, y0, ycor);
+	    continue;
+	}
+	break;
+    }
+
+    c->nconvfails++;
+    return retval;
+}
+
+static int broyden_free(SUNNonlinearSolver nls)
+{
+    BroydenContent c;
+
+    if (nls == NULL) return SUN_NLS_SUCCESS;
+
+    c = BROYDEN_CONTENT(nls);
+    if (c != NULL) {
+	if (c->delta != NULL) N_VDestroy(c->delta);
+	if (c->z0 != NULL) N_VDestroy(c->z0);
+	if (c->w2 != NULL) N_VDestroy(c->w2);
+	if (c->s != NULL) N_VDestroyVectorArray(c->s, c->max_vectors);
+	if (c->ws != NULL) N_VDestroyVectorArray(c->ws, c->max_vectors);
+	free(c->snrm2);
+	free(c);
+    }
+    free(nls->ops);
+    free(nls);
+
+    return SUN_NLS_SUCCESS;
+}
+
+static int broyden_setsysfn(SUNNonlinearSolver nls, SUNNonlinSolSysFn f)
+{
+    if (f == NULL) return SUN_NLS_ILL_INPUT;
+    BROYDEN_CONTENT(nls)->Sys = f;
+    return SUN_NLS_SUCCESS;
+}
+
+static int broyden_setlsetupfn(SUNNonlinearSolver nls, SUNNonlinSolLSetupFn f)
+{
+    BROYDEN_CONTENT(nls)->LSetup = f;
+    return SUN_NLS_SUCCESS;
+}
+
+static int broyden_setlsolvefn(SUNNonlinearSolver nls, SUNNonlinSolLSolveFn f)
+{
+    BROYDEN_CONTENT(nls)->LSolve = f;
+    return SUN_NLS_SUCCESS;
+}
+
+static int broyden_setctestfn(SUNNonlinearSolver nls,
+			      SUNNonlinSolConvTestFn f, void *ctest_data)
+{
+    if (f == NULL) return SUN_NLS_ILL_INPUT;
+    BROYDEN_CONTENT(nls)->CTest = f;
+    BROYDEN_CONTENT(nls)->ctest_data = ctest_data;
+    return SUN_NLS_SUCCESS;
+}
+
+static int broyden_setmaxiters(SUNNonlinearSolver nls, int maxiters)
+{
+    if (maxiters < 1) return SUN_NLS_ILL_INPUT;
+    BROYDEN_CONTENT(nls)->maxiters = maxiters;
+    return SUN_NLS_SUCCESS;
+}
+
+static int broyden_getnumiters(SUNNonlinearSolver nls, long int *niters)
+{
+    *niters = BROYDEN_CONTENT(nls)->niters;
+    return SUN_NLS_SUCCESS;
+}
+
+static int broyden_getcuriter(SUNNonlinearSolver nls, int *iter)
+{
+    *iter = BROYDEN_CONTENT(nls)->curiter;
+    return SUN_NLS_SUCCESS;
+}
+
+static int broyden_getnumconvfails(SUNNonlinearSolver nls,
+				   long int *nconvfails)
+{
+    *nconvfails = BROYDEN_CONTENT(nls)->nconvfails;
+    return SUN_NLS_SUCCESS;
+}
+
+SUNNonlinearSolver sunml_nlsolver_broyden(N_Vector y, int max_vectors)
+{
+    SUNNonlinearSolver nls;
+    SUNNonlinearSolver_Ops ops;
+    BroydenContent c;
+
+    nls = (SUNNonlinearSolver)malloc(sizeof *nls);
+    if (nls == NULL) return NULL;
+
+    ops = (SUNNonlinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNNonlinearSolver_Ops));
+    c = (BroydenContent) calloc(1, sizeof(struct broyden_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(nls);
+	return NULL;
+    }
+
+    ops->gettype         = broyden_gettype;
+    ops->initialize      = broyden_initialize;
+    ops->setup           = NULL;
+    ops->solve           = broyden_solve;
+    ops->free            = broyden_free;
+    ops->setsysfn        = broyden_setsysfn;
+    ops->setlsetupfn     = broyden_setlsetupfn;
+    ops->setlsolvefn     = broyden_setlsolvefn;
+    ops->setctestfn      = broyden_setctestfn;
+    ops->setmaxiters     = broyden_setmaxiters;
+    ops->getnumiters     = broyden_getnumiters;
+    ops->getcuriter      = broyden_getcuriter;
+    ops->getnumconvfails = broyden_getnumconvfails;
+
+    nls->ops = ops;
+    nls->content = c;
+
+    c->max_vectors = (max_vectors < 1) ? 1 : max_vectors;
+    c->maxiters = 3;
+    c->delta = N_VClone(y);
+    c->z0 = N_VClone(y);
+    c->w2 = N_VClone(y);
+    c->s = N_VCloneVectorArray(c->max_vectors, y);
+    c->ws = N_VCloneVectorArray(c->max_vectors, y);
+    c->snrm2 = (sunrealtype *)malloc(sizeof(sunrealtype) * c->max_vectors);
+    if (c->delta == NULL || c->z0 == NULL || c->w2 == NULL
+	    || c->s == NULL || c->ws == NULL || c->snrm2 == NULL) {
+	broyden_free(nls);
+	return NULL;
+    }
+
+    return nls;
+}
+
+long int sunml_nlsolver_broyden_num_restarts(SUNNonlinearSolver nls)
+{
+    return BROYDEN_CONTENT(nls)->nrestarts;
+}
+
+void sunml_nlsolver_broyden_set_print_level(SUNNonlinearSolver nls,
+					    int print_level)
+{
+    BROYDEN_CONTENT(nls)->print_level = print_level;
+}
+
+void sunml_nlsolver_broyden_set_info_file(SUNNonlinearSolver nls, FILE *f)
+{
+    BROYDEN_CONTENT(nls)->info_file = f;
+}
+#endif
@@ -0,0 +1,464 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Task-local Newton solver for block-diagonal nonlinear systems.
+ *
+ * The local part of the unknowns (the array returned by N_VGetArrayPointer)
+ * is split into nblocks contiguous blocks of block_size unknowns, and the
+ * Jacobian of the nonlinear system F (the sysfn of the integrator) is
+ * approximated by its diagonal blocks,
+ *
+ *	J ~ diag(J_1, ..., J_nblocks),
+ *
+ * which is exact when the implicit terms only couple unknowns within a
+ * block, e.g., the reactions in a cell, or all the unknowns of a rank.  The
+ * blocks are computed by difference quotients of F: since different blocks
+ * do not interact, column j of every block is perturbed in the same
+ * evaluation of F, so that the Jacobian costs block_size evaluations of F
+ * for dense blocks, and mu + ml + 1 evaluations for banded ones.  Each
+ * block is factored (dense or band LU with partial pivoting) and the Newton
+ * step s = -J^-1 F(y) is computed block by block.
+ *
+ * Neither the Jacobian, nor the factorizations, nor the step involve any
+ * communication.  The only global operations per iteration are those of
+ * the convergence test of the integrator (a single weighted norm) and those
+ * of F itself, if any.  The integrator's linear solver callbacks (lsetupfn
+ * and lsolvefn) are not used.
+ *
+ * Since F includes the integrator's scaling of the implicit terms (gamma,
+ * or cj), the Jacobian is recomputed at the start of every solve, and, for
+ * a full Newton iteration, at every iteration.  The ranks agree on whether
+ * a factorization failed with one reduction per Jacobian, so that a
+ * singular block on one rank causes a recoverable failure on all of
+ * them.  */
+
+#include "../config.h"
+
+#define CAML_NAME_SPACE
+
+#include <caml/mlvalues.h>
+
+#include "../sundials/sundials_ml.h"
+#include "../lsolvers/sundials_nonlinearsolver_ml.h"
+#include "../lsolvers/sundials_matrix_ml.h"
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <sundials/sundials_nonlinearsolver.h>
+#include <sundials/sundials_nvector.h>
+#include <sundials/sundials_math.h>
+#include <sundials/sundials_dense.h>
+#include <sundials/sundials_band.h>
+
+#if SUNDIALS_LIB_VERSION < 600
+#define SUNDlsMat_denseGETRS denseGETRS
+#define SUNDlsMat_bandGBTRF  bandGBTRF
+#define SUNDlsMat_bandGBTRS  bandGBTRS
+#define SUN_UNIT_ROUNDOFF    UNIT_ROUNDOFF
+#endif
+
+struct tasklocal_content {
+    SUNNonlinSolSysFn Sys;
+    SUNNonlinSolConvTestFn CTest;
+    void *ctest_data;
+
+    N_Vector delta;	/* residual, then the current step */
+    N_Vector ytmp;	/* perturbed correction */
+    N_Vector ftmp;	/* residual at ytmp */
+
+    sunindextype nblocks;
+    sunindextype block_size;
+    int is_band;
+    sunindextype mu;
+    sunindextype ml;
+    sunindextype smu;
+    sunindextype ldim;	/* block_size for dense, smu + ml + 1 for band */
+
+    sunrealtype *jac;	/* factored blocks, one after the other */
+    sunrealtype **cols;	/* columns of the blocks */
+    sunindextype *pivots;
+    int *flags;		/* factorization results per block */
+
+    sunbooleantype full_newton;
+    int curiter;
+    int maxiters;
+    long int niters;
+    long int nconvfails;
+    long int nsetups;
+
+    int print_level;
+    FILE *info_file;
+};
+typedef struct tasklocal_content *TaskLocalContent;
+
+#define TASKLOCAL_CONTENT(nls) ((TaskLocalContent)(nls->content))
+
+static SUNNonlinearSolver_Type tasklocal_gettype(SUNNonlinearSolver nls)
+{
+    return SUNNONLINEARSOLVER_ROOTFIND;
+}
+
+static int tasklocal_initialize(SUNNonlinearSolver nls)
+{
+    TaskLocalContent c = TASKLOCAL_CONTENT(nls);
+
+    if (c->Sys == NULL || c->CTest == NULL)
+	return SUN_NLS_MEM_NULL;
+
+    c->niters = 0;
+    c->nconvfails = 0;
+    c->nsetups = 0;
+    return SUN_NLS_SUCCESS;
+}
+
+/* Difference-quotient approximation of the diagonal blocks of the Jacobian
+   at ycor, where fy = F(ycor).  The columns j, j + ngroups, ... of every
+   block are perturbed together.  */
+static int tasklocal_jac(TaskLocalContent c, N_Vector ycor, N_Vector fy,
+			 N_Vector w, void *mem)
+{
+    sunindextype nb = c->block_size, ngroups, g, b, i, j, k, ilo, ihi;
+    sunrealtype *yd, *td, *fd, *gd, *wd, *col, srur, inc;
+    int retval;
+
+    ngroups = c->is_band ? c->mu + c->ml + 1 : nb;
+    if (ngroups > nb) ngroups = nb;
+    srur = SUNRsqrt(SUN_UNIT_ROUNDOFF);
+
+    yd = N_VGetArrayPointer(ycor);
+    td = N_VGetArrayPointer(c->ytmp);
+    fd = N_VGetArrayPointer(fy);
+    gd = N_VGetArrayPointer(c->ftmp);
+    wd = N_VGetArrayPointer(w);
+    if (yd == NULL || td == NULL || fd == NULL || gd == NULL || wd == NULL)
+	return SUN_NLS_MEM_NULL;
+
+    for (g = 0; g < ngroups; g++) {
+	N_VScale(1.0, ycor, c->ytmp);
+	for (b = 0; b < c->nblocks; b++) {
+	    for (j = g; j < nb; j += ngroups) {
+		k = b * nb + j;
+		inc = srur * SUNMAX(SUNRabs(yd[k]), 1.0 / wd[k]);
+		td[k] = yd[k] + inc;
+	    }
+	}
+
+	retval = c->Sys(c->ytmp, c->ftmp, mem);
+	if (retval != SUN_NLS_SUCCESS) return retval;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(i, j, k, ilo, ihi, inc, col) schedule(static)
+#endif
+	for (b = 0; b < c->nblocks; b++) {
+	    for (j = g; j < nb; j += ngroups) {
+		k = b * nb + j;
+		inc = 1.0 / (td[k] - yd[k]);
+		col = c->cols[k];
+		if (c->is_band) {
+		    ilo = SUNMAX(0, j - c->mu);
+		    ihi = SUNMIN(nb - 1, j + c->ml);
+		    for (i = ilo; i <= ihi; i++)
+			col[i - j + c->smu] = (gd[b * nb + i] - fd[b * nb + i]) * inc;
+		} else {
+		    for (i = 0; i < nb; i++)
+			col[i] = (gd[b * nb + i] - fd[b * nb + i]) * inc;
+		}
+	    }
+	}
+    }
+
+    return SUN_NLS_SUCCESS;
+}
+
+/* Compute and factor the blocks; returns SUN_NLS_CONV_RECVR on every rank
+   if a block is singular on any of them.  */
+static int tasklocal_setup(TaskLocalContent c, N_Vector ycor, N_Vector fy,
+			   N_Vector w, void *mem)
+{
+    sunindextype nb = c->block_size, b;
+    int retval, fail = 0;
+
+    retval = tasklocal_jac(c, ycor, fy, w, mem);
+    if (retval != SUN_NLS_SUCCESS) return retval;
+    c->nsetups++;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (b = 0; b < c->nblocks; b++) {
+	if (c->is_band)
+	    c->flags[b] = SUNDlsMat_bandGBTRF(c->cols + b * nb, nb, c->mu, c->ml,
+					      c->smu, c->pivots + b * nb) != 0;
+	else
+	    c->flags[b] = sunml_dense_getrf(c->cols + b * nb, nb, nb,
+					    c->pivots + b * nb) != 0;
+    }
+    for (b = 0; b < c->nblocks; b++) fail |= c->flags[b];
+
+    N_VConst(fail ? 1.0 : 0.0, c->ytmp);
+    return (N_VMaxNorm(c->ytmp) > 0.0) ? SUN_NLS_CONV_RECVR : SUN_NLS_SUCCESS;
+}
+
+/* delta := -J^-1 delta, block by block.  */
+static int tasklocal_lsolve(TaskLocalContent c, N_Vector delta)
+{
+    sunindextype nb = c->block_size, b;
+    sunrealtype *dd = N_VGetArrayPointer(delta);
+
+    if (dd == NULL) return SUN_NLS_MEM_NULL;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (b = 0; b < c->nblocks; b++) {
+	if (c->is_band)
+	    SUNDlsMat_bandGBTRS(c->cols + b * nb, nb, c->smu, c->ml,
+				c->pivots + b * nb, dd + b * nb);
+	else
+	    SUNDlsMat_denseGETRS(c->cols + b * nb, nb, c->pivots + b * nb,
+				 dd + b * nb);
+    }
+    N_VScale(-1.0, delta, delta);
+
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_solve(SUNNonlinearSolver nls, N_Vector y0,
+			   N_Vector ycor, N_Vector w, sunrealtype tol,
+			   sunbooleantype callLSetup, void *mem)
+{
+    TaskLocalContent c = TASKLOCAL_CONTENT(nls);
+    N_Vector delta = c->delta;
+    int retval;
+
+    N_VScale(1.0, y0, ycor);
+    c->curiter = 0;
+
+    retval = c->Sys(ycor, delta, mem);
+    if (retval == SUN_NLS_SUCCESS)
+	retval = tasklocal_setup(c, ycor, delta, w, mem);
+
+    while (retval == SUN_NLS_SUCCESS) {
+	c->niters++;
+
+	retval = tasklocal_lsolve(c, delta);
+	if (retval != SUN_NLS_SUCCESS) break;
+	N_VLinearSum(1.0, ycor, 1.0, delta, ycor);
+
+	if (c->print_level > 0)
+	    fprintf(c->info_file == NULL ? stdout : c->info_file,
+		    "SUNNonlinSolSolve_TaskLocal: iter = %d, nsetups = %ld, "
+		    "nrm = %.16g\n", c->curiter, c->nsetups,
+		    (double)N_VWrmsNorm(delta, w));
+
+	retval = c->CTest(nls, ycor, delta, tol, w, c->ctest_data);
+	if (retval == SUN_NLS_SUCCESS) return SUN_NLS_SUCCESS;
+	if (retval != SUN_NLS_CONTINUE) break;
+
+	c->curiter++;
+	if (c->curiter >= c->maxiters) {
+	    retval = SUN_NLS_CONV_RECVR;
+	    break;
+	}
+
+	retval = c->Sys(ycor, delta, mem);
+	if (retval == SUN_NLS_SUCCESS && c->full_newton)
+	    retval = tasklocal_setup(c, ycor, delta, w, mem);
+    }
+
+    c->nconvfails++;
+    return retval;
+}
+
+static int tasklocal_free(SUNNonlinearSolver nls)
+{
+    TaskLocalContent c;
+
+    if (nls == NULL) return SUN_NLS_SUCCESS;
+
+    c = TASKLOCAL_CONTENT(nls);
+    if (c != NULL) {
+	if (c->delta != NULL) N_VDestroy(c->delta);
+	if (c->ytmp != NULL) N_VDestroy(c->ytmp);
+	if (c->ftmp != NULL) N_VDestroy(c->ftmp);
+	free(c->jac);
+	free(c->cols);
+	free(c->pivots);
+	free(c->flags);
+	free(c);
+    }
+    free(nls->ops);
+    free(nls);
+
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_setsysfn(SUNNonlinearSolver nls, SUNNonlinSolSysFn f)
+{
+    if (f == NULL) return SUN_NLS_ILL_INPUT;
+    TASKLOCAL_CONTENT(nls)->Sys = f;
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_setlsetupfn(SUNNonlinearSolver nls,
+				 SUNNonlinSolLSetupFn f)
+{
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_setlsolvefn(SUNNonlinearSolver nls,
+				 SUNNonlinSolLSolveFn f)
+{
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_setctestfn(SUNNonlinearSolver nls,
+				SUNNonlinSolConvTestFn f, void *ctest_data)
+{
+    if (f == NULL) return SUN_NLS_ILL_INPUT;
+    TASKLOCAL_CONTENT(nls)->CTest = f;
+    TASKLOCAL_CONTENT(nls)->ctest_data = ctest_data;
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_setmaxiters(SUNNonlinearSolver nls, int maxiters)
+{
+    if (maxiters < 1) return SUN_NLS_ILL_INPUT;
+    TASKLOCAL_CONTENT(nls)->maxiters = maxiters;
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_getnumiters(SUNNonlinearSolver nls, long int *niters)
+{
+    *niters = TASKLOCAL_CONTENT(nls)->niters;
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_getcuriter(SUNNonlinearSolver nls, int *iter)
+{
+    *iter = TASKLOCAL_CONTENT(nls)->curiter;
+    return SUN_NLS_SUCCESS;
+}
+
+static int tasklocal_getnumconvfails(SUNNonlinearSolver nls,
+				     long int *nconvfails)
+{
+    *nconvfails = TASKLOCAL_CONTENT(nls)->nconvfails;
+    return SUN_NLS_SUCCESS;
+}
+
+/* Blocks are banded if mu and ml are nonnegative, and dense otherwise.
+   The local length of y must be a multiple of block_size (this is checked
+   by the caller).  */
+SUNNonlinearSolver sunml_nlsolver_tasklocal(N_Vector y,
+					    sunindextype local_length,
+					    sunindextype block_size,
+					    sunindextype mu, sunindextype ml,
+					    int full_newton)
+{
+    SUNNonlinearSolver nls;
+    SUNNonlinearSolver_Ops ops;
+    TaskLocalContent c;
+    sunindextype k, nb = block_size;
+
+    nls = (SUNNonlinearSolver)malloc(sizeof *nls);
+    if (nls == NULL) return NULL;
+
+    ops = (SUNNonlinearSolver_Ops) calloc(1,
+	    sizeof(struct _generic_SUNNonlinearSolver_Ops));
+    c = (TaskLocalContent) calloc(1, sizeof(struct tasklocal_content));
+    if (ops == NULL || c == NULL) {
+	free(ops);
+	free(c);
+	free(nls);
+	return NULL;
+    }
+
+    ops->gettype         = tasklocal_gettype;
+    ops->initialize      = tasklocal_initialize;
+    ops->setup           = NULL;
+    ops->solve           = tasklocal_solve;
+    ops->free            = tasklocal_free;
+    ops->setsysfn        = tasklocal_setsysfn;
+    ops->setlsetupfn     = tasklocal_setlsetupfn;
+    ops->setlsolvefn     = tasklocal_setlsolvefn;
+    ops->setctestfn      = tasklocal_setctestfn;
+    ops->setmaxiters     = tasklocal_setmaxiters;
+    ops->getnumiters     = tasklocal_getnumiters;
+    ops->getcuriter      = tasklocal_getcuriter;
+    ops->getnumconvfails = tasklocal_getnumconvfails;
+
+    nls->ops = ops;
+    nls->content = c;
+
+    c->block_size = nb;
+    c->nblocks = local_length / nb;
+    c->is_band = (mu >= 0 && ml >= 0);
+    if (c->is_band) {
+	c->mu = SUNMIN(mu, nb - 1);
+	c->ml = SUNMIN(ml, nb - 1);
+	c->smu = SUNMIN(nb - 1, c->mu + c->ml);
+	c->ldim = c->smu + c->ml + 1;
+    } else {
+	c->ldim = nb;
+    }
+    c->full_newton = full_newton ? SUNTRUE : SUNFALSE;
+    c->maxiters = 3;
+
+    c->delta = N_VClone(y);
+    c->ytmp = N_VClone(y);
+    c->ftmp = N_VClone(y);
+    c->jac = (sunrealtype *)calloc(local_length * c->ldim > 0
+				   ? local_length * c->ldim : 1,
+				   sizeof(sunrealtype));
+    c->cols = (sunrealtype **)malloc(sizeof(sunrealtype *)
+				     * (local_length > 0 ? local_length : 1));
+    c->pivots = (sunindextype *)malloc(sizeof(sunindextype)
+				       * (local_length > 0 ? local_length : 1));
+    c->flags = (int *)malloc(sizeof(int)
+			     * (c->nblocks > 0 ? c->nblocks : 1));
+    if (c->delta == NULL || c->ytmp == NULL || c->ftmp == NULL
+	    || c->jac == NULL || c->cols == NULL || c->pivots == NULL
+	    || c->flags == NULL) {
+	tasklocal_free(nls);
+	return NULL;
+    }
+
+    for (k = 0; k < local_length; k++) c->cols[k] = c->jac + k * c->ldim;
+
+    return nls;
+}
+
+long int sunml_nlsolver_tasklocal_num_setups(SUNNonlinearSolver nls)
+{
+    return TASKLOCAL_CONTENT(nls)->nsetups;
+}
+
+void sunml_nlsolver_tasklocal_set_print_level(SUNNonlinearSolver nls,
+					      int print_level)
+{
+    TASKLOCAL_CONTENT(nls)->print_level = print_level;
+}
+
+void sunml_nlsolver_tasklocal_set_info_file(SUNNonlinearSolver nls, FILE *f)
+{
+    TASKLOCAL_CONTENT(nls)->info_file = f;
+}
+#endif
@@ -1012,6 +1012,54 @@ CAMLprim void sunml_nlsolver_set_print_level_newton(value vnls, value vlevel)
     CAMLreturn0;
 }
 
+CAMLprim void sunml_nlsolver_set_info_file_broyden(value vnls, value vfile)
+{
+    CAMLparam2(vnls, vfile);
+#if 500 <= SUNDIALS_LIB_VERSION
+    sunml_nlsolver_broyden_set_info_file(NLSOLVER_VAL(vnls), ML_CFILE(vfile));
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_nlsolver_set_print_level_broyden(value vnls, value vlevel)
+{
+    CAMLparam2(vnls, vlevel);
+#if 500 <= SUNDIALS_LIB_VERSION
+    sunml_nlsolver_broyden_set_print_level(NLSOLVER_VAL(vnls),
+					   Int_val(vlevel));
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_nlsolver_set_info_file_tasklocal(value vnls, value vfile)
+{
+    CAMLparam2(vnls, vfile);
+#if 500 <= SUNDIALS_LIB_VERSION
+    sunml_nlsolver_tasklocal_set_info_file(NLSOLVER_VAL(vnls),
+					   ML_CFILE(vfile));
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn0;
+}
+
+CAMLprim void sunml_nlsolver_set_print_level_tasklocal(value vnls,
+						       value vlevel)
+{
+    CAMLparam2(vnls, vlevel);
+#if 500 <= SUNDIALS_LIB_VERSION
+    sunml_nlsolver_tasklocal_set_print_level(NLSOLVER_VAL(vnls),
+					     Int_val(vlevel));
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn0;
+}
+
 CAMLprim void sunml_nlsolver_set_print_level_fixedpoint(value vnls, value vlevel)
 {
     CAMLparam2(vnls, vlevel);
@@ -1567,6 +1615,102 @@ CAMLprim value sunml_nlsolver_newton_get_sys_fn(value vnls)
 #endif
 }
 
+CAMLprim value sunml_nlsolver_broyden_make(value vy, value vm,
+					   value vcallbacks, value vctx)
+{
+    CAMLparam4(vy, vm, vcallbacks, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    CAMLlocal1(vr);
+
+    vr = rewrap_nlsolver(sunml_nlsolver_broyden(NVEC_VAL(vy), Int_val(vm)),
+			 vcallbacks);
+#if 600 <= SUNDIALS_LIB_VERSION
+    NLSOLVER_VAL(vr)->sunctx = ML_CONTEXT(vctx);
+#endif
+    CAMLreturn (vr);
+#else
+    CAMLreturn (Val_unit);
+#endif
+}
+
+CAMLprim value sunml_nlsolver_broyden_get_num_restarts(value vnls)
+{
+    CAMLparam1(vnls);
+#if 500 <= SUNDIALS_LIB_VERSION
+    CAMLreturn (Val_long(sunml_nlsolver_broyden_num_restarts(
+				NLSOLVER_VAL(vnls))));
+#else
+    CAMLreturn (Val_long(0));
+#endif
+}
+
+/* vbandwidths is an optional pair (mu, ml), and vlocal is negative if the
+   local length is to be taken from the nvector.  The other arguments are
+   checked in OCaml.  */
+CAMLprim value sunml_nlsolver_tasklocal_make(value vy, value vlocal,
+					     value vblock, value vbandwidths,
+					     value vfull, value vcallbacks,
+					     value vctx)
+{
+    CAMLparam5(vy, vlocal, vblock, vbandwidths, vfull);
+    CAMLxparam2(vcallbacks, vctx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    CAMLlocal1(vr);
+    N_Vector y = NVEC_VAL(vy);
+    sunindextype mu = -1, ml = -1, local = Long_val(vlocal), actual = -1;
+
+    if (N_VGetArrayPointer(y) == NULL)
+	caml_invalid_argument("TaskLocal.make: nvector has no local array");
+
+    /* the whole vector is local if there is no communicator */
+    if (y->ops->nvgetlocallength != NULL)
+	actual = N_VGetLocalLength(y);
+    else if (y->ops->nvgetcommunicator == NULL
+	     || N_VGetCommunicator(y) == NULL)
+	actual = N_VGetLength(y);
+
+    if (local < 0) local = actual;
+    if (local < 0)
+	caml_invalid_argument("TaskLocal.make: local_length is required "
+			      "for this nvector");
+    if (actual >= 0 && local != actual)
+	caml_invalid_argument("TaskLocal.make: local_length does not "
+			      "match the nvector");
+    if (local % Long_val(vblock) != 0)
+	caml_invalid_argument("TaskLocal.make: local_length must be a "
+			      "multiple of block_size");
+
+    if (Is_block(vbandwidths)) {
+	mu = Long_val(Field(Some_val(vbandwidths), 0));
+	ml = Long_val(Field(Some_val(vbandwidths), 1));
+    }
+
+    vr = rewrap_nlsolver(sunml_nlsolver_tasklocal(y, local,
+						  Long_val(vblock), mu, ml,
+						  Bool_val(vfull)),
+			 vcallbacks);
+#if 600 <= SUNDIALS_LIB_VERSION
+    NLSOLVER_VAL(vr)->sunctx = ML_CONTEXT(vctx);
+#endif
+    CAMLreturn (vr);
+#else
+    CAMLreturn (Val_unit);
+#endif
+}
+
+BYTE_STUB7(sunml_nlsolver_tasklocal_make)
+
+CAMLprim value sunml_nlsolver_tasklocal_get_num_setups(value vnls)
+{
+    CAMLparam1(vnls);
+#if 500 <= SUNDIALS_LIB_VERSION
+    CAMLreturn (Val_long(sunml_nlsolver_tasklocal_num_setups(
+				NLSOLVER_VAL(vnls))));
+#else
+    CAMLreturn (Val_long(0));
+#endif
+}
+
 CAMLprim value sunml_nlsolver_fixedpoint_make(value vy, value vm,
 					      value vcallbacks, value vctx)
 {
@@ -14,6 +14,7 @@
 #ifndef _NLSOLVER_ML_H__
 #define _NLSOLVER_ML_H__
 
+#include <stdio.h>
 #include <caml/mlvalues.h>
 #include "../sundials/sundials_ml.h"
 
@@ -96,6 +97,26 @@ void sunml_nlsolver_check_flag(const char *call, int flag);
 #define NLS_CHECK_FLAG(call, flag) if (flag != SUN_NLS_SUCCESS) \
 				 sunml_nlsolver_check_flag(call, flag)
 
+#if 500 <= SUNDIALS_LIB_VERSION
+// sundials_nlsolver_broyden_ml.c
+SUNNonlinearSolver sunml_nlsolver_broyden(N_Vector y, int max_vectors);
+long int sunml_nlsolver_broyden_num_restarts(SUNNonlinearSolver nls);
+void sunml_nlsolver_broyden_set_print_level(SUNNonlinearSolver nls,
+					    int print_level);
+void sunml_nlsolver_broyden_set_info_file(SUNNonlinearSolver nls, FILE *f);
+
+// sundials_nlsolver_tasklocal_ml.c
+SUNNonlinearSolver sunml_nlsolver_tasklocal(N_Vector y,
+					    sunindextype local_length,
+					    sunindextype block_size,
+					    sunindextype mu, sunindextype ml,
+					    int full_newton);
+long int sunml_nlsolver_tasklocal_num_setups(SUNNonlinearSolver nls);
+void sunml_nlsolver_tasklocal_set_print_level(SUNNonlinearSolver nls,
+					      int print_level);
+void sunml_nlsolver_tasklocal_set_info_file(SUNNonlinearSolver nls, FILE *f);
+#endif
+
 #endif
 
 enum nlsolver_callbacks_index {
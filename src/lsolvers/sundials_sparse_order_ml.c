@@ -0,0 +1,337 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Bandwidth-reducing orderings of sparse matrices.
+ *
+ * The reverse Cuthill-McKee ordering numbers the unknowns of each
+ * connected component of the graph of A + A^T by a breadth-first search
+ * that visits the neighbours of a node by increasing degree, and then
+ * reverses the whole numbering.  Each search starts from a
+ * pseudo-peripheral node found by the algorithm of Gibbs, Poole and
+ * Stockmeyer as simplified by George and Liu: starting from a node of
+ * minimum degree, repeatedly move to a node of minimum degree in the last
+ * level of a breadth-first search while this increases the number of
+ * levels.
+ *
+ * Permutations map new indices to old ones: row and column perm[i] of A
+ * become row and column i of the reordered matrix.  */
+
+#include "../config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if SUNDIALS_LIB_VERSION >= 300
+#include <sundials/sundials_matrix.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+#elif SUNDIALS_LIB_VERSION >= 260
+#include <sundials/sundials_sparse.h>
+#endif
+
+#include "../sundials/sundials_ml.h"
+#include "../lsolvers/sundials_matrix_ml.h"
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+
+/* Adjacency of A + A^T without self-loops or duplicates.  The orientation
+   of the compressed storage (CSC or CSR) does not matter.  */
+static int order_graph(sundials_ml_index n, sundials_ml_index *ptrs,
+		       sundials_ml_index *vals, sundials_ml_index **pgp,
+		       sundials_ml_index **pgi)
+{
+    sundials_ml_index i, j, k, p, *gp, *gi = NULL, *next, *mark;
+
+    gp = calloc(n + 1, sizeof(sundials_ml_index));
+    next = malloc((n + 1) * sizeof(sundials_ml_index));
+    mark = malloc((n + 1) * sizeof(sundials_ml_index));
+    if (gp == NULL || next == NULL || mark == NULL) goto fail;
+
+    for (j = 0; j < n; j++) {
+	for (k = ptrs[j]; k < ptrs[j + 1]; k++) {
+	    i = vals[k];
+	    if (i == j) continue;
+	    gp[i + 1]++;
+	    gp[j + 1]++;
+	}
+    }
+    for (j = 0; j < n; j++) gp[j + 1] += gp[j];
+
+    gi = malloc((gp[n] > 0 ? gp[n] : 1) * sizeof(sundials_ml_index));
+    if (gi == NULL) goto fail;
+
+    for (j = 0; j < n; j++) next[j] = gp[j];
+    for (j = 0; j < n; j++) {
+	for (k = ptrs[j]; k < ptrs[j + 1]; k++) {
+	    i = vals[k];
+	    if (i == j) continue;
+	    gi[next[i]++] = j;
+	    gi[next[j]++] = i;
+	}
+    }
+
+    for (j = 0; j < n; j++) mark[j] = -1;
+    p = 0;
+    for (j = 0; j < n; j++) {
+	k = gp[j];
+	gp[j] = p;
+	for (; k < next[j]; k++) {
+	    i = gi[k];
+	    if (mark[i] == j) continue;
+	    mark[i] = j;
+	    gi[p++] = i;
+	}
+    }
+    gp[n] = p;
+
+    free(next);
+    free(mark);
+    *pgp = gp;
+    *pgi = gi;
+    return 0;
+
+fail:
+    free(gp);
+    free(gi);
+    free(next);
+    free(mark);
+    return -1;
+}
+
+#define DEG(v) (gp[(v) + 1] - gp[v])
+
+/* Breadth-first search from s over the nodes with visited[v] == 0, using
+   level[] (which must be -1 for those nodes on entry and is reset on
+   exit).  Returns the number of levels and sets *last to a node of
+   minimum degree in the last level.  */
+static sundials_ml_index bfs_levels(sundials_ml_index *gp,
+				    sundials_ml_index *gi,
+				    const char *visited,
+				    sundials_ml_index *level,
+				    sundials_ml_index *queue,
+				    sundials_ml_index s,
+				    sundials_ml_index *last)
+{
+    sundials_ml_index head = 0, tail = 0, k, u, v, nlev, best;
+
+    queue[tail++] = s;
+    level[s] = 0;
+    while (head < tail) {
+	u = queue[head++];
+	for (k = gp[u]; k < gp[u + 1]; k++) {
+	    v = gi[k];
+	    if (visited[v] || level[v] >= 0) continue;
+	    level[v] = level[u] + 1;
+	    queue[tail++] = v;
+	}
+    }
+
+    nlev = level[queue[tail - 1]] + 1;
+    best = queue[tail - 1];
+    for (k = tail - 1; k >= 0 && level[queue[k]] == nlev - 1; k--)
+	if (DEG(queue[k]) < DEG(best)) best = queue[k];
+    *last = best;
+
+    for (k = 0; k < tail; k++) level[queue[k]] = -1;
+    return nlev;
+}
+
+int sunml_sparse_rcm(sundials_ml_index n, sundials_ml_index *ptrs,
+		     sundials_ml_index *vals, sundials_ml_index *perm)
+{
+    sundials_ml_index *gp = NULL, *gi = NULL;
+    sundials_ml_index *bydeg = NULL, *count = NULL, *level = NULL;
+    sundials_ml_index *queue = NULL;
+    sundials_ml_index i, j, k, s, t, u, v, w, nlev, tlev, head, tail, next;
+    char *visited = NULL;
+    int r = -1;
+
+    if (n == 0) return 0;
+    if (order_graph(n, ptrs, vals, &gp, &gi) != 0) return -1;
+
+    bydeg = malloc(n * sizeof(sundials_ml_index));
+    count = calloc(n + 1, sizeof(sundials_ml_index));
+    level = malloc(n * sizeof(sundials_ml_index));
+    queue = malloc(n * sizeof(sundials_ml_index));
+    visited = calloc(n, 1);
+    if (bydeg == NULL || count == NULL || level == NULL || queue == NULL
+	    || visited == NULL) goto cleanup;
+
+    /* nodes sorted by degree, to start each component at a minimum */
+    for (j = 0; j < n; j++) count[DEG(j) + 1]++;
+    for (j = 0; j < n; j++) count[j + 1] += count[j];
+    for (j = 0; j < n; j++) bydeg[count[DEG(j)]++] = j;
+    for (j = 0; j < n; j++) level[j] = -1;
+
+    tail = 0;
+    next = 0;
+    while (tail < n) {
+	while (visited[bydeg[next]]) next++;
+	s = bydeg[next];
+
+	nlev = bfs_levels(gp, gi, visited, level, queue, s, &t);
+	for (;;) {
+	    tlev = bfs_levels(gp, gi, visited, level, queue, t, &u);
+	    if (tlev <= nlev) break;
+	    s = t;
+	    nlev = tlev;
+	    t = u;
+	}
+
+	/* Cuthill-McKee from s */
+	head = tail;
+	perm[tail++] = s;
+	visited[s] = 1;
+	while (head < tail) {
+	    u = perm[head++];
+	    k = tail;
+	    for (i = gp[u]; i < gp[u + 1]; i++) {
+		v = gi[i];
+		if (visited[v]) continue;
+		visited[v] = 1;
+		/* insert by increasing degree */
+		for (w = tail; w > k && DEG(perm[w - 1]) > DEG(v); w--)
+		    perm[w] = perm[w - 1];
+		perm[w] = v;
+		tail++;
+	    }
+	}
+    }
+
+    for (i = 0, j = n - 1; i < j; i++, j--) {
+	k = perm[i];
+	perm[i] = perm[j];
+	perm[j] = k;
+    }
+    r = 0;
+
+cleanup:
+    free(gp);
+    free(gi);
+    free(bydeg);
+    free(count);
+    free(level);
+    free(queue);
+    free(visited);
+    return r;
+}
+
+#undef DEG
+
+void sunml_sparse_bandwidths(sundials_ml_index n, sundials_ml_index *ptrs,
+			     sundials_ml_index *vals, int csr,
+			     sundials_ml_index *iperm,
+			     sundials_ml_index *mu, sundials_ml_index *ml)
+{
+    sundials_ml_index j, k, r, c, u = 0, l = 0;
+
+    for (j = 0; j < n; j++) {
+	for (k = ptrs[j]; k < ptrs[j + 1]; k++) {
+	    r = csr ? j : vals[k];
+	    c = csr ? vals[k] : j;
+	    if (iperm != NULL) {
+		r = iperm[r];
+		c = iperm[c];
+	    }
+	    if (c - r > u) u = c - r;
+	    if (r - c > l) l = r - c;
+	}
+    }
+    *mu = u;
+    *ml = l;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Interface functions
+ */
+
+#if 300 <= SUNDIALS_LIB_VERSION
+/* Decodes an OCaml permutation (new -> old) into its inverse, or raises
+   Invalid_argument.  */
+static sundials_ml_index *inverse_perm(value vperm, sundials_ml_index n)
+{
+    sundials_ml_index i, p, *iperm;
+
+    if (Wosize_val(vperm) != n)
+	caml_invalid_argument("permutation has the wrong length");
+
+    iperm = malloc((n > 0 ? n : 1) * sizeof(sundials_ml_index));
+    if (iperm == NULL) caml_raise_out_of_memory();
+    for (i = 0; i < n; i++) iperm[i] = -1;
+
+    for (i = 0; i < n; i++) {
+	p = Long_val(Field(vperm, i));
+	if (p < 0 || p >= n || iperm[p] >= 0) {
+	    free(iperm);
+	    caml_invalid_argument("not a permutation");
+	}
+	iperm[p] = i;
+    }
+    return iperm;
+}
+#endif
+
+CAMLprim value sunml_matrix_sparse_rcm(value vcptr)
+{
+    CAMLparam1(vcptr);
+    CAMLlocal1(vr);
+#if 300 <= SUNDIALS_LIB_VERSION
+    MAT_CONTENT_SPARSE_TYPE a = MAT_CONTENT_SPARSE(vcptr);
+    sundials_ml_index i, n = a->N, *perm;
+
+    if (a->M != a->N)
+	caml_invalid_argument("matrix is not square");
+
+    perm = malloc((n > 0 ? n : 1) * sizeof(sundials_ml_index));
+    if (perm == NULL) caml_raise_out_of_memory();
+    if (sunml_sparse_rcm(n, a->indexptrs, a->indexvals, perm) != 0) {
+	free(perm);
+	caml_raise_out_of_memory();
+    }
+
+    vr = caml_alloc(n, 0);
+    for (i = 0; i < n; i++) Store_field(vr, i, Val_long(perm[i]));
+    free(perm);
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn(vr);
+}
+
+CAMLprim value sunml_matrix_sparse_bandwidths(value vcptr, value vperm)
+{
+    CAMLparam2(vcptr, vperm);
+    CAMLlocal1(vr);
+#if 300 <= SUNDIALS_LIB_VERSION
+    MAT_CONTENT_SPARSE_TYPE a = MAT_CONTENT_SPARSE(vcptr);
+    sundials_ml_index *iperm = NULL, mu, ml;
+
+    if (a->M != a->N)
+	caml_invalid_argument("matrix is not square");
+    if (Is_block(vperm))
+	iperm = inverse_perm(Some_val(vperm), a->N);
+
+    sunml_sparse_bandwidths(a->N, a->indexptrs, a->indexvals,
+			    a->sparsetype == CSR_MAT, iperm, &mu, &ml);
+    free(iperm);
+
+    vr = caml_alloc_tuple(2);
+    Store_field(vr, 0, Val_long(mu));
+    Store_field(vr, 1, Val_long(ml));
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn(vr);
+}
@@ -28,6 +28,7 @@
 #ifdef MANYVECTOR_BUILD_WITH_MPI
 #include <nvector/nvector_mpimanyvector.h>
 #include <nvector/nvector_mpiplusx.h>
+#include "../nvectors/nvector_parallel_ml.h"
 
 #define MVAPPEND(fun) fun##_MPIManyVector
 #define SUNML_NVEC(fun) sunml_nvec_##fun##_mpimany
@@ -526,6 +527,55 @@ CAMLprim value sunml_nvec_anywrap_mpiplusx(value extconstr, value payload,
 }
 #endif
 
+#ifdef MANYVECTOR_BUILD_WITH_MPI
+/* Node-aware reductions (see nvector_parallel_ml.c).  */
+CAMLprim value sunml_nvec_mpiplusx_set_hierarchical(value vx, value vv)
+{
+    CAMLparam2(vx, vv);
+#if 500 <= SUNDIALS_LIB_VERSION
+    N_Vector x = NVEC_VAL(vx);
+    N_Vector_Ops ops = x->ops;
+
+    if (Bool_val(vv)) {
+	sunml_node_reduction_install(x);
+    } else {
+	ops->nvdotprod      = MVAPPEND(N_VDotProd);
+	ops->nvmaxnorm      = MVAPPEND(N_VMaxNorm);
+	ops->nvmin          = MVAPPEND(N_VMin);
+	ops->nvwrmsnorm     = MVAPPEND(N_VWrmsNorm);
+	ops->nvwrmsnormmask = MVAPPEND(N_VWrmsNormMask);
+	ops->nvwl2norm      = MVAPPEND(N_VWL2Norm);
+	ops->nvl1norm       = MVAPPEND(N_VL1Norm);
+	ops->nvminquotient  = MVAPPEND(N_VMinQuotient);
+	if (ops->nvdotprodmulti == sunml_node_dotprodmulti)
+	    ops->nvdotprodmulti = MVAPPEND(N_VDotProdMulti);
+	if (ops->nvwrmsnormvectorarray == sunml_node_wrmsnormvectorarray)
+	    ops->nvwrmsnormvectorarray = MVAPPEND(N_VWrmsNormVectorArray);
+	if (ops->nvwrmsnormmaskvectorarray
+		== sunml_node_wrmsnormmaskvectorarray)
+	    ops->nvwrmsnormmaskvectorarray =
+		MVAPPEND(N_VWrmsNormMaskVectorArray);
+#if 600 <= SUNDIALS_LIB_VERSION
+	ops->nvdotprodmultiallreduce = N_VDotProdMultiAllReduce_MPIManyVector;
+#endif
+    }
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn (Val_unit);
+}
+
+CAMLprim value sunml_nvec_mpiplusx_is_hierarchical(value vx)
+{
+    CAMLparam1(vx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    CAMLreturn (Val_bool(sunml_node_reduction_installed(NVEC_VAL(vx))));
+#else
+    CAMLreturn (Val_false);
+#endif
+}
+#endif
+
 CAMLprim value SUNML_NVEC_OP(print_file)(value vx, value volog)
 {
     CAMLparam2(vx, volog);
@@ -631,7 +681,7 @@ CAMLprim value SUNML_NVEC_OP(wrmsnorm)(value vx, value vw)
 {
     CAMLparam2(vx, vw);
 #if 500 <= SUNDIALS_LIB_VERSION
-    sunrealtype r = MVAPPEND(N_VWrmsNorm)(NVEC_VAL(vx), NVEC_VAL(vw));
+    sunrealtype r = N_VWrmsNorm(NVEC_VAL(vx), NVEC_VAL(vw));
     CAMLreturn(caml_copy_double(r));
 #else
     CAMLreturn (Val_unit);
@@ -642,8 +692,8 @@ CAMLprim value SUNML_NVEC_OP(wrmsnormmask)(value vx, value vw, value vid)
 {
     CAMLparam3(vx, vw, vid);
 #if 500 <= SUNDIALS_LIB_VERSION
-    sunrealtype r = MVAPPEND(N_VWrmsNormMask)(NVEC_VAL(vx), NVEC_VAL(vw),
-					   NVEC_VAL(vid));
+    sunrealtype r = N_VWrmsNormMask(NVEC_VAL(vx), NVEC_VAL(vw),
+				    NVEC_VAL(vid));
     CAMLreturn(caml_copy_double(r));
 #else
     CAMLreturn (Val_unit);
@@ -655,7 +705,7 @@ CAMLprim value SUNML_NVEC_OP(dotprod)(value vx, value vy)
 {
     CAMLparam2(vx, vy);
 #if 500 <= SUNDIALS_LIB_VERSION
-    sunrealtype r = MVAPPEND(N_VDotProd)(NVEC_VAL(vx), NVEC_VAL(vy));
+    sunrealtype r = N_VDotProd(NVEC_VAL(vx), NVEC_VAL(vy));
     CAMLreturn(caml_copy_double(r));
 #else
     CAMLreturn (Val_unit);
@@ -666,7 +716,7 @@ CAMLprim value SUNML_NVEC_OP(maxnorm)(value vx)
 {
     CAMLparam1(vx);
 #if 500 <= SUNDIALS_LIB_VERSION
-    sunrealtype r = MVAPPEND(N_VMaxNorm)(NVEC_VAL(vx));
+    sunrealtype r = N_VMaxNorm(NVEC_VAL(vx));
     CAMLreturn(caml_copy_double(r));
 #else
     CAMLreturn (Val_unit);
@@ -677,7 +727,7 @@ CAMLprim value SUNML_NVEC_OP(min)(value vx)
 {
     CAMLparam1(vx);
 #if 500 <= SUNDIALS_LIB_VERSION
-    sunrealtype r = MVAPPEND(N_VMin)(NVEC_VAL(vx));
+    sunrealtype r = N_VMin(NVEC_VAL(vx));
     CAMLreturn(caml_copy_double(r));
 #else
     CAMLreturn (Val_unit);
@@ -689,7 +739,7 @@ CAMLprim value SUNML_NVEC_OP(wl2norm)(value vx, value vw)
 {
     CAMLparam2(vx, vw);
 #if 500 <= SUNDIALS_LIB_VERSION
-    sunrealtype r = MVAPPEND(N_VWL2Norm)(NVEC_VAL(vx), NVEC_VAL(vw));
+    sunrealtype r = N_VWL2Norm(NVEC_VAL(vx), NVEC_VAL(vw));
     CAMLreturn(caml_copy_double(r));
 #else
     CAMLreturn (Val_unit);
@@ -701,7 +751,7 @@ CAMLprim value SUNML_NVEC_OP(l1norm)(value vx)
 {
     CAMLparam1(vx);
 #if 500 <= SUNDIALS_LIB_VERSION
-    sunrealtype r = MVAPPEND(N_VL1Norm)(NVEC_VAL(vx));
+    sunrealtype r = N_VL1Norm(NVEC_VAL(vx));
     CAMLreturn(caml_copy_double(r));
 #else
     CAMLreturn (Val_unit);
@@ -750,7 +800,7 @@ CAMLprim value SUNML_NVEC_OP(minquotient)(value vnum, value vdenom)
 {
     CAMLparam2(vnum, vdenom);
 #if 500 <= SUNDIALS_LIB_VERSION
-    sunrealtype r = MVAPPEND(N_VMinQuotient)(NVEC_VAL(vnum), NVEC_VAL(vdenom));
+    sunrealtype r = N_VMinQuotient(NVEC_VAL(vnum), NVEC_VAL(vdenom));
     CAMLreturn(caml_copy_double(r));
 #else
     CAMLreturn (Val_unit);
@@ -833,7 +883,7 @@ CAMLprim value SUNML_NVEC_OP(dotprodmulti)(value vx, value vay, value vad)
     int nvec = sunml_arrays_of_nvectors(&ay, 1, vay);
     if (!nvec) caml_raise_out_of_memory();
 
-    MVAPPEND(N_VDotProdMulti)(nvec, x, ay, ad);
+    N_VDotProdMulti(nvec, x, ay, ad);
     free(ay);
 #endif
     CAMLreturn(Val_unit);
@@ -896,7 +946,7 @@ CAMLprim value SUNML_NVEC_OP(wrmsnormvectorarray)(value vax, value vaw,
     int nvec = sunml_arrays_of_nvectors(a, 2, vax, vaw);
     if (!nvec) caml_raise_out_of_memory();
 
-    MVAPPEND(N_VWrmsNormVectorArray)(nvec, a[0], a[1], an);
+    N_VWrmsNormVectorArray(nvec, a[0], a[1], an);
     free(*a);
 #endif
     CAMLreturn(Val_unit);
@@ -913,7 +963,7 @@ CAMLprim value SUNML_NVEC_OP(wrmsnormmaskvectorarray)(value vax, value vaw,
     int nvec = sunml_arrays_of_nvectors(a, 2, vax, vaw);
     if (!nvec) caml_raise_out_of_memory();
 
-    MVAPPEND(N_VWrmsNormMaskVectorArray)(nvec, a[0], a[1], i, an);
+    N_VWrmsNormMaskVectorArray(nvec, a[0], a[1], i, an);
     free(*a);
 #endif
     CAMLreturn(Val_unit);
@@ -1049,7 +1099,7 @@ CAMLprim value SUNML_NVEC_OP(dotprodmultiallreduce)(value vx, value vd)
     sunrealtype *d = REAL_ARRAY(vd);
     int nvec_total = ARRAY1_LEN(vd);
 
-    MVAPPEND(N_VDotProdMultiAllReduce)(nvec_total, NVEC_VAL(vx), d);
+    N_VDotProdMultiAllReduce(nvec_total, NVEC_VAL(vx), d);
 #endif
     CAMLreturn(Val_unit);
 }
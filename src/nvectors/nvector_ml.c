@@ -3431,3 +3431,105 @@ CAMLprim value sunml_nvec_dotprodmultiallreduce(value vx, value vd)
     CAMLreturn(Val_unit);
 }
 
+
+/* Reproducible reductions.
+ *
+ * Sums are taken over fixed chunks of SUNML_REPRO_CHUNK elements, each
+ * added in index order, and the chunk sums are combined pairwise in a
+ * fixed tree: a binary counter merges two partial sums whenever they cover
+ * blocks of the same number of chunks.  Threads only choose which chunks
+ * they compute, so the result is the same for any number of threads.  */
+
+void sunml_repro_init(struct sunml_repro *acc)
+{
+    acc->levels = 0;
+}
+
+void sunml_repro_add(struct sunml_repro *acc, sunrealtype v)
+{
+    int k = 0;
+
+    while (acc->levels & (1u << k)) {
+	v = acc->sum[k] + v;
+	acc->levels &= ~(1u << k);
+	k++;
+    }
+    acc->sum[k] = v;
+    acc->levels |= (1u << k);
+}
+
+sunrealtype sunml_repro_result(struct sunml_repro *acc)
+{
+    int k, first = 1;
+    sunrealtype r = 0.0;
+
+    for (k = 0; k < SUNML_REPRO_LEVELS; k++) {
+	if (!(acc->levels & (1u << k))) continue;
+	r = first ? acc->sum[k] : acc->sum[k] + r;
+	first = 0;
+    }
+    return r;
+}
+
+sunrealtype sunml_repro_chunk(enum sunml_repro_op op,
+			      sundials_ml_index lo, sundials_ml_index hi,
+			      sunrealtype *x, sunrealtype *y, sunrealtype *id)
+{
+    sundials_ml_index i;
+    sunrealtype s = 0.0, p;
+
+    switch (op) {
+    case SUNML_REPRO_DOT:
+	for (i = lo; i < hi; i++) s += x[i] * y[i];
+	break;
+    case SUNML_REPRO_WSQR:
+	for (i = lo; i < hi; i++) {
+	    p = x[i] * y[i];
+	    s += p * p;
+	}
+	break;
+    case SUNML_REPRO_WSQRMASK:
+	for (i = lo; i < hi; i++) {
+	    if (id[i] > 0.0) {
+		p = x[i] * y[i];
+		s += p * p;
+	    }
+	}
+	break;
+    case SUNML_REPRO_L1:
+	for (i = lo; i < hi; i++) s += fabs(x[i]);
+	break;
+    }
+    return s;
+}
+
+sundials_ml_index sunml_repro_nchunks(sundials_ml_index n)
+{
+    return (n + SUNML_REPRO_CHUNK - 1) / SUNML_REPRO_CHUNK;
+}
+
+sunrealtype sunml_repro_reduce(enum sunml_repro_op op, sundials_ml_index n,
+			       sunrealtype *x, sunrealtype *y, sunrealtype *id)
+{
+    struct sunml_repro acc;
+    sundials_ml_index lo, hi;
+
+    sunml_repro_init(&acc);
+    for (lo = 0; lo < n; lo = hi) {
+	hi = (n - lo > SUNML_REPRO_CHUNK) ? lo + SUNML_REPRO_CHUNK : n;
+	sunml_repro_add(&acc, sunml_repro_chunk(op, lo, hi, x, y, id));
+    }
+    return sunml_repro_result(&acc);
+}
+
+sunrealtype sunml_repro_combine(sunrealtype *partial,
+				sundials_ml_index nchunks)
+{
+    struct sunml_repro acc;
+    sundials_ml_index c;
+
+    sunml_repro_init(&acc);
+    for (c = 0; c < nchunks; c++)
+	sunml_repro_add(&acc, partial[c]);
+    return sunml_repro_result(&acc);
+}
@@ -264,6 +264,36 @@ void sunml_arrays_of_nvectors2(int* nrows, int *ncols, N_Vector **vv[], int n, .
 N_Vector *sunml_nvector_array_alloc(value vtable);
 void sunml_nvector_array_free(N_Vector *nvarr);
 
+/* Reproducible reductions (see nvector_ml.c), shared by the OpenMP and
+   Pthreads nvectors.  Elements [lo, hi) of a chunk are summed in order. */
+#define SUNML_REPRO_CHUNK  4096
+#define SUNML_REPRO_LEVELS 32
+
+enum sunml_repro_op {
+    SUNML_REPRO_DOT,		/* sum x[i] * y[i] */
+    SUNML_REPRO_WSQR,		/* sum (x[i] * y[i])^2 */
+    SUNML_REPRO_WSQRMASK,	/* sum (x[i] * y[i])^2 where id[i] > 0 */
+    SUNML_REPRO_L1,		/* sum |x[i]| */
+};
+
+struct sunml_repro {
+    unsigned int levels;
+    sunrealtype sum[SUNML_REPRO_LEVELS];
+};
+
+void sunml_repro_init(struct sunml_repro *acc);
+void sunml_repro_add(struct sunml_repro *acc, sunrealtype v);
+sunrealtype sunml_repro_result(struct sunml_repro *acc);
+
+sundials_ml_index sunml_repro_nchunks(sundials_ml_index n);
+sunrealtype sunml_repro_chunk(enum sunml_repro_op op,
+			      sundials_ml_index lo, sundials_ml_index hi,
+			      sunrealtype *x, sunrealtype *y, sunrealtype *id);
+sunrealtype sunml_repro_combine(sunrealtype *partial,
+				sundials_ml_index nchunks);
+sunrealtype sunml_repro_reduce(enum sunml_repro_op op, sundials_ml_index n,
+			       sunrealtype *x, sunrealtype *y, sunrealtype *id);
+
 // Creation functions
 value ml_nvec_wrap_serial(value payload, value checkfn);
 value ml_nvec_wrap_custom(value mlops, value payload, value checkfn);
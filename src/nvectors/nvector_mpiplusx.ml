@@ -53,6 +53,12 @@ external c_enablewrmsnormvectorarray_manyvector     : ('d, 'k) Nvector.t -> bool
 external c_enablewrmsnormmaskvectorarray_manyvector : ('d, 'k) Nvector.t -> bool -> unit
   = "sunml_nvec_mpimany_enablewrmsnormmaskvectorarray"
 
+(* Node-aware reductions (see Nvector_parallel.init_hierarchical) *)
+external c_set_hierarchical : ('d, 'k) Nvector.t -> bool -> unit
+  = "sunml_nvec_mpiplusx_set_hierarchical"
+external c_is_hierarchical : ('d, 'k) Nvector.t -> bool
+  = "sunml_nvec_mpiplusx_is_hierarchical"
+
 let subvector_mpi_rank nv =
   match Nvector_parallel.get_communicator nv with
   | None -> 0
@@ -79,10 +85,15 @@ let rec wrap ?context ?(with_fused_ops=false) comm nv =
 
 and clone mnv =
   let nv, comm = unwrap mnv in
-  wrap ~context:(Nvector.context mnv) comm (Nvector.clone nv)
+  let mnv' = wrap ~context:(Nvector.context mnv) comm (Nvector.clone nv) in
+  if c_is_hierarchical mnv then c_set_hierarchical mnv' true;
+  mnv'
 
 let communicator nv = snd (Nvector.unwrap nv)
 
+let set_hierarchical (nv : t) b = c_set_hierarchical nv b
+let is_hierarchical (nv : t) = c_is_hierarchical nv
+
 let do_enable f nv v =
   match v with
   | None -> ()
@@ -116,7 +127,8 @@ let enable
     do_enable c_enablewrmsnormvectorarray_manyvector nv
               with_wrms_norm_vector_array;
     do_enable c_enablewrmsnormmaskvectorarray_manyvector nv
-              with_wrms_norm_mask_vector_array
+              with_wrms_norm_mask_vector_array;
+    if c_is_hierarchical nv then c_set_hierarchical nv true
 
 module Ops : Nvector.NVECTOR_OPS with type t = t =
 struct (* {{{ *)
@@ -702,7 +714,9 @@ module Any = struct (* {{{ *)
                    | MpiPlusX v -> v
                    | _ -> assert false
     in
-    wrap ~context:(Nvector.context mnv) comm (Nvector.clone nv)
+    let mnv' = wrap ~context:(Nvector.context mnv) comm (Nvector.clone nv) in
+    if c_is_hierarchical mnv then c_set_hierarchical mnv' true;
+    mnv'
 
   let unwrap nv =
     match Nvector.unwrap nv with
@@ -741,7 +755,16 @@ module Any = struct (* {{{ *)
       do_enable c_enablewrmsnormvectorarray_manyvector nv
                 with_wrms_norm_vector_array;
       do_enable c_enablewrmsnormmaskvectorarray_manyvector nv
-                with_wrms_norm_mask_vector_array
+                with_wrms_norm_mask_vector_array;
+      if c_is_hierarchical nv then c_set_hierarchical nv true
+
+  let check_id nv =
+    match Nvector.get_id nv with
+    | Nvector.MpiPlusX | Nvector.MpiManyVector -> ()
+    | _ -> raise Nvector.BadGenericType
+
+  let set_hierarchical nv b = check_id nv; c_set_hierarchical nv b
+  let is_hierarchical nv = check_id nv; c_is_hierarchical nv
 
 end (* }}} *)
 
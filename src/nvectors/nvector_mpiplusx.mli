@@ -80,6 +80,23 @@ val enable :
   -> t
   -> unit
 
+(** Selects node-aware reductions for an mpiplusx nvector and its clones.
+    The local parts of the dot product, the norms, [min], [minquotient],
+    and the enabled multiple dot product and norm array operations are
+    reduced through the node reducer of the nvector's communicator, as for
+    {!Nvector_parallel.set_hierarchical}. Passing [false] restores the
+    Sundials operations.
+
+    All ranks must make the same choice.
+
+    @raise Config.NotImplementedBySundialsVersion Local reduction operations not available.
+    @since 5.0.0 *)
+val set_hierarchical : t -> bool -> unit
+
+(** Returns true if node-aware reductions are selected.
+    See {!set_hierarchical}. *)
+val is_hierarchical : t -> bool
+
 (** Underlying nvector operations on mpiplusx nvectors. *)
 module Ops : Nvector.NVECTOR_OPS with type t = t
 
@@ -137,5 +154,16 @@ module Any : sig
     -> ?with_wrms_norm_mask_vector_array     : bool
     -> Nvector.any
     -> unit
+
+  (** Selects node-aware reductions.
+      See {!Nvector_mpiplusx.set_hierarchical}.
+
+      @raise Nvector.BadGenericType If not called on an mpiplusx nvector *)
+  val set_hierarchical : Nvector.any -> bool -> unit
+
+  (** Returns true if node-aware reductions are selected.
+
+      @raise Nvector.BadGenericType If not called on an mpiplusx nvector *)
+  val is_hierarchical : Nvector.any -> bool
 end
 
@@ -23,6 +23,9 @@
 #include <caml/fail.h>
 #include <caml/bigarray.h>
 
+#include <math.h>
+#include <stdlib.h>
+
 #include <nvector/nvector_openmp.h>
 
 /* Adapted from sundials-2.6.1/src/nvec_pthreads/nvector_openmp.c:
@@ -303,6 +306,173 @@ CAMLprim value sunml_nvec_openmp_num_threads(value va)
     CAMLreturn(Val_int(num_threads));
 }
 
+/* Reproducible reductions (see nvector_ml.c).  The chunk sums are
+   computed by a parallel loop and always combined in the same order.  */
+static sunrealtype repro_reduce_openmp(enum sunml_repro_op op,
+				       N_Vector x, N_Vector y, N_Vector id)
+{
+    sundials_ml_index c, n = NV_LENGTH_OMP(x);
+    sundials_ml_index nchunks = sunml_repro_nchunks(n);
+    int nthreads = NV_NUM_THREADS_OMP(x);
+    sunrealtype *xd = NV_DATA_OMP(x);
+    sunrealtype *yd = (y == NULL) ? NULL : NV_DATA_OMP(y);
+    sunrealtype *idd = (id == NULL) ? NULL : NV_DATA_OMP(id);
+    sunrealtype *partial, r;
+
+    if (nthreads <= 1 || nchunks <= 1
+	    || (partial = malloc(nchunks * sizeof(sunrealtype))) == NULL)
+	return sunml_repro_reduce(op, n, xd, yd, idd);
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (c = 0; c < nchunks; c++) {
+	sundials_ml_index lo = c * SUNML_REPRO_CHUNK;
+	sundials_ml_index hi = (n - lo > SUNML_REPRO_CHUNK)
+				? lo + SUNML_REPRO_CHUNK : n;
+	partial[c] = sunml_repro_chunk(op, lo, hi, xd, yd, idd);
+    }
+
+    r = sunml_repro_combine(partial, nchunks);
+    free(partial);
+    return r;
+}
+
+static sunrealtype repro_dotprod_openmp(N_Vector x, N_Vector y)
+{
+    return repro_reduce_openmp(SUNML_REPRO_DOT, x, y, NULL);
+}
+
+static sunrealtype repro_wrmsnorm_openmp(N_Vector x, N_Vector w)
+{
+    return sqrt(repro_reduce_openmp(SUNML_REPRO_WSQR, x, w, NULL)
+		/ NV_LENGTH_OMP(x));
+}
+
+static sunrealtype repro_wrmsnormmask_openmp(N_Vector x, N_Vector w,
+					     N_Vector id)
+{
+    return sqrt(repro_reduce_openmp(SUNML_REPRO_WSQRMASK, x, w, id)
+		/ NV_LENGTH_OMP(x));
+}
+
+static sunrealtype repro_wl2norm_openmp(N_Vector x, N_Vector w)
+{
+    return sqrt(repro_reduce_openmp(SUNML_REPRO_WSQR, x, w, NULL));
+}
+
+static sunrealtype repro_l1norm_openmp(N_Vector x)
+{
+    return repro_reduce_openmp(SUNML_REPRO_L1, x, NULL, NULL);
+}
+
+#if 500 <= SUNDIALS_LIB_VERSION
+static sunrealtype repro_wsqrsum_openmp(N_Vector x, N_Vector w)
+{
+    return repro_reduce_openmp(SUNML_REPRO_WSQR, x, w, NULL);
+}
+
+static sunrealtype repro_wsqrsummask_openmp(N_Vector x, N_Vector w,
+					    N_Vector id)
+{
+    return repro_reduce_openmp(SUNML_REPRO_WSQRMASK, x, w, id);
+}
+#endif
+
+#if 400 <= SUNDIALS_LIB_VERSION
+static int repro_dotprodmulti_openmp(int nvec, N_Vector x, N_Vector *y,
+				     sunrealtype *d)
+{
+    int j;
+    for (j = 0; j < nvec; j++) d[j] = repro_dotprod_openmp(x, y[j]);
+    return 0;
+}
+
+static int repro_wrmsnormvectorarray_openmp(int nvec, N_Vector *x,
+					    N_Vector *w, sunrealtype *nrm)
+{
+    int j;
+    for (j = 0; j < nvec; j++) nrm[j] = repro_wrmsnorm_openmp(x[j], w[j]);
+    return 0;
+}
+
+static int repro_wrmsnormmaskvectorarray_openmp(int nvec, N_Vector *x,
+						N_Vector *w, N_Vector id,
+						sunrealtype *nrm)
+{
+    int j;
+    for (j = 0; j < nvec; j++)
+	nrm[j] = repro_wrmsnormmask_openmp(x[j], w[j], id);
+    return 0;
+}
+#endif
+
+/* The optional fused and array reductions are only replaced if enabled. */
+CAMLprim value sunml_nvec_openmp_set_reproducible(value vx, value vv)
+{
+    CAMLparam2(vx, vv);
+    N_Vector_Ops ops = NVEC_VAL(vx)->ops;
+
+    if (Bool_val(vv)) {
+	ops->nvdotprod      = repro_dotprod_openmp;
+	ops->nvwrmsnorm     = repro_wrmsnorm_openmp;
+	ops->nvwrmsnormmask = repro_wrmsnormmask_openmp;
+	ops->nvwl2norm      = repro_wl2norm_openmp;
+	ops->nvl1norm       = repro_l1norm_openmp;
+#if 400 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmulti != NULL)
+	    ops->nvdotprodmulti = repro_dotprodmulti_openmp;
+	if (ops->nvwrmsnormvectorarray != NULL)
+	    ops->nvwrmsnormvectorarray = repro_wrmsnormvectorarray_openmp;
+	if (ops->nvwrmsnormmaskvectorarray != NULL)
+	    ops->nvwrmsnormmaskvectorarray =
+		repro_wrmsnormmaskvectorarray_openmp;
+#endif
+#if 500 <= SUNDIALS_LIB_VERSION
+	ops->nvdotprodlocal     = repro_dotprod_openmp;
+	ops->nvl1normlocal      = repro_l1norm_openmp;
+	ops->nvwsqrsumlocal     = repro_wsqrsum_openmp;
+	ops->nvwsqrsummasklocal = repro_wsqrsummask_openmp;
+#endif
+#if 600 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmultilocal != NULL)
+	    ops->nvdotprodmultilocal = repro_dotprodmulti_openmp;
+#endif
+    } else {
+	ops->nvdotprod      = N_VDotProd_OpenMP;
+	ops->nvwrmsnorm     = N_VWrmsNorm_OpenMP;
+	ops->nvwrmsnormmask = N_VWrmsNormMask_OpenMP;
+	ops->nvwl2norm      = N_VWL2Norm_OpenMP;
+	ops->nvl1norm       = N_VL1Norm_OpenMP;
+#if 400 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmulti == repro_dotprodmulti_openmp)
+	    ops->nvdotprodmulti = N_VDotProdMulti_OpenMP;
+	if (ops->nvwrmsnormvectorarray == repro_wrmsnormvectorarray_openmp)
+	    ops->nvwrmsnormvectorarray = N_VWrmsNormVectorArray_OpenMP;
+	if (ops->nvwrmsnormmaskvectorarray
+		== repro_wrmsnormmaskvectorarray_openmp)
+	    ops->nvwrmsnormmaskvectorarray = N_VWrmsNormMaskVectorArray_OpenMP;
+#endif
+#if 500 <= SUNDIALS_LIB_VERSION
+	ops->nvdotprodlocal     = N_VDotProd_OpenMP;
+	ops->nvl1normlocal      = N_VL1Norm_OpenMP;
+	ops->nvwsqrsumlocal     = N_VWSqrSumLocal_OpenMP;
+	ops->nvwsqrsummasklocal = N_VWSqrSumMaskLocal_OpenMP;
+#endif
+#if 600 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmultilocal == repro_dotprodmulti_openmp)
+	    ops->nvdotprodmultilocal = N_VDotProdMulti_OpenMP;
+#endif
+    }
+
+    CAMLreturn (Val_unit);
+}
+
+CAMLprim value sunml_nvec_openmp_is_reproducible(value vx)
+{
+    CAMLparam1(vx);
+    CAMLreturn (Val_bool(NVEC_VAL(vx)->ops->nvdotprod
+			 == repro_dotprod_openmp));
+}
+
 CAMLprim value sunml_nvec_openmp_print_file(value vx, value volog)
 {
     CAMLparam2(vx, volog);
@@ -411,7 +581,7 @@ CAMLprim value sunml_nvec_openmp_dotprod(value vx, value vy)
     N_Vector x = NVEC_VAL(vx);
     N_Vector y = NVEC_VAL(vy);
 
-    sunrealtype r = N_VDotProd_OpenMP(x, y);
+    sunrealtype r = N_VDotProd(x, y);
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -428,7 +598,7 @@ CAMLprim value sunml_nvec_openmp_wrmsnorm(value vx, value vw)
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
 
-    sunrealtype r = N_VWrmsNorm_OpenMP(x, w);
+    sunrealtype r = N_VWrmsNorm(x, w);
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -439,7 +609,7 @@ CAMLprim value sunml_nvec_openmp_wrmsnormmask(value vx, value vw, value vid)
     N_Vector w = NVEC_VAL(vw);
     N_Vector id = NVEC_VAL(vid);
 
-    sunrealtype r = N_VWrmsNormMask_OpenMP(x, w, id);
+    sunrealtype r = N_VWrmsNormMask(x, w, id);
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -456,14 +626,14 @@ CAMLprim value sunml_nvec_openmp_wl2norm(value vx, value vw)
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
 
-    sunrealtype r = N_VWL2Norm_OpenMP(x, w);
+    sunrealtype r = N_VWL2Norm(x, w);
     CAMLreturn(caml_copy_double(r));
 }
 
 CAMLprim value sunml_nvec_openmp_l1norm(value vx)
 {
     CAMLparam1(vx);
-    sunrealtype r = N_VL1Norm_OpenMP(NVEC_VAL(vx));
+    sunrealtype r = N_VL1Norm(NVEC_VAL(vx));
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -739,7 +909,7 @@ CAMLprim value sunml_nvec_openmp_wsqrsumlocal(value vx, value vw)
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
 
-    r = N_VWSqrSumLocal_OpenMP(x, w);
+    r = N_VWSqrSumLocal(x, w);
 
 #else
     caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
@@ -758,7 +928,7 @@ CAMLprim value sunml_nvec_openmp_wsqrsummasklocal(value vx, value vw, value vid)
     N_Vector w = NVEC_VAL(vw);
     N_Vector id = NVEC_VAL(vid);
 
-    r = N_VWSqrSumMaskLocal_OpenMP(x, w, id);
+    r = N_VWSqrSumMaskLocal(x, w, id);
 #else
     caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
 #endif
@@ -42,6 +42,12 @@ external c_enablelinearcombinationvectorarray_parallel : ('d, 'k) Nvector.t -> b
 external c_enabledotprodmultilocal_parallel            : ('d, 'k) Nvector.t -> bool -> unit
   = "sunml_nvec_par_enabledotprodmultilocal"
 
+(* Node-aware reductions *)
+external c_set_hierarchical : ('d, 'k) Nvector.t -> bool -> unit
+  = "sunml_nvec_par_set_hierarchical"
+external c_is_hierarchical : ('d, 'k) Nvector.t -> bool
+  = "sunml_nvec_par_is_hierarchical"
+
 let unwrap = Nvector.unwrap
 
 let copydata (a, ng, comm) = (RealArray.copy a, ng, comm)
@@ -82,6 +88,7 @@ and clone nv =
     c_enablelinearcombinationvectorarray_parallel nv'
       (Nvector.Ops.has_linearcombinationvectorarray nv)
   end;
+  if c_is_hierarchical nv then c_set_hierarchical nv' true;
   nv'
 
 let make ?context ?with_fused_ops nl ng comm iv =
@@ -89,7 +96,11 @@ let make ?context ?with_fused_ops nl ng comm iv =
 
 let clone nv =
   let loc, glen, comm = Nvector.unwrap nv in
-  wrap ~context:(Nvector.context nv) (RealArray.copy loc, glen, comm)
+  let nv' =
+    wrap ~context:(Nvector.context nv) (RealArray.copy loc, glen, comm)
+  in
+  if c_is_hierarchical nv then c_set_hierarchical nv' true;
+  nv'
 
 let pp fmt nv =
   let data, _, _ = Nvector.unwrap nv in
@@ -112,6 +123,22 @@ let communicator nv =
 external get_communicator : ('d, 'k) Nvector.t -> Mpi.communicator option
   = "sunml_nvec_par_getcommunicator"
 
+external c_init_hierarchical : Mpi.communicator -> int -> int * int
+  = "sunml_nvector_parallel_init_hierarchical"
+
+let init_hierarchical ?(capacity=64) comm =
+  if capacity < 1 then invalid_arg "capacity must be positive";
+  c_init_hierarchical comm capacity
+
+external free_hierarchical : Mpi.communicator -> unit
+  = "sunml_nvector_parallel_free_hierarchical"
+
+external num_hierarchical_reductions : Mpi.communicator -> int
+  = "sunml_nvector_parallel_num_hierarchical"
+
+let set_hierarchical (nv : t) b = c_set_hierarchical nv b
+let is_hierarchical (nv : t) = c_is_hierarchical nv
+
 let do_enable f nv v =
   match v with
   | None -> ()
@@ -154,7 +181,8 @@ let enable
     do_enable c_enablelinearcombinationvectorarray_parallel nv
               with_linear_combination_vector_array;
     do_enable c_enabledotprodmultilocal_parallel nv
-              with_dot_prod_multi_local
+              with_dot_prod_multi_local;
+    if c_is_hierarchical nv then c_set_hierarchical nv true
 
 external hide_communicator
   : Mpi.communicator -> Nvector_custom.communicator
@@ -255,6 +283,7 @@ module Any = struct (* {{{ *)
       (Nvector.Ops.has_linearcombinationvectorarray nv);
     c_enabledotprodmultilocal_parallel nv'
       (Nvector.Ops.Local.has_dotprodmulti nv);
+    if c_is_hierarchical nv then c_set_hierarchical nv' true;
     nv'
 
   let make
@@ -332,7 +361,16 @@ module Any = struct (* {{{ *)
       do_enable c_enablelinearcombinationvectorarray_parallel nv
                 with_linear_combination_vector_array;
       do_enable c_enabledotprodmultilocal_parallel nv
-                with_dot_prod_multi_local
+                with_dot_prod_multi_local;
+      if c_is_hierarchical nv then c_set_hierarchical nv true
+
+  let set_hierarchical nv b =
+    if Nvector.get_id nv <> Nvector.Parallel then raise Nvector.BadGenericType;
+    c_set_hierarchical nv b
+
+  let is_hierarchical nv =
+    if Nvector.get_id nv <> Nvector.Parallel then raise Nvector.BadGenericType;
+    c_is_hierarchical nv
 
 end (* }}} *)
 
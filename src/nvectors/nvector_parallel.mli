@@ -135,6 +135,59 @@ val enable :
   -> t
   -> unit
 
+(** {2:hierarchical Node-aware reductions}
+
+    By default, every reduction of a parallel nvector calls
+    [MPI_Allreduce] on its communicator. When many ranks share a node,
+    it can be faster to first combine the values of each node in shared
+    memory and only exchange messages between one leader per node. *)
+
+(** [init_hierarchical comm] prepares node-aware reductions over [comm].
+    The communicator is split into the ranks that share memory and a
+    communicator of node leaders, and each node allocates an MPI-3
+    shared-memory window. Reductions over [comm] of at most [capacity]
+    values (default: 64) then go through the window; larger ones still use
+    [MPI_Allreduce]. Returns the number of ranks on the calling node and
+    the number of nodes.
+
+    The reducer also serves the communicators that are congruent to
+    [comm], like those duplicated from it, and all ranks must then make
+    their reductions over [comm] and its copies in the same order.
+
+    This function is collective over [comm]. Calling it again for the same
+    communicator has no effect.
+
+    @raise Config.NotImplementedBySundialsVersion MPI-3 is not available. *)
+val init_hierarchical : ?capacity:int -> Mpi.communicator -> int * int
+
+(** Releases the resources allocated by {!init_hierarchical}. Later
+    reductions over the communicator use [MPI_Allreduce]. This function is
+    collective and must be called before [MPI_Finalize]. *)
+val free_hierarchical : Mpi.communicator -> unit
+
+(** Returns the number of reductions that went through the node reducer
+    of a communicator, or of a congruent one like the copy kept by an
+    {!Nvector_mpiplusx}, since {!init_hierarchical}. Returns 0 if there is
+    no such reducer. *)
+val num_hierarchical_reductions : Mpi.communicator -> int
+
+(** Selects node-aware reductions for a parallel nvector and its clones.
+    The dot product, the norms, [min], [minquotient], and the enabled
+    multiple dot product and norm array operations then compute their local
+    parts and reduce them through the node reducer of the nvector's
+    communicator (see {!init_hierarchical}), or through [MPI_Allreduce] if
+    there is none. Passing [false] restores the Sundials operations.
+
+    All ranks must make the same choice.
+
+    @raise Config.NotImplementedBySundialsVersion Local reduction operations not available.
+    @since 5.0.0 *)
+val set_hierarchical : t -> bool -> unit
+
+(** Returns true if node-aware reductions are selected.
+    See {!set_hierarchical}. *)
+val is_hierarchical : t -> bool
+
 (** Produce a set of parallel {!Nvector.NVECTOR_OPS} from basic
     operations on an underlying array. *)
 module MakeOps : functor (A : sig
@@ -277,5 +330,17 @@ module Any : sig (* {{{ *)
     -> Nvector.any
     -> unit
 
+  (** Selects node-aware reductions.
+      See {!Nvector_parallel.set_hierarchical}.
+
+      @raise Nvector.BadGenericType If not called on a parallel nvector
+      @raise Config.NotImplementedBySundialsVersion Local reduction operations not available. *)
+  val set_hierarchical : Nvector.any -> bool -> unit
+
+  (** Returns true if node-aware reductions are selected.
+
+      @raise Nvector.BadGenericType If not called on a parallel nvector *)
+  val is_hierarchical : Nvector.any -> bool
+
 end (* }}} *)
 
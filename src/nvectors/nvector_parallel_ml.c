@@ -14,6 +14,7 @@
 #include "../sundials/sundials_ml.h"
 #include "../nvectors/nvector_ml.h"
 #include "../nvectors/nvector_parallel_ml.h"
+#include "../lsolvers/sundials_linearsolver_ml.h"
 
 #include <caml/mlvalues.h>
 #include <caml/alloc.h>
@@ -23,6 +24,11 @@
 #include <caml/fail.h>
 #include <caml/bigarray.h>
 
+#include <math.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <nvector/nvector_parallel.h>
 
 /* Must correspond with camlmpi.h */
@@ -44,10 +50,409 @@ CAMLprim value sunml_nvector_parallel_compare_comms(value v1, value v2)
 
 /** Parallel nvectors * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#if 600 <= SUNDIALS_LIB_VERSION
+/* Nonblocking reductions for the pipelined linear solvers
+   (lsolvers/sundials_lsolver_pipelined_ml.c).  */
+
+static int pipelined_reduction_start(N_Vector x, sunrealtype *buf, int n,
+				     void **request)
+{
+    MPI_Comm *comm = (MPI_Comm *)N_VGetCommunicator(x);
+    MPI_Request *req;
+
+    *request = NULL;
+    if (comm == NULL) return -1;
+
+    req = (MPI_Request *)malloc(sizeof(MPI_Request));
+    if (req == NULL) return -1;
+
+    if (MPI_Iallreduce(MPI_IN_PLACE, buf, n, MPI_SUNREALTYPE, MPI_SUM,
+		       *comm, req) != MPI_SUCCESS) {
+	free(req);
+	return -1;
+    }
+
+    *request = req;
+    return 0;
+}
+
+static int pipelined_reduction_finish(void *request)
+{
+    MPI_Request *req = (MPI_Request *)request;
+    int r = MPI_Wait(req, MPI_STATUS_IGNORE);
+
+    free(req);
+    return (r == MPI_SUCCESS) ? 0 : -1;
+}
+#endif
+
+/* Node-aware reductions.
+
+   A node reducer splits a communicator into the ranks that share memory
+   and a communicator of node leaders (the first rank of each node).  The
+   node allocates an MPI-3 shared window with one slot per rank and one for
+   the result.  Each rank copies its values into its slot and then stamps
+   the slot with the number of the reduction; the leader waits for every
+   stamp, combines the slots in rank order, reduces across the leaders,
+   writes the result and whether that reduction failed, and stamps it; the
+   other ranks wait for that stamp and copy the result and the error out,
+   so that a failure is seen by every rank.  A rank only stamps its slot for the next reduction
+   after copying the result, and the leader only overwrites the result
+   after seeing all of those stamps, so no barriers are needed.
+
+   Reducers are kept in a list indexed by the communicator given to
+   init_hierarchical.  A reduction uses the reducer of a communicator that
+   is identical or congruent (same group, same rank order) to its own, so
+   that MPI_Comm_dup copies, like the one that MPIManyVector keeps, share
+   the reducer of their original.  Communicators without one, and
+   reductions larger than the capacity of the window, use MPI_Allreduce
+   directly.  */
+
+/* Stamps are kept a cache line apart.  */
+#define NODE_STAMP_STRIDE 16
+
+#define NODE_ERROR(r) ((r)->stamps[((r)->node_size + 1) * NODE_STAMP_STRIDE])
+
+struct node_reducer {
+    MPI_Comm comm;
+    MPI_Comm node;
+    MPI_Comm leaders;
+    MPI_Win win;
+    volatile long *stamps;  /* node_size + 1 stamps, the last for the result,
+			       then the error flag of the result */
+    sunrealtype *slots;	    /* node_size + 1 slots of capacity values */
+    long round;
+    long count;		    /* reductions through the window */
+    int node_rank;
+    int node_size;
+    int num_nodes;
+    int capacity;
+    struct node_reducer *next;
+};
+
+static struct node_reducer *node_reducers = NULL;
+
+static struct node_reducer *find_node_reducer(MPI_Comm comm)
+{
+    struct node_reducer *r;
+    int result;
+
+    for (r = node_reducers; r != NULL; r = r->next)
+	if (r->comm == comm) return r;
+    for (r = node_reducers; r != NULL; r = r->next)
+	if (MPI_Comm_compare(r->comm, comm, &result) == MPI_SUCCESS
+		&& (result == MPI_IDENT || result == MPI_CONGRUENT))
+	    return r;
+    return NULL;
+}
+
+#if 3 <= MPI_VERSION
+static void node_combine(MPI_Op op, sunrealtype *acc, sunrealtype *v, int n)
+{
+    int i;
+
+    if (op == MPI_MAX) {
+	for (i = 0; i < n; i++) if (v[i] > acc[i]) acc[i] = v[i];
+    } else if (op == MPI_MIN) {
+	for (i = 0; i < n; i++) if (v[i] < acc[i]) acc[i] = v[i];
+    } else {
+	for (i = 0; i < n; i++) acc[i] += v[i];
+    }
+}
+
+static void node_wait(struct node_reducer *r, int k)
+{
+    while (r->stamps[k * NODE_STAMP_STRIDE] != r->round) {
+	sched_yield();
+	MPI_Win_sync(r->win);
+    }
+    MPI_Win_sync(r->win);
+}
+
+static void node_stamp(struct node_reducer *r, int k)
+{
+    MPI_Win_sync(r->win);
+    r->stamps[k * NODE_STAMP_STRIDE] = r->round;
+    MPI_Win_sync(r->win);
+}
+#endif
+
+int sunml_node_allreduce(MPI_Comm comm, sunrealtype *buf, int n, MPI_Op op)
+{
+#if 3 <= MPI_VERSION
+    struct node_reducer *r = find_node_reducer(comm);
+    sunrealtype *result;
+    int k, err = 0;
+
+    if (r != NULL && n <= r->capacity) {
+	result = r->slots + r->node_size * r->capacity;
+	r->round++;
+	r->count++;
+
+	memcpy(r->slots + r->node_rank * r->capacity, buf,
+	       n * sizeof(sunrealtype));
+	if (r->node_rank != 0) {
+	    node_stamp(r, r->node_rank);
+	    node_wait(r, r->node_size);
+	    err = (int)NODE_ERROR(r);
+	} else {
+	    /* all the stamps must be seen before the previous result is
+	       overwritten */
+	    for (k = 1; k < r->node_size; k++) node_wait(r, k);
+	    memcpy(result, r->slots, n * sizeof(sunrealtype));
+	    for (k = 1; k < r->node_size; k++)
+		node_combine(op, result, r->slots + k * r->capacity, n);
+	    if (r->num_nodes > 1)
+		err = MPI_Allreduce(MPI_IN_PLACE, result, n, MPI_SUNREALTYPE,
+				    op, r->leaders) != MPI_SUCCESS;
+	    /* the other ranks must not be left waiting, even on an error */
+	    NODE_ERROR(r) = err;
+	    node_stamp(r, r->node_size);
+	}
+
+	memcpy(buf, result, n * sizeof(sunrealtype));
+	return err ? -1 : 0;
+    }
+#endif
+
+    return (MPI_Allreduce(MPI_IN_PLACE, buf, n, MPI_SUNREALTYPE, op, comm)
+	    == MPI_SUCCESS) ? 0 : -1;
+}
+
+CAMLprim value sunml_nvector_parallel_init_hierarchical(value vcomm,
+							 value vcapacity)
+{
+    CAMLparam2(vcomm, vcapacity);
+    CAMLlocal1(vr);
+#if 3 <= MPI_VERSION
+    MPI_Comm comm = Comm_val(vcomm);
+    struct node_reducer *r = find_node_reducer(comm);
+    MPI_Aint nstamps, size, sz;
+    int rank, disp;
+    void *base;
+
+    if (r == NULL) {
+	r = calloc(1, sizeof(struct node_reducer));
+	if (r == NULL) caml_raise_out_of_memory();
+	r->comm = comm;
+	r->capacity = Int_val(vcapacity);
+
+	MPI_Comm_rank(comm, &rank);
+	MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL,
+			    &r->node);
+	MPI_Comm_rank(r->node, &r->node_rank);
+	MPI_Comm_size(r->node, &r->node_size);
+	MPI_Comm_split(comm, r->node_rank == 0 ? 0 : MPI_UNDEFINED, rank,
+		       &r->leaders);
+	if (r->node_rank == 0) MPI_Comm_size(r->leaders, &r->num_nodes);
+	MPI_Bcast(&r->num_nodes, 1, MPI_INT, 0, r->node);
+
+	/* the whole window belongs to the leader so that it is contiguous */
+	nstamps = (MPI_Aint)(r->node_size + 2) * NODE_STAMP_STRIDE;
+	size = (r->node_rank == 0)
+		? nstamps * sizeof(long)
+		  + (MPI_Aint)(r->node_size + 1) * r->capacity
+		    * sizeof(sunrealtype)
+		: 0;
+	if (MPI_Win_allocate_shared(size, 1, MPI_INFO_NULL, r->node,
+				    &base, &r->win) != MPI_SUCCESS) {
+	    if (r->leaders != MPI_COMM_NULL) MPI_Comm_free(&r->leaders);
+	    MPI_Comm_free(&r->node);
+	    free(r);
+	    caml_failwith("Nvector_parallel.init_hierarchical: "
+			  "cannot allocate a shared window");
+	}
+	MPI_Win_shared_query(r->win, 0, &sz, &disp, &base);
+	r->stamps = (volatile long *)base;
+	r->slots = (sunrealtype *)((long *)base + nstamps);
+
+	MPI_Win_lock_all(MPI_MODE_NOCHECK, r->win);
+	if (r->node_rank == 0) memset(base, 0, nstamps * sizeof(long));
+	MPI_Win_sync(r->win);
+	MPI_Barrier(r->node);
+	MPI_Win_sync(r->win);
+
+	r->next = node_reducers;
+	node_reducers = r;
+    }
+
+    vr = caml_alloc_tuple(2);
+    Store_field(vr, 0, Val_int(r->node_size));
+    Store_field(vr, 1, Val_int(r->num_nodes));
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn(vr);
+}
+
+CAMLprim value sunml_nvector_parallel_num_hierarchical(value vcomm)
+{
+    CAMLparam1(vcomm);
+    struct node_reducer *r = find_node_reducer(Comm_val(vcomm));
+
+    CAMLreturn(Val_long(r == NULL ? 0 : r->count));
+}
+
+CAMLprim value sunml_nvector_parallel_free_hierarchical(value vcomm)
+{
+    CAMLparam1(vcomm);
+    MPI_Comm comm = Comm_val(vcomm);
+    struct node_reducer **pr, *r;
+
+    for (pr = &node_reducers; *pr != NULL; pr = &(*pr)->next) {
+	if ((*pr)->comm != comm) continue;
+	r = *pr;
+	*pr = r->next;
+#if 3 <= MPI_VERSION
+	MPI_Win_unlock_all(r->win);
+	MPI_Win_free(&r->win);
+#endif
+	if (r->leaders != MPI_COMM_NULL) MPI_Comm_free(&r->leaders);
+	MPI_Comm_free(&r->node);
+	free(r);
+	break;
+    }
+    CAMLreturn(Val_unit);
+}
+
+#if 500 <= SUNDIALS_LIB_VERSION
+#define NODE_COMM(x) (*(MPI_Comm *)N_VGetCommunicator(x))
+
+/* A failed reduction gives NaN rather than an arbitrary value, since
+   these operations cannot return an error.  */
+static sunrealtype node_reduce1(N_Vector x, sunrealtype v, MPI_Op op)
+{
+    if (sunml_node_allreduce(NODE_COMM(x), &v, 1, op) != 0) return NAN;
+    return v;
+}
+
+sunrealtype sunml_node_dotprod(N_Vector x, N_Vector y)
+{
+    return node_reduce1(x, N_VDotProdLocal(x, y), MPI_SUM);
+}
+
+static sunrealtype node_maxnorm(N_Vector x)
+{
+    return node_reduce1(x, N_VMaxNormLocal(x), MPI_MAX);
+}
+
+static sunrealtype node_min(N_Vector x)
+{
+    return node_reduce1(x, N_VMinLocal(x), MPI_MIN);
+}
+
+static sunrealtype node_wrmsnorm(N_Vector x, N_Vector w)
+{
+    return sqrt(node_reduce1(x, N_VWSqrSumLocal(x, w), MPI_SUM)
+		/ N_VGetLength(x));
+}
+
+static sunrealtype node_wrmsnormmask(N_Vector x, N_Vector w, N_Vector id)
+{
+    return sqrt(node_reduce1(x, N_VWSqrSumMaskLocal(x, w, id), MPI_SUM)
+		/ N_VGetLength(x));
+}
+
+static sunrealtype node_wl2norm(N_Vector x, N_Vector w)
+{
+    return sqrt(node_reduce1(x, N_VWSqrSumLocal(x, w), MPI_SUM));
+}
+
+static sunrealtype node_l1norm(N_Vector x)
+{
+    return node_reduce1(x, N_VL1NormLocal(x), MPI_SUM);
+}
+
+static sunrealtype node_minquotient(N_Vector num, N_Vector denom)
+{
+    return node_reduce1(num, N_VMinQuotientLocal(num, denom), MPI_MIN);
+}
+
+int sunml_node_dotprodmulti(int nvec, N_Vector x, N_Vector *y,
+			    sunrealtype *d)
+{
+    int j;
+
+#if 600 <= SUNDIALS_LIB_VERSION
+    if (x->ops->nvdotprodmultilocal != NULL)
+	x->ops->nvdotprodmultilocal(nvec, x, y, d);
+    else
+#endif
+    for (j = 0; j < nvec; j++) d[j] = N_VDotProdLocal(x, y[j]);
+
+    return sunml_node_allreduce(NODE_COMM(x), d, nvec, MPI_SUM);
+}
+
+int sunml_node_wrmsnormvectorarray(int nvec, N_Vector *x, N_Vector *w,
+				   sunrealtype *nrm)
+{
+    int j;
+
+    for (j = 0; j < nvec; j++) nrm[j] = N_VWSqrSumLocal(x[j], w[j]);
+    if (sunml_node_allreduce(NODE_COMM(x[0]), nrm, nvec, MPI_SUM) != 0)
+	return -1;
+    for (j = 0; j < nvec; j++) nrm[j] = sqrt(nrm[j] / N_VGetLength(x[j]));
+    return 0;
+}
+
+int sunml_node_wrmsnormmaskvectorarray(int nvec, N_Vector *x, N_Vector *w,
+				       N_Vector id, sunrealtype *nrm)
+{
+    int j;
+
+    for (j = 0; j < nvec; j++) nrm[j] = N_VWSqrSumMaskLocal(x[j], w[j], id);
+    if (sunml_node_allreduce(NODE_COMM(x[0]), nrm, nvec, MPI_SUM) != 0)
+	return -1;
+    for (j = 0; j < nvec; j++) nrm[j] = sqrt(nrm[j] / N_VGetLength(x[j]));
+    return 0;
+}
+
+#if 600 <= SUNDIALS_LIB_VERSION
+static int node_dotprodmultiallreduce(int nvec, N_Vector x, sunrealtype *sum)
+{
+    return sunml_node_allreduce(NODE_COMM(x), sum, nvec, MPI_SUM);
+}
+#endif
+
+void sunml_node_reduction_install(N_Vector v)
+{
+    N_Vector_Ops ops = v->ops;
+
+    ops->nvdotprod      = sunml_node_dotprod;
+    ops->nvmaxnorm      = node_maxnorm;
+    ops->nvmin          = node_min;
+    ops->nvwrmsnorm     = node_wrmsnorm;
+    ops->nvwrmsnormmask = node_wrmsnormmask;
+    ops->nvwl2norm      = node_wl2norm;
+    ops->nvl1norm       = node_l1norm;
+    ops->nvminquotient  = node_minquotient;
+
+    if (ops->nvdotprodmulti != NULL)
+	ops->nvdotprodmulti = sunml_node_dotprodmulti;
+    if (ops->nvwrmsnormvectorarray != NULL)
+	ops->nvwrmsnormvectorarray = sunml_node_wrmsnormvectorarray;
+    if (ops->nvwrmsnormmaskvectorarray != NULL)
+	ops->nvwrmsnormmaskvectorarray = sunml_node_wrmsnormmaskvectorarray;
+#if 600 <= SUNDIALS_LIB_VERSION
+    if (ops->nvdotprodmultiallreduce != NULL)
+	ops->nvdotprodmultiallreduce = node_dotprodmultiallreduce;
+#endif
+}
+
+int sunml_node_reduction_installed(N_Vector v)
+{
+    return (v->ops->nvdotprod == sunml_node_dotprod);
+}
+#endif
+
 CAMLprim value sunml_nvector_parallel_init_module (value exns)
 {
     CAMLparam1 (exns);
     REGISTER_EXNS (NVECTOR_PARALLEL, exns);
+#if 600 <= SUNDIALS_LIB_VERSION
+    sunml_lsolver_pipelined_register_reductions(pipelined_reduction_start,
+						pipelined_reduction_finish);
+#endif
     CAMLreturn (Val_unit);
 }
 
@@ -313,6 +718,52 @@ CAMLprim value sunml_nvec_anywrap_parallel(value extconstr,
     CAMLreturn(vnv);
 }
 
+CAMLprim value sunml_nvec_par_set_hierarchical(value vx, value vv)
+{
+    CAMLparam2(vx, vv);
+#if 500 <= SUNDIALS_LIB_VERSION
+    N_Vector x = NVEC_VAL(vx);
+    N_Vector_Ops ops = x->ops;
+
+    if (Bool_val(vv)) {
+	sunml_node_reduction_install(x);
+    } else {
+	ops->nvdotprod      = N_VDotProd_Parallel;
+	ops->nvmaxnorm      = N_VMaxNorm_Parallel;
+	ops->nvmin          = N_VMin_Parallel;
+	ops->nvwrmsnorm     = N_VWrmsNorm_Parallel;
+	ops->nvwrmsnormmask = N_VWrmsNormMask_Parallel;
+	ops->nvwl2norm      = N_VWL2Norm_Parallel;
+	ops->nvl1norm       = N_VL1Norm_Parallel;
+	ops->nvminquotient  = N_VMinQuotient_Parallel;
+	if (ops->nvdotprodmulti == sunml_node_dotprodmulti)
+	    ops->nvdotprodmulti = N_VDotProdMulti_Parallel;
+	if (ops->nvwrmsnormvectorarray == sunml_node_wrmsnormvectorarray)
+	    ops->nvwrmsnormvectorarray = N_VWrmsNormVectorArray_Parallel;
+	if (ops->nvwrmsnormmaskvectorarray
+		== sunml_node_wrmsnormmaskvectorarray)
+	    ops->nvwrmsnormmaskvectorarray = N_VWrmsNormMaskVectorArray_Parallel;
+#if 600 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmultiallreduce != NULL)
+	    ops->nvdotprodmultiallreduce = N_VDotProdMultiAllReduce_Parallel;
+#endif
+    }
+#else
+    caml_raise_constant(SUNDIALS_EXN(NotImplementedBySundialsVersion));
+#endif
+    CAMLreturn (Val_unit);
+}
+
+CAMLprim value sunml_nvec_par_is_hierarchical(value vx)
+{
+    CAMLparam1(vx);
+#if 500 <= SUNDIALS_LIB_VERSION
+    CAMLreturn (Val_bool(sunml_node_reduction_installed(NVEC_VAL(vx))));
+#else
+    CAMLreturn (Val_false);
+#endif
+}
+
 CAMLprim value sunml_nvec_par_print_file(value vx, value volog)
 {
     CAMLparam2(vx, volog);
@@ -411,14 +862,14 @@ CAMLprim value sunml_nvec_par_dotprod(value vx, value vy)
     CAMLparam2(vx, vy);
     N_Vector x = NVEC_VAL(vx);
     N_Vector y = NVEC_VAL(vy);
-    sunrealtype r = N_VDotProd_Parallel(x, y);
+    sunrealtype r = N_VDotProd(x, y);
     CAMLreturn(caml_copy_double(r));
 }
 
 CAMLprim value sunml_nvec_par_maxnorm(value vx)
 {
     CAMLparam1(vx);
-    sunrealtype r = N_VMaxNorm_Parallel(NVEC_VAL(vx));
+    sunrealtype r = N_VMaxNorm(NVEC_VAL(vx));
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -427,7 +878,7 @@ CAMLprim value sunml_nvec_par_wrmsnorm(value vx, value vw)
     CAMLparam2(vx, vw);
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
-    sunrealtype r = N_VWrmsNorm_Parallel(x, w);
+    sunrealtype r = N_VWrmsNorm(x, w);
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -437,14 +888,14 @@ CAMLprim value sunml_nvec_par_wrmsnormmask(value vx, value vw, value vid)
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
     N_Vector id = NVEC_VAL(vid);
-    sunrealtype r = N_VWrmsNormMask_Parallel(x, w, id);
+    sunrealtype r = N_VWrmsNormMask(x, w, id);
     CAMLreturn(caml_copy_double(r));
 }
 
 CAMLprim value sunml_nvec_par_min(value vx)
 {
     CAMLparam1(vx);
-    sunrealtype r = N_VMin_Parallel(NVEC_VAL(vx));
+    sunrealtype r = N_VMin(NVEC_VAL(vx));
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -453,14 +904,14 @@ CAMLprim value sunml_nvec_par_wl2norm(value vx, value vw)
     CAMLparam2(vx, vw);
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
-    sunrealtype r = N_VWL2Norm_Parallel(x, w);
+    sunrealtype r = N_VWL2Norm(x, w);
     CAMLreturn(caml_copy_double(r));
 }
 
 CAMLprim value sunml_nvec_par_l1norm(value vx)
 {
     CAMLparam1(vx);
-    sunrealtype r = N_VL1Norm_Parallel(NVEC_VAL(vx));
+    sunrealtype r = N_VL1Norm(NVEC_VAL(vx));
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -497,7 +948,7 @@ CAMLprim value sunml_nvec_par_minquotient(value vnum, value vdenom)
     CAMLparam2(vnum, vdenom);
     N_Vector num = NVEC_VAL(vnum);
     N_Vector denom = NVEC_VAL(vdenom);
-    sunrealtype r = N_VMinQuotient_Parallel(num, denom);
+    sunrealtype r = N_VMinQuotient(num, denom);
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -593,7 +1044,7 @@ CAMLprim value sunml_nvec_par_dotprodmulti(value vx, value vay, value vad)
     N_Vector *ay;
     int nvec = sunml_arrays_of_nvectors(&ay, 1, vay);
     if (!nvec) caml_raise_out_of_memory();
-    N_VDotProdMulti_Parallel(nvec, x, ay, ad);
+    N_VDotProdMulti(nvec, x, ay, ad);
     free(ay);
 #endif
     CAMLreturn(Val_unit);
@@ -654,7 +1105,7 @@ CAMLprim value sunml_nvec_par_wrmsnormvectorarray(value vax, value vaw,
     N_Vector *a[2];
     int nvec = sunml_arrays_of_nvectors(a, 2, vax, vaw);
     if (!nvec) caml_raise_out_of_memory();
-    N_VWrmsNormVectorArray_Parallel(nvec, a[0], a[1], an);
+    N_VWrmsNormVectorArray(nvec, a[0], a[1], an);
     free(*a);
 #endif
     CAMLreturn(Val_unit);
@@ -670,7 +1121,7 @@ CAMLprim value sunml_nvec_par_wrmsnormmaskvectorarray(value vax,
     N_Vector *a[2];
     int nvec = sunml_arrays_of_nvectors(a, 2, vax, vaw);
     if (!nvec) caml_raise_out_of_memory();
-    N_VWrmsNormMaskVectorArray_Parallel(nvec, a[0], a[1], i, an);
+    N_VWrmsNormMaskVectorArray(nvec, a[0], a[1], i, an);
     free(*a);
 #endif
     CAMLreturn(Val_unit);
@@ -844,7 +1295,7 @@ CAMLprim value sunml_nvec_par_dotprodmultiallreduce(value vx, value vd)
 #if 600 <= SUNDIALS_LIB_VERSION
     sunrealtype *d = REAL_ARRAY(vd);
     int nvec_total = ARRAY1_LEN(vd);
-    N_VDotProdMultiAllReduce_Parallel(nvec_total, NVEC_VAL(vx), d);
+    N_VDotProdMultiAllReduce(nvec_total, NVEC_VAL(vx), d);
 #endif
     CAMLreturn(Val_unit);
 }
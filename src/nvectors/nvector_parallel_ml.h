@@ -16,6 +16,7 @@
 
 #include <sundials/sundials_nvector.h>
 #include <caml/mlvalues.h>
+#include <mpi.h>
 
 /* OCaml interface to Parallel NVectors.
 
@@ -52,4 +53,37 @@ enum nvector_parallel_exn_index {
 #define MPI_SUNINDEXTYPE PVEC_INTEGER_MPI_TYPE
 #endif
 
+/* Node-aware reductions (nvector_parallel_ml.c).
+
+   sunml_node_allreduce reduces n values in place over comm (MPI_SUM,
+   MPI_MAX, or MPI_MIN).  If a node reducer was registered for comm (by
+   Nvector_parallel.init_hierarchical), it combines the values within each
+   node through a shared-memory window and only calls MPI_Allreduce across
+   node leaders; otherwise it just calls MPI_Allreduce.  Returns 0 on
+   success, and -1 on every rank of comm if the reduction failed on any
+   of them.
+
+   sunml_node_reduction_install replaces the reduction operations of an
+   nvector with versions that compute the local part through the nvector's
+   local operations and then call sunml_node_allreduce on the nvector's
+   communicator.  It works for any nvector that provides the local
+   reduction operations and nvgetcommunicator.  The optional fused and
+   array reductions are only replaced if they are enabled.  On failure,
+   the reductions that return a value give NaN and the fused and array
+   ones return -1.  */
+int sunml_node_allreduce(MPI_Comm comm, sunrealtype *buf, int n, MPI_Op op);
+
+#if 500 <= SUNDIALS_LIB_VERSION
+void sunml_node_reduction_install(N_Vector v);
+int sunml_node_reduction_installed(N_Vector v);
+
+sunrealtype sunml_node_dotprod(N_Vector x, N_Vector y);
+int sunml_node_dotprodmulti(int nvec, N_Vector x, N_Vector *y,
+			    sunrealtype *d);
+int sunml_node_wrmsnormvectorarray(int nvec, N_Vector *x, N_Vector *w,
+				   sunrealtype *nrm);
+int sunml_node_wrmsnormmaskvectorarray(int nvec, N_Vector *x, N_Vector *w,
+				       N_Vector id, sunrealtype *nrm);
+#endif
+
 #endif
@@ -27,6 +27,12 @@ external c_enablescaleaddmultivectorarray_pthreads     : ('d, 'k) Nvector.t -> b
 external c_enablelinearcombinationvectorarray_pthreads : ('d, 'k) Nvector.t -> bool -> unit
   = "sunml_nvec_pthreads_enablelinearcombinationvectorarray"
 
+(* Reproducible reductions *)
+external c_set_reproducible : ('d, 'k) Nvector.t -> bool -> unit
+  = "sunml_nvec_pthreads_set_reproducible"
+external c_is_reproducible : ('d, 'k) Nvector.t -> bool
+  = "sunml_nvec_pthreads_is_reproducible"
+
 let unwrap = Nvector.unwrap
 
 external c_wrap :
@@ -73,6 +79,7 @@ and clone nthreads nv =
     c_enablelinearcombinationvectorarray_pthreads nv'
       (Nvector.Ops.has_linearcombinationvectorarray nv)
   end;
+  if c_is_reproducible nv then c_set_reproducible nv' true;
   nv'
 
 let pp fmt v = RealArray.pp fmt (unwrap v)
@@ -83,6 +90,9 @@ let make ?context ?with_fused_ops nthreads n iv =
 external num_threads : t -> int
   = "sunml_nvec_pthreads_num_threads"
 
+let set_reproducible (nv : t) b = c_set_reproducible nv b
+let is_reproducible (nv : t) = c_is_reproducible nv
+
 let do_enable f nv v =
   match v with
   | None -> ()
@@ -122,7 +132,8 @@ let enable
     do_enable c_enablescaleaddmultivectorarray_pthreads nv
               with_scale_add_multi_vector_array;
     do_enable c_enablelinearcombinationvectorarray_pthreads nv
-              with_linear_combination_vector_array
+              with_linear_combination_vector_array;
+    if c_is_reproducible nv then c_set_reproducible nv true
 
 module Any = struct (* {{{ *)
 
@@ -218,6 +229,7 @@ module Any = struct (* {{{ *)
       (Nvector.Ops.has_scaleaddmultivectorarray nv);
     c_enablelinearcombinationvectorarray_pthreads nv'
       (Nvector.Ops.has_linearcombinationvectorarray nv);
+    if c_is_reproducible nv then c_set_reproducible nv' true;
     nv'
 
   let make
@@ -290,7 +302,16 @@ module Any = struct (* {{{ *)
       do_enable c_enablescaleaddmultivectorarray_pthreads nv
                 with_scale_add_multi_vector_array;
       do_enable c_enablelinearcombinationvectorarray_pthreads nv
-                with_linear_combination_vector_array
+                with_linear_combination_vector_array;
+      if c_is_reproducible nv then c_set_reproducible nv true
+
+  let set_reproducible nv b =
+    if Nvector.get_id nv <> Nvector.Pthreads then raise Nvector.BadGenericType;
+    c_set_reproducible nv b
+
+  let is_reproducible nv =
+    if Nvector.get_id nv <> Nvector.Pthreads then raise Nvector.BadGenericType;
+    c_is_reproducible nv
 
 end (* }}} *)
 
@@ -300,7 +321,9 @@ module Ops = struct (* {{{ *)
 
   let clone nv =
     let data = Nvector.unwrap nv in
-    wrap (num_threads nv) (RealArray.copy data)
+    let nv' = wrap (num_threads nv) (RealArray.copy data) in
+    if c_is_reproducible nv then c_set_reproducible nv' true;
+    nv'
 
   external c_linearsum    : float -> t -> float -> t -> t -> unit
     = "sunml_nvec_pthreads_linearsum" [@@noalloc]
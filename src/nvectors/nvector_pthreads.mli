@@ -107,6 +107,20 @@ val enable :
   -> t
   -> unit
 
+(** Selects reproducible reductions for a Pthreads nvector and its clones.
+    The dot product, the weighted and L1 norms, and the reductions of the
+    enabled fused and array operations then sum fixed chunks of elements
+    and combine the chunk sums in a fixed order, so that they give the
+    same result for any number of threads. Passing [false] restores the
+    Sundials operations.
+
+    Clones inherit the setting. *)
+val set_reproducible : t -> bool -> unit
+
+(** Returns true if reproducible reductions are selected.
+    See {!set_reproducible}. *)
+val is_reproducible : t -> bool
+
 (** Underlyling nvector operations on Pthreads nvectors. *)
 module Ops : Nvector.NVECTOR_OPS with type t = t
 
@@ -228,5 +242,15 @@ module Any : sig (* {{{ *)
     -> Nvector.any
     -> unit
 
+  (** Selects reproducible reductions. See {!Nvector_pthreads.set_reproducible}.
+
+      @raise Nvector.BadGenericType If not called on a Pthreads nvector *)
+  val set_reproducible : Nvector.any -> bool -> unit
+
+  (** Returns true if reproducible reductions are selected.
+
+      @raise Nvector.BadGenericType If not called on a Pthreads nvector *)
+  val is_reproducible : Nvector.any -> bool
+
 end (* }}} *)
 
@@ -23,6 +23,10 @@
 #include <caml/fail.h>
 #include <caml/bigarray.h>
 
+#include <math.h>
+#include <stdlib.h>
+#include <pthread.h>
+
 #include <nvector/nvector_pthreads.h>
 
 /* Adapted from sundials-2.6.1/src/nvec_pthreads/nvector_pthreads.c:
@@ -276,6 +280,219 @@ CAMLprim value sunml_nvec_pthreads_num_threads(value va)
     CAMLreturn(Val_int(num_threads));
 }
 
+/* Reproducible reductions (see nvector_ml.c).  Thread t computes the
+   chunk sums t, t + nthreads, ..., which are always combined in the same
+   order.  */
+struct repro_job {
+    enum sunml_repro_op op;
+    sundials_ml_index n, nchunks;
+    sunrealtype *x, *y, *id, *partial;
+    int first, stride, started;
+    pthread_t thread;
+};
+
+static void *repro_worker(void *arg)
+{
+    struct repro_job *job = (struct repro_job *)arg;
+    sundials_ml_index c, lo, hi;
+
+    for (c = job->first; c < job->nchunks; c += job->stride) {
+	lo = c * SUNML_REPRO_CHUNK;
+	hi = (job->n - lo > SUNML_REPRO_CHUNK) ? lo + SUNML_REPRO_CHUNK
+					       : job->n;
+	job->partial[c] = sunml_repro_chunk(job->op, lo, hi,
+					    job->x, job->y, job->id);
+    }
+    return NULL;
+}
+
+static sunrealtype repro_reduce_pthreads(enum sunml_repro_op op,
+					 N_Vector x, N_Vector y, N_Vector id)
+{
+    sundials_ml_index n = NV_LENGTH_PT(x);
+    sundials_ml_index nchunks = sunml_repro_nchunks(n);
+    int t, nthreads = NV_NUM_THREADS_PT(x);
+    sunrealtype *xd = NV_DATA_PT(x);
+    sunrealtype *yd = (y == NULL) ? NULL : NV_DATA_PT(y);
+    sunrealtype *idd = (id == NULL) ? NULL : NV_DATA_PT(id);
+    sunrealtype *partial, r;
+    struct repro_job *jobs;
+
+    if (nthreads > nchunks) nthreads = nchunks;
+    if (nthreads <= 1) return sunml_repro_reduce(op, n, xd, yd, idd);
+
+    partial = malloc(nchunks * sizeof(sunrealtype));
+    jobs = malloc(nthreads * sizeof(struct repro_job));
+    if (partial == NULL || jobs == NULL) {
+	free(partial);
+	free(jobs);
+	return sunml_repro_reduce(op, n, xd, yd, idd);
+    }
+
+    for (t = 0; t < nthreads; t++) {
+	jobs[t].op = op;
+	jobs[t].n = n;
+	jobs[t].nchunks = nchunks;
+	jobs[t].x = xd;
+	jobs[t].y = yd;
+	jobs[t].id = idd;
+	jobs[t].partial = partial;
+	jobs[t].first = t;
+	jobs[t].stride = nthreads;
+	jobs[t].started = 0;
+    }
+    for (t = 1; t < nthreads; t++)
+	jobs[t].started = (pthread_create(&jobs[t].thread, NULL,
+					  repro_worker, &jobs[t]) == 0);
+    /* the calling thread also does the work of threads that did not start */
+    for (t = 0; t < nthreads; t++)
+	if (!jobs[t].started) repro_worker(&jobs[t]);
+    for (t = 1; t < nthreads; t++)
+	if (jobs[t].started) pthread_join(jobs[t].thread, NULL);
+
+    r = sunml_repro_combine(partial, nchunks);
+    free(jobs);
+    free(partial);
+    return r;
+}
+
+static sunrealtype repro_dotprod_pthreads(N_Vector x, N_Vector y)
+{
+    return repro_reduce_pthreads(SUNML_REPRO_DOT, x, y, NULL);
+}
+
+static sunrealtype repro_wrmsnorm_pthreads(N_Vector x, N_Vector w)
+{
+    return sqrt(repro_reduce_pthreads(SUNML_REPRO_WSQR, x, w, NULL)
+		/ NV_LENGTH_PT(x));
+}
+
+static sunrealtype repro_wrmsnormmask_pthreads(N_Vector x, N_Vector w,
+					     N_Vector id)
+{
+    return sqrt(repro_reduce_pthreads(SUNML_REPRO_WSQRMASK, x, w, id)
+		/ NV_LENGTH_PT(x));
+}
+
+static sunrealtype repro_wl2norm_pthreads(N_Vector x, N_Vector w)
+{
+    return sqrt(repro_reduce_pthreads(SUNML_REPRO_WSQR, x, w, NULL));
+}
+
+static sunrealtype repro_l1norm_pthreads(N_Vector x)
+{
+    return repro_reduce_pthreads(SUNML_REPRO_L1, x, NULL, NULL);
+}
+
+#if 500 <= SUNDIALS_LIB_VERSION
+static sunrealtype repro_wsqrsum_pthreads(N_Vector x, N_Vector w)
+{
+    return repro_reduce_pthreads(SUNML_REPRO_WSQR, x, w, NULL);
+}
+
+static sunrealtype repro_wsqrsummask_pthreads(N_Vector x, N_Vector w,
+					    N_Vector id)
+{
+    return repro_reduce_pthreads(SUNML_REPRO_WSQRMASK, x, w, id);
+}
+#endif
+
+#if 400 <= SUNDIALS_LIB_VERSION
+static int repro_dotprodmulti_pthreads(int nvec, N_Vector x, N_Vector *y,
+				     sunrealtype *d)
+{
+    int j;
+    for (j = 0; j < nvec; j++) d[j] = repro_dotprod_pthreads(x, y[j]);
+    return 0;
+}
+
+static int repro_wrmsnormvectorarray_pthreads(int nvec, N_Vector *x,
+					    N_Vector *w, sunrealtype *nrm)
+{
+    int j;
+    for (j = 0; j < nvec; j++) nrm[j] = repro_wrmsnorm_pthreads(x[j], w[j]);
+    return 0;
+}
+
+static int repro_wrmsnormmaskvectorarray_pthreads(int nvec, N_Vector *x,
+						N_Vector *w, N_Vector id,
+						sunrealtype *nrm)
+{
+    int j;
+    for (j = 0; j < nvec; j++)
+	nrm[j] = repro_wrmsnormmask_pthreads(x[j], w[j], id);
+    return 0;
+}
+#endif
+
+/* The optional fused and array reductions are only replaced if enabled. */
+CAMLprim value sunml_nvec_pthreads_set_reproducible(value vx, value vv)
+{
+    CAMLparam2(vx, vv);
+    N_Vector_Ops ops = NVEC_VAL(vx)->ops;
+
+    if (Bool_val(vv)) {
+	ops->nvdotprod      = repro_dotprod_pthreads;
+	ops->nvwrmsnorm     = repro_wrmsnorm_pthreads;
+	ops->nvwrmsnormmask = repro_wrmsnormmask_pthreads;
+	ops->nvwl2norm      = repro_wl2norm_pthreads;
+	ops->nvl1norm       = repro_l1norm_pthreads;
+#if 400 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmulti != NULL)
+	    ops->nvdotprodmulti = repro_dotprodmulti_pthreads;
+	if (ops->nvwrmsnormvectorarray != NULL)
+	    ops->nvwrmsnormvectorarray = repro_wrmsnormvectorarray_pthreads;
+	if (ops->nvwrmsnormmaskvectorarray != NULL)
+	    ops->nvwrmsnormmaskvectorarray =
+		repro_wrmsnormmaskvectorarray_pthreads;
+#endif
+#if 500 <= SUNDIALS_LIB_VERSION
+	ops->nvdotprodlocal     = repro_dotprod_pthreads;
+	ops->nvl1normlocal      = repro_l1norm_pthreads;
+	ops->nvwsqrsumlocal     = repro_wsqrsum_pthreads;
+	ops->nvwsqrsummasklocal = repro_wsqrsummask_pthreads;
+#endif
+#if 600 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmultilocal != NULL)
+	    ops->nvdotprodmultilocal = repro_dotprodmulti_pthreads;
+#endif
+    } else {
+	ops->nvdotprod      = N_VDotProd_Pthreads;
+	ops->nvwrmsnorm     = N_VWrmsNorm_Pthreads;
+	ops->nvwrmsnormmask = N_VWrmsNormMask_Pthreads;
+	ops->nvwl2norm      = N_VWL2Norm_Pthreads;
+	ops->nvl1norm       = N_VL1Norm_Pthreads;
+#if 400 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmulti == repro_dotprodmulti_pthreads)
+	    ops->nvdotprodmulti = N_VDotProdMulti_Pthreads;
+	if (ops->nvwrmsnormvectorarray == repro_wrmsnormvectorarray_pthreads)
+	    ops->nvwrmsnormvectorarray = N_VWrmsNormVectorArray_Pthreads;
+	if (ops->nvwrmsnormmaskvectorarray
+		== repro_wrmsnormmaskvectorarray_pthreads)
+	    ops->nvwrmsnormmaskvectorarray = N_VWrmsNormMaskVectorArray_Pthreads;
+#endif
+#if 500 <= SUNDIALS_LIB_VERSION
+	ops->nvdotprodlocal     = N_VDotProd_Pthreads;
+	ops->nvl1normlocal      = N_VL1Norm_Pthreads;
+	ops->nvwsqrsumlocal     = N_VWSqrSumLocal_Pthreads;
+	ops->nvwsqrsummasklocal = N_VWSqrSumMaskLocal_Pthreads;
+#endif
+#if 600 <= SUNDIALS_LIB_VERSION
+	if (ops->nvdotprodmultilocal == repro_dotprodmulti_pthreads)
+	    ops->nvdotprodmultilocal = N_VDotProdMulti_Pthreads;
+#endif
+    }
+
+    CAMLreturn (Val_unit);
+}
+
+CAMLprim value sunml_nvec_pthreads_is_reproducible(value vx)
+{
+    CAMLparam1(vx);
+    CAMLreturn (Val_bool(NVEC_VAL(vx)->ops->nvdotprod
+			 == repro_dotprod_pthreads));
+}
+
 CAMLprim value sunml_nvec_pthreads_print_file(value vx, value volog)
 {
     CAMLparam2(vx, volog);
@@ -376,7 +593,7 @@ CAMLprim value sunml_nvec_pthreads_dotprod(value vx, value vy)
     CAMLparam2(vx, vy);
     N_Vector x = NVEC_VAL(vx);
     N_Vector y = NVEC_VAL(vy);
-    sunrealtype r = N_VDotProd_Pthreads(x, y);
+    sunrealtype r = N_VDotProd(x, y);
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -392,7 +609,7 @@ CAMLprim value sunml_nvec_pthreads_wrmsnorm(value vx, value vw)
     CAMLparam2(vx, vw);
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
-    sunrealtype r = N_VWrmsNorm_Pthreads(x, w);
+    sunrealtype r = N_VWrmsNorm(x, w);
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -402,7 +619,7 @@ CAMLprim value sunml_nvec_pthreads_wrmsnormmask(value vx, value vw, value vid)
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
     N_Vector id = NVEC_VAL(vid);
-    sunrealtype r = N_VWrmsNormMask_Pthreads(x, w, id);
+    sunrealtype r = N_VWrmsNormMask(x, w, id);
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -418,14 +635,14 @@ CAMLprim value sunml_nvec_pthreads_wl2norm(value vx, value vw)
     CAMLparam2(vx, vw);
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
-    sunrealtype r = N_VWL2Norm_Pthreads(x, w);
+    sunrealtype r = N_VWL2Norm(x, w);
     CAMLreturn(caml_copy_double(r));
 }
 
 CAMLprim value sunml_nvec_pthreads_l1norm(value vx)
 {
     CAMLparam1(vx);
-    sunrealtype r = N_VL1Norm_Pthreads(NVEC_VAL(vx));
+    sunrealtype r = N_VL1Norm(NVEC_VAL(vx));
     CAMLreturn(caml_copy_double(r));
 }
 
@@ -666,7 +883,7 @@ CAMLprim value sunml_nvec_pthreads_wsqrsumlocal(value vx, value vw)
 #if 500 <= SUNDIALS_LIB_VERSION
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
-    r = N_VWSqrSumLocal_Pthreads(x, w);
+    r = N_VWSqrSumLocal(x, w);
 #endif
     CAMLreturn(caml_copy_double(r));
 }
@@ -681,7 +898,7 @@ CAMLprim value sunml_nvec_pthreads_wsqrsummasklocal(value vx, value vw,
     N_Vector x = NVEC_VAL(vx);
     N_Vector w = NVEC_VAL(vw);
     N_Vector id = NVEC_VAL(vid);
-    r = N_VWSqrSumMaskLocal_Pthreads(x, w, id);
+    r = N_VWSqrSumMaskLocal(x, w, id);
 #endif
 
     CAMLreturn(caml_copy_double(r));
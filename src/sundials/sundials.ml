@@ -21,6 +21,11 @@ module Logfile = struct
   let stdout   = Sundials_impl.Logfile.stdout
   let openfile = Sundials_impl.Logfile.openfile
 
+  type overflow = Sundials_impl.Logfile.overflow = Block | Drop
+
+  let openfile_async = Sundials_impl.Logfile.openfile_async
+  let num_dropped = Sundials_impl.Logfile.num_dropped
+
   let output_string = Sundials_impl.Logfile.output_string
   let output_bytes  = Sundials_impl.Logfile.output_bytes
 
@@ -427,6 +432,8 @@ end (* }}} *)
 
 module Matrix = Sundials_Matrix
 
+module BinaryFile = Sundials_BinaryFile
+
 module LinearSolver = Sundials_LinearSolver
 
 module NonlinearSolver = Sundials_NonlinearSolver
@@ -47,13 +47,49 @@ module Logfile : sig (* {{{ *)
       truncated to zero length. Files are closed on garbage collection. *)
   val openfile : ?trunc:bool -> string -> t
 
+  (** What to do when the buffer of an asynchronous log file is full.
+      - [Block] waits for the background writer to make space, and
+      - [Drop] discards the text (see {!num_dropped}). *)
+  type overflow = Sundials_impl.Logfile.overflow = Block | Drop
+
+  (** Opens the named file for asynchronous writing. Writes, including
+      those made by Sundials (diagnostics, statistics, and error
+      messages), are copied into a ring buffer of at least [buffer_size]
+      bytes (the default is 1 MiB) and written to the file by a background
+      thread. The thread writes whenever the buffer is half full, after
+      {!flush}, and every [flush_interval] seconds (the default is 0.1),
+      so a solver never waits for the file system unless the buffer fills
+      up and [overflow] is [Block] (the default). The [trunc] argument is
+      as for {!openfile}.
+
+      Text still buffered at program exit is written out, as it is when
+      the file is closed. Closing waits for the background thread, but
+      garbage collection does not: the thread finishes writing and closes
+      the file on its own. After an abnormal termination, the text written
+      during the last [flush_interval] seconds may be lost.
+      On platforms without custom stdio streams (other than glibc, macOS,
+      and the BSDs), this function is the same as {!openfile}. *)
+  val openfile_async :
+       ?trunc:bool
+    -> ?buffer_size:int
+    -> ?overflow:overflow
+    -> ?flush_interval:float
+    -> string
+    -> t
+
+  (** Returns the number of bytes discarded by an asynchronous log file,
+      either because its buffer was full and the overflow policy is
+      [Drop] or because of write errors. Returns 0 for other files. *)
+  val num_dropped : t -> int
+
   (** Writes the given string to an open log file. *)
   val output_string : t -> string -> unit
 
   (** Writes the given byte sequence to an open log file. *)
   val output_bytes : t -> bytes -> unit
 
-  (** Flushes the given file. *)
+  (** Flushes the given file. For an asynchronous file, the background
+      writer is woken but not waited for. *)
   val flush : t -> unit
 
   (** Closes the given file. *)
@@ -428,6 +464,10 @@ end (* }}} *)
     @since 3.0.0 *)
 module Matrix = Sundials_Matrix
 
+(** Binary files of matrices and arrays, and MatrixMarket import. Files
+    are mapped into memory and arrays are loaded without copying. *)
+module BinaryFile = Sundials_BinaryFile
+
 (** Generic linear solvers.
 
     Sundials provides a set of functions for instantiating linear solvers from
@@ -0,0 +1,126 @@
+(***********************************************************************)
+(*                                                                     *)
+(*                   OCaml interface to Sundials                       *)
+(*                                                                     *)
+(*             Timothy Bourke, Jun Inoue, and Marc Pouzet              *)
+(*             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *)
+(*                                                                     *)
+(*  Copyright 2026 Institut National de Recherche en Informatique et   *)
+(*  en Automatique.  All rights reserved.  This file is distributed    *)
+(*  under a New BSD License, refer to the file LICENSE.                *)
+(*                                                                     *)
+(***********************************************************************)
+
+(* The workers wait for the generation to change, run the job, and
+   decrement pending; the caller runs worker 0 and waits for pending to
+   reach zero.  All the fields are protected by lock.  *)
+type t = {
+    num_workers : int;
+    lock : Mutex.t;
+    start : Condition.t;                (* wakes the workers *)
+    finish : Condition.t;               (* wakes the caller *)
+    mutable job : int -> unit;
+    mutable generation : int;
+    mutable pending : int;
+    mutable error : (exn * Printexc.raw_backtrace) option;
+    mutable running : bool;
+    mutable stopped : bool;
+    mutable domains : unit Domain.t list;
+  }
+
+let no_job _ = ()
+
+let protect job w =
+  match job w with
+  | () -> None
+  | exception e -> Some (e, Printexc.get_raw_backtrace ())
+
+let worker p w =
+  let rec loop seen =
+    Mutex.lock p.lock;
+    while p.generation = seen && not p.stopped do
+      Condition.wait p.start p.lock
+    done;
+    if p.stopped then Mutex.unlock p.lock
+    else begin
+      let generation = p.generation and job = p.job in
+      Mutex.unlock p.lock;
+      let error = protect job w in
+      Mutex.lock p.lock;
+      if p.error = None then p.error <- error;
+      p.pending <- p.pending - 1;
+      if p.pending = 0 then Condition.signal p.finish;
+      Mutex.unlock p.lock;
+      loop generation
+    end
+  in
+  loop 0
+
+let create ?(num_workers=Domain.recommended_domain_count ()) () =
+  if num_workers < 1 then invalid_arg "Sundials_domains.create";
+  let p = {
+      num_workers;
+      lock = Mutex.create ();
+      start = Condition.create ();
+      finish = Condition.create ();
+      job = no_job;
+      generation = 0;
+      pending = 0;
+      error = None;
+      running = false;
+      stopped = false;
+      domains = [];
+    }
+  in
+  p.domains <- List.init (num_workers - 1)
+                 (fun w -> Domain.spawn (fun () -> worker p (w + 1)));
+  p
+
+let num_workers p = p.num_workers
+
+let run p job =
+  Mutex.lock p.lock;
+  if p.stopped || p.running then begin
+    Mutex.unlock p.lock;
+    invalid_arg (if p.stopped then "Sundials_domains.run: shut down"
+                 else "Sundials_domains.run: busy")
+  end;
+  p.running <- true;
+  p.job <- job;
+  p.pending <- p.num_workers - 1;
+  p.error <- None;
+  p.generation <- p.generation + 1;
+  Condition.broadcast p.start;
+  Mutex.unlock p.lock;
+
+  let error0 = protect job 0 in
+
+  Mutex.lock p.lock;
+  while p.pending > 0 do Condition.wait p.finish p.lock done;
+  let error = if error0 <> None then error0 else p.error in
+  p.job <- no_job;
+  p.error <- None;
+  p.running <- false;
+  Mutex.unlock p.lock;
+  match error with
+  | None -> ()
+  | Some (e, bt) -> Printexc.raise_with_backtrace e bt
+
+let shutdown p =
+  Mutex.lock p.lock;
+  if p.running then begin
+    Mutex.unlock p.lock;
+    invalid_arg "Sundials_domains.shutdown: busy"
+  end;
+  p.stopped <- true;
+  Condition.broadcast p.start;
+  let domains = p.domains in
+  p.domains <- [];
+  Mutex.unlock p.lock;
+  List.iter Domain.join domains
+
+let with_pool ?num_workers f =
+  let p = create ?num_workers () in
+  match f p with
+  | r -> shutdown p; r
+  | exception e -> shutdown p; raise e
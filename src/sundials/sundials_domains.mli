@@ -0,0 +1,63 @@
+(***********************************************************************)
+(*                                                                     *)
+(*                   OCaml interface to Sundials                       *)
+(*                                                                     *)
+(*             Timothy Bourke, Jun Inoue, and Marc Pouzet              *)
+(*             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *)
+(*                                                                     *)
+(*  Copyright 2026 Institut National de Recherche en Informatique et   *)
+(*  en Automatique.  All rights reserved.  This file is distributed    *)
+(*  under a New BSD License, refer to the file LICENSE.                *)
+(*                                                                     *)
+(***********************************************************************)
+
+(** Pools of OCaml domains (requires OCaml 5).
+
+    A pool keeps [num_workers - 1] domains waiting for jobs, so that the
+    callbacks that Sundials/ML can distribute over several workers, like
+    the difference quotient Jacobian approximation of
+    {!Cvode.Dls.solver}, run in parallel without spawning a domain per
+    call. The calling domain is worker [0].
+
+    For example,
+    {[
+      Sundials_domains.with_pool ~num_workers:4 (fun p ->
+        let dq_pool = Cvode.Dls.{ num_workers = Sundials_domains.num_workers p;
+                                  run = Sundials_domains.run p } in
+        ...)
+    ]}
+
+    @version VERSION() *)
+
+(** A pool of domains. *)
+type t
+
+(** Creates a pool of [num_workers] workers by spawning [num_workers - 1]
+    domains. The default is [Domain.recommended_domain_count ()].
+
+    @raise Invalid_argument [num_workers] is not positive. *)
+val create : ?num_workers:int -> unit -> t
+
+(** Returns the number of workers of a pool, including the calling
+    domain. *)
+val num_workers : t -> int
+
+(** [run p job] calls [job w] once for each worker [w] from [0] to
+    [num_workers p - 1], concurrently, and returns once all the calls have
+    completed. If any call raises an exception, one of them is re-raised
+    after all have completed. [run] must not be called from within a job
+    or concurrently with another [run] on the same pool.
+
+    @raise Invalid_argument The pool is busy or has been shut down. *)
+val run : t -> (int -> unit) -> unit
+
+(** Terminates the domains of a pool and waits for them. A pool that is
+    not shut down keeps its domains until the program exits. Shutting
+    down a pool twice has no effect.
+
+    @raise Invalid_argument The pool is running a job. *)
+val shutdown : t -> unit
+
+(** [with_pool f] applies [f] to a new pool and shuts the pool down
+    afterward, even if [f] raises an exception. *)
+val with_pool : ?num_workers:int -> (t -> 'a) -> 'a
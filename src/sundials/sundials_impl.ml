@@ -14,6 +14,8 @@
 
 external crash : string -> 'a = "sunml_crash"
 
+external wall_clock : unit -> float = "sunml_wall_clock"
+
 (* A simple way of sharing values between OCaml and C. *)
 module Vptr : sig
 
@@ -155,6 +157,22 @@ module Logfile = struct
 
   let openfile ?(trunc=false) fpath = fopen fpath trunc
 
+  (* Must correspond with sundials_logfile_ml.c: enum async_overflow *)
+  type overflow = Block | Drop
+
+  external fopen_async : string -> bool -> int -> overflow -> float -> t
+    = "sunml_sundials_fopen_async"
+
+  let openfile_async ?(trunc=false) ?(buffer_size=1048576) ?(overflow=Block)
+                     ?(flush_interval=0.1) fpath =
+    if buffer_size <= 0 then invalid_arg "buffer_size must be positive";
+    if not (flush_interval > 0.0)
+    then invalid_arg "flush_interval must be positive";
+    fopen_async fpath trunc buffer_size overflow flush_interval
+
+  external num_dropped : t -> int
+    = "sunml_sundials_logfile_dropped"
+
   external output_string : t -> string -> unit
     = "sunml_sundials_write"
 
@@ -226,3 +244,133 @@ module Context = struct
 
 end
 
+
+(* Jobs run in forked worker processes (see sundials_workers_ml.c), which
+   must not be used after MPI_Init.  *)
+module Workers = struct
+
+  external c_run : (unit -> bytes) array -> int -> bytes option array
+    = "sunml_sundials_run_workers"
+
+  let marshal_result f () =
+    let r = try Ok (f ()) with e -> Error (Printexc.to_string e) in
+    let b = try Marshal.to_bytes r []
+            with e -> Marshal.to_bytes (Error (Printexc.to_string e)) [] in
+    flush_all ();
+    b
+
+  let unmarshal_result = function
+    | None -> failwith "worker process terminated abnormally"
+    | Some b ->
+        (match Marshal.from_bytes b 0 with
+         | Ok v -> v
+         | Error msg -> failwith msg)
+
+  let run ?(num_workers=0) jobs =
+    flush_all ();
+    let results = c_run (Array.map marshal_result jobs) num_workers in
+    Array.map unmarshal_result results
+
+end
+
+
+(* Binomial (Revolve) checkpointing schedules (Griewank and Walther,
+   Algorithm 799) over a sequence of segments.  *)
+module Revolve = struct
+
+  type budget =
+    | Snapshots of int
+    | Bytes of int
+
+  type stats = {
+      num_segments : int;
+      num_snapshots : int;
+      num_advances : int;
+      num_forward_steps : int;
+      num_taped_steps : int;
+      recomputation_ratio : float;
+    }
+
+  let num_snapshots budget ~snapshot_bytes ~num_segments =
+    let n = match budget with
+            | Snapshots n -> n
+            | Bytes b -> b / max 1 snapshot_bytes
+    in
+    if n < 1 then invalid_arg "the budget does not allow a single snapshot";
+    min n num_segments
+
+  (* The minimal number of segment advances needed to reverse l segments
+     given a snapshot of the first one and c free snapshots, i.e.,
+     r l - binom(c + 1 + r, c + 2) where r is the least integer such that
+     binom(c + 1 + r, c + 1) >= l.  *)
+  let cost l c =
+    if l <= 1 then 0
+    else if c = 0 then l * (l - 1) / 2
+    else begin
+      let s = c + 1 in
+      (* b = binom(s + r, s) *)
+      let rec find r b =
+        if b >= l then (r, b) else find (r + 1) (b * (s + r + 1) / (r + 1))
+      in
+      let r, b = find 0 1 in
+      r * l - b * r / (s + 1)
+    end
+
+  (* The number of segments to advance before taking the next snapshot.  *)
+  let split l c =
+    let best = ref 1 and best_cost = ref max_int in
+    for j = 1 to l - 1 do
+      let k = j + cost (l - j) (c - 1) + cost j c in
+      if k < !best_cost then (best := j; best_cost := k)
+    done;
+    !best
+
+  (* Segment i runs from boundary i to boundary i + 1.
+     - restore k i makes snapshot k, taken at boundary i, the current state;
+     - advance i j integrates the current state from boundary i to boundary
+       j without taping and returns the number of steps taken;
+     - store k saves the current state in snapshot k;
+     - tape i integrates segment i from the current state while recording
+       the checkpoints of the backward problems, and returns the number of
+       steps taken;
+     - backward i integrates the backward problems over segment i.
+     Snapshot 0 must hold the state at boundary 0.  *)
+  let run ~num_segments ~num_snapshots ~restore ~advance ~store ~tape
+          ~backward =
+    let advances = ref 0 and fwd_steps = ref 0 and taped_steps = ref 0 in
+    let advance i j =
+      advances := !advances + (j - i);
+      fwd_steps := !fwd_steps + advance i j
+    in
+    let tape i = taped_steps := !taped_steps + tape i in
+    let rec reverse a b k c =
+      if b - a = 1 then (restore k a; tape a; backward a)
+      else if c = 0 then
+        for i = b - 1 downto a do
+          restore k a;
+          if i > a then advance a i;
+          tape i;
+          backward i
+        done
+      else begin
+        let m = a + split (b - a) c in
+        restore k a;
+        advance a m;
+        store (k + 1);
+        reverse m b (k + 1) (c - 1);
+        reverse a m k c
+      end
+    in
+    reverse 0 num_segments 0 (num_snapshots - 1);
+    {
+      num_segments;
+      num_snapshots;
+      num_advances = !advances;
+      num_forward_steps = !fwd_steps + !taped_steps;
+      num_taped_steps = !taped_steps;
+      recomputation_ratio =
+        if !taped_steps = 0 then 1.0
+        else float (!fwd_steps + !taped_steps) /. float !taped_steps;
+    }
+
+end
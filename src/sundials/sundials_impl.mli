@@ -1,4 +1,5 @@
 external crash : string -> 'a = "sunml_crash"
+external wall_clock : unit -> float = "sunml_wall_clock"
 module Vptr :
   sig type 'a vptr val make : 'a -> 'a vptr val unwrap : 'a vptr -> 'a end
 module Callback :
@@ -28,6 +29,14 @@ module Logfile :
     val stderr : t
     val stdout : t
     val openfile : ?trunc:bool -> string -> t
+    type overflow = Block | Drop
+    external fopen_async : string -> bool -> int -> overflow -> float -> t
+      = "sunml_sundials_fopen_async"
+    val openfile_async :
+      ?trunc:bool ->
+      ?buffer_size:int ->
+      ?overflow:overflow -> ?flush_interval:float -> string -> t
+    external num_dropped : t -> int = "sunml_sundials_logfile_dropped"
     external output_string : t -> string -> unit = "sunml_sundials_write"
     external output_bytes : t -> bytes -> unit = "sunml_sundials_write"
     external flush : t -> unit = "sunml_sundials_fflush"
@@ -50,3 +59,35 @@ module Context :
     val get : t option -> t
     val get_profiler : t -> Profiler.t
   end
+module Workers :
+  sig
+    external c_run : (unit -> bytes) array -> int -> bytes option array
+      = "sunml_sundials_run_workers"
+    val marshal_result : (unit -> 'a) -> unit -> bytes
+    val unmarshal_result : bytes option -> 'a
+    val run : ?num_workers:int -> (unit -> 'a) array -> 'a array
+  end
+module Revolve :
+  sig
+    type budget = Snapshots of int | Bytes of int
+    type stats = {
+      num_segments : int;
+      num_snapshots : int;
+      num_advances : int;
+      num_forward_steps : int;
+      num_taped_steps : int;
+      recomputation_ratio : float;
+    }
+    val num_snapshots :
+      budget -> snapshot_bytes:int -> num_segments:int -> int
+    val cost : int -> int -> int
+    val split : int -> int -> int
+    val run :
+      num_segments:int ->
+      num_snapshots:int ->
+      restore:(int -> int -> unit) ->
+      advance:(int -> int -> int) ->
+      store:(int -> unit) ->
+      tape:(int -> int) ->
+      backward:(int -> unit) -> stats
+  end
@@ -0,0 +1,507 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Asynchronous log files.
+ *
+ * Sundials writes diagnostics with fprintf to a FILE*, so an asynchronous
+ * log file is a custom stream (fopencookie on glibc, funopen on the BSDs
+ * and macOS) whose write function copies the data into a ring buffer.  A
+ * background thread drains the buffer to the underlying file descriptor
+ * when it is half full, when the log is flushed, and periodically.
+ *
+ * The stream is unbuffered, so each fprintf results in exactly one call
+ * of the write function, and stdio locks the stream around it.  There is
+ * thus a single producer at a time and a single consumer, and the ring
+ * buffer needs no lock: the producer publishes with a release store of
+ * head and the consumer with a release store of tail.  The mutex and
+ * condition variables are only used to sleep: the consumer between
+ * drains, and the producer when the buffer is full and the overflow
+ * policy is to block.
+ *
+ * Closing a log stops its writer after a last drain and waits for it.
+ * The finalizer must not wait, so it only asks the writer to stop and
+ * detaches it; the writer then closes the stream itself.  The logs that
+ * are still open, or still draining after finalization, at exit are
+ * waited for by an atexit handler.  Afterward, in forked children, and on
+ * platforms without custom streams, writes go directly to the file.  */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE	/* fopencookie */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+#include <caml/custom.h>
+
+#include "sundials_ml.h"
+
+#if defined(__GLIBC__) \
+    || defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) \
+    || defined(__OpenBSD__) || defined(__DragonFly__)
+#define ASYNC_LOGFILES
+#endif
+
+#ifdef ASYNC_LOGFILES
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/types.h>
+
+#define ATOMIC_LOAD(p)	   __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ATOMIC_ADD(p, v)   __atomic_add_fetch((p), (v), __ATOMIC_RELAXED)
+
+// must correspond with Sundials_impl.Logfile.overflow
+enum async_overflow {
+    OVERFLOW_BLOCK = 0,
+    OVERFLOW_DROP,
+};
+
+struct async_log {
+    FILE *file;
+    int fd;
+
+    char *buf;
+    size_t cap;			/* a power of two */
+    size_t head;		/* bytes written, only stored by producers */
+    size_t tail;		/* bytes drained, only stored by the writer */
+    enum async_overflow overflow;
+    long dropped;
+
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t data;	/* wakes the writer */
+    pthread_cond_t space;	/* wakes blocked producers */
+    struct timespec interval;
+    int kick;			/* drain now */
+    int waiting;		/* a producer waits for space */
+    int stop;			/* drain and terminate */
+    int stopped;		/* the writer has terminated */
+    int detached;		/* the writer closes the stream */
+
+    struct async_log *next;
+};
+
+static struct async_log *open_logs = NULL;
+static pthread_mutex_t open_logs_lock = PTHREAD_MUTEX_INITIALIZER;
+static int atexit_registered = 0;
+static int num_detached = 0;	/* detached writers still running */
+static pthread_cond_t detached_done = PTHREAD_COND_INITIALIZER;
+
+static int write_all(int fd, const char *data, size_t len)
+{
+    ssize_t w;
+
+    while (len > 0) {
+	w = write(fd, data, len);
+	if (w < 0) {
+	    if (errno == EINTR) continue;
+	    return -1;
+	}
+	data += w;
+	len -= w;
+    }
+    return 0;
+}
+
+/* Called only by the writer thread (or after it has stopped).  */
+static void drain(struct async_log *l)
+{
+    size_t tail = l->tail, head = ATOMIC_LOAD(&l->head), off, n;
+
+    while (tail != head) {
+	off = tail & (l->cap - 1);
+	n = head - tail;
+	if (n > l->cap - off) n = l->cap - off;
+	if (write_all(l->fd, l->buf + off, n) != 0)
+	    ATOMIC_ADD(&l->dropped, (long)n);
+	tail += n;
+	ATOMIC_STORE(&l->tail, tail);
+    }
+
+    pthread_mutex_lock(&l->lock);
+    if (l->waiting) pthread_cond_broadcast(&l->space);
+    pthread_mutex_unlock(&l->lock);
+}
+
+static void *writer_main(void *arg)
+{
+    struct async_log *l = (struct async_log *)arg;
+    struct timeval now;
+    struct timespec deadline;
+    int stop, detached;
+
+    for (;;) {
+	gettimeofday(&now, NULL);
+	deadline.tv_sec = now.tv_sec + l->interval.tv_sec;
+	deadline.tv_nsec = now.tv_usec * 1000 + l->interval.tv_nsec;
+	if (deadline.tv_nsec >= 1000000000) {
+	    deadline.tv_sec++;
+	    deadline.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&l->lock);
+	if (!l->stop && !l->kick)
+	    pthread_cond_timedwait(&l->data, &l->lock, &deadline);
+	l->kick = 0;
+	stop = l->stop;
+	detached = l->detached;
+	pthread_mutex_unlock(&l->lock);
+
+	drain(l);
+	if (stop) break;
+    }
+
+    if (detached) {
+	/* async_close frees l */
+	fclose(l->file);
+	pthread_mutex_lock(&open_logs_lock);
+	if (--num_detached == 0) pthread_cond_broadcast(&detached_done);
+	pthread_mutex_unlock(&open_logs_lock);
+    }
+
+    return NULL;
+}
+
+static void wake_writer(struct async_log *l)
+{
+    pthread_mutex_lock(&l->lock);
+    l->kick = 1;
+    pthread_cond_signal(&l->data);
+    pthread_mutex_unlock(&l->lock);
+}
+
+/* Terminate the writer after a last drain.  */
+static void stop_writer(struct async_log *l)
+{
+    if (l->stopped) return;
+
+    pthread_mutex_lock(&l->lock);
+    l->stop = 1;
+    pthread_cond_signal(&l->data);
+    pthread_cond_broadcast(&l->space);
+    pthread_mutex_unlock(&l->lock);
+
+    pthread_join(l->writer, NULL);
+    l->stopped = 1;
+}
+
+/* Ask the writer to stop after a last drain and to close the stream,
+   without waiting for it.  Returns 0 if there is no writer.  */
+static int detach_writer(struct async_log *l)
+{
+    struct async_log **pl;
+    pthread_t writer;
+    int r = 0;
+
+    pthread_mutex_lock(&open_logs_lock);
+    for (pl = &open_logs; *pl != NULL && *pl != l; pl = &(*pl)->next);
+    if (*pl != NULL) *pl = l->next;
+
+    if (!l->stopped) {
+	writer = l->writer;
+	l->stopped = 1;
+	num_detached++;
+	r = 1;
+
+	/* l may be freed as soon as the writer sees detached */
+	pthread_mutex_lock(&l->lock);
+	l->stop = 1;
+	l->detached = 1;
+	pthread_cond_signal(&l->data);
+	pthread_cond_broadcast(&l->space);
+	pthread_mutex_unlock(&l->lock);
+
+	pthread_detach(writer);
+    }
+    pthread_mutex_unlock(&open_logs_lock);
+
+    return r;
+}
+
+static void stop_all_writers(void)
+{
+    struct async_log *l;
+
+    pthread_mutex_lock(&open_logs_lock);
+    for (l = open_logs; l != NULL; l = l->next) stop_writer(l);
+    while (num_detached > 0)
+	pthread_cond_wait(&detached_done, &open_logs_lock);
+    pthread_mutex_unlock(&open_logs_lock);
+}
+
+/* The writer threads do not exist in a forked child, whose writes must
+   thus go directly to the files.  */
+static void stop_all_after_fork(void)
+{
+    struct async_log *l;
+
+    pthread_mutex_init(&open_logs_lock, NULL);
+    pthread_cond_init(&detached_done, NULL);
+    num_detached = 0;
+    for (l = open_logs; l != NULL; l = l->next) {
+	pthread_mutex_init(&l->lock, NULL);
+	l->stop = 1;
+	l->stopped = 1;
+    }
+}
+
+static struct async_log *find_log(FILE *file)
+{
+    struct async_log *l;
+
+    pthread_mutex_lock(&open_logs_lock);
+    for (l = open_logs; l != NULL && l->file != file; l = l->next);
+    pthread_mutex_unlock(&open_logs_lock);
+
+    return l;
+}
+
+/* Copy at most cap bytes into the ring buffer; returns the number of
+   bytes consumed (copied or dropped).  */
+static size_t push(struct async_log *l, const char *data, size_t len)
+{
+    size_t head = l->head, off, n;
+
+    if (len > l->cap) len = l->cap;
+
+    while (l->cap - (head - ATOMIC_LOAD(&l->tail)) < len) {
+	if (l->overflow == OVERFLOW_DROP) {
+	    ATOMIC_ADD(&l->dropped, (long)len);
+	    wake_writer(l);
+	    return len;
+	}
+
+	pthread_mutex_lock(&l->lock);
+	l->waiting = 1;
+	l->kick = 1;
+	pthread_cond_signal(&l->data);
+	while (!l->stopped && !l->stop
+		&& l->cap - (head - ATOMIC_LOAD(&l->tail)) < len)
+	    pthread_cond_wait(&l->space, &l->lock);
+	l->waiting = 0;
+	pthread_mutex_unlock(&l->lock);
+
+	if (l->stop) {
+	    if (write_all(l->fd, data, len) != 0)
+		ATOMIC_ADD(&l->dropped, (long)len);
+	    return len;
+	}
+    }
+
+    off = head & (l->cap - 1);
+    n = (len < l->cap - off) ? len : l->cap - off;
+    memcpy(l->buf + off, data, n);
+    memcpy(l->buf, data + n, len - n);
+    ATOMIC_STORE(&l->head, head + len);
+
+    /* Signal without the lock: a lost wakeup only delays the drain until
+       the next period.  */
+    if (head + len - ATOMIC_LOAD(&l->tail) > l->cap / 2)
+	pthread_cond_signal(&l->data);
+
+    return len;
+}
+
+static ssize_t async_write(void *cookie, const char *data, size_t len)
+{
+    struct async_log *l = (struct async_log *)cookie;
+    size_t done = 0;
+
+    if (l->stop) {
+	return (write_all(l->fd, data, len) == 0) ? (ssize_t)len : -1;
+    }
+
+    while (done < len) done += push(l, data + done, len - done);
+    return (ssize_t)len;
+}
+
+static int async_close(void *cookie)
+{
+    struct async_log *l = (struct async_log *)cookie;
+    struct async_log **pl;
+    int r;
+
+    if (!l->detached) {
+	pthread_mutex_lock(&open_logs_lock);
+	for (pl = &open_logs; *pl != NULL && *pl != l; pl = &(*pl)->next);
+	if (*pl != NULL) *pl = l->next;
+	stop_writer(l);
+	pthread_mutex_unlock(&open_logs_lock);
+    }
+
+    r = close(l->fd);
+    pthread_mutex_destroy(&l->lock);
+    pthread_cond_destroy(&l->data);
+    pthread_cond_destroy(&l->space);
+    free(l->buf);
+    free(l);
+
+    return r;
+}
+
+#ifdef __GLIBC__
+static FILE *open_stream(struct async_log *l)
+{
+    cookie_io_functions_t fns = { NULL, async_write, NULL, async_close };
+    return fopencookie(l, "w", fns);
+}
+#else
+static int funopen_write(void *cookie, const char *data, int len)
+{
+    return (int)async_write(cookie, data, (size_t)len);
+}
+
+static FILE *open_stream(struct async_log *l)
+{
+    return funopen(l, NULL, funopen_write, NULL, async_close);
+}
+#endif
+
+static FILE *open_async(const char *path, int trunc, size_t size,
+			enum async_overflow overflow, double interval)
+{
+    struct async_log *l;
+    sigset_t all, old;
+    int err;
+
+    l = (struct async_log *)calloc(1, sizeof(struct async_log));
+    if (l == NULL) return NULL;
+
+    for (l->cap = 4096; l->cap < size; l->cap *= 2);
+    l->buf = (char *)malloc(l->cap);
+    l->overflow = overflow;
+    l->interval.tv_sec = (time_t)interval;
+    l->interval.tv_nsec = (long)((interval - (double)l->interval.tv_sec) * 1e9);
+    l->fd = open(path, O_WRONLY | O_CREAT | (trunc ? O_TRUNC : O_APPEND),
+		 0666);
+    if (l->buf == NULL || l->fd < 0) goto fail;
+
+    pthread_mutex_init(&l->lock, NULL);
+    pthread_cond_init(&l->data, NULL);
+    pthread_cond_init(&l->space, NULL);
+
+    l->file = open_stream(l);
+    if (l->file == NULL) goto fail_sync;
+    setvbuf(l->file, NULL, _IONBF, 0);
+
+    /* Signals are handled by the other threads.  */
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    err = pthread_create(&l->writer, NULL, writer_main, l);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (err != 0) {
+	/* The stream works without the writer thread: async_write writes
+	   directly once stop is set.  */
+	l->stop = 1;
+	l->stopped = 1;
+    }
+
+    pthread_mutex_lock(&open_logs_lock);
+    l->next = open_logs;
+    open_logs = l;
+    if (!atexit_registered) {
+	atexit(stop_all_writers);
+	pthread_atfork(NULL, NULL, stop_all_after_fork);
+	atexit_registered = 1;
+    }
+    pthread_mutex_unlock(&open_logs_lock);
+
+    return l->file;
+
+fail_sync:
+    pthread_mutex_destroy(&l->lock);
+    pthread_cond_destroy(&l->data);
+    pthread_cond_destroy(&l->space);
+fail:
+    err = errno;
+    if (l->fd >= 0) close(l->fd);
+    free(l->buf);
+    free(l);
+    errno = err;
+    return NULL;
+}
+#endif
+
+void sunml_logfile_async_flush(FILE *file)
+{
+#ifdef ASYNC_LOGFILES
+    struct async_log *l = find_log(file);
+    if (l != NULL && !l->stop) wake_writer(l);
+#endif
+}
+
+/* Closing would wait for the writer, which must not be done in a
+   finalizer.  */
+static void finalize_async_file(value vf)
+{
+    FILE *file = ML_CFILE(vf);
+#ifdef ASYNC_LOGFILES
+    struct async_log *l;
+#endif
+
+    if (file != NULL) {
+#ifdef ASYNC_LOGFILES
+	l = find_log(file);
+	if (l != NULL && detach_writer(l)) return;
+#endif
+	fclose(file);
+    }
+}
+
+CAMLprim value sunml_sundials_fopen_async(value vpath, value vtrunc,
+					  value vsize, value voverflow,
+					  value vinterval)
+{
+    CAMLparam5(vpath, vtrunc, vsize, voverflow, vinterval);
+    CAMLlocal1(vr);
+    FILE *file;
+
+#ifdef ASYNC_LOGFILES
+    file = open_async(String_val(vpath), Bool_val(vtrunc),
+		      Long_val(vsize), Int_val(voverflow),
+		      Double_val(vinterval));
+#else
+    file = fopen(String_val(vpath), Bool_val(vtrunc) ? "w" : "a");
+#endif
+
+    if (file == NULL) {
+	caml_failwith(strerror(errno));
+    }
+
+    vr = caml_alloc_final(1, &finalize_async_file, 1, 10);
+    ML_CFILE(vr) = file;
+
+    CAMLreturn (vr);
+}
+
+CAMLprim value sunml_sundials_logfile_dropped(value vfile)
+{
+    CAMLparam1(vfile);
+    long dropped = 0;
+#ifdef ASYNC_LOGFILES
+    struct async_log *l = find_log(ML_CFILE(vfile));
+
+    if (l != NULL) dropped = ATOMIC_LOAD(&l->dropped);
+#endif
+    CAMLreturn (Val_long(dropped));
+}
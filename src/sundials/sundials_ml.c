@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/time.h>
 
 #include <sundials/sundials_config.h>
 #include <sundials/sundials_types.h>
@@ -176,6 +177,17 @@ CAMLprim void sunml_crash (value msg)
     CAMLreturn0;
 }
 
+/* Wall-clock time in seconds, for calibrations that must not count the
+   CPU time of every OpenMP thread (as Sys.time does).  */
+CAMLprim value sunml_wall_clock (value vunit)
+{
+    CAMLparam1 (vunit);
+    struct timeval now;
+
+    gettimeofday (&now, NULL);
+    CAMLreturn (caml_copy_double ((double)now.tv_sec + 1e-6 * now.tv_usec));
+}
+
 CAMLprim int sunml_sundials_compare_tol(value va, value vb, value vtol)
 {
     CAMLparam3(va, vb, vtol);
@@ -338,6 +350,7 @@ CAMLprim value sunml_sundials_fflush(value vfile)
     CAMLparam1(vfile);
     FILE *file = ML_CFILE(vfile);
     fflush(file);
+    sunml_logfile_async_flush(file);
     CAMLreturn (Val_unit);
 }
 
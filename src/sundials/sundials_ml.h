@@ -231,6 +231,10 @@ enum sundials_exn_index {
 
 CAMLprim value sunml_sundials_wrap_file(FILE* f);
 
+/* Wake the background writer of an asynchronous log file (no effect on
+   other files). */
+void sunml_logfile_async_flush(FILE *file);
+
 /* Accessing callback values */
 #define ML_CALLBACK_CPTR(v) (Field(v, 0))
 
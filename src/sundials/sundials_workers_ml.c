@@ -0,0 +1,266 @@
+/***********************************************************************
+ *                                                                     *
+ *                   OCaml interface to Sundials                       *
+ *                                                                     *
+ *             Timothy Bourke, Jun Inoue, and Marc Pouzet              *
+ *             (Inria/ENS)     (Inria/ENS)    (UPMC/ENS/Inria)         *
+ *                                                                     *
+ *  Copyright 2026 Institut National de Recherche en Informatique et   *
+ *  en Automatique.  All rights reserved.  This file is distributed    *
+ *  under a New BSD License, refer to the file LICENSE.                *
+ *                                                                     *
+ ***********************************************************************/
+
+/* Running jobs in forked worker processes.
+ *
+ * Each job is an OCaml closure returning bytes (the marshalled result).
+ * It is called in a child process, which inherits a copy-on-write image
+ * of the parent, including the solver memory, and writes the bytes to a
+ * pipe before terminating with _exit (so that at_exit functions and
+ * buffers inherited from the parent are not run or flushed twice).  At
+ * most num_workers children run at once; the parent collects the outputs
+ * with poll and returns, for each job, Some bytes or None if the child
+ * did not terminate normally.  Other threads may run OCaml code while the
+ * parent waits in poll.
+ *
+ * Forking is unsafe in programs that have called MPI_Init: most MPI
+ * implementations do not support a child process that uses, or even
+ * inherits, the state of the library.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <caml/mlvalues.h>
+#include <caml/alloc.h>
+#include <caml/memory.h>
+#include <caml/fail.h>
+#include <caml/callback.h>
+#include <caml/signals.h>
+
+#include "sundials_ml.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+
+struct worker {
+    pid_t pid;
+    int fd;
+    int job;
+    char *out;
+    size_t len, cap;
+};
+
+struct job_output {
+    char *data;
+    size_t len;
+    int ok;
+};
+
+static int write_all(int fd, const char *data, size_t len)
+{
+    ssize_t w;
+
+    while (len > 0) {
+	w = write(fd, data, len);
+	if (w < 0) {
+	    if (errno == EINTR) continue;
+	    return -1;
+	}
+	data += w;
+	len -= w;
+    }
+    return 0;
+}
+
+static void run_child(value vjob, int fd)
+{
+    value vr = caml_callback_exn(vjob, Val_unit);
+    int status = 1;
+
+    if (!Is_exception_result(vr)
+	    && write_all(fd, (const char *)Bp_val(vr),
+			 caml_string_length(vr)) == 0)
+	status = 0;
+
+    fflush(NULL);
+    _exit(status);
+}
+
+/* Read what is available; returns 0 at end of file and -1 if the buffer
+   cannot be enlarged.  */
+static int read_some(struct worker *w)
+{
+    ssize_t r;
+    size_t cap;
+    char *out;
+
+    if (w->cap - w->len < 4096) {
+	cap = 2 * w->cap + 4096;
+	out = (char *)realloc(w->out, cap);
+	if (out == NULL) return -1;
+	w->out = out;
+	w->cap = cap;
+    }
+
+    do {
+	r = read(w->fd, w->out + w->len, w->cap - w->len);
+    } while (r < 0 && errno == EINTR);
+
+    if (r <= 0) return 0;
+    w->len += r;
+    return 1;
+}
+
+static void finish(struct worker *w, struct job_output *out)
+{
+    int status;
+
+    close(w->fd);
+    while (waitpid(w->pid, &status, 0) < 0 && errno == EINTR);
+
+    out[w->job].data = w->out;
+    out[w->job].len = w->len;
+    out[w->job].ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/* Kill and reap the running children, and free all the outputs, before
+   raising an exception.  */
+static void abandon(struct worker *ws, int active,
+		    struct job_output *out, int njobs)
+{
+    int i, status;
+
+    for (i = 0; i < active; i++) {
+	kill(ws[i].pid, SIGKILL);
+	close(ws[i].fd);
+	while (waitpid(ws[i].pid, &status, 0) < 0 && errno == EINTR);
+	free(ws[i].out);
+    }
+    for (i = 0; i < njobs; i++) free(out[i].data);
+    free(ws);
+    free(out);
+}
+#endif
+
+CAMLprim value sunml_sundials_run_workers(value vjobs, value vnum_workers)
+{
+    CAMLparam2(vjobs, vnum_workers);
+    CAMLlocal3(vr, vbytes, vsome);
+#ifndef _WIN32
+    int njobs = Wosize_val(vjobs);
+    int nworkers = Int_val(vnum_workers);
+    struct worker *ws;
+    struct job_output *out;
+    struct pollfd *pfds;
+    int next = 0, active = 0, i, r, err, fds[2];
+    pid_t pid;
+
+    if (nworkers <= 0) {
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	nworkers = (ncpus > 0) ? (int)ncpus : 1;
+    }
+    if (nworkers > njobs) nworkers = njobs;
+
+    ws = (struct worker *)calloc(nworkers + 1, sizeof(struct worker));
+    pfds = (struct pollfd *)calloc(nworkers + 1, sizeof(struct pollfd));
+    out = (struct job_output *)calloc(njobs + 1, sizeof(struct job_output));
+    if (ws == NULL || pfds == NULL || out == NULL) {
+	free(ws);
+	free(pfds);
+	free(out);
+	caml_raise_out_of_memory();
+    }
+
+    /* the children must not write what is buffered in the parent */
+    fflush(NULL);
+
+    while (next < njobs || active > 0) {
+	while (next < njobs && active < nworkers) {
+	    if (pipe(fds) != 0) break;
+	    pid = fork();
+	    if (pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		break;
+	    }
+	    if (pid == 0) {
+		close(fds[0]);
+		for (i = 0; i < active; i++) close(ws[i].fd);
+		run_child(Field(vjobs, next), fds[1]);
+	    }
+	    close(fds[1]);
+	    ws[active].pid = pid;
+	    ws[active].fd = fds[0];
+	    ws[active].job = next;
+	    ws[active].out = NULL;
+	    ws[active].len = ws[active].cap = 0;
+	    active++;
+	    next++;
+	}
+
+	if (active == 0) {
+	    /* no child could be started */
+	    err = errno;
+	    abandon(ws, 0, out, njobs);
+	    free(pfds);
+	    caml_failwith(strerror(err));
+	}
+
+	for (i = 0; i < active; i++) {
+	    pfds[i].fd = ws[i].fd;
+	    pfds[i].events = POLLIN;
+	    pfds[i].revents = 0;
+	}
+	caml_enter_blocking_section();
+	r = poll(pfds, active, -1);
+	err = errno;
+	caml_leave_blocking_section();
+	if (r < 0) {
+	    if (err == EINTR) continue;
+	    abandon(ws, active, out, njobs);
+	    free(pfds);
+	    caml_failwith(strerror(err));
+	}
+
+	for (i = active - 1; i >= 0; i--) {
+	    if (pfds[i].revents == 0) continue;
+	    r = read_some(&ws[i]);
+	    if (r < 0) {
+		abandon(ws, active, out, njobs);
+		free(pfds);
+		caml_raise_out_of_memory();
+	    }
+	    if (r == 0) {
+		finish(&ws[i], out);
+		ws[i] = ws[--active];
+	    }
+	}
+    }
+
+    vr = caml_alloc_tuple(njobs);
+    for (i = 0; i < njobs; i++) {
+	if (out[i].ok) {
+	    vbytes = caml_alloc_string(out[i].len);
+	    memcpy(Bp_val(vbytes), out[i].data, out[i].len);
+	    Store_some(vsome, vbytes);
+	    Store_field(vr, i, vsome);
+	} else {
+	    Store_field(vr, i, Val_none);
+	}
+	free(out[i].data);
+    }
+
+    free(ws);
+    free(pfds);
+    free(out);
+#else
+    caml_failwith("worker processes are not supported on this platform");
+#endif
+    CAMLreturn(vr);
+}
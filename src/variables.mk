@@ -25,9 +25,23 @@ include ../config
 
 # Common to CVODE, IDA, KINSOL, and ARKODE.
 COBJ_COMMON = sundials/sundials_ml$(XO)	\
+	      sundials/sundials_logfile_ml$(XO)	\
+	      sundials/sundials_workers_ml$(XO)	\
 	      lsolvers/sundials_matrix_ml$(XO)	\
+	      lsolvers/sundials_binaryfile_ml$(XO)	\
+	      lsolvers/sundials_dense_lu_ml$(XO)	\
+	      lsolvers/sundials_sparse_order_ml$(XO)	\
 	      lsolvers/sundials_linearsolver_ml$(XO)	\
+	      lsolvers/sundials_lsolver_mixed_ml$(XO)	\
+	      lsolvers/sundials_lsolver_cached_ml$(XO)	\
+	      lsolvers/sundials_lsolver_spike_ml$(XO)	\
+	      lsolvers/sundials_lsolver_sparselu_ml$(XO)	\
+	      lsolvers/sundials_lsolver_reordered_ml$(XO)	\
+	      lsolvers/sundials_lsolver_gcrodr_ml$(XO)	\
+	      lsolvers/sundials_lsolver_pipelined_ml$(XO)	\
 	      lsolvers/sundials_nonlinearsolver_ml$(XO)	\
+	      lsolvers/sundials_nlsolver_broyden_ml$(XO)	\
+	      lsolvers/sundials_nlsolver_tasklocal_ml$(XO)	\
 	      nvectors/nvector_ml$(XO)
 
 COBJ_MAIN = $(COBJ_COMMON) \
@@ -48,6 +62,7 @@ MLOBJ_MAIN =	sundials/sundials_configuration.cmo	\
 		nvectors/nvector_serial.cmo		\
 		$(if $(NVECMANYVECTOR_ENABLED),nvectors/nvector_many.cmo) \
 		lsolvers/sundials_Matrix.cmo		\
+		lsolvers/sundials_BinaryFile.cmo	\
 		lsolvers/sundials_LinearSolver_impl.cmo	\
 		lsolvers/sundials_LinearSolver.cmo	\
 		lsolvers/sundials_NonlinearSolver_impl.cmo \
@@ -124,11 +139,15 @@ COBJ_PTHREADS =	nvectors/nvector_pthreads_ml$(XO)
 MLOBJ_PTHREADS=	nvectors/nvector_pthreads.cmo
 CMI_PTHREADS =	$(MLOBJ_PTHREADS:.cmo=.cmi)
 
-### Objects specific to sundials_pthreads.cma.
+### Objects specific to sundials_openmp.cma.
 COBJ_OPENMP =	nvectors/nvector_openmp_ml$(XO)
 MLOBJ_OPENMP =	nvectors/nvector_openmp.cmo
 CMI_OPENMP =	$(MLOBJ_OPENMP:.cmo=.cmi)
 
+### Objects specific to sundials_domains.cma (OCaml only).
+MLOBJ_DOMAINS =	sundials/sundials_domains.cmo
+CMI_DOMAINS =	$(MLOBJ_DOMAINS:.cmo=.cmi)
+
 ### Objects specific to sundials_top_*.cma.
 
 MLOBJ_TOP = sundials/sundials_top.cmo		\
@@ -167,10 +186,11 @@ ALL_COBJ = $(COBJ_MAIN) $(COBJ_SENS) $(COBJ_NO_SENS) $(COBJ_MPI) \
 ALL_MLOBJ =doc/dochtml.cmo					\
 	   $(MLOBJ_MAIN)					\
 	   $(MLOBJ_SENS) $(MLOBJ_NO_SENS) $(MLOBJ_MPI)		\
-	   $(MLOBJ_OPENMP) $(MLOBJ_PTHREADS)			\
+	   $(MLOBJ_OPENMP) $(MLOBJ_PTHREADS) $(MLOBJ_DOMAINS)	\
 	   $(MLOBJ_TOP_ALL)
 ALL_CMA = sundials.cma sundials_no_sens.cma sundials_mpi.cma	\
 	  sundials_openmp.cma sundials_pthreads.cma		\
+	  sundials_domains.cma					\
 	  sundials_docs.cma sundials_docs.cmxs			\
 	  $(CMA_TOP_ALL)
 
@@ -193,8 +213,12 @@ CMA_OF_CMO=$(if $(TOP_ENABLED),						\
 		$(if $(PTHREADS_ENABLED),sundials_top_pthreads.cma)	\
 	    )
 
-INSTALL_CMA= $(CMA_OF_CMO_CMX_COBJ) $(CMA_OF_CMO)
-INSTALL_CMXA=$(CMA_OF_CMO_CMX_COBJ:.cma=.cmxa)
+# Libraries made by linking .cmo or .cmx files, yielding foo.cma and
+# foo.cmxa.
+CMA_OF_CMO_CMX=$(if $(DOMAINS_ENABLED),sundials_domains.cma)
+
+INSTALL_CMA= $(CMA_OF_CMO_CMX_COBJ) $(CMA_OF_CMO) $(CMA_OF_CMO_CMX)
+INSTALL_CMXA=$(CMA_OF_CMO_CMX_COBJ:.cma=.cmxa) $(CMA_OF_CMO_CMX:.cma=.cmxa)
 
 INSTALL_LIBS=$(foreach file,$(CMA_OF_CMO_CMX_COBJ:.cma=$(XA)),libml$(file))
 
@@ -202,13 +226,15 @@ INSTALL_CMI=$(CMI_MAIN) $(CMI_SENS)			\
 	    $(if $(TOP_ENABLED),$(CMI_TOP))		\
 	    $(if $(MPI_ENABLED),$(CMI_MPI))		\
 	    $(if $(PTHREADS_ENABLED),$(CMI_PTHREADS))	\
-	    $(if $(OPENMP_ENABLED),$(CMI_OPENMP))
+	    $(if $(OPENMP_ENABLED),$(CMI_OPENMP))	\
+	    $(if $(DOMAINS_ENABLED),$(CMI_DOMAINS))
 
 INSTALL_CMX=$(MLOBJ_MAIN:.cmo=.cmx) $(MLOBJ_SENS:.cmo=.cmx)	  \
 	    $(MLOBJ_NO_SENS:.cmo=.cmx)				  \
 	    $(if $(MPI_ENABLED),$(MLOBJ_MPI:.cmo=.cmx))		  \
 	    $(if $(PTHREADS_ENABLED),$(MLOBJ_PTHREADS:.cmo=.cmx)) \
-	    $(if $(OPENMP_ENABLED),$(MLOBJ_OPENMP:.cmo=.cmx))
+	    $(if $(OPENMP_ENABLED),$(MLOBJ_OPENMP:.cmo=.cmx))	  \
+	    $(if $(DOMAINS_ENABLED),$(MLOBJ_DOMAINS:.cmo=.cmx))
 
 INSTALL_MLI=$(CMI_MAIN:.cmi=.mli) $(CMI_SENS:.cmi=.mli)
 